@@ -0,0 +1,65 @@
+/**
+ * @file bench.hpp
+ * @brief Minimal microbenchmark harness for the engine hot paths.
+ *
+ * Each benchmark is a function that runs its operation N times. The runner
+ * calibrates N to the requested sample time, takes several samples and
+ * reports per-operation timings as a table and as JSON, so results can be
+ * compared across releases (see --compare in bench_main.cpp).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ida_chat::bench {
+
+/**
+ * @brief A registered benchmark.
+ */
+struct Benchmark {
+    std::string name;                           ///< "group/case", used by --filter
+    std::uint64_t bytes_per_op = 0;             ///< Input size, for throughput (0 = n/a)
+    std::function<void(std::uint64_t iterations)> run;
+};
+
+/**
+ * @brief Collects benchmarks from the bench_*.cpp files.
+ */
+class Registry {
+public:
+    void add(std::string name, std::function<void(std::uint64_t)> run,
+             std::uint64_t bytes_per_op = 0) {
+        benchmarks_.push_back({std::move(name), bytes_per_op, std::move(run)});
+    }
+    
+    [[nodiscard]] const std::vector<Benchmark>& benchmarks() const noexcept {
+        return benchmarks_;
+    }
+
+private:
+    std::vector<Benchmark> benchmarks_;
+};
+
+/**
+ * @brief Keep the compiler from discarding a computed value.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Implemented in bench_engine.cpp / bench_markdown.cpp / bench_widgets.cpp
+void register_engine_benchmarks(Registry& registry);
+void register_markdown_benchmarks(Registry& registry);
+void register_widget_benchmarks(Registry& registry);
+
+} // namespace ida_chat::bench
@@ -0,0 +1,345 @@
+/**
+ * @file bench_engine.cpp
+ * @brief Benchmarks for the IDA-independent engine (api, core, history).
+ */
+
+#include "bench.hpp"
+
+#include <ida_chat/api/claude_types.hpp>
+#include <ida_chat/api/streaming_parser.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/script_scheduler.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/history/message_history.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace ida_chat::bench {
+
+namespace {
+
+// ============================================================================
+// Synthetic inputs
+// ============================================================================
+
+const char* const PROSE =
+    "The function at 0x401000 walks the import table and resolves each thunk "
+    "by hash. The loop at 0x40104c compares the ROR13 hash of every export name "
+    "against a constant, which is the usual shellcode resolver pattern. ";
+
+const char* const SCRIPT =
+    "for func_ea in db.functions:\n"
+    "    name = db.functions.get_name(func_ea)\n"
+    "    if name.startswith('sub_'):\n"
+    "        print(hex(func_ea), name, len(list(db.xrefs.to_ea(func_ea))))\n";
+
+/// Assistant text of roughly `size` bytes with an idascript block every few paragraphs
+std::string make_response_text(std::size_t size) {
+    std::string text;
+    text.reserve(size + 512);
+    for (int i = 0; text.size() < size; ++i) {
+        text += PROSE;
+        text += "\n\n";
+        if (i % 4 == 3) {
+            text += "<idascript>\n";
+            text += SCRIPT;
+            text += "</idascript>\n\n";
+        }
+    }
+    return text;
+}
+
+std::string sse_event(const nlohmann::json& data) {
+    return "event: " + data["type"].get<std::string>() + "\ndata: " + data.dump() + "\n\n";
+}
+
+/// A complete streamed response: one text block delivered in ~40 byte deltas
+std::string make_sse_stream(std::size_t text_size) {
+    std::string stream;
+    stream += sse_event({{"type", "message_start"}, {"message", {
+        {"id", "msg_bench"}, {"type", "message"}, {"role", "assistant"},
+        {"model", "claude-sonnet-4-20250514"}, {"content", nlohmann::json::array()},
+        {"usage", {{"input_tokens", 1200}, {"output_tokens", 1}}}}}});
+    stream += sse_event({{"type", "content_block_start"}, {"index", 0},
+        {"content_block", {{"type", "text"}, {"text", ""}}}});
+    
+    std::string text = make_response_text(text_size);
+    for (std::size_t pos = 0; pos < text.size(); pos += 40) {
+        stream += sse_event({{"type", "content_block_delta"}, {"index", 0},
+            {"delta", {{"type", "text_delta"}, {"text", text.substr(pos, 40)}}}});
+    }
+    
+    stream += sse_event({{"type", "content_block_stop"}, {"index", 0}});
+    stream += sse_event({{"type", "message_delta"}, {"delta", {{"stop_reason", "end_turn"}}},
+        {"usage", {{"output_tokens", 900}}}});
+    stream += sse_event({{"type", "message_stop"}});
+    return stream;
+}
+
+/// A conversation shaped like an agentic session: prompt, then script/result rounds
+CreateMessageRequest make_request(int turns) {
+    CreateMessageRequest request;
+    request.system = make_response_text(8 * 1024);
+    request.messages.push_back(ClaudeMessage::text(MessageRole::User,
+        "Find the API hashing routine and list every resolved import."));
+    
+    std::string output(1500, 'x');
+    for (int i = 0; i < turns; ++i) {
+        ClaudeMessage assistant;
+        assistant.role = MessageRole::Assistant;
+        assistant.content.push_back(TextContent{std::string(PROSE) + PROSE});
+        assistant.content.push_back(ToolUseContent{
+            "toolu_" + std::to_string(i), "idascript", {{"code", SCRIPT}}});
+        request.messages.push_back(std::move(assistant));
+        
+        ClaudeMessage user;
+        user.role = MessageRole::User;
+        user.content.push_back(ToolResultContent{"toolu_" + std::to_string(i), output, false});
+        request.messages.push_back(std::move(user));
+    }
+    return request;
+}
+
+/**
+ * @brief Points the config directory at a scratch directory for its lifetime.
+ */
+class ScratchConfigDir {
+public:
+    ScratchConfigDir() {
+        path_ = std::filesystem::temp_directory_path() / ("ida_chat_bench_" + generate_uuid());
+        std::filesystem::create_directories(path_);
+        set_env(path_.string());
+    }
+    
+    ~ScratchConfigDir() {
+        set_env("");
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+    
+    ScratchConfigDir(const ScratchConfigDir&) = delete;
+    ScratchConfigDir& operator=(const ScratchConfigDir&) = delete;
+
+private:
+    static void set_env(const std::string& value) {
+#ifdef IDA_CHAT_WINDOWS
+        _putenv_s("IDA_CHAT_CONFIG_DIR", value.c_str());
+#else
+        setenv("IDA_CHAT_CONFIG_DIR", value.c_str(), 1);
+#endif
+    }
+    
+    std::filesystem::path path_;
+};
+
+void fill_session(MessageHistory& history, int rounds) {
+    (void)history.start_new_session();
+    history.append_user_message("Find the API hashing routine and list every resolved import.");
+    for (int i = 0; i < rounds; ++i) {
+        std::string id = "toolu_" + std::to_string(i);
+        history.append_assistant_message(std::string(PROSE) + PROSE);
+        history.append_tool_use("idascript", {{"code", SCRIPT}}, id);
+        history.append_tool_result(id, std::string(1500, 'x'));
+    }
+}
+
+// ============================================================================
+// Groups
+// ============================================================================
+
+void register_parser(Registry& registry) {
+    auto stream = std::make_shared<std::string>(make_sse_stream(64 * 1024));
+    
+    for (std::size_t chunk : {16, 256, 4096, 65536}) {
+        auto chunks = std::make_shared<std::vector<std::string>>();
+        for (std::size_t pos = 0; pos < stream->size(); pos += chunk) {
+            chunks->push_back(stream->substr(pos, chunk));
+        }
+        registry.add("parser_feed/chunk_" + std::to_string(chunk), [chunks](std::uint64_t n) {
+            StreamingParser parser(nullptr);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                parser.reset();
+                for (const auto& c : *chunks) parser.feed(c);
+                parser.finish();
+                do_not_optimize(parser.get_response());
+            }
+        }, stream->size());
+    }
+}
+
+void register_script_blocks(Registry& registry) {
+    for (std::size_t size : {16 * 1024, 256 * 1024}) {
+        auto text = std::make_shared<std::string>(make_response_text(size));
+        std::string suffix = std::to_string(size / 1024) + "k";
+        
+        registry.add("extract_idascript_blocks/" + suffix, [text](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                do_not_optimize(extract_idascript_blocks(*text));
+            }
+        }, text->size());
+        registry.add("strip_idascript_blocks/" + suffix, [text](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                do_not_optimize(strip_idascript_blocks(*text));
+            }
+        }, text->size());
+    }
+}
+
+void register_request_json(Registry& registry) {
+    for (int turns : {10, 50, 200}) {
+        auto request = std::make_shared<CreateMessageRequest>(make_request(turns));
+        nlohmann::json sample;
+        to_json(sample, *request);
+        
+        // Same path as ClaudeClient: to_json, then dump
+        registry.add("request_to_json/turns_" + std::to_string(turns), [request](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                nlohmann::json j;
+                to_json(j, *request);
+                do_not_optimize(j.dump());
+            }
+        }, sample.dump().size());
+    }
+}
+
+void register_history(Registry& registry) {
+    auto scratch = std::make_shared<ScratchConfigDir>();
+    
+    registry.add("history/append", [scratch](std::uint64_t n) {
+        MessageHistory history("/bench/append.bin");
+        (void)history.start_new_session();
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(history.append_user_message(PROSE));
+        }
+    });
+    
+    // 200 rounds = 601 lines, about 500 KB of JSONL
+    auto loaded = std::make_shared<MessageHistory>("/bench/load.bin");
+    fill_session(*loaded, 200);
+    auto session_id = loaded->get_current_session_id();
+    registry.add("history/load_session", [scratch, loaded, session_id](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(loaded->load_session(session_id));
+        }
+    });
+    
+    auto listed = std::make_shared<MessageHistory>("/bench/list.bin");
+    for (int s = 0; s < 50; ++s) {
+        fill_session(*listed, 10);
+    }
+    registry.add("history/list_sessions_50", [scratch, listed](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(listed->list_sessions());
+        }
+    });
+}
+
+void register_utilities(Registry& registry) {
+    auto path = std::make_shared<std::string>(
+        "/home/analyst/samples/2024/campaign-x/unpacked/stage2_payload_decrypted.dll");
+    registry.add("base64_url_encode/path", [path](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(base64_url_encode(*path));
+        }
+    }, path->size());
+    
+    registry.add("generate_uuid", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(generate_uuid());
+        }
+    });
+    
+    // Decompiler output is dense in <, > and &
+    auto code = std::make_shared<std::string>();
+    while (code->size() < 16 * 1024) {
+        *code += "if ( (v3 & 0xFF) < a2 && *(_DWORD *)(a1 + 8) > 0 ) v4 = \"<unk>\";\n";
+    }
+    registry.add("html_escape/16k", [code](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(html_escape(*code));
+        }
+    }, code->size());
+}
+
+void register_logging(Registry& registry) {
+    // The cost every filtered-out IDA_CHAT_DEBUG pays on the hot paths
+    registry.add("log/disabled", [](std::uint64_t n) {
+        set_log_level(LogLevel::Warning);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            IDA_CHAT_LOG(LogLevel::Debug, "core", "turn %llu", static_cast<unsigned long long>(i));
+        }
+    });
+    
+    // Format and queue only; delivery happens on the logging thread
+    registry.add("log/enqueue", [](std::uint64_t n) {
+        set_log_sink([](const LogRecord&) {}, LogLevel::Off);
+        set_log_level(LogLevel::Debug);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            IDA_CHAT_LOG(LogLevel::Debug, "core", "turn %llu", static_cast<unsigned long long>(i));
+            if ((i & 1023) == 1023) flush_log();
+        }
+        flush_log();
+        set_log_level(LogLevel::Warning);
+        set_log_sink(nullptr);
+    });
+}
+
+void register_thread_pool(Registry& registry) {
+    // Submit-to-completion overhead per task, the floor for any offloaded job
+    registry.add("pool/submit_wait", [](std::uint64_t n) {
+        auto& pool = ThreadPool::instance();
+        for (std::uint64_t i = 0; i < n; ++i) {
+            pool.submit([]() {}, TaskPriority::Interactive);
+        }
+        pool.wait_idle();
+    });
+    
+    // Interactive tasks queued behind a saturating background load
+    registry.add("pool/interactive_under_load", [](std::uint64_t n) {
+        auto& pool = ThreadPool::instance();
+        auto token = CancelToken::create();
+        for (std::size_t i = 0; i < pool.thread_count() * 4; ++i) {
+            pool.submit([token]() {
+                while (!token.cancelled()) std::this_thread::yield();
+            }, TaskPriority::Background, token);
+        }
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::atomic<bool> done{false};
+            pool.submit([&done]() { done.store(true, std::memory_order_release); },
+                        TaskPriority::Interactive);
+            while (!done.load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+        token.cancel();
+        pool.wait_idle();
+    });
+}
+
+void register_script_scheduler(Registry& registry) {
+    // Admission overhead added to every script, without contention
+    registry.add("script_scheduler/uncontended", [](std::uint64_t n) {
+        ScriptScheduler scheduler;
+        ScriptExecutorFn executor = [](const std::string&) { return ScriptResult::success_result({}); };
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(scheduler.run("pass", executor, "bench"));
+        }
+    });
+}
+
+} // anonymous namespace
+
+void register_engine_benchmarks(Registry& registry) {
+    register_parser(registry);
+    register_script_blocks(registry);
+    register_request_json(registry);
+    register_history(registry);
+    register_utilities(registry);
+    register_logging(registry);
+    register_thread_pool(registry);
+    register_script_scheduler(registry);
+}
+
+} // namespace ida_chat::bench
@@ -0,0 +1,264 @@
+/**
+ * @file bench_main.cpp
+ * @brief Benchmark runner: calibration, sampling, JSON output and baseline diff.
+ *
+ * Usage:
+ *   ida_chat_bench [--filter SUBSTR] [--min-time SEC] [--samples N]
+ *                  [--json FILE] [--compare BASELINE.json] [--max-regression PCT]
+ *
+ * The JSON file records the version, compiler and per-benchmark timings.
+ * Keep one per release and pass it to --compare to spot regressions; with
+ * --max-regression the exit code is 1 when any median got slower than that.
+ */
+
+#include "bench.hpp"
+
+#include <ida_chat/common/json.hpp>
+#include <ida_chat/core/types.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <numeric>
+#include <optional>
+
+namespace ida_chat::bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string filter;
+    double min_time = 0.5;      ///< Seconds per benchmark, split across samples
+    int samples = 10;
+    std::string json_path;
+    std::string compare_path;
+    double max_regression = -1.0;   ///< Percent; negative = report only
+    bool list = false;
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;   ///< Per sample
+    std::uint64_t bytes_per_op = 0;
+    double min_ns = 0.0;
+    double median_ns = 0.0;
+    double mean_ns = 0.0;
+    double max_ns = 0.0;
+    
+    [[nodiscard]] double mb_per_sec() const {
+        return bytes_per_op && median_ns > 0.0
+            ? static_cast<double>(bytes_per_op) / median_ns * 1e9 / (1024.0 * 1024.0)
+            : 0.0;
+    }
+};
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Iterations per sample so that one sample takes about `target` seconds
+std::uint64_t calibrate(const Benchmark& benchmark, double target) {
+    std::uint64_t n = 1;
+    for (;;) {
+        auto start = Clock::now();
+        benchmark.run(n);
+        double elapsed = seconds_since(start);
+        if (elapsed >= target / 4 || n >= (std::uint64_t{1} << 32)) {
+            double per_op = elapsed / static_cast<double>(n);
+            return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(target / std::max(per_op, 1e-12)));
+        }
+        n *= elapsed > 0.0 ? std::clamp<std::uint64_t>(static_cast<std::uint64_t>(target / 4 / elapsed), 2, 100) : 100;
+    }
+}
+
+Result run_benchmark(const Benchmark& benchmark, const Options& opts) {
+    double sample_time = opts.min_time / opts.samples;
+    std::uint64_t n = calibrate(benchmark, sample_time);
+    
+    std::vector<double> per_op;
+    per_op.reserve(static_cast<std::size_t>(opts.samples));
+    for (int s = 0; s < opts.samples; ++s) {
+        auto start = Clock::now();
+        benchmark.run(n);
+        per_op.push_back(seconds_since(start) * 1e9 / static_cast<double>(n));
+    }
+    std::sort(per_op.begin(), per_op.end());
+    
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = n;
+    result.bytes_per_op = benchmark.bytes_per_op;
+    result.min_ns = per_op.front();
+    result.max_ns = per_op.back();
+    result.median_ns = per_op[per_op.size() / 2];
+    result.mean_ns = std::accumulate(per_op.begin(), per_op.end(), 0.0) / static_cast<double>(per_op.size());
+    return result;
+}
+
+std::string format_ns(double ns) {
+    char buf[32];
+    if (ns >= 1e9)      std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+    else if (ns >= 1e6) std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+    else if (ns >= 1e3) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+    else                std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+    return buf;
+}
+
+std::string compiler_id() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+nlohmann::json results_to_json(const std::vector<Result>& results, const Options& opts) {
+    auto benchmarks = nlohmann::json::array();
+    for (const auto& r : results) {
+        nlohmann::json entry = {
+            {"name", r.name},
+            {"iterations", r.iterations},
+            {"samples", opts.samples},
+            {"min_ns", r.min_ns},
+            {"median_ns", r.median_ns},
+            {"mean_ns", r.mean_ns},
+            {"max_ns", r.max_ns}
+        };
+        if (r.bytes_per_op) {
+            entry["bytes_per_op"] = r.bytes_per_op;
+            entry["mb_per_sec"] = r.mb_per_sec();
+        }
+        benchmarks.push_back(std::move(entry));
+    }
+    return {
+        {"format", 1},
+        {"version", IDA_CHAT_VERSION},
+        {"compiler", compiler_id()},
+#ifdef NDEBUG
+        {"optimized", true},
+#else
+        {"optimized", false},
+#endif
+        {"timestamp", std::time(nullptr)},
+        {"benchmarks", std::move(benchmarks)}
+    };
+}
+
+/// Name -> median_ns from a file written by --json
+std::map<std::string, double> load_baseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    auto content = read_file(path);
+    if (!content) return baseline;
+    
+    auto j = nlohmann::json::parse(*content, nullptr, false);
+    if (j.is_discarded() || !j.contains("benchmarks")) return baseline;
+    for (const auto& entry : j["benchmarks"]) {
+        baseline[entry.value("name", "")] = entry.value("median_ns", 0.0);
+    }
+    return baseline;
+}
+
+std::optional<int> parse_args(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        
+        if (arg == "--list") {
+            opts.list = true;
+        } else if (arg == "--filter" && has_value) {
+            opts.filter = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            opts.min_time = std::max(0.01, std::atof(argv[++i]));
+        } else if (arg == "--samples" && has_value) {
+            opts.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && has_value) {
+            opts.json_path = argv[++i];
+        } else if (arg == "--compare" && has_value) {
+            opts.compare_path = argv[++i];
+        } else if (arg == "--max-regression" && has_value) {
+            opts.max_regression = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr,
+                "Usage: %s [--list] [--filter SUBSTR] [--min-time SEC] [--samples N]\n"
+                "          [--json FILE] [--compare BASELINE.json] [--max-regression PCT]\n",
+                argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+int run(int argc, char** argv) {
+    Options opts;
+    if (auto code = parse_args(argc, argv, opts)) {
+        return *code;
+    }
+    
+    Registry registry;
+    register_engine_benchmarks(registry);
+#ifdef IDA_CHAT_BENCH_QT
+    register_widget_benchmarks(registry);   // First: creates the QApplication
+    register_markdown_benchmarks(registry);
+#endif
+
+    std::map<std::string, double> baseline;
+    if (!opts.compare_path.empty()) {
+        baseline = load_baseline(opts.compare_path);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "error: no benchmarks in %s\n", opts.compare_path.c_str());
+            return 2;
+        }
+    }
+    
+    std::vector<Result> results;
+    bool regressed = false;
+    for (const auto& benchmark : registry.benchmarks()) {
+        if (!opts.filter.empty() && benchmark.name.find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        if (opts.list) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        
+        Result r = run_benchmark(benchmark, opts);
+        std::printf("%-36s %12s  (min %s, max %s)", r.name.c_str(), format_ns(r.median_ns).c_str(),
+                    format_ns(r.min_ns).c_str(), format_ns(r.max_ns).c_str());
+        if (r.bytes_per_op) {
+            std::printf("  %8.1f MB/s", r.mb_per_sec());
+        }
+        if (auto it = baseline.find(r.name); it != baseline.end() && it->second > 0.0) {
+            double change = (r.median_ns / it->second - 1.0) * 100.0;
+            bool over = opts.max_regression >= 0.0 && change > opts.max_regression;
+            regressed |= over;
+            std::printf("  %+6.1f%%%s", change, over ? " REGRESSION" : "");
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+        results.push_back(std::move(r));
+    }
+    
+    if (!opts.json_path.empty() && !opts.list &&
+        !write_file(opts.json_path, results_to_json(results, opts).dump(2))) {
+        std::fprintf(stderr, "error: could not write %s\n", opts.json_path.c_str());
+        return 1;
+    }
+    return regressed ? 1 : 0;
+}
+
+} // namespace ida_chat::bench
+
+int main(int argc, char** argv) {
+    return ida_chat::bench::run(argc, argv);
+}
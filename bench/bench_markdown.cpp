@@ -0,0 +1,74 @@
+/**
+ * @file bench_markdown.cpp
+ * @brief MarkdownRenderer benchmarks (built only when Qt is available).
+ */
+
+#include "bench.hpp"
+
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/ui/markdown_renderer.hpp>
+
+#include <QCoreApplication>
+
+#include <memory>
+
+namespace ida_chat::bench {
+
+namespace {
+
+/// A typical analysis answer: headings, lists, inline code and a code block
+const char* const RESPONSE =
+    "## Summary\n"
+    "\n"
+    "`sub_401000` is the **API resolver**. It walks the PEB loader list and hashes\n"
+    "each export name with ROR13, then compares against the constant in `ecx`.\n"
+    "\n"
+    "### Resolved imports\n"
+    "\n"
+    "- `LoadLibraryA` (hash `0x0726774C`)\n"
+    "- `GetProcAddress` (hash `0x7802F749`)\n"
+    "- `VirtualAlloc` (hash `0xE553A458`)\n"
+    "\n"
+    "The decrypted stage is copied with a *rolling XOR* key:\n"
+    "\n"
+    "```c\n"
+    "for ( i = 0; i < len; ++i )\n"
+    "  dst[i] = src[i] ^ key[i % 16];\n"
+    "```\n"
+    "\n"
+    "1. Rename `sub_401000` to `resolve_api`\n"
+    "2. Apply the `IMAGE_EXPORT_DIRECTORY` type at `0x40103A`\n"
+    "\n";
+
+} // anonymous namespace
+
+void register_markdown_benchmarks(Registry& registry) {
+    // The highlighter's thread pool wants an application object
+    if (!QCoreApplication::instance()) {
+        static int argc = 1;
+        static char name[] = "ida_chat_bench";
+        static char* argv[] = {name, nullptr};
+        static QCoreApplication app(argc, argv);
+    }
+    
+    auto renderer = std::make_shared<MarkdownRenderer>(ColorScheme::dark_default());
+    
+    auto response = std::make_shared<QString>(QString::fromUtf8(RESPONSE));
+    registry.add("markdown_render/response", [renderer, response](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(renderer->render(*response));
+        }
+    }, static_cast<std::uint64_t>(response->toUtf8().size()));
+    
+    // A long, code-heavy document (the bundled usage guide)
+    if (auto usage = read_file(IDA_CHAT_BENCH_DATA_DIR "/USAGE.md")) {
+        auto document = std::make_shared<QString>(QString::fromStdString(*usage));
+        registry.add("markdown_render/usage_md", [renderer, document](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                do_not_optimize(renderer->render(*document));
+            }
+        }, usage->size());
+    }
+}
+
+} // namespace ida_chat::bench
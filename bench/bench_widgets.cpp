@@ -0,0 +1,91 @@
+/**
+ * @file bench_widgets.cpp
+ * @brief Chat widget creation benchmarks (built only when Qt is available).
+ *
+ * Measures construction plus style polish under the compiled theme sheet,
+ * which is where per-widget setStyleSheet calls used to cost the most.
+ */
+
+#include "bench.hpp"
+
+#include <ida_chat/ui/cursor_chat_view.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+
+#include <QApplication>
+
+#include <memory>
+
+namespace ida_chat::bench {
+
+namespace {
+
+const char* const ANSWER =
+    "`sub_401000` is the **API resolver**. It walks the PEB loader list and hashes\n"
+    "each export name with ROR13, then compares against the constant in `ecx`.\n"
+    "\n"
+    "- `LoadLibraryA` (hash `0x0726774C`)\n"
+    "- `GetProcAddress` (hash `0x7802F749`)\n";
+
+const char* const SCRIPT =
+    "import idautils\n"
+    "for ea in idautils.Functions():\n"
+    "    print(hex(ea), idc.get_func_name(ea))\n";
+
+/// Let finished highlight jobs land so later iterations hit the cache
+void drain_events() {
+    QCoreApplication::processEvents();
+}
+
+} // anonymous namespace
+
+void register_widget_benchmarks(Registry& registry) {
+    // Widgets need a QApplication; run headless unless a platform was chosen.
+    // Must run before register_markdown_benchmarks, which would otherwise
+    // create a plain QCoreApplication.
+    if (!QCoreApplication::instance()) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        static int argc = 1;
+        static char name[] = "ida_chat_bench";
+        static char* argv[] = {name, nullptr};
+        static QApplication app(argc, argv);
+    }
+    if (!qobject_cast<QApplication*>(QCoreApplication::instance())) return;
+
+    // One themed root, as in the dock; every iteration builds under it
+    static QWidget root;
+    apply_cursor_stylesheet(&root);
+
+    auto answer = std::make_shared<QString>(QString::fromUtf8(ANSWER));
+    auto script = std::make_shared<QString>(QString::fromUtf8(SCRIPT));
+    registry.add("widget_create/turn", [answer, script](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto* user = new UserMessageWidget(QStringLiteral("What does sub_401000 do?"), &root);
+            auto* response = new AssistantResponseWidget(&root);
+            response->add_tool_action(ToolActionType::Read, QStringLiteral("sub_401000"));
+            response->add_text(*answer);
+            response->add_code_block(*script, QStringLiteral("python"));
+            response->add_output(QStringLiteral("0x401000 sub_401000\n0x401080 sub_401080"));
+            response->add_summary({QStringLiteral("Renamed 2 functions")});
+            user->ensurePolished();
+            response->ensurePolished();
+            delete user;
+            delete response;
+            drain_events();
+        }
+    });
+
+    // Large code goes to the plain-text view instead of a rich-text label
+    auto large = std::make_shared<QString>(script->repeated(400));
+    registry.add("widget_create/code_large", [large](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto* block = new CodeBlockWidget(*large, QStringLiteral("python"), &root);
+            block->ensurePolished();
+            delete block;
+            drain_events();
+        }
+    }, static_cast<std::uint64_t>(large->size()));
+}
+
+} // namespace ida_chat::bench
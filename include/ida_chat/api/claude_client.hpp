@@ -20,6 +20,16 @@ namespace ida_chat {
  */
 using StreamEventCallback = std::function<void(const StreamEvent& event)>;
 
+/**
+ * @brief Performs the HTTP round trip of a streaming request.
+ *
+ * Receives the client's configured HttpClient, the serialized request body
+ * and the chunk sink. Session recording wraps the real request; replay
+ * ignores the HttpClient and feeds recorded chunks instead.
+ */
+using StreamTransport = std::function<HttpResponse(
+    HttpClient& http, const std::string& body, const StreamCallback& on_chunk)>;
+
 /**
  * @brief Claude API client.
  * 
@@ -65,6 +75,11 @@ public:
         const CreateMessageRequest& request,
         StreamEventCallback callback);
     
+    /**
+     * @brief Route streaming requests through a transport (empty = HTTP).
+     */
+    void set_stream_transport(StreamTransport transport);
+    
     /**
      * @brief Cancel any ongoing request.
      */
@@ -90,6 +105,11 @@ public:
      */
     [[nodiscard]] TokenUsage get_total_usage() const;
     
+    /**
+     * @brief Get accumulated request body bytes sent.
+     */
+    [[nodiscard]] std::size_t get_bytes_sent() const;
+    
     /**
      * @brief Reset token usage counter.
      */
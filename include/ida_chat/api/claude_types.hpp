@@ -26,6 +26,7 @@ namespace ida_chat {
  */
 struct TextContent {
     std::string text;
+    bool cache = false;     ///< Mark as a prompt-cache breakpoint (cache_control)
     
     static constexpr const char* type() { return "text"; }
 };
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <ida_chat/core/thread_pool.hpp>
+
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <functional>
@@ -118,11 +121,38 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+/**
+ * @brief Outcome of run_cli_command().
+ */
+struct CLICommandResult {
+    bool started = false;       ///< False if the process could not be spawned
+    bool cancelled = false;     ///< The token fired and the process was killed
+    int status = -1;            ///< Exit status, when it ran to completion
+    std::string output;         ///< Everything the command wrote to stdout
+};
+
+/**
+ * @brief Run a shell command, killing it when a token is cancelled.
+ *
+ * Cancellable replacement for popen(). The command runs in its own process
+ * group, which gets SIGTERM (then SIGKILL) on cancellation, so the CLI and
+ * anything it started exit instead of holding the calling worker.
+ *
+ * @param command Passed to /bin/sh -c
+ * @param cancel Polled while waiting for output
+ * @param on_output Called with each chunk read, on the calling thread
+ */
+CLICommandResult run_cli_command(const std::string& command,
+                                 const CancelToken& cancel,
+                                 const std::function<void(std::string_view chunk)>& on_output = {});
+
 /**
  * @brief Test connection to Claude via CLI.
  * @param cli_path Path to CLI (empty for auto-detect)
+ * @param cancel Kills the CLI if cancelled before it replies
  * @return (success, message) pair
  */
-std::pair<bool, std::string> test_cli_connection(const std::string& cli_path = "");
+std::pair<bool, std::string> test_cli_connection(const std::string& cli_path = "",
+                                                 const CancelToken& cancel = {});
 
 } // namespace ida_chat
@@ -81,3 +81,10 @@
     #define IDA_CHAT_LIKELY(x)   (x)
     #define IDA_CHAT_UNLIKELY(x) (x)
 #endif
+
+// printf-style format checking
+#ifdef __GNUC__
+    #define IDA_CHAT_PRINTF(fmt_index, args_index) __attribute__((format(printf, fmt_index, args_index)))
+#else
+    #define IDA_CHAT_PRINTF(fmt_index, args_index)
+#endif
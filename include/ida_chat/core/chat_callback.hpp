@@ -6,6 +6,7 @@
 #pragma once
 
 #include <ida_chat/core/types.hpp>
+#include <ida_chat/core/metrics.hpp>
 
 #include <string>
 #include <optional>
@@ -40,6 +41,12 @@ public:
      */
     virtual void on_thinking_done() = 0;
     
+    /**
+     * @brief Called with extended-thinking text as it streams in.
+     * @param text The next piece of thinking text
+     */
+    virtual void on_thinking_text(const std::string& text) = 0;
+    
     /**
      * @brief Called when the agent uses a tool.
      * @param tool_name Name of the tool being used
@@ -77,6 +84,12 @@ public:
      * @param cost Estimated cost in USD (optional)
      */
     virtual void on_result(int num_turns, std::optional<double> cost) = 0;
+    
+    /**
+     * @brief Called after each request with session and lifetime metrics.
+     * @param snapshot Counters, gauges and latency percentiles
+     */
+    virtual void on_metrics(const MetricsSnapshot& snapshot) = 0;
 };
 
 /**
@@ -87,12 +100,14 @@ public:
     void on_turn_start(int, int) override {}
     void on_thinking() override {}
     void on_thinking_done() override {}
+    void on_thinking_text(const std::string&) override {}
     void on_tool_use(const std::string&, const std::string&) override {}
     void on_text(const std::string&) override {}
     void on_script_code(const std::string&) override {}
     void on_script_output(const std::string&) override {}
     void on_error(const std::string&) override {}
     void on_result(int, std::optional<double>) override {}
+    void on_metrics(const MetricsSnapshot&) override {}
 };
 
 /**
@@ -103,28 +118,34 @@ public:
     void on_turn_start(int turn, int max_turns) override;
     void on_thinking() override;
     void on_thinking_done() override;
+    void on_thinking_text(const std::string& text) override;
     void on_tool_use(const std::string& tool_name, const std::string& details) override;
     void on_text(const std::string& text) override;
     void on_script_code(const std::string& code) override;
     void on_script_output(const std::string& output) override;
     void on_error(const std::string& error) override;
     void on_result(int num_turns, std::optional<double> cost) override;
+    void on_metrics(const MetricsSnapshot& snapshot) override;
     
     // Access collected data
     [[nodiscard]] const std::string& get_text() const { return text_; }
+    [[nodiscard]] const std::string& get_thinking() const { return thinking_; }
     [[nodiscard]] const std::string& get_errors() const { return errors_; }
     [[nodiscard]] const std::string& get_script_outputs() const { return script_outputs_; }
     [[nodiscard]] int get_turns() const { return turns_; }
     [[nodiscard]] std::optional<double> get_cost() const { return cost_; }
+    [[nodiscard]] const MetricsSnapshot& get_metrics() const { return metrics_; }
     
     void clear();
 
 private:
     std::string text_;
+    std::string thinking_;
     std::string errors_;
     std::string script_outputs_;
     int turns_ = 0;
     std::optional<double> cost_;
+    MetricsSnapshot metrics_;
 };
 
 } // namespace ida_chat
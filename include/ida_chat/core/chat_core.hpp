@@ -11,6 +11,7 @@
 #include <ida_chat/core/fwd.hpp>
 #include <ida_chat/core/types.hpp>
 #include <ida_chat/core/chat_callback.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 #include <ida_chat/api/claude_client.hpp>
 #include <ida_chat/api/claude_types.hpp>
 #include <ida_chat/history/message_history.hpp>
@@ -20,6 +21,7 @@
 #include <memory>
 #include <functional>
 #include <atomic>
+#include <chrono>
 #include <optional>
 
 namespace ida_chat {
@@ -33,6 +35,14 @@ struct ChatCoreOptions {
     std::string model = "claude-sonnet-4-20250514";  ///< Model to use
     bool enable_thinking = false;            ///< Enable extended thinking
     int thinking_budget = 10000;             ///< Thinking token budget
+    std::string metrics_path;                ///< Lifetime metrics file ("" = keep in memory)
+    
+    /// Capture inputs, responses and script results of the session (API mode only)
+    std::shared_ptr<SessionRecorder> recorder;
+    
+    /// Answer requests and scripts from a recording instead of the network and
+    /// the executor. EngineClock runs in manual mode while this core exists.
+    std::shared_ptr<SessionReplay> replay;
 };
 
 /**
@@ -102,10 +112,17 @@ public:
      * 3. Feed results back to Claude
      * 4. Repeat until no more scripts or max_turns reached
      * 
+     * Attachments are sent as separate text blocks ahead of the prompt. The
+     * last one is marked as a cache breakpoint so later turns reuse it. In
+     * CLI mode, which takes the prompt on the command line, they are passed
+     * as blob file paths for the agent to read instead.
+     * 
      * @param user_input The user's message
+     * @param attachments Large pasted content stored in the blob store
      * @return Processing result
      */
-    [[nodiscard]] ProcessResult process_message(const std::string& user_input);
+    [[nodiscard]] ProcessResult process_message(const std::string& user_input,
+                                                const std::vector<Attachment>& attachments = {});
     
     /**
      * @brief Request cancellation of the current operation.
@@ -127,6 +144,27 @@ public:
      */
     [[nodiscard]] TokenUsage get_total_usage() const;
     
+    /**
+     * @brief Latency histograms and counters for this session and all sessions.
+     *
+     * The session part is folded into options.metrics_path when a new session
+     * starts and when the core is destroyed. The same snapshot is passed to
+     * ChatCallback::on_metrics() after every request.
+     */
+    [[nodiscard]] MetricsSnapshot get_metrics() const;
+    
+    /**
+     * @brief Live metrics for the request being processed.
+     *
+     * Safe to read from any thread while process_message() runs.
+     */
+    [[nodiscard]] std::shared_ptr<TurnMetricsRecorder> turn_metrics() const;
+    
+    /**
+     * @brief Report into a caller-owned recorder (e.g. one the UI polls).
+     */
+    void set_turn_metrics(std::shared_ptr<TurnMetricsRecorder> recorder);
+    
     /**
      * @brief Set the system prompt.
      */
@@ -155,6 +193,9 @@ public:
     [[nodiscard]] int get_message_count() const;
 
 private:
+    [[nodiscard]] ProcessResult run_message(const std::string& user_input,
+                                            const std::vector<Attachment>& attachments);
+    
     struct Impl;
     std::unique_ptr<Impl> impl_;
 };
@@ -172,9 +213,45 @@ private:
 /**
  * @brief Test connection to Claude API.
  * @param credentials Credentials to test
+ * @param cancel Kills the CLI child of a System-auth test when cancelled
  * @return pair of (success, message)
  */
 [[nodiscard]] std::pair<bool, std::string> test_claude_connection(
-    const AuthCredentials& credentials = {});
+    const AuthCredentials& credentials = {},
+    const CancelToken& cancel = {});
+
+/**
+ * @brief Outcome of a (possibly cached) connection test.
+ */
+struct ConnectionTestResult {
+    bool success = false;
+    std::string message;
+    std::string auth_path;          ///< How we authenticated ("Claude CLI", "API key", ...)
+    double latency_ms = 0.0;        ///< Round trip of the original test
+    bool cached = false;            ///< Served from the cache
+};
+
+/// Successful tests are reused for this long
+constexpr std::chrono::seconds CONNECTION_TEST_TTL{300};
+
+/**
+ * @brief Test the connection, reusing a recent successful result.
+ *
+ * Results are keyed by auth type and a hash of the key (the key itself is
+ * not retained). Failures are never cached. Blocking; call from a worker.
+ *
+ * @param credentials Credentials to test
+ * @param force Skip the cache and always do the full round trip
+ * @param cancel Abandons the test (killing a CLI child) when cancelled
+ */
+[[nodiscard]] ConnectionTestResult test_claude_connection_cached(
+    const AuthCredentials& credentials = {},
+    bool force = false,
+    const CancelToken& cancel = {});
+
+/**
+ * @brief Drop all cached connection test results.
+ */
+void clear_connection_test_cache();
 
 } // namespace ida_chat
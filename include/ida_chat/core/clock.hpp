@@ -0,0 +1,79 @@
+/**
+ * @file clock.hpp
+ * @brief Engine clock with a manual mode for deterministic replay.
+ *
+ * Latency metrics (TTFT, tokens/sec, turn latency) read EngineClock instead of
+ * steady_clock directly. Session replay switches it to manual mode and moves
+ * it to the recorded timestamps, so replayed metrics match the recording
+ * regardless of how fast the replay runs. Tracing spans keep using the real
+ * clock: they profile this process, not the recorded one.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace ida_chat {
+
+/**
+ * @brief steady_clock, or a manually advanced clock while replaying.
+ *
+ * Satisfies the standard Clock requirements. Manual mode is process-wide.
+ */
+class EngineClock {
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+    static constexpr bool is_steady = true;
+    
+    [[nodiscard]] static time_point now() noexcept {
+        if (manual_.load(std::memory_order_acquire)) {
+            return time_point(duration(manual_ticks_.load(std::memory_order_acquire)));
+        }
+        return std::chrono::steady_clock::now();
+    }
+    
+    /**
+     * @brief Enter or leave manual mode. Manual time starts at the real now().
+     */
+    static void set_manual(bool manual) noexcept {
+        if (manual) {
+            manual_ticks_.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                std::memory_order_release);
+        }
+        manual_.store(manual, std::memory_order_release);
+    }
+    
+    [[nodiscard]] static bool is_manual() noexcept {
+        return manual_.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Move manual time forward (no-op in real mode or for negative d).
+     */
+    static void advance(duration d) noexcept {
+        if (d.count() > 0) {
+            manual_ticks_.fetch_add(d.count(), std::memory_order_acq_rel);
+        }
+    }
+    
+    /**
+     * @brief Move manual time to t, never backwards.
+     */
+    static void advance_to(time_point t) noexcept {
+        rep target = t.time_since_epoch().count();
+        rep current = manual_ticks_.load(std::memory_order_acquire);
+        while (current < target &&
+               !manual_ticks_.compare_exchange_weak(current, target, std::memory_order_acq_rel)) {
+        }
+    }
+
+private:
+    static inline std::atomic<bool> manual_{false};
+    static inline std::atomic<rep> manual_ticks_{0};
+};
+
+} // namespace ida_chat
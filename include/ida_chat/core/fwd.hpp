@@ -14,6 +14,9 @@ namespace ida_chat {
 class Config;
 class ScriptExecutor;
 class ChatCore;
+class TurnMetricsRecorder;
+class SessionRecorder;
+class SessionReplay;
 
 // Chat callback interface
 class ChatCallback;
@@ -46,6 +49,7 @@ class IDAChatForm;
 class AgentWorker;
 class AgentSignals;
 class MarkdownRenderer;
+class ScrollController;
 
 // Smart pointer aliases
 using ConfigPtr = std::shared_ptr<Config>;
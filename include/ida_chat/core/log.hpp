@@ -0,0 +1,139 @@
+/**
+ * @file log.hpp
+ * @brief Asynchronous leveled engine logging with per-module filters.
+ *
+ * The engine (api, core, history) does not depend on IDA, so it cannot call
+ * msg() directly. Messages go to process-wide sinks instead: the plugin
+ * installs a console sink that writes to IDA's output window, the headless
+ * CLI one that writes to stderr, and either can add a rotating log file.
+ *
+ * Callers only format the message and push it onto a bounded lock-free
+ * queue; a background thread delivers it to the sinks, so a slow output
+ * window never stalls a worker or the GUI thread. Use IDA_CHAT_LOG: a
+ * statement filtered out by level or module costs one atomic load and its
+ * arguments are not evaluated.
+ */
+
+#pragma once
+
+#include <ida_chat/common/platform.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace ida_chat {
+
+enum class LogLevel : std::uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off         ///< Filter/threshold only: nothing passes
+};
+
+[[nodiscard]] const char* log_level_str(LogLevel level) noexcept;
+
+/**
+ * @brief One delivered message.
+ */
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    const char* module = "";    ///< String literal passed to IDA_CHAT_LOG
+    std::chrono::system_clock::time_point time;
+    std::string message;        ///< No trailing newline
+};
+
+/// Receives records on the logging thread, in submission order per thread
+using LogSink = std::function<void(const LogRecord& record)>;
+
+/**
+ * @brief Replace the console sink and its threshold.
+ *
+ * An empty sink restores the default (stderr). By default only warnings and
+ * errors reach the console; the file sink gets everything that passes the
+ * filter.
+ */
+void set_log_sink(LogSink sink, LogLevel min_level = LogLevel::Warning);
+
+/**
+ * @brief Also write records to a file, rotated at max_bytes.
+ *
+ * Rotation renames path to path.1, path.1 to path.2 and so on, keeping
+ * keep_files old files. An empty path closes the file sink.
+ * @return false if the file cannot be opened
+ */
+bool set_log_file(const std::string& path,
+                  std::uint64_t max_bytes = 4 * 1024 * 1024,
+                  int keep_files = 3);
+
+/**
+ * @brief Set the level for every module (clears per-module overrides).
+ */
+void set_log_level(LogLevel level) noexcept;
+
+/**
+ * @brief Parse and apply a filter such as "info,core=debug,api=warning".
+ *
+ * Bare levels set the default; module=level entries override it. Levels are
+ * debug, info, warning, error and off.
+ * @return false (filter unchanged) if the spec is malformed
+ */
+bool set_log_filter(std::string_view spec);
+
+namespace detail {
+
+/// Lowest level any module accepts; kept in sync by the filter setters
+inline std::atomic<LogLevel> log_floor{LogLevel::Info};
+
+[[nodiscard]] bool log_module_enabled(LogLevel level, const char* module) noexcept;
+
+} // namespace detail
+
+/**
+ * @brief Whether a statement at this level and module would be logged.
+ *
+ * Inline so that statements below every module's level stop at one relaxed load.
+ */
+[[nodiscard]] inline bool log_enabled(LogLevel level, const char* module) noexcept {
+    return level >= detail::log_floor.load(std::memory_order_relaxed)
+        && detail::log_module_enabled(level, module);
+}
+
+/**
+ * @brief Format and queue a message. Prefer IDA_CHAT_LOG, which checks the filter first.
+ * @param module String literal naming the subsystem ("core", "api", "ui", ...)
+ */
+void log_message(LogLevel level, const char* module, const char* fmt, ...) IDA_CHAT_PRINTF(3, 4);
+
+/**
+ * @brief Block until everything queued so far has reached the sinks.
+ */
+void flush_log();
+
+/**
+ * @brief Drain the queue and stop the logging thread.
+ *
+ * The plugin calls it whenever a database closes, so no record is still
+ * being delivered to its sink when the module may be unloaded. The next
+ * message starts the thread again.
+ */
+void shutdown_log();
+
+/**
+ * @brief Messages dropped because the queue was full.
+ */
+[[nodiscard]] std::uint64_t log_dropped_count() noexcept;
+
+} // namespace ida_chat
+
+/// Log unless filtered out; the arguments are only evaluated when enabled
+#define IDA_CHAT_LOG(level, module, ...)                                        \
+    do {                                                                        \
+        if (::ida_chat::log_enabled((level), (module))) {                       \
+            ::ida_chat::log_message((level), (module), __VA_ARGS__);            \
+        }                                                                       \
+    } while (0)
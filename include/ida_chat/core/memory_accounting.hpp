@@ -0,0 +1,155 @@
+/**
+ * @file memory_accounting.hpp
+ * @brief Per-subsystem byte accounting with soft budgets.
+ *
+ * The big consumers of memory in a long session are the conversation sent
+ * with every request, SSE parse buffers, the chat view's live widgets, the
+ * syntax highlighter's HTML cache and the search index. Each owner reports
+ * its current footprint here and reads its budget back: going over a soft
+ * budget makes the owner compact, evict or spill instead of failing.
+ *
+ * Byte counts are estimates of payload sizes (text, cached HTML, posting
+ * lists), not allocator-level measurements.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Accounted memory consumers.
+ */
+enum class MemorySubsystem : std::uint8_t {
+    Conversation,   ///< Messages resent with every request (ChatCore)
+    StreamBuffers,  ///< SSE line buffer and partial content (StreamingParser)
+    ChatWidgets,    ///< Live task widgets and their text (CursorChatView)
+    HighlightCache, ///< Highlighted code HTML (SyntaxHighlighter)
+    SearchIndex,    ///< Retained document text and posting lists
+    Count
+};
+
+/// "conversation", "stream_buffers", ... (settings and metric names)
+[[nodiscard]] const char* memory_subsystem_name(MemorySubsystem subsystem) noexcept;
+[[nodiscard]] std::optional<MemorySubsystem> memory_subsystem_from_name(std::string_view name) noexcept;
+
+using MemoryBudgets = std::vector<std::pair<MemorySubsystem, std::size_t>>;
+
+/**
+ * @brief Parse "conversation=8,search_index=0" (MB per subsystem, 0 = unlimited).
+ * @return Budgets in bytes, or nullopt (and *error set) if malformed
+ */
+[[nodiscard]] std::optional<MemoryBudgets> parse_memory_budgets(std::string_view spec,
+                                                                std::string* error = nullptr);
+
+/**
+ * @brief One subsystem's numbers at a point in time.
+ */
+struct MemoryUsage {
+    MemorySubsystem subsystem = MemorySubsystem::Conversation;
+    std::size_t bytes = 0;
+    std::size_t peak = 0;
+    std::size_t budget = 0;     ///< 0 = unlimited
+    
+    [[nodiscard]] bool over_budget() const noexcept { return budget != 0 && bytes > budget; }
+};
+
+/**
+ * @brief Process-wide byte counters and soft budgets.
+ *
+ * Counters are lock-free; owners on any thread update them as their
+ * footprint changes. Several instances of an owner (e.g. one parser per
+ * request) add up in the same counter.
+ */
+class MemoryAccountant {
+public:
+    static constexpr std::size_t SUBSYSTEM_COUNT = static_cast<std::size_t>(MemorySubsystem::Count);
+    
+    [[nodiscard]] static MemoryAccountant& instance();
+    
+    /**
+     * @brief Budget a subsystem starts with (0 = unlimited).
+     */
+    [[nodiscard]] static std::size_t default_budget(MemorySubsystem subsystem) noexcept;
+    
+    void add(MemorySubsystem subsystem, std::int64_t delta) noexcept;
+    
+    [[nodiscard]] std::size_t bytes(MemorySubsystem subsystem) const noexcept;
+    [[nodiscard]] std::size_t peak(MemorySubsystem subsystem) const noexcept;
+    [[nodiscard]] std::size_t total() const noexcept;
+    
+    /**
+     * @brief Change a soft budget (0 = unlimited). Owners pick it up on their next update.
+     */
+    void set_budget(MemorySubsystem subsystem, std::size_t bytes) noexcept;
+    void set_budgets(const MemoryBudgets& budgets) noexcept;
+    [[nodiscard]] std::size_t budget(MemorySubsystem subsystem) const noexcept;
+    [[nodiscard]] bool over_budget(MemorySubsystem subsystem) const noexcept;
+    
+    /**
+     * @brief All subsystems, in enum order.
+     */
+    [[nodiscard]] std::vector<MemoryUsage> usage() const;
+
+private:
+    MemoryAccountant();
+    
+    struct Counter {
+        std::atomic<std::int64_t> bytes{0};
+        std::atomic<std::int64_t> peak{0};
+        std::atomic<std::size_t> budget{0};
+    };
+    
+    std::array<Counter, SUBSYSTEM_COUNT> counters_;
+};
+
+/**
+ * @brief One owner's share of a subsystem counter.
+ *
+ * set() reports the owner's current footprint; the difference to the last
+ * report goes to the accountant. The share is removed on destruction.
+ * Not thread-safe; the owner serializes its own updates.
+ */
+class TrackedBytes {
+public:
+    explicit TrackedBytes(MemorySubsystem subsystem) noexcept : subsystem_(subsystem) {}
+    ~TrackedBytes() { set(0); }
+    
+    TrackedBytes(const TrackedBytes&) = delete;
+    TrackedBytes& operator=(const TrackedBytes&) = delete;
+    
+    void set(std::size_t bytes) noexcept {
+        if (bytes == bytes_) return;
+        MemoryAccountant::instance().add(subsystem_,
+            static_cast<std::int64_t>(bytes) - static_cast<std::int64_t>(bytes_));
+        bytes_ = bytes;
+    }
+    
+    [[nodiscard]] std::size_t get() const noexcept { return bytes_; }
+    
+    /**
+     * @brief Whether the whole subsystem (all owners) is over its budget.
+     */
+    [[nodiscard]] bool over_budget() const noexcept {
+        return MemoryAccountant::instance().over_budget(subsystem_);
+    }
+    
+    [[nodiscard]] std::size_t budget() const noexcept {
+        return MemoryAccountant::instance().budget(subsystem_);
+    }
+
+private:
+    MemorySubsystem subsystem_;
+    std::size_t bytes_ = 0;
+};
+
+} // namespace ida_chat
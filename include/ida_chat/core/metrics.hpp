@@ -0,0 +1,192 @@
+/**
+ * @file metrics.hpp
+ * @brief Counters, gauges and latency histograms for session and lifetime stats.
+ */
+
+#pragma once
+
+#include <ida_chat/common/json.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Metric names recorded by ChatCore.
+ */
+namespace metric_names {
+    // Histograms
+    constexpr const char* TTFT_MS = "ttft_ms";
+    constexpr const char* TOKENS_PER_SEC = "tokens_per_sec";
+    constexpr const char* TURN_LATENCY_MS = "turn_latency_ms";
+    constexpr const char* SCRIPT_MS = "script_ms";
+    constexpr const char* SCRIPT_QUEUE_MS = "script_queue_ms";
+    constexpr const char* SCRIPT_SCHEDULE_MS = "script_schedule_ms";
+    constexpr const char* CACHE_HIT_RATIO = "cache_hit_ratio";
+    constexpr const char* STALL_MS = "stall_ms";
+    
+    // Counters
+    constexpr const char* REQUESTS = "requests";
+    constexpr const char* TURNS = "turns";
+    constexpr const char* SCRIPTS = "scripts";
+    constexpr const char* SCRIPT_ERRORS = "script_errors";
+    constexpr const char* API_ERRORS = "api_errors";
+    constexpr const char* BYTES_SENT = "bytes_sent";
+    constexpr const char* INPUT_TOKENS = "input_tokens";
+    constexpr const char* OUTPUT_TOKENS = "output_tokens";
+    constexpr const char* STALLS = "stalls";                        ///< Plus stalls_<cause> each
+    
+    // Gauges
+    constexpr const char* PROMPT_TOKENS = "prompt_tokens";
+    constexpr const char* CONVERSATION_MESSAGES = "conversation_messages";
+    constexpr const char* MEMORY_TOTAL_BYTES = "mem_total_bytes";   ///< Plus mem_<subsystem>_bytes each
+    constexpr const char* POOL_UTILIZATION = "pool_utilization";    ///< Plus pool_<priority>_{queued,active,wait_p99_ms}
+    constexpr const char* POOL_STOLEN = "pool_stolen";
+    constexpr const char* FRAME_P95_MS = "frame_p95_ms";
+    constexpr const char* SCRIPT_LONG_SLICES = "script_long_slices";    ///< Plus script_<priority>_{queued,wait_p99_ms,slice_p99_ms}
+}
+
+/**
+ * @brief Log-linear histogram in the style of HdrHistogram.
+ *
+ * Each power of two is split into SUB_BUCKETS linear buckets, so a recorded
+ * value is off by at most 1/SUB_BUCKETS (about 3%) regardless of magnitude.
+ * Buckets are plain counts, which makes histograms cheap to merge and to
+ * persist across sessions. Values at or below 2^MIN_EXPONENT share a single
+ * "zero" bucket; values above 2^MAX_EXPONENT land in the last bucket.
+ */
+class Histogram {
+public:
+    static constexpr int SUB_BUCKETS = 32;
+    static constexpr int MIN_EXPONENT = -10;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr std::size_t BUCKET_COUNT =
+        1 + static_cast<std::size_t>(MAX_EXPONENT - MIN_EXPONENT) * SUB_BUCKETS;
+    
+    void record(double value);
+    void merge(const Histogram& other);
+    
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] double min() const noexcept { return count_ ? min_ : 0.0; }
+    [[nodiscard]] double max() const noexcept { return count_ ? max_ : 0.0; }
+    [[nodiscard]] double mean() const noexcept { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+    
+    /**
+     * @brief Value at quantile q (0..1), within one bucket's precision.
+     */
+    [[nodiscard]] double percentile(double q) const;
+    
+    /**
+     * @brief Sparse bucket dump, the inverse of from_json().
+     */
+    [[nodiscard]] nlohmann::json to_json() const;
+    [[nodiscard]] static Histogram from_json(const nlohmann::json& j);
+
+private:
+    [[nodiscard]] static std::size_t bucket_for(double value) noexcept;
+    [[nodiscard]] static double bucket_midpoint(std::size_t index) noexcept;
+    
+    std::vector<std::uint64_t> counts_;     ///< Sized to BUCKET_COUNT on first record
+    std::uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+/**
+ * @brief Summary statistics of one histogram.
+ */
+struct HistogramSummary {
+    std::uint64_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+};
+
+/**
+ * @brief Point-in-time view of a registry.
+ */
+struct MetricsSummary {
+    std::map<std::string, std::int64_t> counters;
+    std::map<std::string, double> gauges;
+    std::map<std::string, HistogramSummary> histograms;
+    
+    [[nodiscard]] nlohmann::json to_json() const;
+};
+
+/**
+ * @brief Metrics for the current session and for all sessions so far.
+ */
+struct MetricsSnapshot {
+    MetricsSummary session;
+    MetricsSummary lifetime;    ///< Persisted sessions plus the current one
+    
+    [[nodiscard]] nlohmann::json to_json() const;
+};
+
+/**
+ * @brief Named counters, gauges and histograms.
+ *
+ * Thread-safe. Recording takes one short lock and a map lookup, which is
+ * noise next to the API calls and scripts being measured.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry& other);
+    MetricsRegistry& operator=(const MetricsRegistry& other);
+    
+    void add(const std::string& counter, std::int64_t delta = 1);
+    void set(const std::string& gauge, double value);
+    void record(const std::string& histogram, double value);
+    
+    /**
+     * @brief Add counters and histograms of other; its gauges win.
+     */
+    void merge(const MetricsRegistry& other);
+    
+    [[nodiscard]] MetricsSummary summary() const;
+    
+    /**
+     * @brief Full dump including histogram buckets, the inverse of from_json().
+     */
+    [[nodiscard]] nlohmann::json to_json() const;
+    [[nodiscard]] static MetricsRegistry from_json(const nlohmann::json& j);
+    
+    /**
+     * @brief Load a dump written by save() (empty registry if missing or corrupt).
+     */
+    [[nodiscard]] static MetricsRegistry load(const std::string& path);
+    
+    /**
+     * @brief Write to_json() atomically (temp file + rename).
+     */
+    [[nodiscard]] bool save(const std::string& path) const;
+    
+    /**
+     * @brief Load, merge @p delta and save, holding an exclusive lock on
+     *        path + ".lock" so concurrent instances cannot drop updates.
+     * @return The merged registry, or nullopt if it could not be saved
+     */
+    [[nodiscard]] static std::optional<MetricsRegistry> merge_into_file(const std::string& path,
+                                                                        const MetricsRegistry& delta);
+    
+    [[nodiscard]] bool empty() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::int64_t> counters_;
+    std::map<std::string, double> gauges_;
+    std::map<std::string, Histogram> histograms_;
+};
+
+} // namespace ida_chat
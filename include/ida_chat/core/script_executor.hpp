@@ -6,6 +6,7 @@
 #pragma once
 
 #include <ida_chat/core/types.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
 #include <string>
 #include <functional>
@@ -38,11 +39,17 @@ namespace ida_chat {
  * @brief Create a script executor function that runs on the main thread.
  * 
  * Returns a function suitable for use with ChatCore that ensures
- * all script execution happens on IDA's main thread.
+ * all script execution happens on IDA's main thread. Calls from other
+ * threads are admitted by ScriptScheduler, which orders them by priority
+ * and shares main-thread time fairly between sessions.
  * 
+ * @param session Fairness group (one per chat, sub-agent or batch)
+ * @param priority Background for prefetches and other work nobody waits on
  * @return ScriptExecutorFn that executes scripts on the main thread
  */
-[[nodiscard]] ScriptExecutorFn create_main_thread_executor();
+[[nodiscard]] ScriptExecutorFn create_main_thread_executor(
+    std::string session = "chat",
+    TaskPriority priority = TaskPriority::Interactive);
 
 /**
  * @brief Check if the current thread is IDA's main thread.
@@ -0,0 +1,160 @@
+/**
+ * @file script_scheduler.hpp
+ * @brief Prioritized, per-session fair admission of scripts to the main thread.
+ *
+ * IDAPython scripts all run on IDA's main thread. Without a scheduler every
+ * caller races into execute_sync() and the order is whatever the kernel's
+ * request queue produces, so a background prefetch or a second session can
+ * push the interactive session's scripts arbitrarily far back.
+ *
+ * The scheduler sits between ScriptExecutorFn callers and the executor that
+ * marshals to the main thread. It admits one script at a time:
+ *  - interactive scripts before background ones (background scripts that
+ *    have waited longer than BACKGROUND_AGING_MS compete as interactive);
+ *  - within a class, the session that has used the least main-thread time
+ *    goes first (sessions joining late start at the current minimum, so they
+ *    cannot starve the others with accumulated credit);
+ *  - after a slice longer than LONG_SLICE_MS the next script waits a short
+ *    gap, so IDA processes UI events before the main thread is taken again.
+ *
+ * Each script is its own execute_sync() request, which already returns to
+ * IDA's event loop between scripts; the gap makes that turn long enough to
+ * repaint after a slow script.
+ *
+ * A script still waiting for admission gives up when the cancel token of
+ * the enclosing ScriptCancelScope is cancelled. Owners of a session call
+ * close_session() when it ends so its fairness state does not linger.
+ */
+
+#pragma once
+
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Per-priority scheduler counters.
+ */
+struct ScriptPriorityStats {
+    std::size_t queued = 0;
+    std::uint64_t completed = 0;
+    double wait_p50_ms = 0.0;       ///< Submit to admission
+    double wait_p99_ms = 0.0;
+    double slice_p50_ms = 0.0;      ///< Main-thread time per script
+    double slice_p99_ms = 0.0;
+    double slice_max_ms = 0.0;
+};
+
+/**
+ * @brief Main-thread time used by one session.
+ */
+struct ScriptSessionStats {
+    std::string session;
+    std::uint64_t scripts = 0;
+    double slice_total_ms = 0.0;
+    double wait_total_ms = 0.0;
+};
+
+/**
+ * @brief Point-in-time view of the scheduler.
+ */
+struct ScriptSchedulerStats {
+    std::array<ScriptPriorityStats, TASK_PRIORITY_COUNT> priorities;
+    std::uint64_t long_slices = 0;      ///< Slices over LONG_SLICE_MS
+    std::uint64_t promoted = 0;         ///< Background scripts admitted through aging
+    std::vector<ScriptSessionStats> sessions;
+    
+    [[nodiscard]] const ScriptPriorityStats& operator[](TaskPriority priority) const {
+        return priorities[static_cast<std::size_t>(priority)];
+    }
+};
+
+/**
+ * @brief Cancel token for scheduler waits on the calling thread.
+ *
+ * ScriptExecutorFn only takes the code, so the caller that owns a session's
+ * cancel token (ChatCore) opens a scope around each script call instead of
+ * threading the token through every executor wrapper. Scopes nest.
+ */
+class ScriptCancelScope {
+public:
+    explicit ScriptCancelScope(CancelToken token);
+    ~ScriptCancelScope();
+    
+    ScriptCancelScope(const ScriptCancelScope&) = delete;
+    ScriptCancelScope& operator=(const ScriptCancelScope&) = delete;
+    
+    /**
+     * @brief Token of the innermost scope on this thread (never cancelled if none).
+     */
+    [[nodiscard]] static CancelToken current();
+
+private:
+    CancelToken previous_;
+};
+
+/**
+ * @brief Admission control for main-thread scripts.
+ */
+class ScriptScheduler {
+public:
+    /// A slice longer than this delays the next admission
+    static constexpr double LONG_SLICE_MS = 50.0;
+    /// Longest gap inserted after a long slice (a quarter of the slice up to this)
+    static constexpr double MAX_YIELD_MS = 50.0;
+    /// Background scripts waiting this long compete as interactive
+    static constexpr double BACKGROUND_AGING_MS = 2000.0;
+    /// How often a waiting script checks its cancel token
+    static constexpr int CANCEL_POLL_MS = 25;
+    
+    [[nodiscard]] static ScriptScheduler& instance();
+    
+    ScriptScheduler();
+    ~ScriptScheduler();
+    
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+    
+    /**
+     * @brief Wait for admission, then run the script through executor.
+     *
+     * Blocks the calling thread; must not be called on the thread that
+     * executes the scripts. The admission wait is added to queue_wait_ms and
+     * reported as schedule_wait_ms. If ScriptCancelScope::current() is
+     * cancelled before the script starts, it is withdrawn and an error
+     * result is returned without running it.
+     */
+    [[nodiscard]] ScriptResult run(const std::string& code,
+                                   const ScriptExecutorFn& executor,
+                                   const std::string& session,
+                                   TaskPriority priority = TaskPriority::Interactive);
+    
+    /**
+     * @brief An executor that runs every script through run().
+     */
+    [[nodiscard]] ScriptExecutorFn wrap(ScriptExecutorFn executor,
+                                        std::string session,
+                                        TaskPriority priority = TaskPriority::Interactive);
+    
+    /**
+     * @brief Forget a session's fairness state and counters.
+     *
+     * Takes effect once the session has no script queued or running.
+     */
+    void close_session(const std::string& session);
+    
+    [[nodiscard]] ScriptSchedulerStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ida_chat
@@ -0,0 +1,102 @@
+/**
+ * @file search_index.hpp
+ * @brief Incremental trigram index for searching the conversation.
+ */
+
+#pragma once
+
+#include <ida_chat/core/memory_accounting.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Case-insensitive substring search over a growing set of documents.
+ *
+ * Every document is broken into byte trigrams (ASCII-lowercased). A query
+ * intersects the posting lists of its own trigrams and only verifies the
+ * surviving candidates, so lookups stay fast with tens of MB indexed.
+ * Queries shorter than three bytes fall back to scanning every document.
+ *
+ * Documents are kept as given (never as a lowercased copy); candidates are
+ * verified with a case-insensitive comparison. Documents larger than
+ * RETAIN_BYTES that were given a blob id keep only the id. They are read
+ * back from the blob store when they need to be verified, so the index does
+ * not hold a second copy of large outputs. While the
+ * SearchIndex memory budget is exceeded, retained documents are dropped to a
+ * blob id oldest first; documents indexed without one are written to the
+ * blob store first and searched from there afterwards.
+ *
+ * Thread-safe. Both add() and find() may touch the blob store, so they
+ * belong on a worker thread.
+ */
+class SearchIndex {
+public:
+    /// Hits returned by a single query at most
+    static constexpr std::size_t MAX_HITS = 10000;
+    
+    /// Documents above this size are not kept in memory when a blob id is given
+    static constexpr std::size_t RETAIN_BYTES = 64 * 1024;
+    
+    struct Hit {
+        std::uint64_t key = 0;      ///< Caller's document key
+        std::size_t offset = 0;     ///< Byte offset of the match in the document
+    };
+    
+    /**
+     * @brief Index a document.
+     * @param key Caller-defined key; hits are returned in key order
+     * @param text Document text
+     * @param blob_id Blob holding the same text, if any
+     */
+    void add(std::uint64_t key, std::string_view text, std::string blob_id = {});
+    
+    /**
+     * @brief Find all occurrences of a query (case-insensitive).
+     * @return Hits ordered by key, then offset
+     */
+    [[nodiscard]] std::vector<Hit> find(std::string_view query,
+                                        std::size_t max_hits = MAX_HITS) const;
+    
+    void clear();
+    
+    [[nodiscard]] std::size_t document_count() const;
+    [[nodiscard]] std::size_t indexed_bytes() const;
+
+private:
+    struct Spill {
+        std::uint32_t id = 0;
+        std::shared_ptr<const std::string> text;
+    };
+    
+    [[nodiscard]] std::vector<Spill> evict_over_budget();   ///< Caller holds mutex_
+    void spill(const std::vector<Spill>& victims, std::uint64_t epoch);   ///< Without mutex_
+    void account();             ///< Caller holds mutex_
+    
+    struct Document {
+        std::uint64_t key = 0;
+        std::shared_ptr<const std::string> text;   ///< Null if only in a blob
+        std::string blob_id;
+    };
+    
+    mutable std::mutex mutex_;
+    std::vector<Document> docs_;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings_;
+    std::size_t indexed_bytes_ = 0;
+    std::size_t retained_bytes_ = 0;     ///< Text held in memory
+    std::size_t spilling_bytes_ = 0;     ///< Part of it being written to the blob store
+    std::size_t posting_count_ = 0;
+    std::size_t evict_cursor_ = 0;       ///< Docs before this hold no evictable text
+    std::uint64_t epoch_ = 0;            ///< Bumped by clear() so late spills are dropped
+    TrackedBytes tracked_{MemorySubsystem::SearchIndex};
+};
+
+} // namespace ida_chat
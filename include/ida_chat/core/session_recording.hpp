@@ -0,0 +1,169 @@
+/**
+ * @file session_recording.hpp
+ * @brief Record a chat session's inputs and replay them deterministically.
+ *
+ * A recording is a JSONL file holding everything that enters ChatCore:
+ * user inputs (with attachment payloads), request bodies, SSE byte streams
+ * with arrival times, script results, plus the final result of every
+ * message for comparison. Replaying feeds it back through ChatCore with a
+ * manual EngineClock and a fake executor, offline and at full speed, and
+ * reports where the engine's behaviour diverged from the recording.
+ *
+ * Only API mode is recorded; the Claude CLI transport is an opaque
+ * subprocess.
+ */
+
+#pragma once
+
+#include <ida_chat/core/chat_core.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Appends a session to a recording file as it happens.
+ *
+ * Every entry is flushed, so a recording survives a crash of the session it
+ * captures. Thread-safe.
+ */
+class SessionRecorder {
+public:
+    static constexpr int FORMAT_VERSION = 1;
+    
+    /**
+     * @brief Create (truncate) the recording file.
+     */
+    explicit SessionRecorder(const std::string& path);
+    
+    [[nodiscard]] bool is_open() const;
+    [[nodiscard]] const std::string& path() const noexcept { return path_; }
+    
+    /**
+     * @brief Engine settings the replay needs to reproduce the session.
+     */
+    void record_header(const ChatCoreOptions& options);
+    
+    void record_input(const std::string& text, const std::vector<Attachment>& attachments);
+    void record_script(const std::string& code, const ScriptResult& result);
+    void record_result(const ProcessResult& result);
+    
+    /**
+     * @brief Transport that performs the real HTTP request and records it.
+     */
+    [[nodiscard]] StreamTransport transport();
+
+private:
+    void write(const nlohmann::json& entry);
+    
+    std::string path_;
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+};
+
+/**
+ * @brief A user message from a recording.
+ */
+struct RecordedInput {
+    std::string text;
+    std::vector<std::pair<std::string, std::string>> attachments;   ///< (label, payload)
+};
+
+/**
+ * @brief Plays a recording back into ChatCore.
+ *
+ * Requests are answered from the recording in order and script results are
+ * returned without executing anything. Each request body, script and final
+ * result is compared with the recorded one; differences are collected as
+ * divergences rather than aborting, so one run shows all of them.
+ */
+class SessionReplay {
+public:
+    /**
+     * @brief Parse a recording (nullptr and *error set on failure).
+     */
+    [[nodiscard]] static std::shared_ptr<SessionReplay> load(const std::string& path,
+                                                              std::string* error = nullptr);
+    
+    /**
+     * @brief Recorded engine settings (model, max_turns, thinking).
+     */
+    [[nodiscard]] const nlohmann::json& header() const noexcept { return header_; }
+    
+    /**
+     * @brief Options from the header on top of base.
+     */
+    [[nodiscard]] ChatCoreOptions apply_options(ChatCoreOptions base) const;
+    
+    /**
+     * @brief System prompt sent with the first recorded request.
+     */
+    [[nodiscard]] std::string system_prompt() const;
+    
+    [[nodiscard]] const std::vector<RecordedInput>& inputs() const noexcept { return inputs_; }
+    
+    /**
+     * @brief Put an input's attachments into the blob store.
+     */
+    [[nodiscard]] static std::vector<Attachment> materialize_attachments(const RecordedInput& input);
+    
+    /**
+     * @brief Transport that answers with the next recorded response.
+     *
+     * Moves EngineClock (in manual mode) to each chunk's recorded arrival time.
+     */
+    [[nodiscard]] StreamTransport transport();
+    
+    /**
+     * @brief Executor that returns the next recorded script result.
+     */
+    [[nodiscard]] ScriptExecutorFn executor();
+    
+    /**
+     * @brief Compare a finished message with the next recorded result.
+     */
+    void check_result(const ProcessResult& result);
+    
+    [[nodiscard]] bool diverged() const;
+    [[nodiscard]] std::vector<std::string> divergences() const;
+
+private:
+    struct Chunk {
+        std::int64_t offset_us = 0;     ///< Arrival time after the request was sent
+        std::string data;
+    };
+    
+    struct Exchange {
+        std::string request_body;
+        int status_code = 0;
+        bool success = false;
+        std::string error;
+        std::vector<Chunk> chunks;
+    };
+    
+    struct Script {
+        std::string code;
+        ScriptResult result;
+    };
+    
+    void diverge(std::string what);     ///< Caller holds mutex_
+    
+    nlohmann::json header_;
+    std::vector<RecordedInput> inputs_;
+    std::vector<Exchange> exchanges_;
+    std::vector<Script> scripts_;
+    std::vector<ProcessResult> results_;
+    
+    mutable std::mutex mutex_;
+    std::size_t next_exchange_ = 0;
+    std::size_t next_script_ = 0;
+    std::size_t next_result_ = 0;
+    std::vector<std::string> divergences_;
+};
+
+} // namespace ida_chat
@@ -0,0 +1,220 @@
+/**
+ * @file stall_monitor.hpp
+ * @brief GUI-thread stall detection with cause attribution.
+ *
+ * Scripts run on IDA's main thread via execute_sync(), and markdown
+ * rendering, layout and some history I/O also happen there. The stall
+ * monitor measures how long the GUI thread is unresponsive and attributes
+ * each freeze to what it was doing.
+ */
+
+#pragma once
+
+#include <ida_chat/common/json.hpp>
+#include <ida_chat/core/types.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief What the GUI thread was busy with during a stall.
+ */
+enum class StallCause : std::uint8_t {
+    Unknown,    ///< Not inside any instrumented section
+    Script,     ///< IDAPython script via execute_sync
+    Render,     ///< Markdown / syntax highlighting
+    Layout,     ///< Widget layout after inserting chat items
+    HistoryIO   ///< History or blob store disk access
+};
+
+[[nodiscard]] const char* stall_cause_str(StallCause cause) noexcept;
+
+/**
+ * @brief One recorded freeze.
+ */
+struct StallRecord {
+    std::int64_t start_ms = 0;      ///< Wall-clock start (ms since epoch)
+    double duration_ms = 0.0;
+    StallCause cause = StallCause::Unknown;
+    std::string detail;             ///< e.g. "script #12", "markdown 48 KB"
+};
+
+/**
+ * @brief Frame-time distribution over the recent sampling window.
+ */
+struct FrameStats {
+    std::size_t samples = 0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief Watchdog for the GUI event loop.
+ *
+ * A background thread posts a ping to the GUI thread every PING_INTERVAL
+ * and measures how long it takes to run. A ping delayed beyond
+ * STALL_THRESHOLD is recorded as a stall. Instrumented sections
+ * (StallScope) additionally report their own duration, which gives exact
+ * attribution. The watchdog also samples the active scope while a ping is
+ * overdue, so long stalls that no scope reports are still attributed.
+ *
+ * Everything is a no-op until start() is called, so the instrumentation can
+ * stay in release builds.
+ */
+class StallMonitor {
+public:
+    /// Freezes at or above this are recorded
+    static constexpr std::chrono::milliseconds STALL_THRESHOLD{50};
+    
+    /// Watchdog ping period
+    static constexpr std::chrono::milliseconds PING_INTERVAL{20};
+    
+    /// Oldest records are dropped beyond this
+    static constexpr std::size_t MAX_RECORDS = 512;
+    
+    /// Frame-time samples kept for FrameStats
+    static constexpr std::size_t FRAME_WINDOW = 256;
+    
+    /// Posts a callable to the GUI thread's event loop
+    using PostFn = std::function<void(std::function<void()>)>;
+    
+    [[nodiscard]] static StallMonitor& instance();
+    
+    ~StallMonitor();
+    
+    StallMonitor(const StallMonitor&) = delete;
+    StallMonitor& operator=(const StallMonitor&) = delete;
+    
+    /**
+     * @brief Start the watchdog. Must be called from the GUI thread.
+     */
+    void start(PostFn post_to_gui);
+    
+    /**
+     * @brief Stop the watchdog (records are kept).
+     */
+    void stop();
+    
+    [[nodiscard]] bool is_running() const noexcept { return running_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Whether the calling thread is the monitored GUI thread.
+     */
+    [[nodiscard]] bool on_gui_thread() const noexcept;
+    
+    /**
+     * @brief Hint the cause of work queued for the next event-loop pass.
+     *
+     * Used for work Qt performs later on our behalf (e.g. relayout after a
+     * widget is inserted). Cleared when the next ping completes.
+     */
+    void hint(StallCause cause, std::string detail = {});
+    
+    /**
+     * @brief Record one frame interval (from a UI frame timer).
+     */
+    void record_frame(double frame_ms);
+    
+    [[nodiscard]] std::vector<StallRecord> records() const;
+    [[nodiscard]] std::size_t stall_count() const;
+    
+    /**
+     * @brief Stalls recorded since the process started (clear() does not reset it).
+     */
+    [[nodiscard]] std::uint64_t total_recorded() const;
+    
+    /**
+     * @brief Records added after cursor, advancing cursor past them.
+     *
+     * Start the cursor at total_recorded(). Records already dropped (beyond
+     * MAX_RECORDS) are skipped.
+     */
+    [[nodiscard]] std::vector<StallRecord> records_since(std::uint64_t& cursor) const;
+    [[nodiscard]] FrameStats frame_stats() const;
+    
+    /**
+     * @brief Stalls plus per-cause totals and frame stats, for session metrics.
+     */
+    [[nodiscard]] nlohmann::json to_json() const;
+    
+    /**
+     * @brief Write to_json() to a file.
+     */
+    [[nodiscard]] bool export_json(const std::string& path) const;
+    
+    void clear();
+    
+    // Called by StallScope
+    void enter_scope(StallCause cause, const std::string& detail);
+    void leave_scope(StallCause cause, const std::string& detail,
+                     std::chrono::steady_clock::time_point started);
+
+private:
+    StallMonitor() = default;
+    
+    using Clock = std::chrono::steady_clock;
+    
+    void watchdog_loop();
+    void on_pong(std::uint64_t seq);
+    void add_record(Clock::time_point start, Clock::time_point end,
+                    StallCause cause, std::string detail);
+    
+    PostFn post_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::thread::id gui_thread_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    
+    // Outstanding ping (guarded by mutex_)
+    std::uint64_t ping_seq_ = 0;
+    bool ping_outstanding_ = false;
+    Clock::time_point ping_sent_;
+    StallCause ping_cause_ = StallCause::Unknown;
+    std::string ping_detail_;
+    
+    // Active instrumented section on the GUI thread (guarded by mutex_)
+    std::vector<std::pair<StallCause, std::string>> scopes_;
+    StallCause hint_cause_ = StallCause::Unknown;
+    std::string hint_detail_;
+    
+    // Results (guarded by mutex_)
+    std::deque<StallRecord> records_;
+    std::uint64_t recorded_ = 0;        ///< Ever added; records_ holds the newest
+    Clock::time_point last_record_end_{};
+    std::deque<double> frames_;
+};
+
+/**
+ * @brief Marks a section of GUI-thread work for stall attribution.
+ *
+ * Free when the monitor is stopped or when constructed off the GUI thread.
+ */
+class StallScope {
+public:
+    explicit StallScope(StallCause cause, std::string detail = {});
+    ~StallScope();
+    
+    StallScope(const StallScope&) = delete;
+    StallScope& operator=(const StallScope&) = delete;
+
+private:
+    bool active_ = false;
+    StallCause cause_;
+    std::string detail_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+} // namespace ida_chat
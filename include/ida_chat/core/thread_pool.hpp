@@ -0,0 +1,136 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Process-wide work-stealing pool for background engine and UI work.
+ *
+ * Highlighting, attachment hashing, search indexing and similar jobs used to
+ * go to whatever pool was at hand. They now share one pool sized to the
+ * machine, with two priorities: interactive work (something the user is
+ * looking at) always runs before background work, and background work may
+ * never occupy every worker, so an interactive task finds a free thread
+ * even while indexing is saturating the rest.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace ida_chat {
+
+enum class TaskPriority : std::uint8_t {
+    Interactive,    ///< The user is waiting on the result (highlighting, attachments)
+    Background      ///< Indexing, serialization, anything that can lag
+};
+
+constexpr std::size_t TASK_PRIORITY_COUNT = 2;
+
+[[nodiscard]] const char* task_priority_str(TaskPriority priority) noexcept;
+
+/**
+ * @brief Cooperative cancellation shared by a submitter and its tasks.
+ *
+ * Tasks whose token is cancelled before they start are skipped; running
+ * tasks may poll cancelled() to stop early. A default-constructed token is
+ * never cancelled and costs nothing to pass around.
+ */
+class CancelToken {
+public:
+    CancelToken() = default;
+    
+    /**
+     * @brief A token that can be cancelled.
+     */
+    [[nodiscard]] static CancelToken create();
+    
+    void cancel() noexcept;
+    [[nodiscard]] bool cancelled() const noexcept;
+
+private:
+    std::shared_ptr<std::atomic<bool>> state_;
+};
+
+/**
+ * @brief Per-priority pool counters.
+ */
+struct TaskPriorityStats {
+    std::size_t queued = 0;
+    std::size_t active = 0;
+    std::uint64_t completed = 0;
+    double wait_p50_ms = 0.0;       ///< Time from submit to start
+    double wait_p99_ms = 0.0;
+};
+
+/**
+ * @brief Point-in-time view of the pool.
+ */
+struct ThreadPoolStats {
+    std::size_t threads = 0;
+    std::size_t background_limit = 0;   ///< Workers background tasks may occupy at once
+    std::array<TaskPriorityStats, TASK_PRIORITY_COUNT> priorities;
+    std::uint64_t cancelled = 0;        ///< Skipped because their token was cancelled
+    std::uint64_t stolen = 0;           ///< Taken from another worker's queue
+    double utilization = 0.0;           ///< Busy share of all workers since the pool started
+    
+    [[nodiscard]] const TaskPriorityStats& operator[](TaskPriority priority) const {
+        return priorities[static_cast<std::size_t>(priority)];
+    }
+};
+
+/**
+ * @brief Work-stealing thread pool.
+ *
+ * Each worker owns a queue per priority. Tasks submitted from a worker go to
+ * its own queue, others are spread round-robin; an idle worker takes from
+ * its own queue first and then steals from the others. Workers start on the
+ * first submit. Tasks must not throw (exceptions are caught and logged).
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+    
+    /**
+     * @brief The shared pool, one worker per hardware thread (at least two).
+     */
+    [[nodiscard]] static ThreadPool& instance();
+    
+    /**
+     * @param threads Worker count (0 = hardware concurrency)
+     */
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void submit(Task task,
+                TaskPriority priority = TaskPriority::Background,
+                CancelToken token = {});
+    
+    /**
+     * @brief Block until no task is queued or running.
+     */
+    void wait_idle();
+    
+    /**
+     * @brief Drop queued tasks and join the workers.
+     *
+     * Running tasks finish first; submits made while the workers are being
+     * joined are dropped and counted as cancelled. The pool is then back in
+     * its initial state and the next submit starts new workers, so the
+     * plugin can call this each time a database closes. Do not call it from
+     * a pool task.
+     */
+    void shutdown();
+    
+    [[nodiscard]] std::size_t thread_count() const noexcept;
+    [[nodiscard]] ThreadPoolStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ida_chat
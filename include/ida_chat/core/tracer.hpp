@@ -0,0 +1,167 @@
+/**
+ * @file tracer.hpp
+ * @brief Low-overhead tracing spans with Chrome trace export.
+ *
+ * A request crosses several threads: the agent worker builds and sends it,
+ * curl streams the reply, scripts run on IDA's main thread and the UI
+ * renders the result. The tracer records timed spans on each of them into
+ * per-thread ring buffers so a slow turn can be opened in chrome://tracing
+ * or Perfetto and read off a single timeline.
+ */
+
+#pragma once
+
+#include <ida_chat/common/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief One recorded span (or instant event when duration_ns < 0).
+ *
+ * Category and name must be string literals; they are stored as pointers.
+ */
+struct TraceEvent {
+    const char* category = "";
+    const char* name = "";
+    std::int64_t start_ns = 0;      ///< Since the tracer epoch (steady clock)
+    std::int64_t duration_ns = -1;
+    std::string detail;             ///< Optional argument shown in the viewer
+};
+
+/**
+ * @brief Process-wide span collector.
+ *
+ * Each thread writes into its own ring buffer of RING_CAPACITY events; once
+ * full, the oldest events are overwritten and counted as dropped. The
+ * buffer lock is only ever contended by an export, so recording costs a
+ * clock read and an uncontended lock. While disabled (the default) a span
+ * costs one relaxed atomic load. A ring outlives its thread until its
+ * events have been exported (or cleared), so short-lived pool workers do
+ * not accumulate buffers.
+ */
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /// Events kept per thread
+    static constexpr std::size_t RING_CAPACITY = 16384;
+    
+    [[nodiscard]] static Tracer& instance();
+    
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    
+    [[nodiscard]] static bool enabled() noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    
+    void set_enabled(bool enabled);
+    
+    /**
+     * @brief Name the calling thread in exported traces.
+     */
+    void set_thread_name(std::string name);
+    
+    /**
+     * @brief Record a span whose bounds were measured by the caller.
+     */
+    void complete(const char* category, const char* name,
+                  Clock::time_point start, Clock::time_point end,
+                  std::string detail = {});
+    
+    /**
+     * @brief Record a point in time.
+     */
+    void instant(const char* category, const char* name, std::string detail = {});
+    
+    [[nodiscard]] std::size_t event_count() const;
+    
+    /**
+     * @brief All buffered events in Chrome trace event format.
+     */
+    [[nodiscard]] nlohmann::json to_chrome_json() const;
+    
+    /**
+     * @brief Write to_chrome_json() to a file.
+     */
+    [[nodiscard]] bool export_chrome_json(const std::string& path) const;
+    
+    /**
+     * @brief Drop all buffered events (thread names are kept).
+     */
+    void clear();
+
+private:
+    Tracer() = default;
+    
+    struct ThreadBuffer;
+    
+    ThreadBuffer& local();
+    void record(TraceEvent event);
+    void prune_locked() const;  ///< Caller holds mutex_
+    [[nodiscard]] std::int64_t since_epoch(Clock::time_point t) const noexcept;
+    
+    static inline std::atomic<bool> enabled_{false};
+    
+    const Clock::time_point epoch_ = Clock::now();
+    
+    mutable std::mutex mutex_;
+    /// Kept until their thread has exited and the events were exported;
+    /// mutable so that an export can release them
+    mutable std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    std::uint32_t next_tid_ = 1;
+};
+
+/**
+ * @brief Times the enclosing scope as one trace span.
+ *
+ * Names are string literals. Build a detail string only when active() to
+ * keep the disabled path free.
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name) noexcept
+        : category_(category)
+        , name_(name)
+        , active_(Tracer::enabled())
+    {
+        if (active_) {
+            start_ = Tracer::Clock::now();
+        }
+    }
+    
+    ~TraceSpan() {
+        if (active_) {
+            Tracer::instance().complete(category_, name_, start_, Tracer::Clock::now(),
+                                        std::move(detail_));
+        }
+    }
+    
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    
+    [[nodiscard]] bool active() const noexcept { return active_; }
+    
+    void set_detail(std::string detail) {
+        if (active_) {
+            detail_ = std::move(detail);
+        }
+    }
+
+private:
+    const char* category_;
+    const char* name_;
+    bool active_;
+    Tracer::Clock::time_point start_;
+    std::string detail_;
+};
+
+} // namespace ida_chat
@@ -0,0 +1,98 @@
+/**
+ * @file turn_metrics.hpp
+ * @brief Live timing and token metrics for the request being processed.
+ */
+
+#pragma once
+
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/core/clock.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace ida_chat {
+
+/**
+ * @brief Metrics for one user request (all of its agentic turns).
+ *
+ * Token counts are summed over the request. While an API call is still
+ * streaming, its output count is an estimate from the streamed text; it is
+ * replaced by the reported usage when the call ends. TTFT and tokens/s
+ * describe the most recent API call.
+ */
+struct TurnMetrics {
+    int request = 0;                ///< Sequence number of the user request (0 = none yet)
+    int turn = 0;                   ///< Agentic turn within the request
+    bool active = false;            ///< Request still running
+    double elapsed_ms = 0.0;        ///< Since the request started
+    double ttft_ms = -1.0;          ///< Call start -> first streamed token (-1 = not yet)
+    double tokens_per_sec = 0.0;    ///< Output rate after the first token
+    TokenUsage usage;
+    int scripts = 0;
+    double script_ms = 0.0;         ///< Time spent running scripts
+    double queue_wait_ms = 0.0;     ///< Time scripts waited for the main thread
+    
+    /**
+     * @brief Share of prompt tokens served from the cache (0..1).
+     */
+    [[nodiscard]] double cache_hit_ratio() const noexcept;
+};
+
+/**
+ * @brief Collects TurnMetrics from the engine thread.
+ *
+ * ChatCore reports events as they happen. The UI polls snapshot() on a
+ * timer instead of receiving a signal per token. All methods are
+ * thread-safe and cheap (one short lock).
+ */
+class TurnMetricsRecorder {
+public:
+    void begin_request();
+    void end_request();
+    
+    /**
+     * @brief An API call (or CLI invocation) for the given turn starts.
+     */
+    void begin_call(int turn);
+    
+    /**
+     * @brief Prompt-side usage reported at the start of a streamed call.
+     */
+    void on_call_usage(const TokenUsage& usage);
+    
+    /**
+     * @brief Streamed output arrived (estimated tokens).
+     */
+    void on_output(std::size_t tokens);
+    
+    /**
+     * @brief The call finished with its reported usage.
+     */
+    void end_call(const TokenUsage& usage);
+    
+    void on_script(const ScriptResult& result);
+    
+    [[nodiscard]] TurnMetrics snapshot() const;
+
+private:
+    using Clock = EngineClock;     ///< Manual during session replay
+    
+    [[nodiscard]] double call_rate(std::int64_t output_tokens) const;
+    
+    mutable std::mutex mutex_;
+    TurnMetrics metrics_;               ///< Usage of finished calls only
+    
+    // Open call
+    bool call_open_ = false;
+    TokenUsage call_usage_;
+    std::size_t call_output_estimate_ = 0;
+    Clock::time_point request_start_;
+    Clock::time_point call_start_;
+    Clock::time_point first_token_;
+    Clock::time_point last_token_;
+    bool first_token_seen_ = false;
+};
+
+} // namespace ida_chat
@@ -8,6 +8,7 @@
 #include <ida_chat/common/platform.hpp>
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <variant>
@@ -126,6 +127,8 @@ struct ScriptResult {
     std::string output;         ///< Captured stdout/stderr
     std::string error;          ///< Error message if failed
     double execution_time_ms = 0.0;  ///< Execution duration
+    double queue_wait_ms = 0.0;      ///< Wait for the main thread before running
+    double schedule_wait_ms = 0.0;   ///< Part of queue_wait_ms spent waiting for the script scheduler
     
     [[nodiscard]] static ScriptResult success_result(std::string out) {
         return {true, std::move(out), {}, 0.0};
@@ -168,6 +171,32 @@ struct TokenUsage {
     }
 };
 
+// ============================================================================
+// Attachments
+// ============================================================================
+
+/**
+ * @brief Large pasted content sent alongside a prompt.
+ *
+ * The payload lives in the blob store; only the reference travels through
+ * the UI and the worker queue. It is read back when the request is built.
+ */
+struct Attachment {
+    std::string blob_id;            ///< BlobStore content id
+    std::string label;              ///< Display name, e.g. "Pasted text #1"
+    std::uint64_t size = 0;         ///< Payload size in bytes
+    std::size_t tokens = 0;         ///< Estimated token count
+};
+
+/**
+ * @brief Rough token estimate for a payload (no tokenizer available).
+ *
+ * Letter/digit runs count one token per four bytes, and punctuation counts
+ * one token each. This keeps hex dumps and disassembly from being
+ * underestimated the way a flat bytes/4 would.
+ */
+[[nodiscard]] std::size_t estimate_tokens(std::string_view text) noexcept;
+
 // ============================================================================
 // Chat State Types
 // ============================================================================
@@ -251,6 +280,8 @@ struct DatabaseInfo {
 
 /**
  * @brief Get the IDA Chat configuration directory (~/.ida-chat/).
+ *
+ * IDA_CHAT_CONFIG_DIR overrides the location (benchmarks, sandboxed runs).
  */
 [[nodiscard]] std::string get_config_directory();
 
@@ -259,6 +290,21 @@ struct DatabaseInfo {
  */
 [[nodiscard]] std::string get_sessions_directory();
 
+/**
+ * @brief Get the content-addressed blob directory (~/.ida-chat/blobs/).
+ */
+[[nodiscard]] std::string get_blobs_directory();
+
+/**
+ * @brief Get the diagnostics/metrics export directory (~/.ida-chat/metrics/).
+ */
+[[nodiscard]] std::string get_metrics_directory();
+
+/**
+ * @brief Get the log file directory (~/.ida-chat/logs/).
+ */
+[[nodiscard]] std::string get_logs_directory();
+
 /**
  * @brief Ensure a directory exists, creating it if necessary.
  * @return true if directory exists or was created successfully.
@@ -275,6 +321,15 @@ struct DatabaseInfo {
  */
 [[nodiscard]] std::string base64_url_decode(const std::string& input);
 
+// ============================================================================
+// Hashing
+// ============================================================================
+
+/**
+ * @brief 64-bit FNV-1a hash (stable across runs; used for content addressing).
+ */
+[[nodiscard]] std::uint64_t fnv1a_64(std::string_view data) noexcept;
+
 // ============================================================================
 // String Utilities
 // ============================================================================
@@ -0,0 +1,160 @@
+/**
+ * @file blob_store.hpp
+ * @brief Content-addressed storage for large history payloads.
+ *
+ * Script outputs, pasted attachments and other large payloads are written
+ * once to ~/.ida-chat/blobs/ and referenced by id. The JSONL history keeps
+ * only a preview, and UI widgets keep only the reference.
+ */
+
+#pragma once
+
+#include <ida_chat/core/types.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace ida_chat {
+
+/**
+ * @brief Reference to a stored blob.
+ */
+struct BlobRef {
+    std::string id;             ///< Content id (hash + size)
+    std::uint64_t size = 0;     ///< Size in bytes
+    
+    [[nodiscard]] bool valid() const noexcept { return !id.empty(); }
+};
+
+/**
+ * @brief Content-addressed blob store.
+ *
+ * Blobs are immutable files named by content hash, so storing the same
+ * payload twice (e.g. from history and from the UI) writes it only once.
+ * Writes go to a temp file and are renamed into place, so concurrent
+ * writers and readers from different threads are safe.
+ *
+ * Blobs are reclaimed by collect_garbage(): anything no session transcript
+ * references, no running process has leased, and that has not been stored
+ * for GC_GRACE is deleted. Each process lists its leases in a manifest
+ * under leases/, so spills the UI still holds (collapsed outputs, spilled
+ * tasks, attachments, compacted history) survive a GC from any instance.
+ */
+class BlobStore {
+public:
+    /// Payloads at or above this size are spilled out of the JSONL history,
+    /// and script outputs at or above it are collapsed in the chat view
+    static constexpr std::size_t SPILL_THRESHOLD = 32 * 1024;
+    
+    /// Unreferenced blobs stored (or re-stored) more recently than this are
+    /// kept, which covers a write racing the lease manifest
+    static constexpr std::chrono::hours GC_GRACE{24};
+    
+    /// Preview kept inline next to a spilled payload
+    static constexpr std::size_t PREVIEW_BYTES = 4 * 1024;
+    
+    /**
+     * @brief Create a store rooted at a directory.
+     */
+    explicit BlobStore(std::string directory);
+    
+    /**
+     * @brief Remove this process's lease manifest.
+     */
+    ~BlobStore();
+    
+    BlobStore(const BlobStore&) = delete;
+    BlobStore& operator=(const BlobStore&) = delete;
+    
+    /**
+     * @brief Shared store in get_blobs_directory().
+     */
+    [[nodiscard]] static BlobStore& shared();
+    
+    /**
+     * @brief Store a payload.
+     *
+     * If the blob is already present only its timestamp is refreshed, which
+     * restarts its GC grace period. The blob is leased to this process.
+     * @return Reference, or an invalid ref if the write failed
+     */
+    [[nodiscard]] BlobRef put(std::string_view data);
+    
+    /**
+     * @brief Keep a blob from GC for as long as this process runs.
+     *
+     * put() leases what it stores; call this for ids adopted otherwise.
+     */
+    void lease(const std::string& id);
+    
+    /**
+     * @brief Read a byte range of a blob.
+     * @return The bytes read (may be shorter at end of blob), or nullopt if missing
+     */
+    [[nodiscard]] std::optional<std::string> read(const std::string& id,
+                                                  std::uint64_t offset,
+                                                  std::size_t length) const;
+    
+    /**
+     * @brief Read a whole blob.
+     */
+    [[nodiscard]] std::optional<std::string> read_all(const std::string& id) const;
+    
+    /**
+     * @brief Check whether a blob exists.
+     */
+    [[nodiscard]] bool contains(const std::string& id) const;
+    
+    /**
+     * @brief Path of the file backing a blob id.
+     */
+    [[nodiscard]] std::string path_for(const std::string& id) const;
+    
+    /**
+     * @brief Root directory of the store.
+     */
+    [[nodiscard]] const std::string& directory() const noexcept { return directory_; }
+    
+    /**
+     * @brief Compute the content id for a payload without storing it.
+     */
+    [[nodiscard]] static std::string content_id(std::string_view data);
+    
+    /**
+     * @brief Add every blob id mentioned in text (JSON fields, blob paths) to ids.
+     */
+    static void find_ids(std::string_view text, std::unordered_set<std::string>& ids);
+    
+    /**
+     * @brief Delete blobs that are not in live, not leased by a running
+     *        process, and older than GC_GRACE.
+     *
+     * Manifests left by processes that have exited are removed.
+     * @return Number of blobs deleted
+     */
+    std::size_t collect_garbage(const std::unordered_set<std::string>& live);
+    
+    /**
+     * @brief Build the inline preview for a spilled payload.
+     *
+     * Truncates at a UTF-8 boundary and appends a marker with the full size.
+     */
+    [[nodiscard]] static std::string make_preview(std::string_view data);
+
+private:
+    [[nodiscard]] std::string lease_directory() const;
+    [[nodiscard]] std::unordered_set<std::string> running_leases() const;
+    
+    std::string directory_;
+    
+    std::mutex lease_mutex_;
+    std::unordered_set<std::string> leased_;     ///< Ids already in the manifest
+    std::string manifest_path_;                  ///< Empty until the first lease
+};
+
+} // namespace ida_chat
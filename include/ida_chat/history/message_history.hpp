@@ -118,6 +118,10 @@ public:
     
     /**
      * @brief Append a tool result record.
+     * 
+     * Results of BlobStore::SPILL_THRESHOLD bytes or more are written to the
+     * blob store; the record keeps a preview plus "contentBlob"/"contentSize".
+     * 
      * @param tool_use_id ID of the tool use this responds to
      * @param result The tool result content
      * @param is_error Whether the result is an error
@@ -7,6 +7,7 @@
 
 #include <ida_chat/core/types.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <optional>
@@ -68,12 +69,21 @@ public:
     [[nodiscard]] std::optional<SessionInfo> get_session_info(const std::string& session_id) const;
     
     /**
-     * @brief Delete a session.
+     * @brief Delete a session; the blobs only it referenced are collected on the pool.
      * @param session_id Session UUID
      * @return true if deleted successfully
      */
     [[nodiscard]] bool delete_session(const std::string& session_id);
     
+    /**
+     * @brief Delete blobs that no session transcript references.
+     *
+     * Scans every transcript under the sessions directory, so run it off
+     * the GUI thread.
+     * @return Number of blobs deleted
+     */
+    std::size_t collect_blobs() const;
+    
     /**
      * @brief Create a new session.
      * @param database_path Associated database path (optional)
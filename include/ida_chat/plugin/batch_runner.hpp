@@ -0,0 +1,93 @@
+/**
+ * @file batch_runner.hpp
+ * @brief Headless agent runs under idat for batch triage.
+ */
+
+#pragma once
+
+// Qt before IDA headers (settings.hpp pulls in QString)
+#include <QString>
+
+#include <ida_chat/core/fwd.hpp>
+
+#include <ida_chat/common/ida_begin.hpp>
+#include <ida.hpp>
+#include <idp.hpp>
+#include <loader.hpp>
+#include <ida_chat/common/ida_end.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief One prompt of a batch run.
+ */
+struct BatchTask {
+    std::string id;         ///< From the task file, or "task-N"
+    std::string prompt;
+};
+
+/**
+ * @brief Batch configuration.
+ *
+ * Read from -Oida_chat:key=value;key=value on the idat command line, falling
+ * back to the IDA_CHAT_BATCH_* environment variables.
+ */
+struct BatchOptions {
+    std::string prompt;         ///< prompt= / IDA_CHAT_BATCH_PROMPT
+    std::string task_path;      ///< task= / IDA_CHAT_BATCH_TASK
+    std::string output_path;    ///< out= / IDA_CHAT_BATCH_OUT ("" = <idb>.ida-chat.jsonl)
+    std::string project_dir;    ///< project= / IDA_CHAT_PROJECT_DIR ("" = search the plugin dirs)
+    int max_turns = DEFAULT_MAX_TURNS;  ///< max_turns= / IDA_CHAT_BATCH_MAX_TURNS
+    bool exit_when_done = true; ///< exit= / IDA_CHAT_BATCH_EXIT ("0" keeps IDA running)
+};
+
+/**
+ * @brief Batch options for this process, or nullopt if no prompt or task was given.
+ */
+[[nodiscard]] std::optional<BatchOptions> get_batch_options();
+
+/**
+ * @brief Read a task file.
+ *
+ * A file whose first non-empty line is a JSON object with a "prompt" (and
+ * an optional "id") is a task list, and every later non-empty line must be
+ * one too; a malformed line fails with its line number in @p error.
+ * Anything else is a single prompt.
+ */
+[[nodiscard]] std::optional<std::vector<BatchTask>> load_batch_tasks(const std::string& path,
+                                                                    std::string* error = nullptr);
+
+/**
+ * @brief Run every task against the open database, one fresh conversation each.
+ *
+ * Must run on the main thread: scripts execute directly with the native
+ * executor. Appends one JSON record per task (response, turns, cost,
+ * duration, metrics) to the output file.
+ * @return Process exit code: 0 all tasks succeeded, 1 a task failed, 2 bad setup
+ */
+int run_batch(const BatchOptions& options);
+
+/**
+ * @brief Plugin module used instead of IDAChatPlugin when running headless.
+ *
+ * Waits for ui_ready_to_run, lets auto-analysis finish, runs the batch and
+ * exits IDA with run_batch()'s code.
+ */
+class BatchRunner : public plugmod_t, public event_listener_t {
+public:
+    explicit BatchRunner(BatchOptions options);
+    ~BatchRunner() override;
+    
+    bool idaapi run(size_t arg) override;
+    ssize_t idaapi on_event(ssize_t code, va_list va) override;
+
+private:
+    BatchOptions options_;
+    bool started_ = false;
+};
+
+} // namespace ida_chat
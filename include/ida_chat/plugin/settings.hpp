@@ -6,6 +6,7 @@
 #pragma once
 
 #include <ida_chat/core/types.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
 
 #include <string>
 #include <optional>
@@ -56,6 +57,46 @@ void save_auth_settings(AuthType auth_type, const std::string& api_key = "");
  */
 void apply_auth_to_environment();
 
+/**
+ * @brief Get the GUI stall monitor mode: "off", "on" or "overlay".
+ *
+ * The IDA_CHAT_STALL_MONITOR environment variable overrides the stored value.
+ */
+[[nodiscard]] std::string get_stall_monitor_mode();
+
+/**
+ * @brief Whether span tracing is enabled (Chrome trace written per session).
+ *
+ * The IDA_CHAT_TRACE environment variable ("1"/"on" or "0"/"off") overrides
+ * the stored value.
+ */
+[[nodiscard]] bool get_trace_enabled();
+
+/**
+ * @brief Soft memory budgets that replace the defaults, in bytes.
+ *
+ * Stored as an object of MB per subsystem, e.g. {"conversation": 8}
+ * (0 = unlimited). Entries from the IDA_CHAT_MEMORY_BUDGETS environment
+ * variable ("conversation=8,search_index=0") take precedence.
+ */
+[[nodiscard]] MemoryBudgets get_memory_budgets();
+
+/**
+ * @brief Log filter such as "info,core=debug" (see set_log_filter()).
+ *
+ * The IDA_CHAT_LOG environment variable overrides the stored value; empty
+ * means the logger default (info).
+ */
+[[nodiscard]] std::string get_log_filter();
+
+/**
+ * @brief Path of the rotating log file, or empty for none.
+ *
+ * The IDA_CHAT_LOG_FILE environment variable gives a path directly. The
+ * stored "log_file" flag selects ~/.ida-chat/logs/ida-chat.log.
+ */
+[[nodiscard]] std::string get_log_file();
+
 /**
  * @brief Clear all stored settings.
  */
@@ -68,6 +109,11 @@ namespace settings_keys {
     constexpr const char* SHOW_WIZARD = "show_wizard";
     constexpr const char* AUTH_TYPE = "auth_type";
     constexpr const char* API_KEY = "api_key";
+    constexpr const char* STALL_MONITOR = "stall_monitor";
+    constexpr const char* TRACE = "trace";
+    constexpr const char* MEMORY_BUDGETS = "memory_budgets_mb";
+    constexpr const char* LOG_FILTER = "log_filter";
+    constexpr const char* LOG_FILE = "log_file";
 }
 
 /**
@@ -42,6 +42,12 @@ signals:
      */
     void thinking_done();
     
+    /**
+     * @brief Emitted with streamed extended-thinking text.
+     * @param text The next piece of thinking text
+     */
+    void thinking_text(const QString& text);
+    
     /**
      * @brief Emitted when agent uses a tool.
      * @param tool_name Name of the tool
@@ -80,6 +86,12 @@ signals:
      */
     void result(int num_turns, double cost);
     
+    /**
+     * @brief Emitted after each request with the metrics snapshot.
+     * @param snapshot_json MetricsSnapshot::to_json() text
+     */
+    void metrics(const QString& snapshot_json);
+    
     /**
      * @brief Emitted when agent worker finishes.
      */
@@ -8,11 +8,13 @@
 #include <ida_chat/core/types.hpp>
 #include <ida_chat/core/chat_core.hpp>
 #include <ida_chat/core/chat_callback.hpp>
+#include <ida_chat/core/turn_metrics.hpp>
 #include <ida_chat/history/message_history.hpp>
 #include <ida_chat/ui/agent_signals.hpp>
 
 #include <QThread>
 #include <QString>
+#include <QStringList>
 
 #include <memory>
 #include <atomic>
@@ -32,6 +34,7 @@ enum class WorkerCommand {
     Disconnect,
     SendMessage,
     NewSession,
+    LoadPrompt,
     Cancel,
     Quit
 };
@@ -87,8 +90,9 @@ public:
     /**
      * @brief Send a message to the agent.
      * @param message The message to send
+     * @param attachments Blob-backed pasted content to send with it
      */
-    void send_message(const QString& message);
+    void send_message(const QString& message, std::vector<Attachment> attachments = {});
     
     /**
      * @brief Check if currently processing.
@@ -105,6 +109,11 @@ public:
      */
     [[nodiscard]] ChatState get_state() const noexcept;
     
+    /**
+     * @brief Live metrics for the running (or last) request; any thread.
+     */
+    [[nodiscard]] TurnMetrics turn_metrics() const;
+    
     /**
      * @brief Stop the worker thread.
      */
@@ -119,6 +128,16 @@ public:
      * @brief Load system prompt from project directory.
      */
     void load_system_prompt(const QString& project_dir);
+    
+    /**
+     * @brief Find the project directory and load the prompt on the worker thread.
+     *
+     * The first path containing PROMPT.md wins. Commands run in order, so a
+     * request_connect() queued afterwards sees the loaded prompt.
+     *
+     * @param search_paths Candidate project directories, in priority order
+     */
+    void request_load_prompt(const QStringList& search_paths);
 
 protected:
     void run() override;
@@ -134,12 +153,14 @@ private:
         void on_turn_start(int turn, int max_turns) override;
         void on_thinking() override;
         void on_thinking_done() override;
+        void on_thinking_text(const std::string& text) override;
         void on_tool_use(const std::string& tool_name, const std::string& details) override;
         void on_text(const std::string& text) override;
         void on_script_code(const std::string& code) override;
         void on_script_output(const std::string& output) override;
         void on_error(const std::string& error) override;
         void on_result(int num_turns, std::optional<double> cost) override;
+        void on_metrics(const MetricsSnapshot& snapshot) override;
         
     private:
         AgentSignals& agent_sigs_;
@@ -152,11 +173,14 @@ private:
     ScriptExecutorFn script_executor_;
     MessageHistory* history_;
     std::unique_ptr<ChatCore> core_;
+    std::shared_ptr<TurnMetricsRecorder> turn_metrics_ = std::make_shared<TurnMetricsRecorder>();
     
     // Thread synchronization (use std:: instead of Qt to avoid version compatibility issues)
     std::mutex mutex_;
     std::condition_variable condition_;
     std::queue<std::pair<WorkerCommand, QString>> command_queue_;
+    std::queue<std::vector<Attachment>> attachment_queue_;  ///< One entry per queued SendMessage
+    std::vector<Attachment> current_attachments_;           ///< Worker thread only
     std::atomic<bool> running_{false};
     std::atomic<ChatState> state_{ChatState::Disconnected};
     
@@ -0,0 +1,96 @@
+/**
+ * @file animation_ticker.hpp
+ * @brief Shared animation clock for spinners, blinkers and elapsed-time labels.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Single application-wide animation clock.
+ *
+ * Every animated widget (task spinners, thinking indicators, blinking
+ * status dots) subscribes here instead of owning a QTimer. One timer then
+ * drives all of them, and it only runs while it has something to do:
+ *
+ * - It stops when no subscriber is on screen (dock hidden, tab in the
+ *   background, spinner scrolled out of view) and restarts when one is
+ *   shown again.
+ * - It stops while the application is inactive.
+ * - On each tick only subscribers with a non-empty visible region are
+ *   called, so off-screen widgets are never touched.
+ *
+ * All subscribers see the same frame counter, which keeps spinners in
+ * lockstep.
+ */
+class AnimationTicker : public QObject {
+    Q_OBJECT
+
+public:
+    /// Tick callback; receives the global frame counter.
+    using TickFn = std::function<void(int frame)>;
+
+    /// Base tick interval. Slower animations derive from the frame counter.
+    static constexpr int TICK_INTERVAL_MS = 100;
+
+    /**
+     * @brief Get the shared ticker (created on first use, owned by qApp).
+     */
+    [[nodiscard]] static AnimationTicker& instance();
+
+    /**
+     * @brief Subscribe a widget to the clock.
+     *
+     * Re-subscribing an already subscribed widget replaces its callback.
+     * The subscription is dropped automatically when the widget is destroyed.
+     *
+     * @param widget Widget being animated (its visibility gates the callback)
+     * @param on_tick Called on the GUI thread for each visible tick
+     */
+    void subscribe(QWidget* widget, TickFn on_tick);
+
+    /**
+     * @brief Remove a widget's subscription.
+     */
+    void unsubscribe(QWidget* widget);
+
+    /**
+     * @brief Current global frame counter.
+     */
+    [[nodiscard]] int frame() const noexcept { return frame_; }
+
+    /**
+     * @brief Whether the underlying timer is currently running.
+     */
+    [[nodiscard]] bool is_running() const { return timer_.isActive(); }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    explicit AnimationTicker(QObject* parent);
+
+    struct Subscriber {
+        QPointer<QWidget> widget;
+        TickFn on_tick;
+    };
+
+    void on_tick();
+    void update_running_state();
+    [[nodiscard]] bool any_subscriber_visible() const;
+
+    QTimer timer_;
+    std::vector<Subscriber> subscribers_;
+    int frame_ = 0;
+    bool app_active_ = true;
+};
+
+} // namespace ida_chat
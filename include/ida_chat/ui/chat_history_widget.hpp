@@ -8,6 +8,7 @@
 #include <ida_chat/core/types.hpp>
 #include <ida_chat/ui/chat_message.hpp>
 #include <ida_chat/ui/collapsible_section.hpp>
+#include <ida_chat/ui/scroll_controller.hpp>
 
 #include <QScrollArea>
 #include <QString>
@@ -20,8 +21,8 @@ namespace ida_chat {
 /**
  * @brief Scrollable chat history container.
  * 
- * Manages a list of ChatMessage widgets and auto-scrolls to show
- * the latest message.
+ * Manages a list of ChatMessage widgets and follows the latest message
+ * while the user is scrolled to the bottom.
  */
 class ChatHistoryWidget : public QScrollArea {
     Q_OBJECT
@@ -60,7 +61,7 @@ public:
     void mark_current_complete();
     
     /**
-     * @brief Scroll to the bottom of the history.
+     * @brief Scroll to the bottom of the history and resume following it.
      */
     void scroll_to_bottom();
     
@@ -92,6 +93,7 @@ private:
     
     QWidget* container_ = nullptr;
     QVBoxLayout* layout_ = nullptr;
+    ScrollController* scroll_ = nullptr;
     QList<ChatMessage*> messages_;
     ChatMessage* current_processing_ = nullptr;
 };
@@ -9,7 +9,6 @@
 
 #include <QFrame>
 #include <QString>
-#include <QTimer>
 #include <QLabel>
 #include <QVBoxLayout>
 
@@ -68,14 +67,12 @@ public:
      */
     [[nodiscard]] QString text() const;
 
-private slots:
-    void toggle_blink();
-
 private:
     void setup_ui(const QString& text);
     void update_indicator_style();
     void start_blinking();
     void stop_blinking();
+    void on_tick(int frame);
     
     bool is_user_;
     bool is_processing_;
@@ -84,7 +81,7 @@ private:
     QLabel* label_ = nullptr;
     QLabel* indicator_ = nullptr;
     QVBoxLayout* layout_ = nullptr;
-    QTimer* blink_timer_ = nullptr;
+    bool blinking_ = false;
     bool blink_state_ = false;
 };
 
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <ida_chat/core/memory_accounting.hpp>
+
 #include <QFrame>
 #include <QString>
 #include <QLabel>
@@ -12,12 +14,21 @@
 #include <QTextEdit>
 #include <QPushButton>
 
+#include <cstddef>
+#include <functional>
+#include <string>
+
 namespace ida_chat {
 
 /**
  * @brief Expandable/collapsible section for long content.
  * 
  * Auto-collapses content that exceeds COLLAPSE_THRESHOLD lines.
+ *
+ * Collapsed sections only hold a header and a short preview label. The full
+ * text and its editor are created from a content provider on the first
+ * expand(). Held and expanded text is counted in MemorySubsystem::ChatWidgets;
+ * after a collapse the editor is released again while that is over budget.
  */
 class CollapsibleSection : public QFrame {
     Q_OBJECT
@@ -25,18 +36,44 @@ class CollapsibleSection : public QFrame {
 public:
     static constexpr int COLLAPSE_THRESHOLD = 10;
     
+    /// Lines shown in the collapsed preview
+    static constexpr int PREVIEW_LINES = 3;
+    
+    /// Produces the full content on demand (called on the GUI thread)
+    using ContentProvider = std::function<QString()>;
+    
     /**
      * @brief Create a collapsible section.
      * @param title Section title
      * @param content Section content
      * @param collapsed Whether to start collapsed
      * @param parent Parent widget
+     *
+     * Content at or above BlobStore::SPILL_THRESHOLD is written to the blob
+     * store on the pool and read back on expand; it is held in memory until
+     * the write lands.
      */
     CollapsibleSection(const QString& title,
                        const QString& content,
                        bool collapsed = true,
                        QWidget* parent = nullptr);
     
+    /**
+     * @brief Create a section whose content is loaded on demand.
+     * @param title Section title
+     * @param provider Returns the full content; may be called again after a release
+     * @param preview Text shown while collapsed
+     * @param line_count Line count shown in the header
+     * @param collapsed Whether to start collapsed
+     * @param parent Parent widget
+     */
+    CollapsibleSection(const QString& title,
+                       ContentProvider provider,
+                       const QString& preview,
+                       int line_count,
+                       bool collapsed = true,
+                       QWidget* parent = nullptr);
+    
     ~CollapsibleSection() override;
     
     /**
@@ -47,7 +84,12 @@ public:
     [[nodiscard]] static bool should_collapse(const QString& content);
     
     /**
-     * @brief Expand the section.
+     * @brief Build the collapsed preview for a piece of content.
+     */
+    [[nodiscard]] static QString make_preview(const QString& content);
+    
+    /**
+     * @brief Expand the section (builds the content on first use).
      */
     void expand();
     
@@ -60,7 +102,12 @@ public:
      * @brief Check if section is collapsed.
      */
     [[nodiscard]] bool is_collapsed() const noexcept { return collapsed_; }
-
+    
+    /**
+     * @brief Whether the full content is currently built.
+     */
+    [[nodiscard]] bool is_materialized() const noexcept { return content_widget_ != nullptr; }
+    
 private slots:
     void toggle();
 
@@ -68,12 +115,23 @@ private:
     void setup_ui();
     void update_header_text();
     void update_content();
+    void materialize();
+    void release();
+    void spill(const QString& content);
+    void finish_spill(const std::string& blob_id);
+    void update_tracked();
     
     QString title_;
-    QString content_;
+    ContentProvider provider_;
+    QString preview_;
+    int line_count_ = 0;
     bool collapsed_;
+    std::size_t held_ = 0;          ///< Content kept in memory by provider_
+    std::size_t resident_ = 0;      ///< Text of the expanded editor
+    TrackedBytes tracked_{MemorySubsystem::ChatWidgets};   ///< held_ + resident_
     
     QPushButton* header_ = nullptr;
+    QLabel* preview_label_ = nullptr;
     QTextEdit* content_widget_ = nullptr;
     QVBoxLayout* layout_ = nullptr;
 };
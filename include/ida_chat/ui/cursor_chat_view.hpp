@@ -5,15 +5,27 @@
 
 #pragma once
 
+#include <ida_chat/ui/scroll_controller.hpp>
+#include <ida_chat/core/search_index.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+#include <ida_chat/ui/frame_paced_buffer.hpp>
+
 #include <QWidget>
 #include <QScrollArea>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
 #include <QTimer>
 #include <QString>
 #include <QDateTime>
+#include <QHash>
+#include <QPointer>
+#include <functional>
+#include <optional>
 #include <vector>
 #include <memory>
+#include <string>
 
 namespace ida_chat {
 
@@ -63,6 +75,12 @@ struct FileBlockData {
 // Message Data
 // ============================================================================
 
+/**
+ * @brief One rendered chat element, as recorded for rehydration.
+ *
+ * Output entries that were collapsed keep only the blob id (in `content`),
+ * not the output text.
+ */
 struct CursorMessageData {
     CursorMessageType type;
     QString content;
@@ -106,12 +124,60 @@ public:
     bool is_active() const { return active_; }
     
 private:
+    void on_tick(int frame);
+    
     QLabel* icon_label_;
     QLabel* text_label_;
-    QTimer* timer_;
     QDateTime start_time_;
     bool active_ = false;
-    int frame_ = 0;
+    qint64 shown_seconds_ = -1;
+};
+
+// ============================================================================
+// Thinking Stream Panel
+// ============================================================================
+
+/**
+ * @brief Collapsible live view of the extended-thinking stream.
+ *
+ * The header shows an estimated token count. Collapsed, incoming text only
+ * goes to a string buffer and the header count; the text view does not
+ * exist. Expanding creates the view from the buffer, and from then on new
+ * text is appended at frame pace.
+ */
+class ThinkingStreamPanel : public QWidget {
+    Q_OBJECT
+public:
+    /// Height of the expanded text view
+    static constexpr int VIEW_HEIGHT = 220;
+    
+    explicit ThinkingStreamPanel(QWidget* parent = nullptr);
+    
+    void append(const QString& text);
+    
+    /**
+     * @brief Replace the content (used when a task is rehydrated).
+     */
+    void set_text(const QString& text);
+    
+    /**
+     * @brief Deliver anything still pending (end of the thinking phase).
+     */
+    void finish();
+    
+    [[nodiscard]] const QString& text() const noexcept { return text_; }
+    [[nodiscard]] bool is_expanded() const noexcept { return view_ != nullptr; }
+    
+private:
+    void toggle();
+    void deliver(const QString& chunk);
+    void update_header();
+    
+    QPushButton* header_;
+    QPlainTextEdit* view_ = nullptr;
+    QString text_;
+    std::size_t tokens_ = 0;
+    FramePacedBuffer buffer_;
 };
 
 // ============================================================================
@@ -141,12 +207,9 @@ signals:
     
 protected:
     void mousePressEvent(QMouseEvent* event) override;
-    void enterEvent(QEnterEvent* event) override;
-    void leaveEvent(QEvent* event) override;
     
 private:
     FileBlockData data_;
-    bool hovered_ = false;
 };
 
 // ============================================================================
@@ -156,14 +219,24 @@ private:
 class CodeBlockWidget : public QWidget {
     Q_OBJECT
 public:
+    /// Code above either limit is shown in a scrolling QPlainTextEdit of at
+    /// most PLAIN_VIEW_VISIBLE_LINES lines, colored by CodeSpanHighlighter
+    static constexpr int PLAIN_VIEW_LINES = 200;
+    static constexpr qsizetype PLAIN_VIEW_CHARS = 16 * 1024;
+    static constexpr int PLAIN_VIEW_VISIBLE_LINES = 30;
+    
     CodeBlockWidget(const QString& code, const QString& language = "", QWidget* parent = nullptr);
     
-    void set_output(const QString& output, bool is_error = false);
+    /**
+     * @return Blob id of the collapsed output, empty when shown inline
+     */
+    std::string set_output(const QString& output, bool is_error = false);
     
 private:
-    QLabel* code_label_;
+    QLabel* code_label_ = nullptr;          ///< Null when shown in a plain-text view
     QWidget* output_widget_;
     QLabel* output_label_;
+    QWidget* collapsed_output_ = nullptr;
 };
 
 // ============================================================================
@@ -177,20 +250,71 @@ public:
     
     void add_thinking(int duration_seconds = 0);
     void add_tool_action(ToolActionType type, const QString& detail);
-    void add_text(const QString& text);
+    QLabel* add_text(const QString& text);
     void add_file_block(const FileBlockData& data);
     void add_code_block(const QString& code, const QString& language = "");
-    void add_output(const QString& output, bool is_error = false);
+    /**
+     * @return Blob id of the collapsed output, empty when shown inline
+     */
+    std::string add_output(const QString& output, bool is_error = false);
     void add_summary(const QStringList& points);
     
     ThinkingIndicator* thinking_indicator() { return thinking_; }
     
+    /// Thinking text panel, created under the indicator on first use
+    ThinkingStreamPanel* thinking_stream();
+    [[nodiscard]] bool has_thinking_stream() const noexcept { return thinking_stream_ != nullptr; }
+    
+    /**
+     * @brief Render markdown into a response label (also used while streaming).
+     * @param highlight False while the text is still streaming
+     */
+    static void render_text(QLabel* label, const QString& text, bool highlight = true);
+    
 private:
     QVBoxLayout* layout_;
     ThinkingIndicator* thinking_ = nullptr;
+    ThinkingStreamPanel* thinking_stream_ = nullptr;
     CodeBlockWidget* last_code_block_ = nullptr;
 };
 
+// ============================================================================
+// Chat Task Entry
+// ============================================================================
+
+/**
+ * @brief One task's slice of the conversation (user message + responses).
+ *
+ * Every task renders into its own block widget in the content layout, so a
+ * task id maps to exactly one widget. While live, `ops` records what was
+ * rendered. Once spilled, the block only holds a placeholder of about the
+ * same height and the ops live in the blob store under `blob_id`. Spills
+ * and reloads do their I/O on the shared pool; the widgets are swapped when
+ * it finishes.
+ */
+struct ChatTaskEntry {
+    QString task_id;                        ///< Empty for messages outside a task
+    QString title;
+    QWidget* block = nullptr;
+    std::vector<CursorMessageData> ops;
+    std::string blob_id;                    ///< Non-empty while spilled
+    quint64 last_used = 0;
+    std::size_t estimated_bytes = 0;        ///< Rough widget + text cost while live
+    
+    // Pool I/O in flight
+    bool spilling = false;                  ///< Ops being written; widgets still live
+    bool loading = false;                   ///< Ops being read back
+    quint64 io_generation = 0;              ///< Bumped to abandon an in-flight spill
+    std::vector<std::function<void()>> after_load;
+    
+    // Placeholder while spilled; its height follows the viewport width
+    QPointer<QWidget> placeholder;
+    int spilled_height = 0;
+    int spilled_width = 0;
+    
+    [[nodiscard]] bool is_spilled() const noexcept { return !blob_id.empty(); }
+};
+
 // ============================================================================
 // Cursor Chat View (main conversation container)
 // ============================================================================
@@ -199,10 +323,28 @@ class CursorChatView : public QWidget {
     Q_OBJECT
     
 public:
+    /// Tasks kept as live widgets; older ones are spilled to placeholders
+    static constexpr std::size_t MAX_LIVE_TASKS = 24;
+    
+    /// Live tasks further than this many viewport heights away are spilled
+    static constexpr int EVICT_DISTANCE_SCREENS = 3;
+    
+    /// Spilled tasks within this many viewport heights are rehydrated
+    static constexpr int REHYDRATE_DISTANCE_SCREENS = 1;
+    
+    /// Delay before re-evaluating eviction after scrolling or new content
+    static constexpr int RECLAIM_DELAY_MS = 200;
+    
+    /// Delay before re-applying search highlights after scrolling
+    static constexpr int HIGHLIGHT_DELAY_MS = 50;
+    
+    /// Occurrences highlighted per text widget at most
+    static constexpr int MAX_HIGHLIGHTS_PER_WIDGET = 200;
+    
     explicit CursorChatView(QWidget* parent = nullptr);
     
-    // Add messages
-    void add_user_message(const QString& text);
+    // Add messages (a user message with a task id starts a new task block)
+    void add_user_message(const QString& text, const QString& task_id = QString());
     AssistantResponseWidget* start_assistant_response();
     void finish_assistant_response();
     
@@ -211,6 +353,19 @@ public:
     void hide_thinking(int duration_seconds);
     void add_tool_action(ToolActionType type, const QString& detail);
     void add_assistant_text(const QString& text);
+    
+    /**
+     * @brief Append streamed response text to the current text element.
+     *
+     * Consecutive deltas grow a single label, re-rendered at frame pace.
+     * Adding anything else ends the streamed element.
+     */
+    void append_assistant_text(const QString& text);
+    
+    /**
+     * @brief Append streamed thinking text to the current response's panel.
+     */
+    void append_thinking_text(const QString& text);
     void add_file_block(const FileBlockData& data);
     void add_code_block(const QString& code, const QString& language = "");
     void add_code_output(const QString& output, bool is_error = false);
@@ -219,20 +374,130 @@ public:
     // Clear
     void clear();
     
-    // Scroll to bottom
+    // Scroll to bottom and resume following new content
     void scroll_to_bottom();
     
+    /**
+     * @brief Jump to a task's user message, rehydrating it if it was spilled.
+     * @return false if the task is not in this view
+     */
+    bool scroll_to_task(const QString& task_id);
+    
+    [[nodiscard]] std::size_t task_count() const noexcept { return tasks_.size(); }
+    [[nodiscard]] std::size_t live_task_count() const;
+    [[nodiscard]] std::size_t live_bytes() const;
+    
+    /**
+     * @brief Search the whole conversation, including spilled tasks.
+     *
+     * The lookup runs on the shared pool. When it finishes, the first hit at
+     * or below the top of the viewport is shown and search_result_changed
+     * reports the hit count (capped at SearchIndex::MAX_HITS).
+     */
+    void search(const QString& query);
+    
+    /**
+     * @brief Move to the next (+1) or previous (-1) hit, wrapping around.
+     */
+    void step_search(int delta);
+    
+    /**
+     * @brief Drop the query and remove all highlights.
+     */
+    void clear_search();
+    
+    [[nodiscard]] int search_hit_count() const noexcept { return static_cast<int>(search_hits_.size()); }
+    [[nodiscard]] int current_search_hit() const noexcept { return search_current_; }
+    
 signals:
     void file_clicked(const QString& filename);
     
+    /// Emitted whenever the current hit or the hit count changes
+    void search_result_changed(int current, int total);
+    
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+    
 private:
     void setup_ui();
     
+    /// Attribute the pending relayout to the chat view, then follow the tail
+    void content_changed();
+    void trace_layout();
+    
+    // Task blocks
+    ChatTaskEntry& current_task();
+    ChatTaskEntry& new_task(const QString& task_id, const QString& title);
+    void record(CursorMessageData op);
+    
+    // Streamed response text
+    void on_stream_chunk(const QString& chunk);
+    void end_text_stream();
+    void enforce_live_limit(std::size_t keep);
+    void spill_task(std::size_t index);
+    void finish_spill(std::size_t index, quint64 generation, std::string blob_id);
+    
+    /**
+     * @brief Load a spilled task back; then runs once its widgets exist.
+     */
+    void rehydrate_task(std::size_t index, std::function<void()> then = {});
+    void finish_rehydrate(std::size_t index,
+                          std::optional<std::vector<CursorMessageData>> ops,
+                          std::vector<QString> outputs);
+    void resize_placeholders();
+    void clear_block(QWidget* block);
+    
+    // Viewport-driven reclamation
+    void schedule_reclaim();
+    void reclaim();
+    [[nodiscard]] int distance_to_viewport(const ChatTaskEntry& entry) const;
+    
+    // Search
+    void index_op(std::uint64_t key, const CursorMessageData& op);
+    void run_find(std::function<void(std::vector<SearchIndex::Hit>)> done);
+    void refresh_search(std::vector<SearchIndex::Hit> hits);
+    void show_search_hit(int index);
+    void schedule_highlights();
+    void apply_highlights();
+    void clear_highlights();
+    
     QScrollArea* scroll_area_;
     QWidget* content_widget_;
     QVBoxLayout* content_layout_;
+    ScrollController* scroll_ = nullptr;
     
     AssistantResponseWidget* current_response_ = nullptr;
+    
+    // Task blocks in display order; task_index_ maps task id -> position
+    std::vector<ChatTaskEntry> tasks_;
+    QHash<QString, std::size_t> task_index_;
+    quint64 use_clock_ = 0;
+    QTimer reclaim_timer_;
+    TrackedBytes live_bytes_{MemorySubsystem::ChatWidgets};   ///< Spilled early when over budget
+    bool layout_trace_pending_ = false;
+    
+    // Response text being streamed into stream_label_ (an op of the last task)
+    bool streaming_ = false;
+    QPointer<QLabel> stream_label_;
+    QString stream_text_;
+    std::size_t stream_op_ = 0;
+    FramePacedBuffer text_buffer_{[this](const QString& chunk) { on_stream_chunk(chunk); }};
+    
+    // Search state. The index is replaced (not cleared) on clear() so that
+    // background indexing jobs still holding the old one are harmless; the
+    // token lets queued jobs for the old index skip their work.
+    std::shared_ptr<SearchIndex> search_index_ = std::make_shared<SearchIndex>();
+    CancelToken index_jobs_ = CancelToken::create();
+    CancelToken task_io_ = CancelToken::create();   ///< Spill/reload jobs; replaced on clear()
+    CancelToken search_job_ = CancelToken::create();    ///< Pending find(); replaced per query
+    QString search_query_;
+    std::vector<SearchIndex::Hit> search_hits_;
+    int search_current_ = -1;
+    bool search_stale_ = false;             ///< Content was indexed since the last find()
+    QPointer<QWidget> hit_widget_;          ///< Widget holding the current hit
+    int hit_occurrence_ = 0;                ///< Which occurrence inside hit_widget_
+    std::vector<QPointer<QWidget>> highlighted_;
+    QTimer highlight_timer_;
 };
 
 } // namespace ida_chat
@@ -5,15 +5,90 @@
 
 #pragma once
 
+#include <ida_chat/core/types.hpp>
+
 #include <QWidget>
 #include <QTextEdit>
 #include <QLabel>
 #include <QPushButton>
 #include <QComboBox>
+#include <QFrame>
+#include <QHBoxLayout>
+#include <QList>
 #include <QString>
 
+#include <vector>
+
+class QMimeData;
+
 namespace ida_chat {
 
+// ============================================================================
+// Prompt Edit
+// ============================================================================
+
+/**
+ * @brief Prompt text edit that diverts huge pastes instead of inserting them.
+ *
+ * Laying out a multi-MB plain-text paste in a QTextEdit blocks the GUI for
+ * seconds, so pastes over the thresholds are reported via large_paste() and
+ * never reach the document. Drops go through the same path.
+ */
+class PromptEdit : public QTextEdit {
+    Q_OBJECT
+    
+public:
+    /// Pastes with at least this many characters become attachments
+    static constexpr int ATTACH_CHARS = 16 * 1024;
+    
+    /// ...or at least this many lines
+    static constexpr int ATTACH_LINES = 200;
+    
+    using QTextEdit::QTextEdit;
+    
+signals:
+    void large_paste(const QString& text);
+    
+protected:
+    void insertFromMimeData(const QMimeData* source) override;
+};
+
+// ============================================================================
+// Attachment Chip
+// ============================================================================
+
+/**
+ * @brief Chip shown above the prompt for one pasted attachment.
+ *
+ * Starts in a pending state while the payload is written to the blob store
+ * off the GUI thread.
+ */
+class AttachmentChip : public QFrame {
+    Q_OBJECT
+    
+public:
+    AttachmentChip(const QString& label, QWidget* parent = nullptr);
+    
+    void set_ready(const Attachment& attachment, const QString& preview);
+    void set_failed();
+    
+    [[nodiscard]] bool is_pending() const noexcept { return pending_; }
+    [[nodiscard]] bool is_ready() const noexcept { return !pending_ && !attachment_.blob_id.empty(); }
+    [[nodiscard]] const Attachment& attachment() const noexcept { return attachment_; }
+    
+    /// "label · 1.2 MB · ~310k tokens"
+    [[nodiscard]] static QString describe(const Attachment& attachment);
+    
+signals:
+    void remove_requested(AttachmentChip* chip);
+    
+private:
+    QLabel* label_;
+    QPushButton* remove_button_;
+    Attachment attachment_;
+    bool pending_ = true;
+};
+
 // ============================================================================
 // Cursor Input Widget
 // ============================================================================
@@ -22,6 +97,9 @@ class CursorInputWidget : public QWidget {
     Q_OBJECT
     
 public:
+    /// Characters of a pasted attachment shown in its chip tooltip
+    static constexpr int PREVIEW_CHARS = 600;
+    
     explicit CursorInputWidget(QWidget* parent = nullptr);
     
     QString text() const;
@@ -30,6 +108,10 @@ public:
     void set_placeholder(const QString& text);
     void focus();
     
+    // Attachments from large pastes
+    [[nodiscard]] bool has_attachments() const;
+    std::vector<Attachment> take_attachments();
+    
     // Model selection
     void set_model(const QString& model);
     QString current_model() const;
@@ -47,8 +129,15 @@ private:
     void setup_ui();
     void submit();
     void update_submit_button();
+    void add_paste_attachment(const QString& text);
+    void remove_chip(AttachmentChip* chip);
+    
+    PromptEdit* text_edit_;
+    QWidget* chips_row_;
+    QHBoxLayout* chips_layout_;
+    QList<AttachmentChip*> chips_;
+    int paste_counter_ = 0;
     
-    QTextEdit* text_edit_;
     QPushButton* agent_button_;
     QComboBox* model_combo_;
     QPushButton* submit_button_;
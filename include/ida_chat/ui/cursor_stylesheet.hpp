@@ -0,0 +1,41 @@
+/**
+ * @file cursor_stylesheet.hpp
+ * @brief Compiled theme stylesheet and dynamic-property state helpers.
+ *
+ * The Cursor-style widgets no longer format their own stylesheets. They set
+ * an object name (and, for stateful widgets, a dynamic property) and the
+ * single sheet built here from cursor_theme.hpp does the rest. Qt parses the
+ * sheet once per root instead of once per widget, and a state change becomes
+ * a property toggle plus a repolish of that one widget.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVariant>
+#include <QWidget>
+
+namespace ida_chat {
+
+/**
+ * @brief The full theme stylesheet (built on first use, then cached).
+ */
+[[nodiscard]] const QString& cursor_stylesheet();
+
+/**
+ * @brief Apply the theme stylesheet to a top-level plugin widget.
+ *
+ * Scoped to the plugin's own root rather than qApp so IDA's widgets keep
+ * their native style. Children inherit it; top-level tool windows that are
+ * not parented into the dock should call this themselves.
+ */
+void apply_cursor_stylesheet(QWidget* root);
+
+/**
+ * @brief Set a dynamic style property and repolish only if it changed.
+ *
+ * Stylesheet rules select on these properties (e.g. `#TaskSummary[status="error"]`).
+ */
+void set_style_state(QWidget* widget, const char* name, const QVariant& value);
+
+} // namespace ida_chat
@@ -30,6 +30,7 @@ inline const QString BG_USER_MESSAGE = "#0f2a4a";   // User message (dark blue t
 inline const QString BG_ASSISTANT = "transparent";  // Assistant message (no bg)
 inline const QString BG_TOOL_ACTION = "#1a1a1a";    // Tool action indicator
 inline const QString BG_FILE_BLOCK = "#141414";     // File change block
+inline const QString BG_ERROR = "#1c0f0f";          // Error output surface
 
 // ============================================================================
 // Text Colors
@@ -58,6 +59,7 @@ inline const QString ACCENT_PURPLE = "#a855f7";     // Special highlights
 inline const QString BORDER_SUBTLE = "#1f1f1f";     // Subtle borders (separators)
 inline const QString BORDER_DEFAULT = "#2a2a2a";    // Default borders
 inline const QString BORDER_FOCUS = "#3b82f6";      // Focus ring
+inline const QString BORDER_ERROR = "#3d1f1f";      // Error output border
 
 // ============================================================================
 // Semantic Colors
@@ -68,6 +70,20 @@ inline const QString COLOR_ERROR = ACCENT_RED;
 inline const QString COLOR_WARNING = ACCENT_YELLOW;
 inline const QString COLOR_INFO = ACCENT_BLUE;
 
+// ============================================================================
+// Syntax Highlighting Colors
+// ============================================================================
+
+inline const QString SYNTAX_KEYWORD = "#c084fc";    // Keywords, mnemonics
+inline const QString SYNTAX_TYPE = "#60a5fa";       // Types, builtins
+inline const QString SYNTAX_STRING = "#86efac";     // String/char literals
+inline const QString SYNTAX_NUMBER = "#fbbf24";     // Numeric literals
+inline const QString SYNTAX_COMMENT = "#6b7280";    // Comments
+inline const QString SYNTAX_PREPROC = "#f472b6";    // Preprocessor, decorators
+inline const QString SYNTAX_FUNCTION = "#fde68a";   // Function names at call sites
+inline const QString SYNTAX_REGISTER = "#67e8f9";   // CPU registers
+inline const QString SYNTAX_LABEL = "#fca5a5";      // Labels, addresses
+
 // ============================================================================
 // Spinner Animation Frames
 // ============================================================================
@@ -91,5 +107,8 @@ inline const QString FONT_SM = "12px";
 inline const QString FONT_BASE = "13px";
 inline const QString FONT_LG = "14px";
 
+// Monospace font stack
+inline const QString FONT_MONO = "'SF Mono', 'Menlo', 'Monaco', 'Consolas', monospace";
+
 } // namespace theme
 } // namespace ida_chat
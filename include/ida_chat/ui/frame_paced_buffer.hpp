@@ -0,0 +1,70 @@
+/**
+ * @file frame_paced_buffer.hpp
+ * @brief Coalesces streamed text into at most one UI update per frame.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+namespace ida_chat {
+
+/**
+ * @brief Buffers streamed text and hands it to a sink at frame pace.
+ *
+ * The API streams responses a few tokens at a time. Rendering each delta
+ * separately costs a relayout per token. Deltas are appended here instead,
+ * and the sink receives everything that arrived since the last delivery, at
+ * most once per FRAME_MS.
+ *
+ * The pace adapts to the sink: if a delivery took longer than a frame (e.g.
+ * re-rendering a long markdown answer), the next one waits twice that long,
+ * up to MAX_INTERVAL_MS. Rendering then never takes more than about a third
+ * of the GUI thread, however large the text gets.
+ */
+class FramePacedBuffer {
+public:
+    /// Receives all text appended since the previous delivery
+    using Sink = std::function<void(const QString& chunk)>;
+    
+    /// Minimum interval between deliveries (~60 Hz)
+    static constexpr int FRAME_MS = 16;
+    
+    /// Slowest pace for expensive sinks
+    static constexpr int MAX_INTERVAL_MS = 250;
+    
+    explicit FramePacedBuffer(Sink sink);
+    
+    FramePacedBuffer(const FramePacedBuffer&) = delete;
+    FramePacedBuffer& operator=(const FramePacedBuffer&) = delete;
+    
+    /**
+     * @brief Queue text for the next delivery.
+     */
+    void append(const QString& text);
+    
+    /**
+     * @brief Deliver pending text now (e.g. when the stream ends).
+     */
+    void flush();
+    
+    /**
+     * @brief Drop pending text without delivering it.
+     */
+    void discard();
+    
+    [[nodiscard]] bool has_pending() const noexcept { return !pending_.isEmpty(); }
+
+private:
+    void deliver();
+    
+    Sink sink_;
+    QString pending_;
+    QTimer timer_;
+    int interval_ms_ = FRAME_MS;
+};
+
+} // namespace ida_chat
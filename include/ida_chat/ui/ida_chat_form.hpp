@@ -17,6 +17,7 @@
 #include <QSplitter>
 #include <QStackedWidget>
 #include <memory>
+#include <string>
 
 #include <ida_chat/core/types.hpp>
 #include <ida_chat/history/message_history.hpp>
@@ -25,6 +26,11 @@
 #include <ida_chat/ui/cursor_input.hpp>
 #include <ida_chat/ui/onboarding_panel.hpp>
 #include <ida_chat/ui/agent_worker.hpp>
+#include <ida_chat/ui/startup_trace.hpp>
+#include <ida_chat/ui/stall_overlay.hpp>
+#include <ida_chat/ui/memory_panel.hpp>
+#include <ida_chat/ui/search_bar.hpp>
+#include <ida_chat/ui/turn_status_strip.hpp>
 
 namespace ida_chat {
 
@@ -88,6 +94,9 @@ private:
     void create_main_view();
     void create_status_bar();
     void init_agent();
+    void on_first_show();
+    TaskSidebar* ensure_sidebar();
+    OnboardingPanel* ensure_onboarding();
     
     // Event handlers
     void on_connection_ready();
@@ -95,12 +104,14 @@ private:
     void on_turn_start(int turn, int max_turns);
     void on_thinking();
     void on_thinking_done();
+    void on_thinking_text(const QString& text);
     void on_tool_use(const QString& tool_name, const QString& details);
     void on_text(const QString& text);
     void on_script_code(const QString& code);
     void on_script_output(const QString& output);
     void on_error(const QString& error);
     void on_result(int num_turns, double cost);
+    void on_metrics(const QString& snapshot_json);
     void on_finished();
     
     // UI actions
@@ -115,6 +126,16 @@ private:
     void show_onboarding();
     void update_for_task(const QString& task_id);
     ScriptExecutorFn create_script_executor();
+    void start_stall_monitor();
+    void export_stall_report();
+    void start_tracer();
+    void export_trace();
+    
+    // Find in conversation (the bar is created on first Ctrl+F)
+    void open_search();
+    
+    // Memory debug panel (created on first Ctrl+Shift+M)
+    void toggle_memory_panel();
     
     // IDA widget (TWidget* stored as void* to avoid IDA header in this file)
     IDAWidget* ida_widget_ = nullptr;
@@ -124,26 +145,32 @@ private:
     QVBoxLayout* main_layout_ = nullptr;
     QStackedWidget* stack_ = nullptr;
     
-    // Cursor-style main view (sidebar + chat + input)
+    // Cursor-style main view (sidebar + chat + input); sidebar is lazy
     QWidget* main_view_ = nullptr;
     QSplitter* splitter_ = nullptr;
     TaskSidebar* sidebar_ = nullptr;
     QWidget* chat_container_ = nullptr;
     CursorChatView* chat_view_ = nullptr;
     CursorInputWidget* input_ = nullptr;
+    SearchBar* search_bar_ = nullptr;
+    TurnStatusStrip* status_strip_ = nullptr;
     
-    // Onboarding
+    // Onboarding (created on first use)
     OnboardingPanel* onboarding_ = nullptr;
     
     // Agent
     std::unique_ptr<MessageHistory> message_history_;
     std::unique_ptr<AgentWorker> worker_;
+    std::string script_session_;        ///< ScriptScheduler fairness group of this form
     
     // State
     QString current_task_id_;
     bool processing_ = false;
     int thinking_start_time_ = 0;
     TokenUsage session_usage_;
+    StartupTrace startup_trace_;
+    StallOverlay* stall_overlay_ = nullptr;
+    MemoryPanel* memory_panel_ = nullptr;
 };
 
 } // namespace ida_chat
@@ -0,0 +1,108 @@
+/**
+ * @file large_output_viewer.hpp
+ * @brief Collapsed placeholder and chunked viewer for large script outputs.
+ */
+
+#pragma once
+
+#include <ida_chat/history/blob_store.hpp>
+
+#include <QWidget>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QString>
+#include <QTimer>
+
+namespace ida_chat {
+
+/**
+ * @brief Human-readable byte size ("812 B", "4.2 KB", "3.1 MB").
+ */
+[[nodiscard]] QString format_byte_size(quint64 bytes);
+
+// ============================================================================
+// Collapsed Output Widget
+// ============================================================================
+
+/**
+ * @brief Inline stand-in for an output too large to lay out in a QLabel.
+ *
+ * Shows a size badge and a short preview. The full text stays in the blob
+ * store; "Open" launches a LargeOutputViewer that streams it back in.
+ */
+class CollapsedOutputWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    /// Outputs of BlobStore::SPILL_THRESHOLD bytes or more, or with more
+    /// lines than this, are collapsed instead of rendered inline
+    static constexpr int COLLAPSE_LINES = 400;
+    
+    /// Lines shown in the inline preview
+    static constexpr int PREVIEW_LINES = 8;
+    
+    /**
+     * @brief Check whether an output should be collapsed.
+     */
+    [[nodiscard]] static bool should_collapse(const QString& output);
+    
+    /**
+     * @brief Build the collapsed view and store the output in the blob store.
+     *
+     * The blob is written on the shared pool; its reference is known at
+     * once, and "Open" is enabled when the write has finished. The caller's
+     * QString is not retained.
+     */
+    CollapsedOutputWidget(const QString& output, bool is_error, QWidget* parent = nullptr);
+    
+    [[nodiscard]] const BlobRef& blob() const noexcept { return blob_; }
+
+private:
+    void on_stored(bool ok);
+    void open_viewer();
+    
+    BlobRef blob_;
+    bool is_error_ = false;
+    int line_count_ = 0;
+    QPushButton* open_button_ = nullptr;
+};
+
+// ============================================================================
+// Large Output Viewer
+// ============================================================================
+
+/**
+ * @brief Read-only, searchable viewer that loads a blob in chunks.
+ *
+ * Opens as a separate tool window. Text is appended CHUNK_BYTES at a time
+ * from the event loop so the UI stays responsive while loading, and loading
+ * stops at MAX_BLOCKS lines to bound memory.
+ */
+class LargeOutputViewer : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int CHUNK_BYTES = 256 * 1024;
+    static constexpr int MAX_BLOCKS = 500000;
+    
+    LargeOutputViewer(const BlobRef& blob, const QString& title, QWidget* parent = nullptr);
+
+private:
+    void load_next_chunk();
+    void find(bool backward);
+    void update_status();
+    
+    BlobRef blob_;
+    quint64 offset_ = 0;
+    QByteArray carry_;          // Partial trailing line from the previous chunk
+    bool truncated_ = false;
+    
+    QPlainTextEdit* text_ = nullptr;
+    QLineEdit* search_edit_ = nullptr;
+    QLabel* status_label_ = nullptr;
+    QTimer load_timer_;
+};
+
+} // namespace ida_chat
@@ -9,6 +9,8 @@
 #include <QColor>
 #include <QMap>
 
+#include <vector>
+
 namespace ida_chat {
 
 /**
@@ -44,6 +46,14 @@ struct ColorScheme {
     static ColorScheme light_default();
 };
 
+/**
+ * @brief A fenced block render() left uncolored because it was not cached.
+ */
+struct PendingCodeBlock {
+    QString code;
+    QString language;       ///< Fence hint, as written
+};
+
 /**
  * @brief Markdown to HTML renderer.
  */
@@ -54,9 +64,21 @@ public:
     /**
      * @brief Convert markdown text to HTML.
      * @param markdown Input markdown text
+     * @param highlight Color closed code blocks from the highlight cache.
+     *        Pass false while text is still streaming; an unterminated
+     *        fence is never colored.
      * @return HTML suitable for QLabel rich text display
      */
-    [[nodiscard]] QString render(const QString& markdown) const;
+    [[nodiscard]] QString render(const QString& markdown, bool highlight = true) const;
+    
+    /**
+     * @brief Closed code blocks the last render() left uncolored because
+     *        their highlight was not cached yet. The caller requests them
+     *        from SyntaxHighlighter and renders again when they land.
+     */
+    [[nodiscard]] const std::vector<PendingCodeBlock>& pending_code_blocks() const noexcept {
+        return pending_code_blocks_;
+    }
     
     /**
      * @brief Set the color scheme.
@@ -87,8 +109,10 @@ public:
 private:
     QString render_line(const QString& line) const;
     QString render_inline(const QString& text) const;
+    QString code_block_html(const QString& code, const QString& language, bool highlight) const;
     
     ColorScheme colors_;
+    mutable std::vector<PendingCodeBlock> pending_code_blocks_;
 };
 
 /**
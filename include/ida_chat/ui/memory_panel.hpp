@@ -0,0 +1,45 @@
+/**
+ * @file memory_panel.hpp
+ * @brief Debug panel with per-subsystem memory usage and budgets.
+ */
+
+#pragma once
+
+#include <QLabel>
+#include <QTimer>
+
+namespace ida_chat {
+
+/**
+ * @brief Corner table of MemoryAccountant counters: live bytes, peak, budget.
+ *
+ * Toggled from the chat dock (Ctrl+Shift+M). It polls the accountant only
+ * while visible and sits in the top-left corner of its parent (the stall
+ * overlay takes the top-right one). The border turns to the warning colour
+ * while any subsystem is over its budget.
+ */
+class MemoryPanel : public QLabel {
+    Q_OBJECT
+
+public:
+    /// Refresh period while visible
+    static constexpr int REFRESH_INTERVAL_MS = 1000;
+    
+    explicit MemoryPanel(QWidget* parent);
+    
+    /**
+     * @brief Render the accountant's current numbers as the panel text.
+     */
+    [[nodiscard]] static QString format_usage(bool* any_over_budget = nullptr);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void refresh();
+    
+    QTimer timer_;
+};
+
+} // namespace ida_chat
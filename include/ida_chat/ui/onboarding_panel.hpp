@@ -6,6 +6,8 @@
 #pragma once
 
 #include <ida_chat/core/types.hpp>
+#include <ida_chat/core/chat_core.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
 #include <QFrame>
 #include <QString>
@@ -59,10 +61,13 @@ signals:
 private slots:
     void on_auth_type_changed();
     void on_test_clicked();
-    void on_test_finished(bool success, const QString& message);
     void on_save_clicked();
 
 private:
+    void on_test_finished(const ConnectionTestResult& result);
+    void update_test_progress(int frame);
+    void cancel_test();
+    void end_test();
     void setup_ui();
     void apply_current_settings();
     [[nodiscard]] AuthType get_auth_type() const;
@@ -90,6 +95,9 @@ private:
     
     // State
     bool testing_ = false;
+    quint64 test_generation_ = 0;       // Bumped on start/cancel; stale results are dropped
+    CancelToken test_token_;            // Kills a running test (or skips a queued one) when cancelled or closed
+    qint64 test_started_ms_ = 0;
 };
 
 } // namespace ida_chat
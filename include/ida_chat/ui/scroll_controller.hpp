@@ -0,0 +1,83 @@
+/**
+ * @file scroll_controller.hpp
+ * @brief Coalesced stick-to-bottom autoscroll for chat scroll areas.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QScrollArea>
+#include <QTimer>
+
+namespace ida_chat {
+
+/**
+ * @brief Keeps a scroll area pinned to the bottom while the user is there.
+ *
+ * Instead of scheduling a scroll after every appended element, the controller
+ * follows the scrollbar's rangeChanged signal. Qt emits it once the content
+ * has been laid out in the normal course of the event loop, so following the
+ * bottom never forces a synchronous layout and costs one setValue() per
+ * layout pass no matter how many tokens arrived in between.
+ *
+ * Following is "sticky": it is enabled while the view is within
+ * STICK_THRESHOLD_PX of the bottom and disabled as soon as the user scrolls
+ * up. Explicit scroll requests are coalesced into at most one per frame.
+ *
+ * scroll_to_widget() anchors the view to an item instead (navigation). The
+ * anchor is re-applied on layout passes until the user scrolls, so content
+ * that is still being laid out above or inside the target cannot push it away.
+ */
+class ScrollController : public QObject {
+    Q_OBJECT
+
+public:
+    /// Distance from the bottom (px) that still counts as "at the bottom"
+    static constexpr int STICK_THRESHOLD_PX = 24;
+    
+    /// Coalescing window for explicit scroll requests (~one frame)
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    
+    /**
+     * @brief Attach to a scroll area (the controller is parented to it).
+     */
+    explicit ScrollController(QScrollArea* area);
+    
+    /**
+     * @brief Scroll to the bottom if the view is currently following it.
+     *
+     * Cheap to call on every append; requests within a frame collapse into one.
+     */
+    void request_follow();
+    
+    /**
+     * @brief Jump to the bottom and resume following (e.g. after sending a message).
+     */
+    void scroll_to_bottom();
+    
+    /**
+     * @brief Stop following and bring a content widget to the top of the view.
+     *
+     * Applied on the next frame, after pending layout has run.
+     */
+    void scroll_to_widget(QWidget* target);
+    
+    /**
+     * @brief Whether the view is currently following the bottom.
+     */
+    [[nodiscard]] bool is_following() const noexcept { return following_; }
+
+private:
+    void on_range_changed(int min, int max);
+    void on_value_changed(int value);
+    void apply();
+    
+    QPointer<QScrollArea> area_;
+    QPointer<QWidget> target_;
+    QTimer frame_timer_;
+    bool following_ = true;
+    bool applying_ = false;
+};
+
+} // namespace ida_chat
@@ -0,0 +1,68 @@
+/**
+ * @file search_bar.hpp
+ * @brief Find-in-conversation bar (Ctrl+F) for the chat dock.
+ */
+
+#pragma once
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+
+namespace ida_chat {
+
+/**
+ * @brief Query field with a hit counter and previous/next buttons.
+ *
+ * Typing is debounced before query_changed() is emitted, so a fast typist
+ * runs one search rather than one per keystroke. Enter moves to the next
+ * hit, Shift+Enter to the previous one and Escape closes the bar. The bar
+ * does not search itself; the owner runs the query and reports back with
+ * set_result().
+ */
+class SearchBar : public QWidget {
+    Q_OBJECT
+
+public:
+    /// Delay between the last keystroke and query_changed()
+    static constexpr int DEBOUNCE_MS = 120;
+    
+    explicit SearchBar(QWidget* parent = nullptr);
+    
+    /**
+     * @brief Show the bar and focus the query (selecting any previous text).
+     */
+    void open();
+    
+    [[nodiscard]] QString query() const { return input_->text(); }
+    
+    /**
+     * @brief Update the "n / m" counter.
+     * @param current Zero-based index of the shown hit, or -1 for none
+     * @param total Number of hits for the current query
+     */
+    void set_result(int current, int total);
+
+signals:
+    void query_changed(const QString& query);
+    void next_requested();
+    void prev_requested();
+    void closed();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void flush_query();
+    void close_bar();
+    
+    QLineEdit* input_;
+    QLabel* status_;
+    QPushButton* prev_button_;
+    QPushButton* next_button_;
+    QTimer debounce_;
+};
+
+} // namespace ida_chat
@@ -0,0 +1,49 @@
+/**
+ * @file stall_overlay.hpp
+ * @brief Frame-time / stall counter overlay for the chat dock.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QTimer>
+
+namespace ida_chat {
+
+/**
+ * @brief Small corner label showing frame p95, stall count and the last stall.
+ *
+ * While visible it runs a frame-rate timer and feeds the measured interval
+ * between ticks to StallMonitor::record_frame(), so it also provides the
+ * frame-time samples for the exported stall report. It stays anchored to
+ * the top-right corner of its parent.
+ */
+class StallOverlay : public QLabel {
+    Q_OBJECT
+
+public:
+    /// Frame sampling period (~60 Hz)
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    
+    /// Label refresh period
+    static constexpr int REFRESH_INTERVAL_MS = 500;
+    
+    explicit StallOverlay(QWidget* parent);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void on_frame();
+    void refresh();
+    void reposition();
+    
+    QTimer frame_timer_;
+    QElapsedTimer frame_clock_;
+    QElapsedTimer refresh_clock_;
+};
+
+} // namespace ida_chat
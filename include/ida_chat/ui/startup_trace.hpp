@@ -0,0 +1,73 @@
+/**
+ * @file startup_trace.hpp
+ * @brief Phase timings for opening the chat dock.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <vector>
+
+namespace ida_chat {
+
+/**
+ * @brief Records how long each step of opening the dock takes.
+ *
+ * The trace starts when the dock is requested. Each phase is marked as it
+ * completes. The "first show" time is measured up to the first event-loop
+ * turn after the UI was built, which is when IDA has had a chance to paint
+ * the dock. It is checked against FIRST_SHOW_BUDGET_MS. Work deferred past
+ * that point (agent start, prompt loading) is reported separately and does
+ * not count against the budget.
+ */
+class StartupTrace {
+public:
+    /// Target for dock request -> first painted frame
+    static constexpr qint64 FIRST_SHOW_BUDGET_MS = 100;
+    
+    struct Phase {
+        QString name;
+        qint64 elapsed_us = 0;      ///< Time since the previous mark
+    };
+    
+    /**
+     * @brief Start (or restart) the trace.
+     */
+    void start();
+    
+    /**
+     * @brief Record the end of a phase.
+     */
+    void mark(const QString& name);
+    
+    /**
+     * @brief Record the first-show point (end of the budgeted section).
+     */
+    void mark_first_show();
+    
+    [[nodiscard]] bool is_running() const { return clock_.isValid(); }
+    [[nodiscard]] const std::vector<Phase>& phases() const noexcept { return phases_; }
+    
+    /**
+     * @brief Time from start() to mark_first_show(), in ms (-1 if not reached).
+     */
+    [[nodiscard]] qint64 first_show_ms() const noexcept { return first_show_ms_; }
+    
+    [[nodiscard]] bool over_budget() const noexcept {
+        return first_show_ms_ > FIRST_SHOW_BUDGET_MS;
+    }
+    
+    /**
+     * @brief One-line summary of all phases plus the first-show total vs. budget.
+     */
+    [[nodiscard]] QString summary() const;
+
+private:
+    QElapsedTimer clock_;
+    qint64 last_us_ = 0;
+    qint64 first_show_ms_ = -1;
+    std::vector<Phase> phases_;
+};
+
+} // namespace ida_chat
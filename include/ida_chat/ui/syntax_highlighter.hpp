@@ -0,0 +1,173 @@
+/**
+ * @file syntax_highlighter.hpp
+ * @brief Background syntax highlighting for Python, C pseudocode and assembly.
+ */
+
+#pragma once
+
+#include <ida_chat/core/memory_accounting.hpp>
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QHash>
+#include <QCache>
+#include <QSyntaxHighlighter>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace ida_chat {
+
+// ============================================================================
+// Languages and Tokens
+// ============================================================================
+
+enum class CodeLanguage {
+    Plain,          // No highlighting
+    Python,         // IDAPython scripts
+    C,              // Hex-Rays pseudocode / C
+    Asm             // IDA disassembly listings
+};
+
+enum class TokenKind : std::uint8_t {
+    Keyword,
+    Type,
+    String,
+    Number,
+    Comment,
+    Preprocessor,
+    Function,
+    Register,
+    Label
+};
+
+struct HighlightSpan {
+    int start = 0;
+    int length = 0;
+    TokenKind kind = TokenKind::Keyword;
+};
+
+/**
+ * @brief Map a fenced-code hint ("py", "c", "cpp", "asm", "x86"...) to a language.
+ */
+[[nodiscard]] CodeLanguage language_from_hint(const QString& hint);
+
+/**
+ * @brief Tokenize code into highlight spans.
+ *
+ * Pure and thread-safe; this is the part that runs on the worker.
+ * Spans are sorted by start and never overlap.
+ */
+[[nodiscard]] std::vector<HighlightSpan> tokenize_code(const QString& code, CodeLanguage language);
+
+/**
+ * @brief Render code plus spans as escaped HTML with colored spans.
+ *
+ * Pure and thread-safe. The result is an inline fragment (no <pre> wrapper).
+ */
+[[nodiscard]] QString spans_to_html(const QString& code, const std::vector<HighlightSpan>& spans);
+
+// ============================================================================
+// Highlight Service
+// ============================================================================
+
+/**
+ * @brief Computes highlighted HTML off the GUI thread and caches it.
+ *
+ * Results are keyed by a hash of (language, content), so re-rendering the
+ * same block (re-layout, rehydration, duplicate scripts) is a cache hit.
+ * Requests for content already being computed are merged.
+ */
+class SyntaxHighlighter : public QObject {
+    Q_OBJECT
+
+public:
+    using ReadyFn = std::function<void(const QString& html)>;
+    using SpansReadyFn = std::function<void(const std::vector<HighlightSpan>& spans)>;
+
+    /**
+     * @brief Get the shared service (created on first use, owned by qApp).
+     */
+    [[nodiscard]] static SyntaxHighlighter& instance();
+
+    /**
+     * @brief Look up already computed HTML.
+     */
+    [[nodiscard]] std::optional<QString> cached_html(const QString& code, CodeLanguage language) const;
+
+    /**
+     * @brief Request highlighted HTML.
+     *
+     * If the result is cached, @p on_ready runs immediately. Otherwise the
+     * work is queued on a worker and @p on_ready runs later on the GUI
+     * thread, unless @p context has been destroyed in the meantime. If the
+     * job never runs (pool shut down), @p on_ready is dropped.
+     *
+     * @param code Source text
+     * @param language Language to highlight as
+     * @param context Lifetime guard for the callback
+     * @param on_ready Receives the HTML fragment
+     */
+    void request(const QString& code, CodeLanguage language, QObject* context, ReadyFn on_ready);
+
+    /**
+     * @brief Request raw token spans, for views that color a plain-text document.
+     *
+     * Same caching and lifetime rules as request().
+     */
+    void request_spans(const QString& code, CodeLanguage language, QObject* context, SpansReadyFn on_ready);
+
+private:
+    explicit SyntaxHighlighter(QObject* parent);
+
+    struct Job;
+
+    struct Waiter {
+        QPointer<QObject> context;
+        ReadyFn on_ready;
+    };
+
+    struct SpansWaiter {
+        QPointer<QObject> context;
+        SpansReadyFn on_ready;
+    };
+
+    [[nodiscard]] static quint64 cache_key(const QString& code, CodeLanguage language);
+    void apply_budget();
+    void start_job(quint64 key, const QString& code, CodeLanguage language, bool as_html);
+    void finish_job(quint64 key, bool as_html, bool done,
+                    const QString& html, const std::vector<HighlightSpan>& spans);
+
+    // Only touched on the GUI thread; workers run the pure functions above.
+    // Both caches are costed in bytes and share the HighlightCache budget.
+    QCache<quint64, QString> cache_;
+    QCache<quint64, std::vector<HighlightSpan>> span_cache_;
+    TrackedBytes cache_bytes_{MemorySubsystem::HighlightCache};   ///< Budget bounds both caches
+    QHash<quint64, std::vector<Waiter>> pending_;
+    QHash<quint64, std::vector<SpansWaiter>> pending_spans_;
+};
+
+/**
+ * @brief Colors a plain-text document from precomputed spans.
+ *
+ * Used for code too large for a rich-text label. Tokenizing happens on the
+ * worker (SyntaxHighlighter::request_spans); highlightBlock() only maps the
+ * absolute spans onto each block. The document text must match the code the
+ * spans were computed from, with no '\r'.
+ */
+class CodeSpanHighlighter : public QSyntaxHighlighter {
+    Q_OBJECT
+
+public:
+    CodeSpanHighlighter(std::vector<HighlightSpan> spans, QTextDocument* document);
+
+protected:
+    void highlightBlock(const QString& text) override;
+
+private:
+    std::vector<HighlightSpan> spans_;
+};
+
+} // namespace ida_chat
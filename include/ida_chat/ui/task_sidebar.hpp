@@ -11,7 +11,6 @@
 #include <QLabel>
 #include <QString>
 #include <QDateTime>
-#include <QTimer>
 #include <vector>
 #include <memory>
 
@@ -62,12 +61,11 @@ signals:
     
 protected:
     void mousePressEvent(QMouseEvent* event) override;
-    void enterEvent(QEnterEvent* event) override;
-    void leaveEvent(QEvent* event) override;
     
 private:
     void setup_ui();
     void update_status_icon();
+    void update_animation();
     QString format_time_ago() const;
     
     TaskItem task_;
@@ -76,9 +74,7 @@ private:
     QLabel* summary_label_;
     QLabel* time_label_;
     QLabel* diff_label_;
-    QTimer* animation_timer_;
     int animation_frame_ = 0;
-    bool hovered_ = false;
 };
 
 // ============================================================================
@@ -0,0 +1,63 @@
+/**
+ * @file turn_status_strip.hpp
+ * @brief One-line live metrics for the running request.
+ */
+
+#pragma once
+
+#include <ida_chat/core/turn_metrics.hpp>
+#include <ida_chat/core/metrics.hpp>
+
+#include <QLabel>
+#include <QTimer>
+#include <functional>
+
+namespace ida_chat {
+
+/**
+ * @brief Status strip showing TTFT, tokens/s, cache hits, tokens and script time.
+ *
+ * The strip polls a metrics source every REFRESH_INTERVAL_MS while a request
+ * runs instead of reacting to engine events, so streaming cost does not
+ * depend on it. After the request ends it keeps showing the final numbers.
+ */
+class TurnStatusStrip : public QLabel {
+    Q_OBJECT
+
+public:
+    using Source = std::function<TurnMetrics()>;
+    
+    /// Poll period while a request runs
+    static constexpr int REFRESH_INTERVAL_MS = 500;
+    
+    explicit TurnStatusStrip(Source source, QWidget* parent = nullptr);
+    
+    /**
+     * @brief Start polling (shows the strip).
+     */
+    void start();
+    
+    /**
+     * @brief Stop polling after one last refresh.
+     */
+    void stop();
+    
+    /**
+     * @brief Format metrics as the strip's text.
+     */
+    [[nodiscard]] static QString format(const TurnMetrics& metrics);
+    
+    /**
+     * @brief Show session and lifetime percentiles in the tooltip.
+     * @param snapshot MetricsSnapshot::to_json() of the last request
+     */
+    void set_percentiles(const nlohmann::json& snapshot);
+
+private:
+    void refresh();
+    
+    Source source_;
+    QTimer timer_;
+};
+
+} // namespace ida_chat
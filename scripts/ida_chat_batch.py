@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Run the IDA Chat agent over a corpus of binaries, one idat process each.
+
+Every binary gets its own work directory under --out with the database, the
+IDA log and the per-binary results. All records are merged into
+OUT/results.jsonl; a binary whose idat run produced no record (crash,
+timeout, bad setup) gets a synthetic failure record so the corpus stays
+accounted for.
+
+    ida_chat_batch.py --task triage.jsonl --out runs/ -j 8 samples/
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from pathlib import Path
+
+DATABASE_SUFFIXES = {".i64", ".idb"}
+
+
+def find_idat(explicit):
+    candidates = [explicit, os.environ.get("IDAT")]
+    if os.environ.get("IDADIR"):
+        for name in ("idat64", "idat", "idat64.exe", "idat.exe"):
+            candidates.append(str(Path(os.environ["IDADIR"]) / name))
+    candidates += ["idat64", "idat"]
+    for candidate in filter(None, candidates):
+        path = shutil.which(candidate) or (candidate if Path(candidate).is_file() else None)
+        if path:
+            return path
+    return None
+
+
+def collect_binaries(paths, recursive):
+    binaries = []
+    for path in map(Path, paths):
+        if path.is_dir():
+            pattern = "**/*" if recursive else "*"
+            binaries += sorted(p for p in path.glob(pattern) if p.is_file())
+        elif path.is_file():
+            binaries.append(path)
+        else:
+            print(f"warning: {path} does not exist", file=sys.stderr)
+    return binaries
+
+
+def work_dir_for(out_dir, binary):
+    # The path hash keeps same-named samples from different folders apart
+    digest = hashlib.sha1(str(binary.resolve()).encode()).hexdigest()[:8]
+    return out_dir / f"{binary.name}-{digest}"
+
+
+def read_records(results, binary):
+    """Parse a results.jsonl; a bad line (e.g. cut off by a crash) becomes a failure record."""
+    records = []
+    with results.open(encoding="utf-8", errors="replace") as f:
+        for number, line in enumerate(f, 1):
+            if not line.strip():
+                continue
+            try:
+                record = json.loads(line)
+                if not isinstance(record, dict):
+                    raise ValueError("not a JSON object")
+            except ValueError as e:
+                record = {"binary": str(binary), "success": False,
+                          "error": f"malformed result line {number}: {e}"}
+            records.append(record)
+    return records
+
+
+def run_one(binary, args, idat):
+    work_dir = work_dir_for(args.out, binary)
+    work_dir.mkdir(parents=True, exist_ok=True)
+    results = work_dir / "results.jsonl"
+    if results.exists():
+        results.unlink()
+
+    command = [idat, "-A", f"-L{work_dir / 'ida.log'}"]
+    if binary.suffix.lower() not in DATABASE_SUFFIXES:
+        command += ["-c", f"-o{work_dir / binary.name}"]
+    command.append(str(binary))
+
+    env = dict(os.environ)
+    env["IDA_CHAT_BATCH_OUT"] = str(results)
+    if args.task:
+        env["IDA_CHAT_BATCH_TASK"] = str(args.task.resolve())
+    if args.prompt:
+        env["IDA_CHAT_BATCH_PROMPT"] = args.prompt
+    if args.project:
+        env["IDA_CHAT_PROJECT_DIR"] = str(args.project.resolve())
+    if args.max_turns:
+        env["IDA_CHAT_BATCH_MAX_TURNS"] = str(args.max_turns)
+
+    start = time.monotonic()
+    try:
+        process = subprocess.run(command, env=env, stdin=subprocess.DEVNULL,
+                                 stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                                 timeout=args.timeout or None)
+        error = None if process.returncode == 0 else f"idat exited with {process.returncode}"
+    except subprocess.TimeoutExpired:
+        error = f"timed out after {args.timeout} s"
+    elapsed = time.monotonic() - start
+
+    records = read_records(results, binary) if results.exists() else []
+    if not records:
+        records = [{"binary": str(binary), "success": False,
+                    "error": error or "no results written", "duration_ms": elapsed * 1000}]
+    return binary, records, error, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("inputs", nargs="+", help="binaries, databases or directories")
+    parser.add_argument("--prompt", help="prompt to run against every binary")
+    parser.add_argument("--task", type=Path, help="task file (JSONL of {id, prompt}, or one prompt)")
+    parser.add_argument("--out", type=Path, default=Path("ida-chat-runs"), help="output directory")
+    parser.add_argument("-j", "--jobs", type=int, default=max(1, (os.cpu_count() or 2) // 2),
+                        help="idat processes to run at once (default: half the CPUs)")
+    parser.add_argument("--timeout", type=int, default=0, help="seconds per binary (0 = none)")
+    parser.add_argument("--max-turns", type=int, help="agentic turns per task")
+    parser.add_argument("--project", type=Path, help="directory with PROMPT.md and friends")
+    parser.add_argument("--idat", help="idat executable (default: $IDAT, $IDADIR, PATH)")
+    parser.add_argument("-r", "--recursive", action="store_true", help="descend into directories")
+    args = parser.parse_args()
+
+    if not args.prompt and not args.task:
+        parser.error("give --prompt or --task")
+    idat = find_idat(args.idat)
+    if not idat:
+        parser.error("idat not found (use --idat, $IDAT or $IDADIR)")
+    binaries = collect_binaries(args.inputs, args.recursive)
+    if not binaries:
+        parser.error("no input files")
+
+    args.out.mkdir(parents=True, exist_ok=True)
+    merged_path = args.out / "results.jsonl"
+    failed = 0
+    with merged_path.open("w", encoding="utf-8") as merged, \
+            ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        futures = [pool.submit(run_one, binary, args, idat) for binary in binaries]
+        for done, future in enumerate(as_completed(futures), 1):
+            binary, records, error, elapsed = future.result()
+            for record in records:
+                merged.write(json.dumps(record) + "\n")
+            merged.flush()
+            ok = error is None and all(r.get("success") for r in records)
+            failed += not ok
+            print(f"[{done}/{len(binaries)}] {binary.name}: {'ok' if ok else error or 'task failed'}"
+                  f" ({elapsed:.0f} s)", file=sys.stderr)
+
+    print(f"{len(binaries)} binaries, {failed} failed, results in {merged_path}", file=sys.stderr)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
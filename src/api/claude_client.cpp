@@ -6,6 +6,7 @@
 #include <ida_chat/api/claude_client.hpp>
 #include <ida_chat/api/streaming_parser.hpp>
 #include <ida_chat/api/keychain.hpp>
+#include <ida_chat/core/tracer.hpp>
 
 #include <cstdlib>
 
@@ -32,7 +33,9 @@ struct ClaudeClient::Impl {
     AuthCredentials credentials;
     std::string model = DEFAULT_MODEL;
     TokenUsage total_usage;
+    std::size_t bytes_sent = 0;
     std::atomic<bool> cancelled{false};
+    StreamTransport transport;
     
     Impl() = default;
     
@@ -141,7 +144,9 @@ std::optional<CreateMessageResponse> ClaudeClient::send_message(
     nlohmann::json request_json;
     to_json(request_json, request);
     
-    auto response = impl_->http.post("/v1/messages", request_json.dump());
+    std::string body = request_json.dump();
+    impl_->bytes_sent += body.size();
+    auto response = impl_->http.post("/v1/messages", body);
     
     if (!response.is_success()) {
         return std::nullopt;
@@ -181,8 +186,18 @@ std::optional<CreateMessageResponse> ClaudeClient::send_message_streaming(
     CreateMessageRequest streaming_request = request;
     streaming_request.stream = true;
     
-    nlohmann::json request_json;
-    to_json(request_json, streaming_request);
+    std::string body;
+    {
+        TraceSpan span("api", "serialize");
+        nlohmann::json request_json;
+        to_json(request_json, streaming_request);
+        body = request_json.dump();
+        if (span.active()) {
+            span.set_detail(std::to_string(body.size() / 1024) + " KB");
+        }
+    }
+    
+    impl_->bytes_sent += body.size();
     
     StreamingParser parser([&callback](const StreamEvent& event) {
         if (callback) {
@@ -190,18 +205,17 @@ std::optional<CreateMessageResponse> ClaudeClient::send_message_streaming(
         }
     });
     
-    auto response = impl_->http.stream_request(
-        HttpMethod::POST,
-        "/v1/messages",
-        request_json.dump(),
-        [&parser, this](const std::string& chunk) -> bool {
-            if (impl_->cancelled) {
-                return false;
-            }
-            parser.feed(chunk);
-            return true;
+    StreamCallback on_chunk = [&parser, this](const std::string& chunk) -> bool {
+        if (impl_->cancelled) {
+            return false;
         }
-    );
+        parser.feed(chunk);
+        return true;
+    };
+    
+    auto response = impl_->transport
+        ? impl_->transport(impl_->http, body, on_chunk)
+        : impl_->http.stream_request(HttpMethod::POST, "/v1/messages", body, on_chunk);
     
     parser.finish();
     
@@ -217,6 +231,10 @@ std::optional<CreateMessageResponse> ClaudeClient::send_message_streaming(
     return final_response;
 }
 
+void ClaudeClient::set_stream_transport(StreamTransport transport) {
+    impl_->transport = std::move(transport);
+}
+
 void ClaudeClient::cancel() {
     impl_->cancelled = true;
     impl_->http.cancel();
@@ -239,6 +257,10 @@ TokenUsage ClaudeClient::get_total_usage() const {
     return impl_->total_usage;
 }
 
+std::size_t ClaudeClient::get_bytes_sent() const {
+    return impl_->bytes_sent;
+}
+
 void ClaudeClient::reset_usage() {
     impl_->total_usage = TokenUsage{};
 }
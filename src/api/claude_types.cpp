@@ -16,6 +16,9 @@ void to_json(nlohmann::json& j, const TextContent& c) {
         {"type", "text"},
         {"text", c.text}
     };
+    if (c.cache) {
+        j["cache_control"] = {{"type", "ephemeral"}};
+    }
 }
 
 void to_json(nlohmann::json& j, const ToolUseContent& c) {
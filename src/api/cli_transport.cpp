@@ -5,8 +5,11 @@
 
 #include <ida_chat/api/cli_transport.hpp>
 #include <ida_chat/common/json.hpp>
+#include <ida_chat/common/platform.hpp>
 
 #include <array>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
@@ -15,9 +18,10 @@
 #include <condition_variable>
 #include <queue>
 
-#ifdef __APPLE__
+#ifndef IDA_CHAT_WINDOWS
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <spawn.h>
@@ -477,11 +481,100 @@ std::string CLITransport::get_last_error() const {
     return impl_->last_error;
 }
 
+// ============================================================================
+// One-Shot Commands
+// ============================================================================
+
+namespace {
+
+/// How often a blocked read rechecks the cancel token
+constexpr int CANCEL_POLL_MS = 100;
+
+/// How long a cancelled command gets to exit on SIGTERM before SIGKILL
+constexpr auto KILL_GRACE = std::chrono::seconds(2);
+
+} // anonymous namespace
+
+CLICommandResult run_cli_command(const std::string& command,
+                                 const CancelToken& cancel,
+                                 const std::function<void(std::string_view chunk)>& on_output) {
+    CLICommandResult result;
+#ifndef IDA_CHAT_WINDOWS
+    int out_pipe[2];
+    if (pipe(out_pipe) != 0) return result;
+    
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, out_pipe[0]);
+    posix_spawn_file_actions_addclose(&actions, out_pipe[1]);
+    
+    // Own process group, so a cancel reaches the CLI behind the shell too
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+    
+    const char* argv[] = {"/bin/sh", "-c", command.c_str(), nullptr};
+    pid_t pid = -1;
+    int spawned = posix_spawn(&pid, "/bin/sh", &actions, &attr, const_cast<char* const*>(argv), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(out_pipe[1]);
+    if (spawned != 0) {
+        close(out_pipe[0]);
+        return result;
+    }
+    result.started = true;
+    
+    char buffer[4096];
+    pollfd fd{out_pipe[0], POLLIN, 0};
+    while (!cancel.cancelled()) {
+        int ready = poll(&fd, 1, CANCEL_POLL_MS);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+        
+        ssize_t n = read(out_pipe[0], buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;     // EOF: the command closed its stdout
+        
+        std::string_view chunk(buffer, static_cast<std::size_t>(n));
+        result.output.append(chunk);
+        if (on_output) on_output(chunk);
+    }
+    close(out_pipe[0]);
+    
+    int status = 0;
+    if (cancel.cancelled()) {
+        result.cancelled = true;
+        kill(-pid, SIGTERM);
+        auto deadline = std::chrono::steady_clock::now() + KILL_GRACE;
+        while (waitpid(pid, &status, WNOHANG) == 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                kill(-pid, SIGKILL);
+                waitpid(pid, &status, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return result;
+    }
+    
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    result.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#else
+    (void)command;
+    (void)cancel;
+    (void)on_output;
+#endif
+    return result;
+}
+
 // ============================================================================
 // Test Connection
 // ============================================================================
 
-std::pair<bool, std::string> test_cli_connection(const std::string& cli_path) {
+std::pair<bool, std::string> test_cli_connection(const std::string& cli_path, const CancelToken& cancel) {
     std::string path = cli_path.empty() ? CLITransport::find_cli() : cli_path;
     
     if (path.empty()) {
@@ -495,17 +588,15 @@ std::pair<bool, std::string> test_cli_connection(const std::string& cli_path) {
                       "--permission-mode bypassPermissions --setting-sources \"\" "
                       "--max-turns 1 -- \"Say exactly: Hello from IDA Chat\" 2>&1";
     
-    FILE* fp = popen(cmd.c_str(), "r");
-    if (!fp) {
+    CLICommandResult run = run_cli_command(cmd, cancel);
+    if (!run.started) {
         return {false, "Failed to execute Claude CLI"};
     }
-    
-    char buffer[4096];
-    std::string output;
-    while (fgets(buffer, sizeof(buffer), fp)) {
-        output += buffer;
+    if (run.cancelled) {
+        return {false, "Connection test cancelled"};
     }
-    int status = pclose(fp);
+    const std::string& output = run.output;
+    int status = run.status;
     
     // Parse JSON lines to find assistant message or result
     std::string response_text;
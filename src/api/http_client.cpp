@@ -4,6 +4,7 @@
  */
 
 #include <ida_chat/api/http_client.hpp>
+#include <ida_chat/core/tracer.hpp>
 
 #include <curl/curl.h>
 
@@ -90,6 +91,38 @@ struct HttpClient::Impl {
         auto* cancelled = static_cast<std::atomic<bool>*>(clientp);
         return cancelled->load() ? 1 : 0;
     }
+    
+    /**
+     * @brief Emit connection phase spans from curl's timings of the last transfer.
+     *
+     * curl reports each phase as an offset from the start of the transfer
+     * (in microseconds); a phase that did not happen (reused connection)
+     * reports the same offset as the one before it.
+     */
+    void trace_phases(Tracer::Clock::time_point started) const {
+        if (!Tracer::enabled()) return;
+        
+        struct Phase { CURLINFO info; const char* name; };
+        static constexpr Phase phases[] = {
+            {CURLINFO_NAMELOOKUP_TIME_T, "dns"},
+            {CURLINFO_CONNECT_TIME_T, "connect"},
+            {CURLINFO_APPCONNECT_TIME_T, "tls"},
+            {CURLINFO_STARTTRANSFER_TIME_T, "ttfb"},
+        };
+        
+        auto& tracer = Tracer::instance();
+        curl_off_t previous = 0;
+        for (const auto& phase : phases) {
+            curl_off_t offset = 0;
+            if (curl_easy_getinfo(curl, phase.info, &offset) != CURLE_OK || offset <= previous) {
+                continue;
+            }
+            tracer.complete("http", phase.name,
+                            started + std::chrono::microseconds(previous),
+                            started + std::chrono::microseconds(offset));
+            previous = offset;
+        }
+    }
 };
 
 // ============================================================================
@@ -212,7 +245,13 @@ HttpResponse HttpClient::request(HttpMethod method,
     curl_easy_setopt(impl_->curl, CURLOPT_SSL_VERIFYHOST, 2L);
     
     // Perform request
-    CURLcode res = curl_easy_perform(impl_->curl);
+    auto started = Tracer::Clock::now();
+    CURLcode res;
+    {
+        TraceSpan span("http", "transfer");
+        res = curl_easy_perform(impl_->curl);
+    }
+    impl_->trace_phases(started);
     
     // Cleanup headers
     if (header_list) {
@@ -306,7 +345,13 @@ HttpResponse HttpClient::stream_request(HttpMethod method,
     curl_easy_setopt(impl_->curl, CURLOPT_SSL_VERIFYHOST, 2L);
     
     // Perform request
-    CURLcode res = curl_easy_perform(impl_->curl);
+    auto started = Tracer::Clock::now();
+    CURLcode res;
+    {
+        TraceSpan span("http", "transfer");
+        res = curl_easy_perform(impl_->curl);
+    }
+    impl_->trace_phases(started);
     
     // Cleanup headers
     if (header_list) {
@@ -5,6 +5,8 @@
 
 #include <ida_chat/api/streaming_parser.hpp>
 #include <ida_chat/core/types.hpp>  // For trim()
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
 
 #include <sstream>
 #include <regex>
@@ -15,6 +17,13 @@ namespace ida_chat {
 // StreamingParser Implementation
 // ============================================================================
 
+namespace {
+
+/// Spare line-buffer capacity released when stream buffers are over budget
+constexpr std::size_t SHRINK_SLACK_BYTES = 64 * 1024;
+
+} // anonymous namespace
+
 struct StreamingParser::Impl {
     EventCallback callback;
     std::string buffer;
@@ -25,8 +34,21 @@ struct StreamingParser::Impl {
     bool has_error = false;
     std::string error_message;
     
+    // Accumulated text, thinking and tool JSON, plus the line buffer's capacity
+    std::size_t content_bytes = 0;
+    TrackedBytes tracked{MemorySubsystem::StreamBuffers};
+    
     explicit Impl(EventCallback cb) : callback(std::move(cb)) {}
     
+    void account() {
+        // A single huge line (e.g. a large tool input) leaves the buffer's
+        // capacity behind after it is consumed
+        if (buffer.capacity() > buffer.size() + SHRINK_SLACK_BYTES && tracked.over_budget()) {
+            buffer.shrink_to_fit();
+        }
+        tracked.set(buffer.capacity() + content_bytes);
+    }
+    
     void process_line(const std::string& line) {
         // Parse SSE format
         if (line.find("event:") == 0) {
@@ -45,10 +67,14 @@ struct StreamingParser::Impl {
                 return;
             }
             
+            TraceSpan span("api", "parse_event");
             try {
                 auto json = nlohmann::json::parse(data);
                 StreamEvent event;
                 from_json(json, event);
+                if (span.active()) {
+                    span.set_detail(json.value("type", ""));
+                }
                 
                 // Update internal state
                 process_event(event);
@@ -90,12 +116,15 @@ struct StreamingParser::Impl {
                         if (event.delta->type == "text_delta") {
                             if (auto* text = std::get_if<TextContent>(&content_blocks[idx])) {
                                 text->text += event.delta->text;
+                                content_bytes += event.delta->text.size();
                             }
                         } else if (event.delta->type == "input_json_delta") {
                             partial_jsons[idx] += event.delta->partial_json;
+                            content_bytes += event.delta->partial_json.size();
                         } else if (event.delta->type == "thinking_delta") {
                             if (auto* thinking = std::get_if<ThinkingContent>(&content_blocks[idx])) {
                                 thinking->thinking += event.delta->thinking;
+                                content_bytes += event.delta->thinking.size();
                             }
                         }
                     }
@@ -124,8 +153,17 @@ struct StreamingParser::Impl {
                 if (event.stop_reason.has_value() && response.has_value()) {
                     response->stop_reason = event.stop_reason;
                 }
+                // The delta carries the final output count; prompt-side counts
+                // come from message_start unless the delta repeats them
                 if (event.usage.has_value() && response.has_value()) {
-                    response->usage = event.usage.value();
+                    const auto& delta = event.usage.value();
+                    auto& usage = response->usage;
+                    usage.output_tokens = delta.output_tokens;
+                    if (delta.input_tokens > 0) usage.input_tokens = delta.input_tokens;
+                    if (delta.cache_read_tokens > 0) usage.cache_read_tokens = delta.cache_read_tokens;
+                    if (delta.cache_creation_tokens > 0) {
+                        usage.cache_creation_tokens = delta.cache_creation_tokens;
+                    }
                 }
                 break;
                 
@@ -171,6 +209,7 @@ void StreamingParser::feed(const std::string& data) {
             impl_->process_line(line);
         }
     }
+    impl_->account();
 }
 
 void StreamingParser::finish() {
@@ -179,6 +218,7 @@ void StreamingParser::finish() {
         impl_->process_line(impl_->buffer);
         impl_->buffer.clear();
     }
+    impl_->account();
 }
 
 void StreamingParser::reset() {
@@ -189,6 +229,8 @@ void StreamingParser::reset() {
     impl_->complete = false;
     impl_->has_error = false;
     impl_->error_message.clear();
+    impl_->content_bytes = 0;
+    impl_->account();
 }
 
 std::optional<CreateMessageResponse> StreamingParser::get_response() const {
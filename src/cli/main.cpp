@@ -0,0 +1,521 @@
+/**
+ * @file main.cpp
+ * @brief Headless driver for ChatCore (batch runs, profiling, CI gates).
+ *
+ * Runs the same agentic loop as the plugin from a terminal, without IDA or
+ * Qt. Scripts go to a pluggable executor: refused, echoed back, or run by an
+ * external command (e.g. a Python interpreter with a stub `db` module).
+ */
+
+#include <ida_chat/core/chat_core.hpp>
+#include <ida_chat/core/chat_callback.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
+#include <ida_chat/core/session_recording.hpp>
+#include <ida_chat/core/tracer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef IDA_CHAT_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <share.h>
+#include <sys/stat.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <unistd.h>
+#endif
+
+namespace ida_chat {
+
+namespace {
+
+// ============================================================================
+// Options
+// ============================================================================
+
+struct CliOptions {
+    std::string model;
+    int max_turns = DEFAULT_MAX_TURNS;
+    std::string auth;               ///< "api", "system" or "" (api when a key is set)
+    std::string base_url;           ///< API base URL override ("" = default)
+    std::string executor = "none";  ///< "none", "echo" or "cmd"
+    std::string exec_cmd;
+    std::string prompt_dir;
+    std::string metrics_path;
+    std::string trace_path;
+    std::string record_path;
+    std::string replay_path;
+    std::string memory_budgets;     ///< "name=MB,..." ("" = IDA_CHAT_MEMORY_BUDGETS)
+    std::string log_filter;         ///< "info,core=debug" ("" = IDA_CHAT_LOG)
+    std::string log_file;
+    bool verbose = false;
+    std::vector<std::string> prompt_words;
+};
+
+void print_usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options] [prompt...]\n"
+        "\n"
+        "Runs each prompt through the IDA Chat agent loop. Without a prompt on the\n"
+        "command line, every non-empty stdin line is sent as a follow-up message.\n"
+        "\n"
+        "Options:\n"
+        "  -m, --model NAME      Model to use\n"
+        "  -t, --max-turns N     Agentic turns per prompt (default %d)\n"
+        "      --auth api|system Claude API key from the environment, or the Claude CLI\n"
+        "      --base-url URL    API endpoint (e.g. a proxy or local stub server)\n"
+        "      --executor KIND   Script executor: none (default), echo, cmd\n"
+        "      --exec-cmd CMD    Run each script as `CMD <file>` (implies --executor cmd)\n"
+        "      --prompt-dir DIR  Load PROMPT.md and friends from DIR\n"
+        "      --metrics FILE    Write the final metrics snapshot as JSON\n"
+        "      --trace FILE      Record tracing spans and write a Chrome trace\n"
+        "      --record FILE     Record the session for --replay\n"
+        "      --replay FILE     Re-run a recorded session offline and report divergences\n"
+        "      --memory-budget SPEC\n"
+        "                        Soft memory budgets in MB (0 = none), e.g.\n"
+        "                        conversation=8,search_index=0\n"
+        "      --log FILTER      Log levels, e.g. info,core=debug (default warning)\n"
+        "      --log-file FILE   Also write the log to FILE, rotated at 4 MB\n"
+        "  -v, --verbose         Log engine debug messages and scripts to stderr\n"
+        "  -h, --help            Show this help\n",
+        argv0, DEFAULT_MAX_TURNS);
+}
+
+/// Returns the exit code when the process should stop, nullopt to run
+std::optional<int> parse_args(int argc, char** argv, CliOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "error: %s needs a value\n", arg.c_str());
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "-v" || arg == "--verbose") {
+            opts.verbose = true;
+        } else if (arg == "-m" || arg == "--model") {
+            const char* v = value(); if (!v) return 2;
+            opts.model = v;
+        } else if (arg == "-t" || arg == "--max-turns") {
+            const char* v = value(); if (!v) return 2;
+            opts.max_turns = std::max(1, std::atoi(v));
+        } else if (arg == "--auth") {
+            const char* v = value(); if (!v) return 2;
+            opts.auth = v;
+        } else if (arg == "--base-url") {
+            const char* v = value(); if (!v) return 2;
+            opts.base_url = v;
+        } else if (arg == "--executor") {
+            const char* v = value(); if (!v) return 2;
+            opts.executor = v;
+        } else if (arg == "--exec-cmd") {
+            const char* v = value(); if (!v) return 2;
+            opts.exec_cmd = v;
+            opts.executor = "cmd";
+        } else if (arg == "--prompt-dir") {
+            const char* v = value(); if (!v) return 2;
+            opts.prompt_dir = v;
+        } else if (arg == "--metrics") {
+            const char* v = value(); if (!v) return 2;
+            opts.metrics_path = v;
+        } else if (arg == "--trace") {
+            const char* v = value(); if (!v) return 2;
+            opts.trace_path = v;
+        } else if (arg == "--record") {
+            const char* v = value(); if (!v) return 2;
+            opts.record_path = v;
+        } else if (arg == "--replay") {
+            const char* v = value(); if (!v) return 2;
+            opts.replay_path = v;
+        } else if (arg == "--memory-budget") {
+            const char* v = value(); if (!v) return 2;
+            opts.memory_budgets = v;
+        } else if (arg == "--log") {
+            const char* v = value(); if (!v) return 2;
+            opts.log_filter = v;
+        } else if (arg == "--log-file") {
+            const char* v = value(); if (!v) return 2;
+            opts.log_file = v;
+        } else if (arg == "--") {
+            for (++i; i < argc; ++i) opts.prompt_words.emplace_back(argv[i]);
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "error: unknown option %s\n", arg.c_str());
+            return 2;
+        } else {
+            opts.prompt_words.push_back(std::move(arg));
+        }
+    }
+    
+    if (opts.executor != "none" && opts.executor != "echo" && opts.executor != "cmd") {
+        std::fprintf(stderr, "error: unknown executor '%s'\n", opts.executor.c_str());
+        return 2;
+    }
+    if (!opts.replay_path.empty() && (!opts.record_path.empty() || !opts.prompt_words.empty())) {
+        std::fprintf(stderr, "error: --replay takes its prompts from the recording\n");
+        return 2;
+    }
+    if (opts.executor == "cmd" && opts.exec_cmd.empty()) {
+        std::fprintf(stderr, "error: --executor cmd needs --exec-cmd\n");
+        return 2;
+    }
+    
+    if (opts.memory_budgets.empty()) {
+        if (const char* env = std::getenv("IDA_CHAT_MEMORY_BUDGETS")) opts.memory_budgets = env;
+    }
+    std::string error;
+    auto budgets = parse_memory_budgets(opts.memory_budgets, &error);
+    if (!budgets) {
+        std::fprintf(stderr, "error: --memory-budget: %s\n", error.c_str());
+        return 2;
+    }
+    MemoryAccountant::instance().set_budgets(*budgets);
+    
+    // Everything the filter lets through goes to stderr
+    if (opts.log_filter.empty()) {
+        if (const char* env = std::getenv("IDA_CHAT_LOG")) opts.log_filter = env;
+    }
+    if (opts.log_filter.empty()) {
+        set_log_level(opts.verbose ? LogLevel::Debug : LogLevel::Warning);
+    } else if (!set_log_filter(opts.log_filter)) {
+        std::fprintf(stderr, "error: --log: malformed filter '%s'\n", opts.log_filter.c_str());
+        return 2;
+    }
+    set_log_sink(nullptr, LogLevel::Debug);
+    if (!opts.log_file.empty() && !set_log_file(opts.log_file)) {
+        std::fprintf(stderr, "error: could not open %s\n", opts.log_file.c_str());
+        return 1;
+    }
+    return std::nullopt;
+}
+
+// ============================================================================
+// Script executors
+// ============================================================================
+
+/// Write code to a fresh temp file that no other process can have pre-created
+std::optional<std::filesystem::path> write_temp_script(const std::string& code) {
+    auto dir = std::filesystem::temp_directory_path();
+#ifdef IDA_CHAT_WINDOWS
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        auto path = dir / ("ida_chat_cli_" + std::to_string(_getpid()) + "_"
+                           + generate_uuid().substr(0, 8) + ".py");
+        int fd = -1;
+        if (_sopen_s(&fd, path.string().c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY,
+                     _SH_DENYRW, _S_IREAD | _S_IWRITE) != 0) {
+            if (errno == EEXIST) continue;
+            return std::nullopt;
+        }
+        bool ok = _write(fd, code.data(), static_cast<unsigned>(code.size())) ==
+                  static_cast<int>(code.size());
+        _close(fd);
+        if (ok) return path;
+        std::filesystem::remove(path);
+        return std::nullopt;
+    }
+    return std::nullopt;
+#else
+    // mkstemps creates the file exclusively (O_EXCL, mode 0600) under a random name
+    std::string name = (dir / "ida_chat_cli_XXXXXX.py").string();
+    int fd = mkstemps(name.data(), 3);
+    if (fd < 0) return std::nullopt;
+    
+    std::size_t written = 0;
+    while (written < code.size()) {
+        auto n = ::write(fd, code.data() + written, code.size() - written);
+        if (n <= 0) break;
+        written += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    if (written == code.size()) return std::filesystem::path(name);
+    std::filesystem::remove(name);
+    return std::nullopt;
+#endif
+}
+
+ScriptResult run_with_command(const std::string& command, const std::string& code) {
+    auto script = write_temp_script(code);
+    if (!script) {
+        return ScriptResult::error_result("Could not write script to "
+                                          + std::filesystem::temp_directory_path().string());
+    }
+    const auto& path = *script;
+    
+    auto start = std::chrono::steady_clock::now();
+    std::string cmd = command + " \"" + path.string() + "\" 2>&1";
+    FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) {
+        std::filesystem::remove(path);
+        return ScriptResult::error_result("Could not run: " + command);
+    }
+    
+    std::string output;
+    char buffer[4096];
+    while (std::size_t n = std::fread(buffer, 1, sizeof(buffer), pipe)) {
+        output.append(buffer, n);
+    }
+    int status = pclose(pipe);
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    
+    ScriptResult result = status == 0
+        ? ScriptResult::success_result(std::move(output))
+        : ScriptResult{false, output, "Script exited with status " + std::to_string(status)};
+    result.execution_time_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+ScriptExecutorFn make_executor(const CliOptions& opts) {
+    if (opts.executor == "echo") {
+        // Lets the loop run end to end without executing anything
+        return [](const std::string& code) {
+            return ScriptResult::success_result("(not executed)\n" + code);
+        };
+    }
+    if (opts.executor == "cmd") {
+        return [command = opts.exec_cmd](const std::string& code) {
+            return run_with_command(command, code);
+        };
+    }
+    return [](const std::string&) {
+        return ScriptResult::error_result("Script execution is not available in this session");
+    };
+}
+
+// ============================================================================
+// Terminal output
+// ============================================================================
+
+/**
+ * @brief Assistant text to stdout, progress and scripts to stderr.
+ */
+class TerminalCallback : public ChatCallback {
+public:
+    explicit TerminalCallback(bool verbose) : verbose_(verbose) {}
+    
+    void on_turn_start(int turn, int max_turns) override {
+        std::fprintf(stderr, "[turn %d/%d]\n", turn, max_turns);
+    }
+    void on_thinking() override {}
+    void on_thinking_done() override {}
+    void on_thinking_text(const std::string&) override {}
+    void on_tool_use(const std::string& tool_name, const std::string& details) override {
+        std::fprintf(stderr, "[%s] %s\n", tool_name.c_str(), details.c_str());
+    }
+    void on_text(const std::string& text) override {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fflush(stdout);
+    }
+    void on_script_code(const std::string& code) override {
+        if (verbose_) std::fprintf(stderr, "[script]\n%s\n", code.c_str());
+    }
+    void on_script_output(const std::string& output) override {
+        if (verbose_) std::fprintf(stderr, "[output]\n%s\n", output.c_str());
+    }
+    void on_error(const std::string& error) override {
+        std::fprintf(stderr, "[error] %s\n", error.c_str());
+    }
+    void on_result(int num_turns, std::optional<double> cost) override {
+        std::fprintf(stdout, "\n");
+        std::fprintf(stderr, "[done] %d turn(s), $%.4f\n", num_turns, cost.value_or(0.0));
+    }
+    void on_metrics(const MetricsSnapshot&) override {}
+
+private:
+    bool verbose_;
+};
+
+// Set from the SIGINT handler, which may only touch lock-free atomics;
+// the real cancel runs on InterruptWatcher's thread
+std::atomic<bool> g_interrupted{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+void on_interrupt(int) {
+    g_interrupted.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Turns Ctrl+C into ChatCore::request_cancel() off the signal handler.
+ */
+class InterruptWatcher {
+public:
+    explicit InterruptWatcher(ChatCore& core)
+        : thread_([this, &core]() {
+            while (!stop_.load(std::memory_order_relaxed)) {
+                if (g_interrupted.exchange(false, std::memory_order_relaxed)) {
+                    core.request_cancel();
+                }
+                std::this_thread::sleep_for(POLL_INTERVAL);
+            }
+        }) {
+        std::signal(SIGINT, on_interrupt);
+    }
+    
+    ~InterruptWatcher() {
+        std::signal(SIGINT, SIG_DFL);
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+        g_interrupted.store(false, std::memory_order_relaxed);
+    }
+    
+    InterruptWatcher(const InterruptWatcher&) = delete;
+    InterruptWatcher& operator=(const InterruptWatcher&) = delete;
+
+private:
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{50};
+    
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+bool write_text(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary);
+    return file && (file << text);
+}
+
+} // anonymous namespace
+
+int run_cli(int argc, char** argv) {
+    CliOptions opts;
+    if (auto code = parse_args(argc, argv, opts)) {
+        return *code;
+    }
+    
+    if (!opts.trace_path.empty()) {
+        Tracer::instance().set_enabled(true);
+        Tracer::instance().set_thread_name("main");
+    }
+    
+    ChatCoreOptions core_options;
+    core_options.max_turns = opts.max_turns;
+    core_options.verbose = opts.verbose;
+    if (!opts.model.empty()) {
+        core_options.model = opts.model;
+    }
+    
+    std::shared_ptr<SessionReplay> replay;
+    if (!opts.replay_path.empty()) {
+        std::string error;
+        replay = SessionReplay::load(opts.replay_path, &error);
+        if (!replay) {
+            std::fprintf(stderr, "error: %s\n", error.c_str());
+            return 1;
+        }
+        core_options = replay->apply_options(core_options);
+        core_options.replay = replay;
+    }
+    if (!opts.record_path.empty()) {
+        core_options.recorder = std::make_shared<SessionRecorder>(opts.record_path);
+        if (!core_options.recorder->is_open()) {
+            std::fprintf(stderr, "error: could not write %s\n", opts.record_path.c_str());
+            return 1;
+        }
+    }
+    
+    TerminalCallback callback(opts.verbose);
+    ChatCore core(callback, make_executor(opts), nullptr, core_options);
+    
+    AuthCredentials credentials;
+    const char* key = std::getenv("ANTHROPIC_API_KEY");
+    if (!key || !*key) key = std::getenv("CLAUDE_API_KEY");
+    bool has_key = key && *key;
+    if (opts.auth == "system" || (opts.auth.empty() && !has_key)) {
+        credentials.type = AuthType::System;
+    } else {
+        credentials.type = AuthType::ApiKey;
+        credentials.api_key = has_key ? key : "";
+    }
+    credentials.api_base_url = opts.base_url;
+    if (!core.connect(credentials)) {
+        std::fprintf(stderr, "error: not connected (set ANTHROPIC_API_KEY or install the Claude CLI)\n");
+        return 1;
+    }
+    if (!opts.prompt_dir.empty()) {
+        core.load_system_prompt(opts.prompt_dir, false);
+    } else if (replay) {
+        core.set_system_prompt(replay->system_prompt());
+    }
+    
+    auto interrupt_watcher = std::make_unique<InterruptWatcher>(core);
+    
+    bool ok = true;
+    auto run_prompt = [&](const std::string& prompt) {
+        auto result = core.process_message(prompt);
+        if (!result.success && !result.cancelled) {
+            ok = false;
+        }
+        return !result.cancelled;
+    };
+    
+    if (replay) {
+        for (const auto& input : replay->inputs()) {
+            (void)core.process_message(input.text, SessionReplay::materialize_attachments(input));
+        }
+    } else if (!opts.prompt_words.empty()) {
+        std::string prompt;
+        for (const auto& word : opts.prompt_words) {
+            if (!prompt.empty()) prompt += ' ';
+            prompt += word;
+        }
+        run_prompt(prompt);
+    } else {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (trim(line).empty()) continue;
+            if (!run_prompt(line)) break;
+        }
+    }
+    
+    interrupt_watcher.reset();
+    
+    if (replay) {
+        auto divergences = replay->divergences();
+        for (const auto& divergence : divergences) {
+            std::fprintf(stderr, "[diverged] %s\n", divergence.c_str());
+        }
+        std::fprintf(stderr, "[replay] %zu input(s), %s\n", replay->inputs().size(),
+                     divergences.empty() ? "identical to the recording" : "diverged");
+        ok = ok && divergences.empty();
+    }
+    
+    if (!opts.metrics_path.empty() &&
+        !write_text(opts.metrics_path, core.get_metrics().to_json().dump(2))) {
+        std::fprintf(stderr, "error: could not write %s\n", opts.metrics_path.c_str());
+        ok = false;
+    }
+    if (!opts.trace_path.empty() && !Tracer::instance().export_chrome_json(opts.trace_path)) {
+        std::fprintf(stderr, "error: could not write %s\n", opts.trace_path.c_str());
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+} // namespace ida_chat
+
+int main(int argc, char** argv) {
+    int code = ida_chat::run_cli(argc, argv);
+    ida_chat::shutdown_log();
+    return code;
+}
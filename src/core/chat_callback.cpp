@@ -23,6 +23,10 @@ void CollectorCallback::on_thinking_done() {
     // No-op for collector
 }
 
+void CollectorCallback::on_thinking_text(const std::string& text) {
+    thinking_ += text;
+}
+
 void CollectorCallback::on_tool_use(const std::string& /*tool_name*/, const std::string& /*details*/) {
     // No-op for collector - could add tool use tracking if needed
 }
@@ -54,12 +58,18 @@ void CollectorCallback::on_result(int num_turns, std::optional<double> cost) {
     cost_ = cost;
 }
 
+void CollectorCallback::on_metrics(const MetricsSnapshot& snapshot) {
+    metrics_ = snapshot;
+}
+
 void CollectorCallback::clear() {
     text_.clear();
+    thinking_.clear();
     errors_.clear();
     script_outputs_.clear();
     turns_ = 0;
     cost_.reset();
+    metrics_ = MetricsSnapshot{};
 }
 
 } // namespace ida_chat
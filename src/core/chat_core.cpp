@@ -4,28 +4,159 @@
  */
 
 #include <ida_chat/core/chat_core.hpp>
+#include <ida_chat/core/turn_metrics.hpp>
+#include <ida_chat/core/clock.hpp>
+#include <ida_chat/core/session_recording.hpp>
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/metrics.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+#include <ida_chat/core/script_scheduler.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/log.hpp>
 #include <ida_chat/api/streaming_parser.hpp>
 #include <ida_chat/api/cli_transport.hpp>
+#include <ida_chat/history/blob_store.hpp>
 
 #include <fstream>
 #include <sstream>
 #include <cstdio>
+#include <string_view>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef __APPLE__
 #include <unistd.h>
 #endif
 
-// IDA headers for msg() debug output
-#include <ida_chat/common/ida_begin.hpp>
-#include <ida.hpp>
-#include <kernwin.hpp>
-#include <ida_chat/common/ida_end.hpp>
-
-// Debug logging macro - outputs to IDA's output window
-#define IDA_CHAT_DEBUG(fmt, ...) msg("[IDA Chat] " fmt "\n", ##__VA_ARGS__)
+// Debug logging; filtered out (arguments unevaluated) unless "core" is at debug
+#define IDA_CHAT_DEBUG(...) IDA_CHAT_LOG(LogLevel::Debug, "core", __VA_ARGS__)
 
 namespace ida_chat {
 
+// ============================================================================
+// Attachments
+// ============================================================================
+
+namespace {
+
+/// One line per attachment, pointing at the blob file backing it
+std::string attachment_note(const std::vector<Attachment>& attachments) {
+    std::string note;
+    for (const auto& att : attachments) {
+        note += "\n[Attachment \"" + att.label + "\": " + std::to_string(att.size)
+              + " bytes, ~" + std::to_string(att.tokens) + " tokens, file "
+              + BlobStore::shared().path_for(att.blob_id) + "]";
+    }
+    return note;
+}
+
+/// Error naming the first attachment whose blob is gone, empty if all are present
+std::string missing_attachment_error(const std::vector<Attachment>& attachments) {
+    for (const auto& att : attachments) {
+        if (!BlobStore::shared().contains(att.blob_id)) {
+            return "Attachment \"" + att.label + "\" is no longer available; remove it and attach it again";
+        }
+    }
+    return {};
+}
+
+/// User message with each attachment as its own (cacheable) text block
+ClaudeMessage build_user_message(const std::string& user_input,
+                                 const std::vector<Attachment>& attachments) {
+    ClaudeMessage message;
+    message.role = MessageRole::User;
+    
+    for (const auto& att : attachments) {
+        auto data = BlobStore::shared().read_all(att.blob_id);
+        if (!data) {
+            // Checked before the request; only a concurrent delete gets here
+            IDA_CHAT_LOG(LogLevel::Warning, "core", "attachment '%s' missing from blob store, sent without it",
+                         att.label.c_str());
+            continue;
+        }
+        
+        std::string text;
+        text.reserve(data->size() + att.label.size() + 64);
+        text += "<attachment name=\"" + att.label + "\">\n";
+        text += *data;
+        text += "\n</attachment>";
+        message.content.push_back(TextContent{std::move(text)});
+    }
+    
+    // One breakpoint after the last attachment covers all of them
+    if (!message.content.empty()) {
+        std::get<TextContent>(message.content.back()).cache = true;
+    }
+    
+    // Attachment-only submits have no text, and the API rejects blank blocks
+    if (user_input.find_first_not_of(" \t\r\n") != std::string::npos) {
+        message.content.push_back(TextContent{user_input});
+    } else if (message.content.empty()) {
+        message.content.push_back(TextContent{attachment_note(attachments).substr(1)});
+    }
+    return message;
+}
+
+// ============================================================================
+// Conversation memory
+// ============================================================================
+
+/// Messages at the end of the conversation that compaction never touches
+constexpr std::size_t COMPACT_KEEP_RECENT = 6;
+
+/// Blocks smaller than this are not worth moving to the blob store
+constexpr std::size_t COMPACT_MIN_BYTES = 8 * 1024;
+
+std::size_t block_bytes(const ContentBlock& block) {
+    if (auto* text = std::get_if<TextContent>(&block)) return text->text.size();
+    if (auto* result = std::get_if<ToolResultContent>(&block)) return result->content.size();
+    if (auto* thinking = std::get_if<ThinkingContent>(&block)) return thinking->thinking.size();
+    if (auto* tool = std::get_if<ToolUseContent>(&block)) {
+        return tool->id.size() + tool->name.size() + tool->input.dump().size();
+    }
+    return 0;
+}
+
+std::size_t message_bytes(const ClaudeMessage& message) {
+    std::size_t bytes = 0;
+    for (const auto& block : message.content) {
+        bytes += block_bytes(block);
+    }
+    return bytes;
+}
+
+/// Replace a large payload with its preview and the path of the blob holding it
+bool compact_payload(std::string& payload) {
+    if (payload.size() < COMPACT_MIN_BYTES) return false;
+    
+    BlobRef ref = BlobStore::shared().put(payload);
+    if (!ref.valid()) return false;
+    
+    payload = BlobStore::make_preview(payload)
+            + "\n[Compacted to save memory; full text in " + BlobStore::shared().path_for(ref.id) + "]";
+    return true;
+}
+
+/// Records the enclosing scope's duration into a histogram
+class ScopedLatency {
+public:
+    ScopedLatency(MetricsRegistry& registry, const char* name)
+        : registry_(registry), name_(name), start_(EngineClock::now()) {}
+    
+    ~ScopedLatency() {
+        registry_.record(name_, std::chrono::duration<double, std::milli>(
+            EngineClock::now() - start_).count());
+    }
+
+private:
+    MetricsRegistry& registry_;
+    const char* name_;
+    EngineClock::time_point start_;
+};
+
+} // anonymous namespace
+
 // ============================================================================
 // Implementation
 // ============================================================================
@@ -43,6 +174,14 @@ struct ChatCore::Impl {
     std::atomic<bool> cancelled{false};
     std::atomic<ChatState> state{ChatState::Disconnected};
     TokenUsage total_usage;
+    std::shared_ptr<TurnMetricsRecorder> metrics = std::make_shared<TurnMetricsRecorder>();
+    
+    // Aggregates: this session, and earlier sessions as loaded from options.metrics_path
+    MetricsRegistry session_metrics;
+    MetricsRegistry lifetime_metrics;
+    std::uint64_t stall_cursor = StallMonitor::instance().total_recorded();
+    
+    TrackedBytes conversation_bytes{MemorySubsystem::Conversation};
     
     // CLI mode support
     bool use_cli_mode = false;
@@ -52,7 +191,187 @@ struct ChatCore::Impl {
         : callback(cb)
         , script_executor(std::move(exec))
         , history(hist)
-        , options(opts) {}
+        , options(opts)
+    {
+        if (!options.metrics_path.empty()) {
+            lifetime_metrics = MetricsRegistry::load(options.metrics_path);
+        }
+        if (options.replay) {
+            script_executor = options.replay->executor();
+            EngineClock::set_manual(true);
+        }
+        if (options.recorder) {
+            options.recorder->record_header(options);
+        }
+    }
+    
+    // Fold a finished API/CLI call into the session metrics
+    void record_call(const TokenUsage& usage, std::size_t bytes_sent) {
+        namespace mn = metric_names;
+        
+        TurnMetrics live = metrics->snapshot();
+        if (live.ttft_ms >= 0.0) {
+            session_metrics.record(mn::TTFT_MS, live.ttft_ms);
+        }
+        if (live.tokens_per_sec > 0.0) {
+            session_metrics.record(mn::TOKENS_PER_SEC, live.tokens_per_sec);
+        }
+        
+        auto prompt = usage.input_tokens + usage.cache_read_tokens + usage.cache_creation_tokens;
+        if (prompt > 0) {
+            session_metrics.record(mn::CACHE_HIT_RATIO,
+                static_cast<double>(usage.cache_read_tokens) / static_cast<double>(prompt));
+            session_metrics.set(mn::PROMPT_TOKENS, static_cast<double>(prompt));
+        }
+        session_metrics.add(mn::TURNS);
+        session_metrics.add(mn::INPUT_TOKENS, prompt);
+        session_metrics.add(mn::OUTPUT_TOKENS, usage.output_tokens);
+        session_metrics.add(mn::BYTES_SENT, static_cast<std::int64_t>(bytes_sent));
+    }
+    
+    [[nodiscard]] MetricsSnapshot metrics_snapshot() const {
+        MetricsRegistry lifetime = lifetime_metrics;
+        lifetime.merge(session_metrics);
+        return MetricsSnapshot{session_metrics.summary(), lifetime.summary()};
+    }
+    
+    void publish_metrics() {
+        session_metrics.set(metric_names::CONVERSATION_MESSAGES, static_cast<double>(conversation.size()));
+        
+        auto& accountant = MemoryAccountant::instance();
+        for (const auto& usage : accountant.usage()) {
+            session_metrics.set("mem_" + std::string(memory_subsystem_name(usage.subsystem)) + "_bytes",
+                                static_cast<double>(usage.bytes));
+        }
+        session_metrics.set(metric_names::MEMORY_TOTAL_BYTES, static_cast<double>(accountant.total()));
+        
+        auto pool = ThreadPool::instance().stats();
+        for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+            std::string prefix = std::string("pool_") + task_priority_str(static_cast<TaskPriority>(p));
+            session_metrics.set(prefix + "_queued", static_cast<double>(pool.priorities[p].queued));
+            session_metrics.set(prefix + "_active", static_cast<double>(pool.priorities[p].active));
+            session_metrics.set(prefix + "_wait_p99_ms", pool.priorities[p].wait_p99_ms);
+        }
+        session_metrics.set(metric_names::POOL_UTILIZATION, pool.utilization);
+        session_metrics.set(metric_names::POOL_STOLEN, static_cast<double>(pool.stolen));
+        
+        auto scripts = ScriptScheduler::instance().stats();
+        for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+            std::string prefix = std::string("script_") + task_priority_str(static_cast<TaskPriority>(p));
+            session_metrics.set(prefix + "_queued", static_cast<double>(scripts.priorities[p].queued));
+            session_metrics.set(prefix + "_wait_p99_ms", scripts.priorities[p].wait_p99_ms);
+            session_metrics.set(prefix + "_slice_p99_ms", scripts.priorities[p].slice_p99_ms);
+        }
+        session_metrics.set(metric_names::SCRIPT_LONG_SLICES, static_cast<double>(scripts.long_slices));
+        fold_stalls();
+        
+        callback.on_metrics(metrics_snapshot());
+    }
+    
+    // GUI stalls since the last fold (none in the CLI, where the monitor never runs)
+    void fold_stalls() {
+        auto& stalls = StallMonitor::instance();
+        for (const auto& stall : stalls.records_since(stall_cursor)) {
+            session_metrics.add(metric_names::STALLS);
+            session_metrics.add(std::string("stalls_") + stall_cause_str(stall.cause));
+            session_metrics.record(metric_names::STALL_MS, stall.duration_ms);
+        }
+        auto frames = stalls.frame_stats();
+        if (frames.samples > 0) {
+            session_metrics.set(metric_names::FRAME_P95_MS, frames.p95_ms);
+        }
+    }
+    
+    void add_to_conversation(ClaudeMessage message) {
+        conversation_bytes.set(conversation_bytes.get() + message_bytes(message));
+        conversation.push_back(std::move(message));
+    }
+    
+    // The API allows four cache_control blocks per request; only the newest
+    // attachment message keeps its breakpoint, which still covers the prefix
+    void clear_cache_breakpoints() {
+        for (auto& message : conversation) {
+            for (auto& block : message.content) {
+                if (auto* text = std::get_if<TextContent>(&block)) {
+                    text->cache = false;
+                }
+            }
+        }
+    }
+    
+    void clear_conversation() {
+        conversation.clear();
+        conversation_bytes.set(0);
+    }
+    
+    // Over budget: move large old payloads (script output, attachments) to
+    // the blob store, oldest first, leaving a preview and the blob path.
+    // This changes the request prefix, so the next call misses the prompt
+    // cache once; it only happens when the budget is exceeded.
+    void compact_conversation() {
+        if (!conversation_bytes.over_budget()) return;
+        
+        std::size_t budget = conversation_bytes.budget();
+        std::size_t bytes = conversation_bytes.get();
+        std::size_t compacted = 0;
+        std::size_t end = conversation.size() > COMPACT_KEEP_RECENT
+                        ? conversation.size() - COMPACT_KEEP_RECENT : 0;
+        
+        for (std::size_t i = 0; i < end && bytes > budget; ++i) {
+            for (auto& block : conversation[i].content) {
+                std::string* payload = nullptr;
+                if (auto* text = std::get_if<TextContent>(&block)) {
+                    payload = &text->text;
+                } else if (auto* result = std::get_if<ToolResultContent>(&block)) {
+                    payload = &result->content;
+                }
+                if (!payload) continue;
+                
+                std::size_t before = payload->size();
+                if (compact_payload(*payload)) {
+                    bytes -= before - payload->size();
+                    ++compacted;
+                }
+            }
+        }
+        
+        if (compacted > 0) {
+            conversation_bytes.set(bytes);
+            IDA_CHAT_DEBUG("compacted %zu conversation blocks, %zu bytes left", compacted, bytes);
+        }
+    }
+    
+    // Fold the session into the lifetime file and start a fresh session
+    void persist_metrics() {
+        fold_stalls();
+        if (session_metrics.empty()) return;
+        
+        if (!options.metrics_path.empty()) {
+            // Re-read under the lock: another IDA instance may have saved since we loaded
+            if (auto stored = MetricsRegistry::merge_into_file(options.metrics_path, session_metrics)) {
+                lifetime_metrics = std::move(*stored);
+                session_metrics.clear();
+                return;
+            }
+            IDA_CHAT_DEBUG("could not save metrics to %s", options.metrics_path.c_str());
+        }
+        lifetime_metrics.merge(session_metrics);
+        session_metrics.clear();
+    }
+    // Cancel token for scheduler waits and CLI calls, replaced whenever `cancelled` is reset
+    std::mutex cancel_mutex;
+    CancelToken script_cancel = CancelToken::create();
+    
+    CancelToken script_cancel_token() {
+        std::lock_guard<std::mutex> lock(cancel_mutex);
+        return script_cancel;
+    }
+    
+    void reset_cancel() {
+        std::lock_guard<std::mutex> lock(cancel_mutex);
+        cancelled = false;
+        script_cancel = CancelToken::create();
+    }
     
     // Execute idascript and return output
     std::string execute_script(const std::string& code) {
@@ -62,7 +381,24 @@ struct ChatCore::Impl {
         
         callback.on_script_code(code);
         
-        auto result = script_executor(code);
+        ScriptResult result;
+        {
+            // A cancel also withdraws the script if it is still waiting for the main thread
+            ScriptCancelScope cancel_scope(script_cancel_token());
+            TraceSpan span("script", "script");
+            result = script_executor(code);
+        }
+        if (options.recorder) {
+            options.recorder->record_script(code, result);
+        }
+        metrics->on_script(result);
+        session_metrics.add(metric_names::SCRIPTS);
+        session_metrics.record(metric_names::SCRIPT_MS, result.execution_time_ms);
+        session_metrics.record(metric_names::SCRIPT_QUEUE_MS, result.queue_wait_ms);
+        session_metrics.record(metric_names::SCRIPT_SCHEDULE_MS, result.schedule_wait_ms);
+        if (!result.success) {
+            session_metrics.add(metric_names::SCRIPT_ERRORS);
+        }
         
         if (result.success) {
             callback.on_script_output(result.output);
@@ -111,6 +447,8 @@ struct ChatCore::Impl {
         double cost = 0.0;
         int num_turns = 1;
         std::string session_id;
+        TokenUsage usage;
+        bool cancelled = false;     ///< The CLI was killed by request_cancel()
     };
     
     // Run CLI call
@@ -188,18 +526,32 @@ struct ChatCore::Impl {
         
         IDA_CHAT_DEBUG("run_cli_call: is_continue=%d, session_id='%s'", is_continue, session_id.c_str());
         
-        FILE* fp = popen(cmd.c_str(), "r");
-        if (!fp) {
+        TraceSpan span("cli", "cli_call");
+        auto call_start = Tracer::Clock::now();
+        
+        // The CLI prints whole messages; its first one is our first token
+        static constexpr std::string_view FIRST_MESSAGE = "\"type\":\"assistant\"";
+        std::string seen;
+        bool first_output = true;
+        CLICommandResult run = run_cli_command(cmd, script_cancel_token(), [&](std::string_view chunk) {
+            if (!first_output) return;
+            seen.append(chunk);
+            if (seen.find(FIRST_MESSAGE) != std::string::npos) {
+                metrics->on_output(0);
+                Tracer::instance().complete("cli", "ttft", call_start, Tracer::Clock::now());
+                first_output = false;
+                seen.clear();
+            }
+        });
+        if (!run.started) {
             result.error_text = "Failed to execute Claude CLI";
             return result;
         }
-        
-        char buffer[4096];
-        std::string output;
-        while (fgets(buffer, sizeof(buffer), fp)) {
-            output += buffer;
+        if (run.cancelled) {
+            result.cancelled = true;
+            return result;
         }
-        pclose(fp);
+        const std::string& output = run.output;
         
         IDA_CHAT_DEBUG("run_cli_call: raw output length=%zu", output.size());
         
@@ -214,6 +566,18 @@ struct ChatCore::Impl {
                 std::string type = json.value("type", "");
                 
                 if (type == "assistant") {
+                    // Thinking belongs to the phase that is ending, so report it first
+                    if (json.contains("message") && json["message"].contains("content")) {
+                        for (const auto& block : json["message"]["content"]) {
+                            if (block.value("type", "") == "thinking") {
+                                std::string thinking = block.value("thinking", "");
+                                if (!thinking.empty()) {
+                                    callback.on_thinking_text(thinking);
+                                }
+                            }
+                        }
+                    }
+                    
                     callback.on_thinking_done();
                     
                     if (json.contains("message") && json["message"].contains("content")) {
@@ -247,6 +611,9 @@ struct ChatCore::Impl {
                     }
                     result.cost = json.value("total_cost_usd", 0.0);
                     result.num_turns = json.value("num_turns", 1);
+                    if (json.contains("usage")) {
+                        from_json(json["usage"], result.usage);
+                    }
                     
                     if (json.contains("session_id")) {
                         result.session_id = json["session_id"].get<std::string>();
@@ -272,7 +639,7 @@ struct ChatCore::Impl {
         ProcessResult result;
         
         state = ChatState::Processing;
-        cancelled = false;
+        reset_cancel();
         
         IDA_CHAT_DEBUG("process_message_cli: user_input='%s'", user_input.c_str());
         IDA_CHAT_DEBUG("process_message_cli: cli_path='%s'", cli_path.c_str());
@@ -301,9 +668,20 @@ struct ChatCore::Impl {
             IDA_CHAT_DEBUG("process_message_cli: turn %d, is_continue=%d, session_id='%s'", 
                           turn + 1, is_continue, session_id.c_str());
             
+            ScopedLatency turn_latency(session_metrics, metric_names::TURN_LATENCY_MS);
+            metrics->begin_call(turn + 1);
             auto cli_result = run_cli_call(current_message, session_id, is_continue);
+            metrics->end_call(cli_result.usage);
+            record_call(cli_result.usage, current_message.size());
+            
+            if (cli_result.cancelled) {
+                result.cancelled = true;
+                state = ChatState::Idle;
+                return result;
+            }
             
             if (!cli_result.error_text.empty()) {
+                session_metrics.add(metric_names::API_ERRORS);
                 result.error = cli_result.error_text;
                 callback.on_error(cli_result.error_text);
                 state = ChatState::Idle;
@@ -333,7 +711,7 @@ struct ChatCore::Impl {
                 if (!scripts.empty() && !outputs.empty()) {
                     // Need a session ID to continue
                     if (session_id.empty()) {
-                        IDA_CHAT_DEBUG("process_message_cli: WARNING - no session_id, cannot continue");
+                        IDA_CHAT_LOG(LogLevel::Warning, "core", "process_message_cli: no session_id, cannot continue");
                         break;
                     }
                     
@@ -384,16 +762,34 @@ ChatCore::ChatCore(ChatCallback& callback,
                    const ChatCoreOptions& options)
     : impl_(std::make_unique<Impl>(callback, std::move(script_executor), history, options)) {}
 
-ChatCore::~ChatCore() = default;
+ChatCore::~ChatCore() {
+    impl_->persist_metrics();
+    if (impl_->options.replay) {
+        EngineClock::set_manual(false);
+    }
+}
 
 bool ChatCore::connect(const AuthCredentials& credentials) {
     impl_->state = ChatState::Connecting;
-    impl_->cancelled = false;
+    impl_->reset_cancel();
+    
+    // A replay never touches the network; the key only marks the client configured
+    if (impl_->options.replay) {
+        impl_->use_cli_mode = false;
+        impl_->client = std::make_unique<ClaudeClient>(AuthCredentials{AuthType::ApiKey, "replay", ""});
+        impl_->client->set_stream_transport(impl_->options.replay->transport());
+        impl_->client->set_model(impl_->options.model);
+        impl_->state = ChatState::Idle;
+        return true;
+    }
     
     // For System auth, use CLI mode
     if (credentials.type == AuthType::System || credentials.type == AuthType::None) {
         impl_->cli_path = CLITransport::find_cli();
         if (!impl_->cli_path.empty()) {
+            if (impl_->options.recorder) {
+                IDA_CHAT_LOG(LogLevel::Warning, "core", "session recording covers API mode only");
+            }
             impl_->use_cli_mode = true;
             impl_->state = ChatState::Idle;
             return true;
@@ -415,6 +811,10 @@ bool ChatCore::connect(const AuthCredentials& credentials) {
         return false;
     }
     
+    if (impl_->options.recorder) {
+        impl_->client->set_stream_transport(impl_->options.recorder->transport());
+    }
+    
     impl_->client->set_model(impl_->options.model);
     impl_->state = ChatState::Idle;
     
@@ -433,7 +833,26 @@ bool ChatCore::is_connected() const noexcept {
     return impl_->state != ChatState::Disconnected && impl_->client != nullptr;
 }
 
-ProcessResult ChatCore::process_message(const std::string& user_input) {
+ProcessResult ChatCore::process_message(const std::string& user_input,
+                                        const std::vector<Attachment>& attachments) {
+    const auto& recorder = impl_->options.recorder;
+    if (recorder) {
+        recorder->record_input(user_input, attachments);
+    }
+    
+    ProcessResult result = run_message(user_input, attachments);
+    
+    if (recorder) {
+        recorder->record_result(result);
+    }
+    if (impl_->options.replay) {
+        impl_->options.replay->check_result(result);
+    }
+    return result;
+}
+
+ProcessResult ChatCore::run_message(const std::string& user_input,
+                                    const std::vector<Attachment>& attachments) {
     ProcessResult result;
     
     if (!is_connected()) {
@@ -441,20 +860,48 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
         return result;
     }
     
+    // Closes the request's metrics and reports them on every return path
+    struct RequestMetrics {
+        Impl& impl;
+        explicit RequestMetrics(Impl& i) : impl(i) {
+            impl.metrics->begin_request();
+            impl.session_metrics.add(metric_names::REQUESTS);
+        }
+        ~RequestMetrics() {
+            impl.metrics->end_request();
+            impl.publish_metrics();
+        }
+    } request_metrics(*impl_);
+    TraceSpan request_span("core", "request");
+    
+    // Never answer as if an attachment had been sent when its payload is gone
+    std::string attachment_error = missing_attachment_error(attachments);
+    if (!attachment_error.empty()) {
+        IDA_CHAT_LOG(LogLevel::Warning, "core", "%s", attachment_error.c_str());
+        result.error = attachment_error;
+        impl_->callback.on_error(attachment_error);
+        return result;
+    }
+    
     // Use CLI mode if configured
     if (impl_->use_cli_mode) {
-        return impl_->process_message_cli(user_input);
+        return impl_->process_message_cli(user_input + attachment_note(attachments));
     }
     
     impl_->state = ChatState::Processing;
-    impl_->cancelled = false;
+    impl_->reset_cancel();
     
     // Add user message to conversation
-    impl_->conversation.push_back(ClaudeMessage::user(user_input));
+    if (attachments.empty()) {
+        impl_->add_to_conversation(ClaudeMessage::user(user_input));
+    } else {
+        impl_->clear_cache_breakpoints();
+        impl_->add_to_conversation(build_user_message(user_input, attachments));
+    }
     
-    // Log to history
+    // Log to history (attachments by reference; the payloads stay in the blob store)
     if (impl_->history) {
-        impl_->history->append_user_message(user_input);
+        impl_->history->append_user_message(user_input + attachment_note(attachments));
     }
     
     int turn = 0;
@@ -465,27 +912,52 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
         impl_->callback.on_turn_start(turn, impl_->options.max_turns);
         impl_->callback.on_thinking();
         
+        TraceSpan turn_span("core", "turn");
+        ScopedLatency turn_latency(impl_->session_metrics, metric_names::TURN_LATENCY_MS);
+        if (turn_span.active()) {
+            turn_span.set_detail("turn " + std::to_string(turn));
+        }
+        
         // Build request
         CreateMessageRequest request;
-        request.model = impl_->options.model;
-        request.messages = impl_->conversation;
-        request.system = impl_->system_prompt;
-        request.tools = ClaudeClient::get_default_tools();
-        request.stream = true;
-        
-        if (impl_->options.enable_thinking) {
-            request.thinking = CreateMessageRequest::ThinkingConfig{true, impl_->options.thinking_budget};
+        {
+            TraceSpan build_span("core", "build_request");
+            impl_->compact_conversation();
+            request.model = impl_->options.model;
+            request.messages = impl_->conversation;
+            request.system = impl_->system_prompt;
+            request.tools = ClaudeClient::get_default_tools();
+            request.stream = true;
+            
+            if (impl_->options.enable_thinking) {
+                request.thinking = CreateMessageRequest::ThinkingConfig{true, impl_->options.thinking_budget};
+            }
         }
         
         // Accumulate text for this turn
         std::string turn_text;
         bool first_text = true;
+        bool first_delta = true;
+        auto call_start = Tracer::Clock::now();
+        auto bytes_before = impl_->client->get_bytes_sent();
+        impl_->metrics->begin_call(turn);
         
         auto response = impl_->client->send_message_streaming(request,
-            [this, &turn_text, &first_text](const StreamEvent& event) {
+            [this, &turn_text, &first_text, &first_delta, call_start](const StreamEvent& event) {
                 if (impl_->cancelled) return;
                 
+                if (event.type == StreamEventType::MessageStart && event.message.has_value()) {
+                    impl_->metrics->on_call_usage(event.message->usage);
+                }
+                
                 if (event.type == StreamEventType::ContentBlockDelta && event.delta.has_value()) {
+                    if (first_delta) {
+                        Tracer::instance().complete("api", "ttft", call_start, Tracer::Clock::now());
+                        first_delta = false;
+                    }
+                    impl_->metrics->on_output(
+                        estimate_tokens(event.delta->text) + estimate_tokens(event.delta->thinking));
+                    
                     if (event.delta->type == "text_delta" && !event.delta->text.empty()) {
                         if (first_text) {
                             impl_->callback.on_thinking_done();
@@ -497,6 +969,8 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
                         if (!text_only.empty()) {
                             impl_->callback.on_text(text_only);
                         }
+                    } else if (event.delta->type == "thinking_delta" && !event.delta->thinking.empty()) {
+                        impl_->callback.on_thinking_text(event.delta->thinking);
                     }
                 }
             });
@@ -505,12 +979,16 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
             if (impl_->cancelled) {
                 result.cancelled = true;
             } else {
+                impl_->session_metrics.add(metric_names::API_ERRORS);
                 result.error = "Failed to get response from Claude";
             }
             impl_->state = ChatState::Idle;
             return result;
         }
         
+        impl_->metrics->end_call(response->usage);
+        impl_->record_call(response->usage, impl_->client->get_bytes_sent() - bytes_before);
+        
         // Get full response text
         std::string response_text = response->get_text();
         
@@ -518,7 +996,7 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
         ClaudeMessage assistant_msg;
         assistant_msg.role = MessageRole::Assistant;
         assistant_msg.content = response->content;
-        impl_->conversation.push_back(assistant_msg);
+        impl_->add_to_conversation(assistant_msg);
         
         // Log to history
         if (impl_->history) {
@@ -546,7 +1024,7 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
                 // Add tool result to conversation as user message
                 // Note: This is a simplification - real implementation would use proper tool_use/tool_result
                 ClaudeMessage result_msg = ClaudeMessage::user("Script output:\n" + combined_output);
-                impl_->conversation.push_back(result_msg);
+                impl_->add_to_conversation(std::move(result_msg));
                 
                 // Continue the loop for another turn
                 continue;
@@ -569,7 +1047,11 @@ ProcessResult ChatCore::process_message(const std::string& user_input) {
 }
 
 void ChatCore::request_cancel() {
-    impl_->cancelled = true;
+    {
+        std::lock_guard<std::mutex> lock(impl_->cancel_mutex);
+        impl_->cancelled = true;
+        impl_->script_cancel.cancel();
+    }
     if (impl_->client) {
         impl_->client->cancel();
     }
@@ -584,6 +1066,20 @@ ChatState ChatCore::get_state() const noexcept {
     return impl_->state;
 }
 
+MetricsSnapshot ChatCore::get_metrics() const {
+    return impl_->metrics_snapshot();
+}
+
+std::shared_ptr<TurnMetricsRecorder> ChatCore::turn_metrics() const {
+    return impl_->metrics;
+}
+
+void ChatCore::set_turn_metrics(std::shared_ptr<TurnMetricsRecorder> recorder) {
+    if (recorder) {
+        impl_->metrics = std::move(recorder);
+    }
+}
+
 TokenUsage ChatCore::get_total_usage() const {
     return impl_->total_usage;
 }
@@ -597,10 +1093,11 @@ void ChatCore::load_system_prompt(const std::string& project_dir, bool inside_id
 }
 
 void ChatCore::clear_conversation() {
-    impl_->conversation.clear();
+    impl_->clear_conversation();
 }
 
 void ChatCore::start_new_session() {
+    impl_->persist_metrics();
     clear_conversation();
     if (impl_->history) {
         (void)impl_->history->start_new_session();
@@ -647,10 +1144,11 @@ std::string load_default_system_prompt(const std::string& project_dir, bool insi
     return prompt;
 }
 
-std::pair<bool, std::string> test_claude_connection(const AuthCredentials& credentials) {
+std::pair<bool, std::string> test_claude_connection(const AuthCredentials& credentials,
+                                                    const CancelToken& cancel) {
     // For System auth, use CLI transport (like the Python SDK does)
     if (credentials.type == AuthType::System || credentials.type == AuthType::None) {
-        return test_cli_connection();
+        return test_cli_connection("", cancel);
     }
     
     // For explicit API key/OAuth, use direct API
@@ -658,4 +1156,78 @@ std::pair<bool, std::string> test_claude_connection(const AuthCredentials& crede
     return client.test_connection();
 }
 
+namespace {
+
+struct CachedConnectionTest {
+    ConnectionTestResult result;
+    std::chrono::steady_clock::time_point tested_at;
+};
+
+std::mutex g_connection_test_mutex;
+std::unordered_map<std::uint64_t, CachedConnectionTest> g_connection_tests;
+
+std::uint64_t connection_test_key(const AuthCredentials& credentials) {
+    std::string material = auth_type_str(credentials.type);
+    material += '\0';
+    material += credentials.api_key;
+    material += '\0';
+    material += credentials.api_base_url;   // A different endpoint needs its own test
+    return fnv1a_64(material);
+}
+
+std::string connection_auth_path(const AuthCredentials& credentials) {
+    switch (credentials.type) {
+        case AuthType::ApiKey: return "API key";
+        case AuthType::OAuth: return "OAuth token";
+        default: {
+            std::string cli = CLITransport::find_cli();
+            return cli.empty() ? "Claude CLI" : "Claude CLI (" + cli + ")";
+        }
+    }
+}
+
+} // anonymous namespace
+
+ConnectionTestResult test_claude_connection_cached(const AuthCredentials& credentials, bool force,
+                                                  const CancelToken& cancel) {
+    const std::uint64_t key = connection_test_key(credentials);
+    
+    if (!force) {
+        std::lock_guard<std::mutex> lock(g_connection_test_mutex);
+        auto it = g_connection_tests.find(key);
+        if (it != g_connection_tests.end()) {
+            if (std::chrono::steady_clock::now() - it->second.tested_at < CONNECTION_TEST_TTL) {
+                ConnectionTestResult result = it->second.result;
+                result.cached = true;
+                return result;
+            }
+            g_connection_tests.erase(it);
+        }
+    }
+    
+    ConnectionTestResult result;
+    result.auth_path = connection_auth_path(credentials);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto [success, message] = test_claude_connection(credentials, cancel);
+    result.latency_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    result.success = success;
+    result.message = std::move(message);
+    
+    if (result.success) {
+        std::lock_guard<std::mutex> lock(g_connection_test_mutex);
+        g_connection_tests[key] = {result, std::chrono::steady_clock::now()};
+    }
+    
+    IDA_CHAT_DEBUG("connection test via %s: %s in %.0f ms",
+                   result.auth_path.c_str(), result.success ? "ok" : "failed", result.latency_ms);
+    return result;
+}
+
+void clear_connection_test_cache() {
+    std::lock_guard<std::mutex> lock(g_connection_test_mutex);
+    g_connection_tests.clear();
+}
+
 } // namespace ida_chat
@@ -0,0 +1,466 @@
+/**
+ * @file log.cpp
+ * @brief Asynchronous engine logging implementation.
+ */
+
+#include <ida_chat/core/log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ida_chat {
+
+namespace {
+
+// ============================================================================
+// Filter
+// ============================================================================
+
+struct Filter {
+    LogLevel default_level = LogLevel::Info;
+    std::vector<std::pair<std::string, LogLevel>> modules;
+    
+    [[nodiscard]] LogLevel floor() const noexcept {
+        LogLevel lowest = default_level;
+        for (const auto& [name, level] : modules) {
+            lowest = std::min(lowest, level);
+        }
+        return lowest;
+    }
+};
+
+const Filter DEFAULT_FILTER;
+
+std::atomic<const Filter*> g_filter{&DEFAULT_FILTER};
+
+/// Published filters stay alive so a reader never sees a freed table
+std::mutex g_filter_mutex;
+std::vector<std::unique_ptr<const Filter>> g_filters;
+
+void publish_filter(Filter filter) {
+    auto next = std::make_unique<const Filter>(std::move(filter));
+    std::lock_guard<std::mutex> lock(g_filter_mutex);
+    g_filter.store(next.get(), std::memory_order_release);
+    detail::log_floor.store(next->floor(), std::memory_order_release);
+    g_filters.push_back(std::move(next));
+}
+
+std::optional<LogLevel> parse_level(std::string_view name) {
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info") return LogLevel::Info;
+    if (name == "warning" || name == "warn") return LogLevel::Warning;
+    if (name == "error") return LogLevel::Error;
+    if (name == "off") return LogLevel::Off;
+    return std::nullopt;
+}
+
+std::string_view trim_view(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// ============================================================================
+// Record queue
+// ============================================================================
+
+/**
+ * Bounded multi-producer queue (Vyukov). Producers claim a slot with one CAS
+ * and never block; a full queue rejects the record. Only the logging thread
+ * pops.
+ */
+class RecordQueue {
+public:
+    static constexpr std::size_t CAPACITY = 4096;   // Power of two
+    
+    RecordQueue() : slots_(std::make_unique<Slot[]>(CAPACITY)) {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    bool push(LogRecord&& record) {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots_[pos & (CAPACITY - 1)];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record = std::move(record);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(LogRecord& out) {
+        Slot& slot = slots_[dequeue_ & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_ + 1) return false;
+        
+        out = std::move(slot.record);
+        slot.sequence.store(dequeue_ + CAPACITY, std::memory_order_release);
+        ++dequeue_;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogRecord record;
+    };
+    
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::size_t> enqueue_{0};
+    alignas(64) std::size_t dequeue_ = 0;
+};
+
+// ============================================================================
+// Sinks
+// ============================================================================
+
+std::string format_time(std::chrono::system_clock::time_point time) {
+    auto seconds = std::chrono::system_clock::to_time_t(time);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        time.time_since_epoch()).count() % 1000;
+    
+    std::tm local{};
+#ifdef IDA_CHAT_WINDOWS
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char buffer[32];
+    std::size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", static_cast<int>(millis));
+    return buffer;
+}
+
+void stderr_sink(const LogRecord& record) {
+    std::fprintf(stderr, "[%s] %s: %s\n", log_level_str(record.level),
+                 record.module, record.message.c_str());
+}
+
+class RotatingFile {
+public:
+    RotatingFile(std::string path, std::uint64_t max_bytes, int keep_files)
+        : path_(std::move(path)), max_bytes_(max_bytes), keep_files_(std::max(0, keep_files))
+    {
+        std::error_code ec;
+        size_ = std::filesystem::file_size(path_, ec);
+        if (ec) size_ = 0;
+        file_.open(path_, std::ios::binary | std::ios::app);
+    }
+    
+    [[nodiscard]] bool is_open() const { return file_.is_open(); }
+    
+    void write(const LogRecord& record) {
+        std::string line = format_time(record.time);
+        line += ' ';
+        line += log_level_str(record.level);
+        line += ' ';
+        line += record.module;
+        line += ": ";
+        line += record.message;
+        line += '\n';
+        
+        if (size_ > 0 && size_ + line.size() > max_bytes_) {
+            rotate();
+        }
+        file_.write(line.data(), static_cast<std::streamsize>(line.size()));
+        file_.flush();
+        size_ += line.size();
+    }
+
+private:
+    void rotate() {
+        file_.close();
+        std::error_code ec;
+        if (keep_files_ == 0) {
+            std::filesystem::remove(path_, ec);
+        }
+        for (int i = keep_files_; i >= 1; --i) {
+            std::string from = i == 1 ? path_ : path_ + "." + std::to_string(i - 1);
+            std::string to = path_ + "." + std::to_string(i);
+            std::filesystem::remove(to, ec);
+            std::filesystem::rename(from, to, ec);
+        }
+        file_.open(path_, std::ios::binary | std::ios::trunc);
+        size_ = 0;
+    }
+    
+    std::string path_;
+    std::uint64_t max_bytes_;
+    int keep_files_;
+    std::uint64_t size_ = 0;
+    std::ofstream file_;
+};
+
+// ============================================================================
+// Logging thread
+// ============================================================================
+
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+    
+    ~Logger() {
+        shutdown();
+        state_.store(STOPPED, std::memory_order_release);
+    }
+    
+    void submit(LogRecord&& record) {
+        int state = state_.load(std::memory_order_acquire);
+        if (state == IDLE) {
+            state = start();
+        }
+        if (state == STOPPED) {
+            deliver(record);
+            return;
+        }
+        
+        if (!queue_.push(std::move(record))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        submitted_.fetch_add(1, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+    }
+    
+    void flush() {
+        if (state_.load(std::memory_order_acquire) != RUNNING) return;
+        if (std::this_thread::get_id() == thread_id_) return;   // A sink logging
+        
+        auto target = submitted_.load(std::memory_order_acquire);
+        auto done = delivered_.load(std::memory_order_acquire);
+        while (done < target && state_.load(std::memory_order_acquire) == RUNNING) {
+            delivered_.wait(done, std::memory_order_acquire);
+            done = delivered_.load(std::memory_order_acquire);
+        }
+    }
+    
+    void shutdown() {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        if (state_.load(std::memory_order_acquire) != RUNNING) return;
+        
+        // New messages go straight to the sinks while the thread drains the rest
+        state_.store(STOPPED, std::memory_order_release);
+        stop_.store(true, std::memory_order_release);
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+        delivered_.notify_all();
+        
+        // The next message starts a new thread
+        stop_.store(false, std::memory_order_release);
+        state_.store(IDLE, std::memory_order_release);
+    }
+    
+    void set_console(LogSink sink, LogLevel min_level) {
+        auto next = sink ? std::make_shared<const LogSink>(std::move(sink)) : nullptr;
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        console_ = std::move(next);
+        console_level_ = min_level;
+    }
+    
+    bool set_file(const std::string& path, std::uint64_t max_bytes, int keep_files) {
+        std::unique_ptr<RotatingFile> next;
+        if (!path.empty()) {
+            next = std::make_unique<RotatingFile>(path, max_bytes, keep_files);
+            if (!next->is_open()) return false;
+        }
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        file_ = std::move(next);
+        return true;
+    }
+    
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum State : int { IDLE, RUNNING, STOPPED };
+    
+    int start() {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        if (state_.load(std::memory_order_acquire) == IDLE) {
+            thread_ = std::thread([this]() { run(); });
+            thread_id_ = thread_.get_id();
+            state_.store(RUNNING, std::memory_order_release);
+        }
+        return state_.load(std::memory_order_acquire);
+    }
+    
+    void run() {
+        LogRecord record;
+        for (;;) {
+            auto seen = wake_.load(std::memory_order_acquire);
+            bool delivered_any = false;
+            while (queue_.pop(record)) {
+                deliver(record);
+                delivered_.fetch_add(1, std::memory_order_release);
+                delivered_any = true;
+            }
+            if (delivered_any) {
+                delivered_.notify_all();
+            }
+            if (stop_.load(std::memory_order_acquire)) {
+                while (queue_.pop(record)) {
+                    deliver(record);
+                }
+                return;
+            }
+            wake_.wait(seen, std::memory_order_acquire);
+        }
+    }
+    
+    void deliver(const LogRecord& record) {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        if (record.level >= console_level_) {
+            if (console_) {
+                (*console_)(record);
+            } else {
+                stderr_sink(record);
+            }
+        }
+        if (file_) {
+            file_->write(record);
+        }
+    }
+    
+    RecordQueue queue_;
+    
+    std::mutex start_mutex_;
+    std::atomic<int> state_{IDLE};
+    std::thread thread_;
+    std::thread::id thread_id_;
+    std::atomic<bool> stop_{false};
+    std::atomic<std::uint32_t> wake_{0};
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> delivered_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    
+    // Only the logging thread delivers while it runs; the mutex covers
+    // reconfiguration and synchronous delivery after shutdown
+    std::mutex sink_mutex_;
+    std::shared_ptr<const LogSink> console_;    ///< nullptr = stderr
+    LogLevel console_level_ = LogLevel::Warning;
+    std::unique_ptr<RotatingFile> file_;
+};
+
+} // anonymous namespace
+
+const char* log_level_str(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::Debug:   return "debug";
+        case LogLevel::Info:    return "info";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Error:   return "error";
+        case LogLevel::Off:     return "off";
+        default:                return "unknown";
+    }
+}
+
+void set_log_sink(LogSink sink, LogLevel min_level) {
+    Logger::instance().set_console(std::move(sink), min_level);
+}
+
+bool set_log_file(const std::string& path, std::uint64_t max_bytes, int keep_files) {
+    return Logger::instance().set_file(path, max_bytes, keep_files);
+}
+
+void set_log_level(LogLevel level) noexcept {
+    Filter filter;
+    filter.default_level = level;
+    publish_filter(std::move(filter));
+}
+
+bool set_log_filter(std::string_view spec) {
+    Filter filter;
+    while (!spec.empty()) {
+        auto comma = spec.find(',');
+        std::string_view entry = trim_view(spec.substr(0, comma));
+        spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+        if (entry.empty()) continue;
+        
+        auto equals = entry.find('=');
+        if (equals == std::string_view::npos) {
+            auto level = parse_level(entry);
+            if (!level) return false;
+            filter.default_level = *level;
+            continue;
+        }
+        
+        std::string_view module = trim_view(entry.substr(0, equals));
+        auto level = parse_level(trim_view(entry.substr(equals + 1)));
+        if (module.empty() || !level) return false;
+        filter.modules.emplace_back(std::string(module), *level);
+    }
+    publish_filter(std::move(filter));
+    return true;
+}
+
+bool detail::log_module_enabled(LogLevel level, const char* module) noexcept {
+    const Filter* filter = g_filter.load(std::memory_order_acquire);
+    for (const auto& [name, module_level] : filter->modules) {
+        if (name == module) return level >= module_level;
+    }
+    return level >= filter->default_level;
+}
+
+void log_message(LogLevel level, const char* module, const char* fmt, ...) {
+    if (!log_enabled(level, module)) return;
+    
+    LogRecord record;
+    record.level = level;
+    record.module = module;
+    record.time = std::chrono::system_clock::now();
+    
+    va_list args;
+    va_start(args, fmt);
+    va_list measure;
+    va_copy(measure, args);
+    int length = std::vsnprintf(nullptr, 0, fmt, measure);
+    va_end(measure);
+    
+    if (length > 0) {
+        record.message.resize(static_cast<std::size_t>(length));
+        std::vsnprintf(record.message.data(), record.message.size() + 1, fmt, args);
+    }
+    va_end(args);
+    
+    Logger::instance().submit(std::move(record));
+}
+
+void flush_log() {
+    Logger::instance().flush();
+}
+
+void shutdown_log() {
+    Logger::instance().shutdown();
+}
+
+std::uint64_t log_dropped_count() noexcept {
+    return Logger::instance().dropped();
+}
+
+} // namespace ida_chat
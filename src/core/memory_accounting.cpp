@@ -0,0 +1,161 @@
+/**
+ * @file memory_accounting.cpp
+ * @brief Per-subsystem byte accounting implementation.
+ */
+
+#include <ida_chat/core/memory_accounting.hpp>
+
+#include <charconv>
+#include <iterator>
+
+namespace ida_chat {
+
+namespace {
+
+constexpr std::size_t MB = 1024 * 1024;
+
+constexpr const char* SUBSYSTEM_NAMES[] = {
+    "conversation",
+    "stream_buffers",
+    "chat_widgets",
+    "highlight_cache",
+    "search_index",
+};
+static_assert(std::size(SUBSYSTEM_NAMES) == MemoryAccountant::SUBSYSTEM_COUNT);
+
+inline std::size_t index_of(MemorySubsystem subsystem) noexcept {
+    return static_cast<std::size_t>(subsystem);
+}
+
+} // anonymous namespace
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) noexcept {
+    auto index = index_of(subsystem);
+    return index < std::size(SUBSYSTEM_NAMES) ? SUBSYSTEM_NAMES[index] : "unknown";
+}
+
+std::optional<MemorySubsystem> memory_subsystem_from_name(std::string_view name) noexcept {
+    for (std::size_t i = 0; i < std::size(SUBSYSTEM_NAMES); ++i) {
+        if (name == SUBSYSTEM_NAMES[i]) {
+            return static_cast<MemorySubsystem>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<MemoryBudgets> parse_memory_budgets(std::string_view spec, std::string* error) {
+    auto fail = [error](std::string message) -> std::optional<MemoryBudgets> {
+        if (error) *error = std::move(message);
+        return std::nullopt;
+    };
+    
+    MemoryBudgets budgets;
+    while (!spec.empty()) {
+        auto comma = spec.find(',');
+        std::string_view entry = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+        if (entry.empty()) continue;
+        
+        auto equals = entry.find('=');
+        if (equals == std::string_view::npos) {
+            return fail("expected name=MB, got '" + std::string(entry) + "'");
+        }
+        
+        std::string_view name = entry.substr(0, equals);
+        auto subsystem = memory_subsystem_from_name(name);
+        if (!subsystem) {
+            return fail("unknown memory subsystem '" + std::string(name) + "'");
+        }
+        
+        std::string_view value = entry.substr(equals + 1);
+        std::size_t mb = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), mb);
+        if (ec != std::errc() || end != value.data() + value.size()) {
+            return fail("bad budget '" + std::string(value) + "' for " + std::string(name));
+        }
+        budgets.emplace_back(*subsystem, mb * MB);
+    }
+    return budgets;
+}
+
+MemoryAccountant& MemoryAccountant::instance() {
+    static MemoryAccountant accountant;
+    return accountant;
+}
+
+MemoryAccountant::MemoryAccountant() {
+    for (std::size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        counters_[i].budget.store(default_budget(static_cast<MemorySubsystem>(i)),
+                                  std::memory_order_relaxed);
+    }
+}
+
+std::size_t MemoryAccountant::default_budget(MemorySubsystem subsystem) noexcept {
+    switch (subsystem) {
+        case MemorySubsystem::Conversation:   return 16 * MB;
+        case MemorySubsystem::StreamBuffers:  return 8 * MB;
+        case MemorySubsystem::ChatWidgets:    return 32 * MB;
+        case MemorySubsystem::HighlightCache: return 16 * MB;
+        case MemorySubsystem::SearchIndex:    return 64 * MB;
+        default:                              return 0;
+    }
+}
+
+void MemoryAccountant::add(MemorySubsystem subsystem, std::int64_t delta) noexcept {
+    auto& counter = counters_[index_of(subsystem)];
+    std::int64_t now = counter.bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    
+    std::int64_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (now > peak &&
+           !counter.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+std::size_t MemoryAccountant::bytes(MemorySubsystem subsystem) const noexcept {
+    auto value = counters_[index_of(subsystem)].bytes.load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<std::size_t>(value) : 0;
+}
+
+std::size_t MemoryAccountant::peak(MemorySubsystem subsystem) const noexcept {
+    auto value = counters_[index_of(subsystem)].peak.load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<std::size_t>(value) : 0;
+}
+
+std::size_t MemoryAccountant::total() const noexcept {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        sum += bytes(static_cast<MemorySubsystem>(i));
+    }
+    return sum;
+}
+
+void MemoryAccountant::set_budget(MemorySubsystem subsystem, std::size_t bytes) noexcept {
+    counters_[index_of(subsystem)].budget.store(bytes, std::memory_order_relaxed);
+}
+
+void MemoryAccountant::set_budgets(const MemoryBudgets& budgets) noexcept {
+    for (const auto& [subsystem, bytes] : budgets) {
+        set_budget(subsystem, bytes);
+    }
+}
+
+std::size_t MemoryAccountant::budget(MemorySubsystem subsystem) const noexcept {
+    return counters_[index_of(subsystem)].budget.load(std::memory_order_relaxed);
+}
+
+bool MemoryAccountant::over_budget(MemorySubsystem subsystem) const noexcept {
+    std::size_t limit = budget(subsystem);
+    return limit != 0 && bytes(subsystem) > limit;
+}
+
+std::vector<MemoryUsage> MemoryAccountant::usage() const {
+    std::vector<MemoryUsage> result;
+    result.reserve(SUBSYSTEM_COUNT);
+    for (std::size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        auto subsystem = static_cast<MemorySubsystem>(i);
+        result.push_back({subsystem, bytes(subsystem), peak(subsystem), budget(subsystem)});
+    }
+    return result;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,390 @@
+/**
+ * @file metrics.cpp
+ * @brief Metrics registry and histogram implementation.
+ */
+
+#include <ida_chat/core/metrics.hpp>
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/common/platform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <filesystem>
+
+#ifdef IDA_CHAT_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX        // std::min/std::max below
+#endif
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace ida_chat {
+
+namespace {
+
+/**
+ * @brief Exclusive advisory lock on a file, released by the OS if we die.
+ */
+class FileLock {
+public:
+    explicit FileLock(const std::string& path) {
+#ifdef IDA_CHAT_WINDOWS
+        handle_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle_ == INVALID_HANDLE_VALUE) return;
+        OVERLAPPED overlapped{};
+        locked_ = LockFileEx(handle_, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped) != 0;
+#else
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) return;
+        int rc;
+        while ((rc = flock(fd_, LOCK_EX)) != 0 && errno == EINTR) {}
+        locked_ = rc == 0;
+#endif
+    }
+    
+    ~FileLock() {
+#ifdef IDA_CHAT_WINDOWS
+        if (handle_ == INVALID_HANDLE_VALUE) return;
+        if (locked_) {
+            OVERLAPPED overlapped{};
+            UnlockFileEx(handle_, 0, 1, 0, &overlapped);
+        }
+        CloseHandle(handle_);
+#else
+        if (fd_ >= 0) close(fd_);     // Also drops the lock
+#endif
+    }
+    
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    
+    [[nodiscard]] bool locked() const noexcept { return locked_; }
+
+private:
+#ifdef IDA_CHAT_WINDOWS
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+    bool locked_ = false;
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+std::size_t Histogram::bucket_for(double value) noexcept {
+    if (!(value > std::ldexp(1.0, MIN_EXPONENT))) return 0;   // Also catches NaN
+    
+    // value = mantissa * 2^exponent with mantissa in [0.5, 1)
+    int exponent = 0;
+    double mantissa = std::frexp(value, &exponent);
+    int power = exponent - 1;
+    if (power >= MAX_EXPONENT) return BUCKET_COUNT - 1;
+    
+    auto sub = static_cast<std::size_t>((mantissa * 2.0 - 1.0) * SUB_BUCKETS);
+    sub = std::min<std::size_t>(sub, SUB_BUCKETS - 1);
+    return 1 + static_cast<std::size_t>(power - MIN_EXPONENT) * SUB_BUCKETS + sub;
+}
+
+double Histogram::bucket_midpoint(std::size_t index) noexcept {
+    if (index == 0) return 0.0;
+    
+    std::size_t offset = index - 1;
+    int power = static_cast<int>(offset / SUB_BUCKETS) + MIN_EXPONENT;
+    double sub = static_cast<double>(offset % SUB_BUCKETS);
+    return std::ldexp(1.0 + (sub + 0.5) / SUB_BUCKETS, power);
+}
+
+void Histogram::record(double value) {
+    if (counts_.empty()) {
+        counts_.assign(BUCKET_COUNT, 0);
+    }
+    ++counts_[bucket_for(value)];
+    
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    ++count_;
+    sum_ += value;
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.count_ == 0) return;
+    
+    if (counts_.empty()) {
+        counts_.assign(BUCKET_COUNT, 0);
+    }
+    for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    
+    min_ = count_ ? std::min(min_, other.min_) : other.min_;
+    max_ = count_ ? std::max(max_, other.max_) : other.max_;
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+double Histogram::percentile(double q) const {
+    if (count_ == 0) return 0.0;
+    
+    q = std::clamp(q, 0.0, 1.0);
+    auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count_))));
+    
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            // The exact extremes are known; keep estimates inside them
+            return std::clamp(i == 0 ? min_ : bucket_midpoint(i), min_, max_);
+        }
+    }
+    return max_;
+}
+
+nlohmann::json Histogram::to_json() const {
+    auto buckets = nlohmann::json::array();
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i]) {
+            buckets.push_back({i, counts_[i]});
+        }
+    }
+    return {
+        {"count", count_},
+        {"sum", sum_},
+        {"min", min()},
+        {"max", max()},
+        {"buckets", std::move(buckets)}
+    };
+}
+
+Histogram Histogram::from_json(const nlohmann::json& j) {
+    Histogram histogram;
+    if (!j.is_object()) return histogram;
+    
+    histogram.count_ = j.value("count", std::uint64_t{0});
+    histogram.sum_ = j.value("sum", 0.0);
+    histogram.min_ = j.value("min", 0.0);
+    histogram.max_ = j.value("max", 0.0);
+    
+    if (auto it = j.find("buckets"); it != j.end() && it->is_array()) {
+        histogram.counts_.assign(BUCKET_COUNT, 0);
+        for (const auto& bucket : *it) {
+            if (!bucket.is_array() || bucket.size() != 2) continue;
+            auto index = bucket[0].get<std::size_t>();
+            if (index < BUCKET_COUNT) {
+                histogram.counts_[index] += bucket[1].get<std::uint64_t>();
+            }
+        }
+    }
+    return histogram;
+}
+
+// ============================================================================
+// Summaries
+// ============================================================================
+
+nlohmann::json MetricsSummary::to_json() const {
+    nlohmann::json histogram_json = nlohmann::json::object();
+    for (const auto& [name, h] : histograms) {
+        histogram_json[name] = {
+            {"count", h.count}, {"min", h.min}, {"max", h.max}, {"mean", h.mean},
+            {"p50", h.p50}, {"p95", h.p95}, {"p99", h.p99}
+        };
+    }
+    return {
+        {"counters", counters},
+        {"gauges", gauges},
+        {"histograms", std::move(histogram_json)}
+    };
+}
+
+nlohmann::json MetricsSnapshot::to_json() const {
+    return {
+        {"session", session.to_json()},
+        {"lifetime", lifetime.to_json()}
+    };
+}
+
+// ============================================================================
+// MetricsRegistry
+// ============================================================================
+
+MetricsRegistry::MetricsRegistry(const MetricsRegistry& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    counters_ = other.counters_;
+    gauges_ = other.gauges_;
+    histograms_ = other.histograms_;
+}
+
+MetricsRegistry& MetricsRegistry::operator=(const MetricsRegistry& other) {
+    if (this != &other) {
+        std::scoped_lock lock(mutex_, other.mutex_);
+        counters_ = other.counters_;
+        gauges_ = other.gauges_;
+        histograms_ = other.histograms_;
+    }
+    return *this;
+}
+
+void MetricsRegistry::add(const std::string& counter, std::int64_t delta) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[counter] += delta;
+}
+
+void MetricsRegistry::set(const std::string& gauge, double value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gauges_[gauge] = value;
+}
+
+void MetricsRegistry::record(const std::string& histogram, double value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histograms_[histogram].record(value);
+}
+
+void MetricsRegistry::merge(const MetricsRegistry& other) {
+    if (this == &other) return;
+    
+    std::scoped_lock lock(mutex_, other.mutex_);
+    for (const auto& [name, value] : other.counters_) {
+        counters_[name] += value;
+    }
+    for (const auto& [name, value] : other.gauges_) {
+        gauges_[name] = value;
+    }
+    for (const auto& [name, histogram] : other.histograms_) {
+        histograms_[name].merge(histogram);
+    }
+}
+
+MetricsSummary MetricsRegistry::summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    MetricsSummary summary;
+    summary.counters = counters_;
+    summary.gauges = gauges_;
+    for (const auto& [name, h] : histograms_) {
+        summary.histograms[name] = HistogramSummary{
+            h.count(), h.min(), h.max(), h.mean(),
+            h.percentile(0.50), h.percentile(0.95), h.percentile(0.99)
+        };
+    }
+    return summary;
+}
+
+nlohmann::json MetricsRegistry::to_json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    nlohmann::json histogram_json = nlohmann::json::object();
+    for (const auto& [name, histogram] : histograms_) {
+        histogram_json[name] = histogram.to_json();
+    }
+    return {
+        {"version", 1},
+        {"counters", counters_},
+        {"gauges", gauges_},
+        {"histograms", std::move(histogram_json)}
+    };
+}
+
+MetricsRegistry MetricsRegistry::from_json(const nlohmann::json& j) {
+    MetricsRegistry registry;
+    if (!j.is_object()) return registry;
+    
+    try {
+        if (auto it = j.find("counters"); it != j.end() && it->is_object()) {
+            registry.counters_ = it->get<std::map<std::string, std::int64_t>>();
+        }
+        if (auto it = j.find("gauges"); it != j.end() && it->is_object()) {
+            registry.gauges_ = it->get<std::map<std::string, double>>();
+        }
+        if (auto it = j.find("histograms"); it != j.end() && it->is_object()) {
+            for (const auto& [name, value] : it->items()) {
+                registry.histograms_[name] = Histogram::from_json(value);
+            }
+        }
+    } catch (const nlohmann::json::exception&) {
+        return MetricsRegistry{};
+    }
+    return registry;
+}
+
+MetricsRegistry MetricsRegistry::load(const std::string& path) {
+    auto content = read_file(path);
+    if (!content) return {};
+    
+    auto j = nlohmann::json::parse(*content, nullptr, false);
+    if (j.is_discarded()) return {};
+    return from_json(j);
+}
+
+bool MetricsRegistry::save(const std::string& path) const {
+    auto parent = std::filesystem::path(path).parent_path().string();
+    if (!parent.empty() && !ensure_directory_exists(parent)) {
+        return false;
+    }
+    
+    // Write-then-rename so a crash never leaves a truncated lifetime file;
+    // the temp name is per writer so concurrent saves never share one
+    static std::atomic<std::uint64_t> tmp_counter{0};
+#ifdef IDA_CHAT_WINDOWS
+    std::string tmp = path + ".tmp" + std::to_string(_getpid()) + "_" + std::to_string(tmp_counter++);
+#else
+    std::string tmp = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(tmp_counter++);
+#endif
+    if (!write_file(tmp, to_json().dump())) {
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<MetricsRegistry> MetricsRegistry::merge_into_file(const std::string& path,
+                                                                const MetricsRegistry& delta) {
+    auto parent = std::filesystem::path(path).parent_path().string();
+    if (!parent.empty() && !ensure_directory_exists(parent)) {
+        return std::nullopt;
+    }
+    
+    FileLock lock(path + ".lock");
+    if (!lock.locked()) return std::nullopt;
+    
+    MetricsRegistry stored = load(path);
+    stored.merge(delta);
+    if (!stored.save(path)) return std::nullopt;
+    return stored;
+}
+
+bool MetricsRegistry::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_.empty() && gauges_.empty() && histograms_.empty();
+}
+
+void MetricsRegistry::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.clear();
+    gauges_.clear();
+    histograms_.clear();
+}
+
+} // namespace ida_chat
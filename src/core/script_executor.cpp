@@ -4,6 +4,9 @@
  */
 
 #include <ida_chat/core/script_executor.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/script_scheduler.hpp>
 
 #include <ida_chat/common/warn_off.hpp>
 #include <ida.hpp>
@@ -14,6 +17,7 @@
 
 #include <sstream>
 #include <chrono>
+#include <atomic>
 
 namespace ida_chat {
 
@@ -190,16 +194,13 @@ static constexpr const char* DB_SETUP_CODE = R"PYTHON(
 import sys
 import builtins
 
-# Debug: print Python path info
-print(f"[IDA Chat] Python: {sys.executable}")
-print(f"[IDA Chat] sys.path: {sys.path[:3]}...")
+# Runs before every script, so it stays silent unless something is wrong
 
 # Check if db already exists in builtins
 if not hasattr(builtins, 'db') or builtins.db is None:
     try:
         from ida_domain import Database
         builtins.db = Database.open()
-        print(f"[IDA Chat] Initialized db: {builtins.db.module}")
     except ImportError as e:
         # ida_domain not found - try to find where it might be
         print(f"[IDA Chat] ERROR: {e}")
@@ -237,10 +238,19 @@ db = builtins.db
 struct ScriptExecRequest : public exec_request_t {
     std::string code;
     ScriptResult result;
+    std::chrono::steady_clock::time_point queued_at = std::chrono::steady_clock::now();
     
     explicit ScriptExecRequest(const std::string& c) : code(c) {}
     
     ssize_t idaapi execute() override {
+        static std::atomic<std::uint64_t> script_counter{0};
+        StallScope stall(StallCause::Script, "script #" + std::to_string(++script_counter));
+        TraceSpan span("script", "script_exec");
+        
+        // execute_sync() only runs us once the main thread gets to the request
+        result.queue_wait_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - queued_at).count();
+        
         auto start_time = std::chrono::high_resolution_clock::now();
         
         // First, ensure 'db' is available in the global namespace
@@ -297,13 +307,25 @@ ScriptResult execute_script_on_main_thread(const std::string& code) {
     // MFF_WRITE allows modification of the database
     execute_sync(req, MFF_WRITE);
     
+    // Recorded on the waiting thread, next to the span it delays
+    Tracer::instance().complete("script", "queue_wait", req.queued_at,
+        req.queued_at + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(req.result.queue_wait_ms)));
+    
     return req.result;
 }
 
-ScriptExecutorFn create_main_thread_executor() {
-    return [](const std::string& code) -> ScriptResult {
+ScriptExecutorFn create_main_thread_executor(std::string session, TaskPriority priority) {
+    ScriptExecutorFn on_main_thread = [](const std::string& code) -> ScriptResult {
         return execute_script_on_main_thread(code);
     };
+    auto scheduled = ScriptScheduler::instance().wrap(on_main_thread, std::move(session), priority);
+    
+    // The main thread cannot wait for its own admission; it runs scripts
+    // directly (batch mode), which also keeps it from competing with itself
+    return [on_main_thread, scheduled](const std::string& code) -> ScriptResult {
+        return is_main_thread() ? on_main_thread(code) : scheduled(code);
+    };
 }
 
 bool is_main_thread() {
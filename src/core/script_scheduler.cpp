@@ -0,0 +1,308 @@
+/**
+ * @file script_scheduler.cpp
+ * @brief Main-thread script scheduler implementation.
+ */
+
+#include <ida_chat/core/script_scheduler.hpp>
+#include <ida_chat/core/metrics.hpp>
+#include <ida_chat/core/tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ida_chat {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_between(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+struct Waiter {
+    std::string session;
+    std::size_t priority = 0;
+    Clock::time_point queued_at;
+    bool admitted = false;
+};
+
+struct SessionState {
+    double vruntime_ms = 0.0;       ///< Main-thread time used, the fairness key
+    std::uint64_t scripts = 0;
+    double slice_total_ms = 0.0;
+    double wait_total_ms = 0.0;
+    std::size_t in_flight = 0;      ///< Scripts queued or running
+    bool closed = false;            ///< Erase once in_flight drops to zero
+};
+
+constexpr std::size_t INTERACTIVE = static_cast<std::size_t>(TaskPriority::Interactive);
+
+thread_local CancelToken current_cancel;
+
+} // anonymous namespace
+
+struct ScriptScheduler::Impl {
+    mutable std::mutex mutex;
+    std::condition_variable admitted;
+    bool running = false;
+    Clock::time_point resume_at;        ///< Earliest start of the next script
+    std::list<Waiter*> waiting;         ///< Submission order
+    std::map<std::string, SessionState> sessions;
+    
+    std::array<Histogram, TASK_PRIORITY_COUNT> wait_ms;
+    std::array<Histogram, TASK_PRIORITY_COUNT> slice_ms;
+    std::uint64_t long_slices = 0;
+    std::uint64_t promoted = 0;
+    
+    [[nodiscard]] bool has_waiter(const std::string& session) const {
+        return std::any_of(waiting.begin(), waiting.end(),
+                           [&](const Waiter* w) { return w->session == session; });
+    }
+    
+    // A session that was idle rejoins at the least-served active session's
+    // level, so time it did not use is not banked against the others
+    void enqueue(Waiter& waiter) {
+        bool active = has_waiter(waiter.session);
+        double floor = -1.0;
+        for (const Waiter* w : waiting) {
+            double v = sessions[w->session].vruntime_ms;
+            floor = floor < 0 ? v : std::min(floor, v);
+        }
+        auto& state = sessions[waiter.session];
+        if (!active && floor >= 0) {
+            state.vruntime_ms = std::max(state.vruntime_ms, floor);
+        }
+        state.closed = false;
+        state.in_flight++;
+        waiting.push_back(&waiter);
+    }
+    
+    // Caller holds mutex
+    void leave(const std::string& session) {
+        auto it = sessions.find(session);
+        if (it == sessions.end()) return;
+        if (--it->second.in_flight == 0 && it->second.closed) {
+            sessions.erase(it);
+        }
+    }
+    
+    // A script gave up before running: drop it from the queue, or give back
+    // the slot it was admitted to
+    void withdraw(Waiter& waiter) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (waiter.admitted) {
+            running = false;
+        } else {
+            waiting.remove(&waiter);
+        }
+        leave(waiter.session);
+        admit_next();
+    }
+    
+    [[nodiscard]] std::size_t effective_priority(const Waiter& w, Clock::time_point now) const {
+        if (w.priority != INTERACTIVE && ms_between(w.queued_at, now) >= BACKGROUND_AGING_MS) {
+            return INTERACTIVE;
+        }
+        return w.priority;
+    }
+    
+    void admit_next() {
+        if (running || waiting.empty()) return;
+        
+        auto now = Clock::now();
+        auto best = waiting.end();
+        for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+            if (best == waiting.end()) {
+                best = it;
+                continue;
+            }
+            std::size_t p = effective_priority(**it, now);
+            std::size_t best_p = effective_priority(**best, now);
+            // Earlier entries win ties, which keeps each session FIFO
+            if (p < best_p ||
+                (p == best_p && sessions[(*it)->session].vruntime_ms <
+                                sessions[(*best)->session].vruntime_ms)) {
+                best = it;
+            }
+        }
+        
+        Waiter* next = *best;
+        if (next->priority != INTERACTIVE && effective_priority(*next, now) == INTERACTIVE) {
+            ++promoted;
+        }
+        waiting.erase(best);
+        next->admitted = true;
+        running = true;
+        admitted.notify_all();
+    }
+    
+    void finish(const Waiter& waiter, double wait, double slice) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& state = sessions[waiter.session];
+        state.vruntime_ms += slice;
+        state.scripts++;
+        state.slice_total_ms += slice;
+        state.wait_total_ms += wait;
+        wait_ms[waiter.priority].record(wait);
+        slice_ms[waiter.priority].record(slice);
+        leave(waiter.session);
+        
+        if (slice > LONG_SLICE_MS) {
+            ++long_slices;
+            resume_at = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(std::min(slice / 4.0, MAX_YIELD_MS)));
+        }
+        running = false;
+        admit_next();
+    }
+};
+
+// ============================================================================
+// ScriptCancelScope
+// ============================================================================
+
+ScriptCancelScope::ScriptCancelScope(CancelToken token) : previous_(std::move(current_cancel)) {
+    current_cancel = std::move(token);
+}
+
+ScriptCancelScope::~ScriptCancelScope() {
+    current_cancel = std::move(previous_);
+}
+
+CancelToken ScriptCancelScope::current() {
+    return current_cancel;
+}
+
+// ============================================================================
+// ScriptScheduler
+// ============================================================================
+
+ScriptScheduler& ScriptScheduler::instance() {
+    static ScriptScheduler scheduler;
+    return scheduler;
+}
+
+ScriptScheduler::ScriptScheduler() : impl_(std::make_unique<Impl>()) {}
+
+ScriptScheduler::~ScriptScheduler() = default;
+
+ScriptResult ScriptScheduler::run(const std::string& code,
+                                  const ScriptExecutorFn& executor,
+                                  const std::string& session,
+                                  TaskPriority priority) {
+    if (!executor) {
+        return ScriptResult::error_result("No script executor available");
+    }
+    
+    Waiter waiter;
+    waiter.session = session;
+    waiter.priority = static_cast<std::size_t>(priority);
+    waiter.queued_at = Clock::now();
+    
+    // Nothing signals the condition variable on cancel, so waits poll the token
+    CancelToken cancel = ScriptCancelScope::current();
+    auto poll = std::chrono::milliseconds(CANCEL_POLL_MS);
+    auto cancelled_result = [&]() {
+        impl_->withdraw(waiter);
+        Tracer::instance().complete("script", "schedule_cancelled", waiter.queued_at, Clock::now());
+        auto result = ScriptResult::error_result("Script cancelled before it started");
+        result.schedule_wait_ms = ms_between(waiter.queued_at, Clock::now());
+        return result;
+    };
+    
+    Clock::time_point resume_at;
+    {
+        std::unique_lock<std::mutex> lock(impl_->mutex);
+        impl_->enqueue(waiter);
+        impl_->admit_next();
+        while (!impl_->admitted.wait_for(lock, poll, [&]() { return waiter.admitted; })) {
+            if (cancel.cancelled()) {
+                lock.unlock();
+                return cancelled_result();
+            }
+        }
+        resume_at = impl_->resume_at;
+    }
+    
+    // The previous script ran long: leave the main thread to IDA for a moment
+    while (Clock::now() < resume_at) {
+        if (cancel.cancelled()) {
+            return cancelled_result();
+        }
+        std::this_thread::sleep_until(std::min(resume_at, Clock::now() + poll));
+    }
+    
+    auto start = Clock::now();
+    double wait = ms_between(waiter.queued_at, start);
+    Tracer::instance().complete("script", "schedule_wait", waiter.queued_at, start);
+    
+    ScriptResult result;
+    try {
+        result = executor(code);
+    } catch (...) {
+        result = ScriptResult::error_result("Script executor failed");
+    }
+    
+    // Main-thread occupancy: the executor's wall time minus its own wait for the main thread
+    double slice = std::max(result.execution_time_ms,
+                            ms_between(start, Clock::now()) - result.queue_wait_ms);
+    impl_->finish(waiter, wait, slice);
+    
+    result.schedule_wait_ms = wait;
+    result.queue_wait_ms += wait;
+    return result;
+}
+
+ScriptExecutorFn ScriptScheduler::wrap(ScriptExecutorFn executor,
+                                       std::string session,
+                                       TaskPriority priority) {
+    return [this, executor = std::move(executor), session = std::move(session), priority](
+               const std::string& code) {
+        return run(code, executor, session, priority);
+    };
+}
+
+void ScriptScheduler::close_session(const std::string& session) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->sessions.find(session);
+    if (it == impl_->sessions.end()) return;
+    
+    if (it->second.in_flight == 0) {
+        impl_->sessions.erase(it);
+    } else {
+        it->second.closed = true;
+    }
+}
+
+ScriptSchedulerStats ScriptScheduler::stats() const {
+    ScriptSchedulerStats stats;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    
+    for (const Waiter* w : impl_->waiting) {
+        stats.priorities[w->priority].queued++;
+    }
+    for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+        auto& out = stats.priorities[p];
+        out.completed = impl_->slice_ms[p].count();
+        out.wait_p50_ms = impl_->wait_ms[p].percentile(0.50);
+        out.wait_p99_ms = impl_->wait_ms[p].percentile(0.99);
+        out.slice_p50_ms = impl_->slice_ms[p].percentile(0.50);
+        out.slice_p99_ms = impl_->slice_ms[p].percentile(0.99);
+        out.slice_max_ms = impl_->slice_ms[p].max();
+    }
+    stats.long_slices = impl_->long_slices;
+    stats.promoted = impl_->promoted;
+    
+    for (const auto& [name, state] : impl_->sessions) {
+        stats.sessions.push_back({name, state.scripts, state.slice_total_ms, state.wait_total_ms});
+    }
+    return stats;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,234 @@
+/**
+ * @file search_index.cpp
+ * @brief Incremental trigram index implementation.
+ */
+
+#include <ida_chat/core/search_index.hpp>
+#include <ida_chat/history/blob_store.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace ida_chat {
+
+namespace {
+
+constexpr std::size_t BITMAP_MIN_BYTES = 256 * 1024;
+
+inline unsigned char fold(char c) noexcept {
+    auto u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u - 'A' + 'a') : u;
+}
+
+/// Hash and equality for the case-insensitive searcher
+struct FoldHash {
+    std::size_t operator()(char c) const noexcept { return fold(c); }
+};
+struct FoldEqual {
+    bool operator()(char a, char b) const noexcept { return fold(a) == fold(b); }
+};
+
+/// Trigrams are folded as they are read, so no lowercased copy is made
+inline std::uint32_t trigram_at(std::string_view text, std::size_t i) noexcept {
+    return (static_cast<std::uint32_t>(fold(text[i])) << 16)
+         | (static_cast<std::uint32_t>(fold(text[i + 1])) << 8)
+         |  static_cast<std::uint32_t>(fold(text[i + 2]));
+}
+
+std::vector<std::uint32_t> unique_trigrams(std::string_view text) {
+    std::vector<std::uint32_t> grams;
+    if (text.size() < 3) return grams;
+    
+    // Large documents: dedupe with a bitmap over the whole 24-bit trigram space
+    // (2 MB) instead of sorting millions of entries
+    if (text.size() > BITMAP_MIN_BYTES) {
+        std::vector<bool> seen(std::size_t{1} << 24);
+        for (std::size_t i = 0; i + 2 < text.size(); ++i) {
+            std::uint32_t gram = trigram_at(text, i);
+            if (!seen[gram]) {
+                seen[gram] = true;
+                grams.push_back(gram);
+            }
+        }
+        return grams;
+    }
+    
+    grams.reserve(text.size() - 2);
+    for (std::size_t i = 0; i + 2 < text.size(); ++i) {
+        grams.push_back(trigram_at(text, i));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+} // anonymous namespace
+
+void SearchIndex::add(std::uint64_t key, std::string_view text, std::string blob_id) {
+    // Extract trigrams outside the lock; this is the expensive part
+    auto grams = unique_trigrams(text);
+    
+    Document doc;
+    doc.key = key;
+    doc.blob_id = std::move(blob_id);
+    if (doc.blob_id.empty() || text.size() <= RETAIN_BYTES) {
+        doc.text = std::make_shared<const std::string>(text);
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto id = static_cast<std::uint32_t>(docs_.size());
+    if (doc.text) {
+        retained_bytes_ += doc.text->size();
+    }
+    docs_.push_back(std::move(doc));
+    indexed_bytes_ += text.size();
+    
+    // Ids only grow, so every posting list stays sorted
+    for (std::uint32_t gram : grams) {
+        postings_[gram].push_back(id);
+    }
+    posting_count_ += grams.size();
+    
+    account();
+    auto victims = evict_over_budget();
+    std::uint64_t epoch = epoch_;
+    lock.unlock();
+    
+    spill(victims, epoch);
+}
+
+void SearchIndex::account() {
+    // Text queued for spilling counts as released, so one pass over budget
+    // does not queue every document
+    tracked_.set(retained_bytes_ - spilling_bytes_ + posting_count_ * sizeof(std::uint32_t));
+}
+
+std::vector<SearchIndex::Spill> SearchIndex::evict_over_budget() {
+    // Oldest first. Documents already in a blob just drop their text; the
+    // rest keep it until spill() has written them out.
+    std::vector<Spill> victims;
+    while (tracked_.over_budget() && evict_cursor_ < docs_.size()) {
+        auto id = static_cast<std::uint32_t>(evict_cursor_++);
+        Document& doc = docs_[id];
+        if (!doc.text) continue;
+        
+        if (!doc.blob_id.empty()) {
+            retained_bytes_ -= doc.text->size();
+            doc.text.reset();
+        } else {
+            spilling_bytes_ += doc.text->size();
+            victims.push_back({id, doc.text});
+        }
+        account();
+    }
+    return victims;
+}
+
+void SearchIndex::spill(const std::vector<Spill>& victims, std::uint64_t epoch) {
+    for (const auto& victim : victims) {
+        BlobRef ref = BlobStore::shared().put(*victim.text);
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (epoch != epoch_) return;    // Cleared meanwhile
+        
+        Document& doc = docs_[victim.id];
+        spilling_bytes_ -= victim.text->size();
+        if (ref.valid()) {
+            doc.blob_id = std::move(ref.id);
+            doc.text.reset();
+            retained_bytes_ -= victim.text->size();
+        }
+        // On a failed write the text simply stays in memory
+        account();
+    }
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::find(std::string_view query, std::size_t max_hits) const {
+    std::vector<Hit> hits;
+    if (query.empty()) return hits;
+    
+    std::string_view needle = query;
+    std::vector<Document> candidates;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (needle.size() < 3) {
+            candidates = docs_;
+        } else {
+            // Intersect posting lists, smallest first
+            std::vector<const std::vector<std::uint32_t>*> lists;
+            for (std::uint32_t gram : unique_trigrams(needle)) {
+                auto it = postings_.find(gram);
+                if (it == postings_.end()) return hits;
+                lists.push_back(&it->second);
+            }
+            std::sort(lists.begin(), lists.end(),
+                      [](const auto* a, const auto* b) { return a->size() < b->size(); });
+            
+            std::vector<std::uint32_t> ids = *lists.front();
+            std::vector<std::uint32_t> next;
+            for (std::size_t i = 1; i < lists.size() && !ids.empty(); ++i) {
+                next.clear();
+                std::set_intersection(ids.begin(), ids.end(),
+                                      lists[i]->begin(), lists[i]->end(),
+                                      std::back_inserter(next));
+                ids.swap(next);
+            }
+            
+            candidates.reserve(ids.size());
+            for (std::uint32_t id : ids) {
+                candidates.push_back(docs_[id]);
+            }
+        }
+    }
+    
+    // Hits come back in conversation order regardless of indexing order
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Document& a, const Document& b) { return a.key < b.key; });
+    
+    // Verify outside the lock (trigrams can match without the full string),
+    // comparing case-insensitively in place rather than on a folded copy
+    std::boyer_moore_horspool_searcher searcher(needle.begin(), needle.end(), FoldHash{}, FoldEqual{});
+    for (const auto& doc : candidates) {
+        std::shared_ptr<const std::string> text = doc.text;
+        if (!text) {
+            auto data = BlobStore::shared().read_all(doc.blob_id);
+            if (!data) continue;
+            text = std::make_shared<const std::string>(std::move(*data));
+        }
+        
+        auto begin = text->begin();
+        for (auto it = std::search(begin, text->end(), searcher); it != text->end();
+             it = std::search(it + 1, text->end(), searcher)) {
+            hits.push_back({doc.key, static_cast<std::size_t>(it - begin)});
+            if (hits.size() >= max_hits) return hits;
+        }
+    }
+    return hits;
+}
+
+void SearchIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    docs_.clear();
+    postings_.clear();
+    indexed_bytes_ = 0;
+    retained_bytes_ = 0;
+    spilling_bytes_ = 0;
+    posting_count_ = 0;
+    evict_cursor_ = 0;
+    ++epoch_;
+    account();
+}
+
+std::size_t SearchIndex::document_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return docs_.size();
+}
+
+std::size_t SearchIndex::indexed_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indexed_bytes_;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,359 @@
+/**
+ * @file session_recording.cpp
+ * @brief Session record/replay implementation.
+ */
+
+#include <ida_chat/core/session_recording.hpp>
+#include <ida_chat/core/clock.hpp>
+#include <ida_chat/history/blob_store.hpp>
+
+#include <algorithm>
+
+namespace ida_chat {
+
+namespace {
+
+using Json = nlohmann::json;
+
+/// Recordings hold raw payloads; never let a stray invalid UTF-8 byte throw
+std::string dump_line(const Json& entry) {
+    return entry.dump(-1, ' ', false, Json::error_handler_t::replace);
+}
+
+/// "at byte N: recorded '...' vs '...'" for two payloads that should match
+std::string describe_difference(const std::string& recorded, const std::string& actual) {
+    auto mismatch = std::mismatch(recorded.begin(), recorded.end(), actual.begin(), actual.end());
+    auto offset = static_cast<std::size_t>(mismatch.first - recorded.begin());
+    
+    auto excerpt = [offset](const std::string& s) {
+        std::size_t begin = offset > 20 ? offset - 20 : 0;
+        std::string part = s.substr(begin, 60);
+        std::replace(part.begin(), part.end(), '\n', ' ');
+        return "'" + part + "'";
+    };
+    return "at byte " + std::to_string(offset) + ": recorded " + excerpt(recorded)
+         + " vs " + excerpt(actual);
+}
+
+Json script_result_to_json(const ScriptResult& result) {
+    return {
+        {"success", result.success},
+        {"output", result.output},
+        {"error", result.error},
+        {"execution_time_ms", result.execution_time_ms},
+        {"queue_wait_ms", result.queue_wait_ms},
+        {"schedule_wait_ms", result.schedule_wait_ms}
+    };
+}
+
+ScriptResult script_result_from_json(const Json& j) {
+    ScriptResult result;
+    result.success = j.value("success", false);
+    result.output = j.value("output", "");
+    result.error = j.value("error", "");
+    result.execution_time_ms = j.value("execution_time_ms", 0.0);
+    result.queue_wait_ms = j.value("queue_wait_ms", 0.0);
+    result.schedule_wait_ms = j.value("schedule_wait_ms", 0.0);
+    return result;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// SessionRecorder
+// ============================================================================
+
+SessionRecorder::SessionRecorder(const std::string& path)
+    : path_(path)
+    , file_(path, std::ios::binary | std::ios::trunc) {}
+
+bool SessionRecorder::is_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.is_open() && file_.good();
+}
+
+void SessionRecorder::write(const nlohmann::json& entry) {
+    std::string line = dump_line(entry);
+    line += '\n';
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    file_.flush();
+}
+
+void SessionRecorder::record_header(const ChatCoreOptions& options) {
+    write({
+        {"kind", "header"},
+        {"format", FORMAT_VERSION},
+        {"version", IDA_CHAT_VERSION},
+        {"model", options.model},
+        {"max_turns", options.max_turns},
+        {"enable_thinking", options.enable_thinking},
+        {"thinking_budget", options.thinking_budget}
+    });
+}
+
+void SessionRecorder::record_input(const std::string& text,
+                                   const std::vector<Attachment>& attachments) {
+    Json recorded_attachments = Json::array();
+    for (const auto& att : attachments) {
+        auto data = BlobStore::shared().read_all(att.blob_id);
+        recorded_attachments.push_back({{"label", att.label}, {"data", data.value_or("")}});
+    }
+    write({{"kind", "input"}, {"text", text}, {"attachments", std::move(recorded_attachments)}});
+}
+
+void SessionRecorder::record_script(const std::string& code, const ScriptResult& result) {
+    write({{"kind", "script"}, {"code", code}, {"result", script_result_to_json(result)}});
+}
+
+void SessionRecorder::record_result(const ProcessResult& result) {
+    write({
+        {"kind", "result"},
+        {"success", result.success},
+        {"cancelled", result.cancelled},
+        {"turns", result.turns_used},
+        {"response", result.response},
+        {"error", result.error}
+    });
+}
+
+StreamTransport SessionRecorder::transport() {
+    return [this](HttpClient& http, const std::string& body, const StreamCallback& on_chunk) {
+        write({{"kind", "request"}, {"body", body}});
+        
+        // The stream is kept whole (chunks may split UTF-8 sequences);
+        // chunks are (arrival offset, length) pairs into it
+        std::string stream;
+        Json chunks = Json::array();
+        auto start = EngineClock::now();
+        
+        auto response = http.stream_request(HttpMethod::POST, "/v1/messages", body,
+            [&](const std::string& data) {
+                auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+                    EngineClock::now() - start).count();
+                chunks.push_back({offset, data.size()});
+                stream += data;
+                return on_chunk(data);
+            });
+        
+        write({
+            {"kind", "response"},
+            {"status", response.status_code},
+            {"success", response.success},
+            {"error", response.error},
+            {"stream", std::move(stream)},
+            {"chunks", std::move(chunks)}
+        });
+        return response;
+    };
+}
+
+// ============================================================================
+// SessionReplay
+// ============================================================================
+
+std::shared_ptr<SessionReplay> SessionReplay::load(const std::string& path, std::string* error) {
+    auto fail = [error](std::string message) -> std::shared_ptr<SessionReplay> {
+        if (error) *error = std::move(message);
+        return nullptr;
+    };
+    
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return fail("cannot open " + path);
+    }
+    
+    auto replay = std::make_shared<SessionReplay>();
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (trim(line).empty()) continue;
+        
+        auto entry = Json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.is_object()) {
+            return fail(path + ":" + std::to_string(line_number) + ": not a JSON object");
+        }
+        
+        try {
+            std::string kind = entry.value("kind", "");
+            if (kind == "header") {
+                if (entry.value("format", 0) > SessionRecorder::FORMAT_VERSION) {
+                    return fail(path + ": recorded with a newer format");
+                }
+                replay->header_ = std::move(entry);
+            } else if (kind == "input") {
+                RecordedInput input;
+                input.text = entry.value("text", "");
+                for (const auto& att : entry.value("attachments", Json::array())) {
+                    input.attachments.emplace_back(att.value("label", ""), att.value("data", ""));
+                }
+                replay->inputs_.push_back(std::move(input));
+            } else if (kind == "request") {
+                Exchange exchange;
+                exchange.request_body = entry.value("body", "");
+                replay->exchanges_.push_back(std::move(exchange));
+            } else if (kind == "response") {
+                if (replay->exchanges_.empty()) {
+                    return fail(path + ":" + std::to_string(line_number) + ": response without request");
+                }
+                auto& exchange = replay->exchanges_.back();
+                exchange.status_code = entry.value("status", 0);
+                exchange.success = entry.value("success", false);
+                exchange.error = entry.value("error", "");
+                
+                std::string stream = entry.value("stream", "");
+                std::size_t pos = 0;
+                for (const auto& chunk : entry.value("chunks", Json::array())) {
+                    auto length = std::min(chunk.at(1).get<std::size_t>(), stream.size() - pos);
+                    exchange.chunks.push_back({chunk.at(0).get<std::int64_t>(), stream.substr(pos, length)});
+                    pos += length;
+                }
+            } else if (kind == "script") {
+                replay->scripts_.push_back({entry.value("code", ""),
+                                            script_result_from_json(entry.value("result", Json::object()))});
+            } else if (kind == "result") {
+                ProcessResult result;
+                result.success = entry.value("success", false);
+                result.cancelled = entry.value("cancelled", false);
+                result.turns_used = entry.value("turns", 0);
+                result.response = entry.value("response", "");
+                result.error = entry.value("error", "");
+                replay->results_.push_back(std::move(result));
+            }
+            // Unknown kinds are skipped so newer recorders stay readable
+        } catch (const Json::exception& e) {
+            return fail(path + ":" + std::to_string(line_number) + ": " + e.what());
+        }
+    }
+    
+    if (replay->inputs_.empty()) {
+        return fail(path + ": no user input recorded");
+    }
+    return replay;
+}
+
+ChatCoreOptions SessionReplay::apply_options(ChatCoreOptions base) const {
+    base.model = header_.value("model", base.model);
+    base.max_turns = header_.value("max_turns", base.max_turns);
+    base.enable_thinking = header_.value("enable_thinking", base.enable_thinking);
+    base.thinking_budget = header_.value("thinking_budget", base.thinking_budget);
+    return base;
+}
+
+std::string SessionReplay::system_prompt() const {
+    if (exchanges_.empty()) return {};
+    
+    auto body = Json::parse(exchanges_.front().request_body, nullptr, false);
+    if (body.is_discarded()) return {};
+    return body.value("system", "");
+}
+
+std::vector<Attachment> SessionReplay::materialize_attachments(const RecordedInput& input) {
+    std::vector<Attachment> attachments;
+    for (const auto& [label, data] : input.attachments) {
+        // Content-addressed, so the ids (and the request body) match the recording
+        auto ref = BlobStore::shared().put(data);
+        if (!ref.valid()) continue;
+        attachments.push_back({ref.id, label, data.size(), estimate_tokens(data)});
+    }
+    return attachments;
+}
+
+StreamTransport SessionReplay::transport() {
+    return [this](HttpClient&, const std::string& body, const StreamCallback& on_chunk) {
+        HttpResponse response;
+        const Exchange* exchange = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::size_t index = next_exchange_++;
+            if (index >= exchanges_.size()) {
+                diverge("request " + std::to_string(index + 1) + " was not recorded");
+                response.error = "No recorded response";
+                return response;
+            }
+            exchange = &exchanges_[index];
+            if (exchange->request_body != body) {
+                diverge("request " + std::to_string(index + 1) + " differs "
+                        + describe_difference(exchange->request_body, body));
+            }
+        }
+        
+        auto start = EngineClock::now();
+        for (const auto& chunk : exchange->chunks) {
+            EngineClock::advance_to(start + std::chrono::microseconds(chunk.offset_us));
+            if (!on_chunk(chunk.data)) {
+                response.error = "Request was cancelled";
+                return response;
+            }
+        }
+        
+        response.status_code = exchange->status_code;
+        response.success = exchange->success;
+        response.error = exchange->error;
+        return response;
+    };
+}
+
+ScriptExecutorFn SessionReplay::executor() {
+    return [this](const std::string& code) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t index = next_script_++;
+        if (index >= scripts_.size()) {
+            diverge("script " + std::to_string(index + 1) + " was not recorded");
+            return ScriptResult::error_result("Script was not recorded");
+        }
+        
+        const auto& script = scripts_[index];
+        if (script.code != code) {
+            diverge("script " + std::to_string(index + 1) + " differs "
+                    + describe_difference(script.code, code));
+        }
+        
+        // The script "ran" for as long as it did when recorded
+        EngineClock::advance(std::chrono::duration_cast<EngineClock::duration>(
+            std::chrono::duration<double, std::milli>(
+                script.result.queue_wait_ms + script.result.execution_time_ms)));
+        return script.result;
+    };
+}
+
+void SessionReplay::check_result(const ProcessResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t index = next_result_++;
+    if (index >= results_.size()) {
+        diverge("message " + std::to_string(index + 1) + " has no recorded result");
+        return;
+    }
+    
+    const auto& recorded = results_[index];
+    std::string label = "message " + std::to_string(index + 1);
+    if (recorded.success != result.success || recorded.cancelled != result.cancelled) {
+        diverge(label + " outcome differs (recorded "
+                + (recorded.success ? "success" : recorded.cancelled ? "cancelled" : "failure") + ")");
+    }
+    if (recorded.turns_used != result.turns_used) {
+        diverge(label + " took " + std::to_string(result.turns_used) + " turns, recorded "
+                + std::to_string(recorded.turns_used));
+    }
+    if (recorded.response != result.response) {
+        diverge(label + " response differs " + describe_difference(recorded.response, result.response));
+    }
+}
+
+void SessionReplay::diverge(std::string what) {
+    divergences_.push_back(std::move(what));
+}
+
+bool SessionReplay::diverged() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !divergences_.empty();
+}
+
+std::vector<std::string> SessionReplay::divergences() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return divergences_;
+}
+
+} // namespace ida_chat
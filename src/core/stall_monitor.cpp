@@ -0,0 +1,314 @@
+/**
+ * @file stall_monitor.cpp
+ * @brief GUI-thread stall detection implementation.
+ */
+
+#include <ida_chat/core/stall_monitor.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace ida_chat {
+
+const char* stall_cause_str(StallCause cause) noexcept {
+    switch (cause) {
+        case StallCause::Script:    return "script";
+        case StallCause::Render:    return "render";
+        case StallCause::Layout:    return "layout";
+        case StallCause::HistoryIO: return "history_io";
+        default:                    return "unknown";
+    }
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+StallMonitor& StallMonitor::instance() {
+    static StallMonitor monitor;
+    return monitor;
+}
+
+StallMonitor::~StallMonitor() {
+    stop();
+}
+
+void StallMonitor::start(PostFn post_to_gui) {
+    if (running_.load() || !post_to_gui) return;
+    
+    post_ = std::move(post_to_gui);
+    gui_thread_ = std::this_thread::get_id();
+    running_ = true;
+    thread_ = std::thread([this]() { watchdog_loop(); });
+}
+
+void StallMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.load()) return;
+        running_ = false;
+        ping_outstanding_ = false;
+        scopes_.clear();
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool StallMonitor::on_gui_thread() const noexcept {
+    return std::this_thread::get_id() == gui_thread_;
+}
+
+// ============================================================================
+// Watchdog
+// ============================================================================
+
+void StallMonitor::watchdog_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (running_.load()) {
+        auto now = Clock::now();
+        
+        if (!ping_outstanding_) {
+            std::uint64_t seq = ++ping_seq_;
+            ping_outstanding_ = true;
+            ping_sent_ = now;
+            ping_cause_ = StallCause::Unknown;
+            ping_detail_.clear();
+            
+            // Post outside the lock: the GUI thread may be waiting on it
+            lock.unlock();
+            post_([this, seq]() { on_pong(seq); });
+            lock.lock();
+        } else if (now - ping_sent_ >= STALL_THRESHOLD && ping_cause_ == StallCause::Unknown) {
+            // Overdue: sample what the GUI thread is doing right now
+            if (!scopes_.empty()) {
+                ping_cause_ = scopes_.back().first;
+                ping_detail_ = scopes_.back().second;
+            }
+        }
+        
+        wake_.wait_for(lock, PING_INTERVAL, [this]() { return !running_.load(); });
+    }
+}
+
+void StallMonitor::on_pong(std::uint64_t seq) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ping_outstanding_ || seq != ping_seq_) return;
+    
+    ping_outstanding_ = false;
+    auto end = Clock::now();
+    auto start = ping_sent_;
+    
+    StallCause cause = ping_cause_;
+    std::string detail = std::move(ping_detail_);
+    if (cause == StallCause::Unknown && hint_cause_ != StallCause::Unknown) {
+        cause = hint_cause_;
+        detail = std::move(hint_detail_);
+    }
+    hint_cause_ = StallCause::Unknown;
+    hint_detail_.clear();
+    
+    // A scope that ended inside this window already recorded the stall exactly
+    if (end - start >= STALL_THRESHOLD && last_record_end_ < start) {
+        add_record(start, end, cause, std::move(detail));
+    }
+}
+
+// ============================================================================
+// Attribution
+// ============================================================================
+
+void StallMonitor::hint(StallCause cause, std::string detail) {
+    if (!is_running() || !on_gui_thread()) return;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    hint_cause_ = cause;
+    hint_detail_ = std::move(detail);
+}
+
+void StallMonitor::enter_scope(StallCause cause, const std::string& detail) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scopes_.emplace_back(cause, detail);
+}
+
+void StallMonitor::leave_scope(StallCause cause, const std::string& detail,
+                               Clock::time_point started) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!scopes_.empty()) {
+        scopes_.pop_back();
+    }
+    
+    // Skip if a nested scope already recorded this stretch
+    auto end = Clock::now();
+    if (end - started >= STALL_THRESHOLD && last_record_end_ < started) {
+        add_record(started, end, cause, detail);
+    }
+}
+
+void StallMonitor::add_record(Clock::time_point start, Clock::time_point end,
+                              StallCause cause, std::string detail) {
+    // Caller holds mutex_
+    auto wall_start = std::chrono::system_clock::now() - (Clock::now() - start);
+    
+    StallRecord record;
+    record.start_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        wall_start.time_since_epoch()).count();
+    record.duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    record.cause = cause;
+    record.detail = std::move(detail);
+    
+    records_.push_back(std::move(record));
+    ++recorded_;
+    while (records_.size() > MAX_RECORDS) {
+        records_.pop_front();
+    }
+    last_record_end_ = std::max(last_record_end_, end);
+}
+
+// ============================================================================
+// Frame Sampling
+// ============================================================================
+
+void StallMonitor::record_frame(double frame_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_.push_back(frame_ms);
+    while (frames_.size() > FRAME_WINDOW) {
+        frames_.pop_front();
+    }
+}
+
+FrameStats StallMonitor::frame_stats() const {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples.assign(frames_.begin(), frames_.end());
+    }
+    
+    FrameStats stats;
+    stats.samples = samples.size();
+    if (samples.empty()) return stats;
+    
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q) {
+        auto idx = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(idx, samples.size() - 1)];
+    };
+    stats.p50_ms = at(0.50);
+    stats.p95_ms = at(0.95);
+    stats.max_ms = samples.back();
+    return stats;
+}
+
+// ============================================================================
+// Results
+// ============================================================================
+
+std::vector<StallRecord> StallMonitor::records() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {records_.begin(), records_.end()};
+}
+
+std::size_t StallMonitor::stall_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+}
+
+std::uint64_t StallMonitor::total_recorded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_;
+}
+
+std::vector<StallRecord> StallMonitor::records_since(std::uint64_t& cursor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t first = recorded_ - records_.size();
+    std::size_t skip = cursor > first ? static_cast<std::size_t>(cursor - first) : 0;
+    cursor = recorded_;
+    if (skip >= records_.size()) return {};
+    return {records_.begin() + static_cast<std::ptrdiff_t>(skip), records_.end()};
+}
+
+void StallMonitor::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+    frames_.clear();
+}
+
+nlohmann::json StallMonitor::to_json() const {
+    auto stalls = records();
+    auto frames = frame_stats();
+    
+    nlohmann::json by_cause = nlohmann::json::object();
+    nlohmann::json list = nlohmann::json::array();
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+    
+    for (const auto& record : stalls) {
+        auto& entry = by_cause[stall_cause_str(record.cause)];
+        entry["count"] = entry.value("count", 0) + 1;
+        entry["total_ms"] = entry.value("total_ms", 0.0) + record.duration_ms;
+        
+        total_ms += record.duration_ms;
+        max_ms = std::max(max_ms, record.duration_ms);
+        
+        list.push_back({
+            {"start_ms", record.start_ms},
+            {"duration_ms", record.duration_ms},
+            {"cause", stall_cause_str(record.cause)},
+            {"detail", record.detail}
+        });
+    }
+    
+    return {
+        {"threshold_ms", STALL_THRESHOLD.count()},
+        {"stall_count", stalls.size()},
+        {"total_stall_ms", total_ms},
+        {"max_stall_ms", max_ms},
+        {"by_cause", by_cause},
+        {"frames", {
+            {"samples", frames.samples},
+            {"p50_ms", frames.p50_ms},
+            {"p95_ms", frames.p95_ms},
+            {"max_ms", frames.max_ms}
+        }},
+        {"stalls", list}
+    };
+}
+
+bool StallMonitor::export_json(const std::string& path) const {
+    auto parent = std::filesystem::path(path).parent_path().string();
+    if (!parent.empty() && !ensure_directory_exists(parent)) {
+        return false;
+    }
+    
+    std::ofstream file(path);
+    if (!file) return false;
+    file << to_json().dump(2);
+    return static_cast<bool>(file);
+}
+
+// ============================================================================
+// StallScope
+// ============================================================================
+
+StallScope::StallScope(StallCause cause, std::string detail)
+    : cause_(cause)
+{
+    auto& monitor = StallMonitor::instance();
+    if (!monitor.is_running() || !monitor.on_gui_thread()) return;
+    
+    active_ = true;
+    detail_ = std::move(detail);
+    started_ = std::chrono::steady_clock::now();
+    monitor.enter_scope(cause_, detail_);
+}
+
+StallScope::~StallScope() {
+    if (active_) {
+        StallMonitor::instance().leave_scope(cause_, detail_, started_);
+    }
+}
+
+} // namespace ida_chat
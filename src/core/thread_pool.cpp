@@ -0,0 +1,380 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Work-stealing thread pool implementation.
+ */
+
+#include <ida_chat/core/thread_pool.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/metrics.hpp>
+#include <ida_chat/core/tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ida_chat {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t INTERACTIVE = static_cast<std::size_t>(TaskPriority::Interactive);
+constexpr std::size_t BACKGROUND = static_cast<std::size_t>(TaskPriority::Background);
+
+struct QueuedTask {
+    ThreadPool::Task run;
+    CancelToken token;
+    Clock::time_point queued_at;
+};
+
+struct Worker {
+    std::mutex mutex;
+    std::array<std::deque<QueuedTask>, TASK_PRIORITY_COUNT> queues;
+    std::thread thread;
+};
+
+} // anonymous namespace
+
+const char* task_priority_str(TaskPriority priority) noexcept {
+    switch (priority) {
+        case TaskPriority::Interactive: return "interactive";
+        case TaskPriority::Background:  return "background";
+        default:                        return "unknown";
+    }
+}
+
+// ============================================================================
+// CancelToken
+// ============================================================================
+
+CancelToken CancelToken::create() {
+    CancelToken token;
+    token.state_ = std::make_shared<std::atomic<bool>>(false);
+    return token;
+}
+
+void CancelToken::cancel() noexcept {
+    if (state_) state_->store(true, std::memory_order_relaxed);
+}
+
+bool CancelToken::cancelled() const noexcept {
+    return state_ && state_->load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// ThreadPool::Impl
+// ============================================================================
+
+struct ThreadPool::Impl {
+    explicit Impl(std::size_t threads)
+        : thread_count(threads)
+        , background_limit(std::max<std::size_t>(1, threads - 1))
+    {
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+    }
+    
+    const std::size_t thread_count;
+    const std::size_t background_limit;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::int64_t> started_ns{0};   ///< Clock ticks at first start, 0 before
+    std::atomic<std::size_t> next_worker{0};
+    
+    // Signed: a worker may take a task before its submitter counts it
+    std::array<std::atomic<std::int64_t>, TASK_PRIORITY_COUNT> queued{};
+    std::array<std::atomic<std::size_t>, TASK_PRIORITY_COUNT> active{};
+    std::array<std::atomic<std::uint64_t>, TASK_PRIORITY_COUNT> completed{};
+    std::atomic<std::uint64_t> cancelled{0};
+    std::atomic<std::uint64_t> stolen{0};
+    std::atomic<std::int64_t> busy_ns{0};
+    
+    // Sleeping workers and wait_idle() callers
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    bool running = false;                       ///< Worker threads exist
+    bool stopping = false;                      ///< stop() in progress; submits are dropped
+    std::atomic<bool> stop_requested{false};    ///< stopping, readable without the lock
+    
+    mutable std::mutex wait_mutex;
+    std::array<Histogram, TASK_PRIORITY_COUNT> wait_ms;
+    
+    static inline thread_local Impl* current_pool = nullptr;
+    static inline thread_local std::size_t current_worker = 0;
+    
+    /// Start the workers if they are not running; caller holds sleep_mutex
+    void start_locked() {
+        if (running) return;
+        std::int64_t unset = 0;
+        started_ns.compare_exchange_strong(unset, Clock::now().time_since_epoch().count(),
+                                           std::memory_order_relaxed);
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i]->thread = std::thread([this, i]() { worker_loop(i); });
+        }
+        running = true;
+    }
+    
+    /// Queue a task; caller holds sleep_mutex, so stop() cannot run in between
+    void push_locked(QueuedTask task, std::size_t priority) {
+        // Local submits keep related work on the same worker
+        std::size_t index = current_pool == this
+            ? current_worker
+            : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->queues[priority].push_back(std::move(task));
+        }
+        queued[priority].fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    bool pop(std::size_t index, std::size_t priority, bool steal, QueuedTask& out) {
+        auto& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        auto& queue = worker.queues[priority];
+        if (queue.empty()) return false;
+        
+        // The owner takes the oldest task, thieves the newest
+        if (steal) {
+            out = std::move(queue.back());
+            queue.pop_back();
+        } else {
+            out = std::move(queue.front());
+            queue.pop_front();
+        }
+        queued[priority].fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    bool take_from_any(std::size_t self, std::size_t priority, QueuedTask& out) {
+        if (pop(self, priority, false, out)) return true;
+        for (std::size_t offset = 1; offset < workers.size(); ++offset) {
+            if (pop((self + offset) % workers.size(), priority, true, out)) {
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool take(std::size_t self, QueuedTask& out, std::size_t& priority) {
+        if (queued[INTERACTIVE].load(std::memory_order_relaxed) > 0 &&
+            take_from_any(self, INTERACTIVE, out)) {
+            priority = INTERACTIVE;
+            active[INTERACTIVE].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (queued[BACKGROUND].load(std::memory_order_relaxed) <= 0) {
+            return false;
+        }
+        
+        // Reserve a background slot before taking, so the cap holds
+        std::size_t running = active[BACKGROUND].load(std::memory_order_relaxed);
+        do {
+            if (running >= background_limit) return false;
+        } while (!active[BACKGROUND].compare_exchange_weak(running, running + 1,
+                                                            std::memory_order_relaxed));
+        if (take_from_any(self, BACKGROUND, out)) {
+            priority = BACKGROUND;
+            return true;
+        }
+        active[BACKGROUND].fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    [[nodiscard]] bool runnable() const {
+        return queued[INTERACTIVE].load(std::memory_order_relaxed) > 0
+            || (queued[BACKGROUND].load(std::memory_order_relaxed) > 0 &&
+                active[BACKGROUND].load(std::memory_order_relaxed) < background_limit);
+    }
+    
+    [[nodiscard]] bool is_idle() const {
+        for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+            if (queued[p].load(std::memory_order_relaxed) > 0 ||
+                active[p].load(std::memory_order_relaxed) > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    void execute(QueuedTask& task, std::size_t priority) {
+        auto start = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            wait_ms[priority].record(
+                std::chrono::duration<double, std::milli>(start - task.queued_at).count());
+        }
+        
+        if (task.token.cancelled()) {
+            cancelled.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            try {
+                task.run();
+            } catch (const std::exception& e) {
+                IDA_CHAT_LOG(LogLevel::Error, "pool", "%s task threw: %s",
+                             task_priority_str(static_cast<TaskPriority>(priority)), e.what());
+            } catch (...) {
+                IDA_CHAT_LOG(LogLevel::Error, "pool", "%s task threw",
+                             task_priority_str(static_cast<TaskPriority>(priority)));
+            }
+            completed[priority].fetch_add(1, std::memory_order_relaxed);
+        }
+        task.run = nullptr;     // Release captures before reporting idle
+        busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count(), std::memory_order_relaxed);
+        
+        active[priority].fetch_sub(1, std::memory_order_relaxed);
+        
+        // A freed background slot may unblock a sleeper; an empty pool unblocks wait_idle()
+        bool freed_slot = priority == BACKGROUND && queued[BACKGROUND].load(std::memory_order_relaxed) > 0;
+        bool now_idle = is_idle();
+        if (freed_slot || now_idle) {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        if (freed_slot) wake.notify_one();
+        if (now_idle) idle.notify_all();
+    }
+    
+    void worker_loop(std::size_t index) {
+        current_pool = this;
+        current_worker = index;
+        Tracer::instance().set_thread_name("pool-" + std::to_string(index));
+        
+        while (!stop_requested.load(std::memory_order_relaxed)) {
+            QueuedTask task;
+            std::size_t priority = 0;
+            if (take(index, task, priority)) {
+                execute(task, priority);
+                continue;
+            }
+            
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [this]() { return stopping || runnable(); });
+            if (stopping) return;
+        }
+    }
+    
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            if (!running || stopping) return;
+            stopping = true;
+            stop_requested.store(true, std::memory_order_relaxed);
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+        
+        std::uint64_t dropped = 0;
+        for (auto& worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+                dropped += worker->queues[p].size();
+                queued[p].fetch_sub(static_cast<std::int64_t>(worker->queues[p].size()),
+                                    std::memory_order_relaxed);
+                worker->queues[p].clear();
+            }
+        }
+        cancelled.fetch_add(dropped, std::memory_order_relaxed);
+        
+        // Back to the initial state: the next submit starts fresh workers
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stop_requested.store(false, std::memory_order_relaxed);
+            stopping = false;
+            running = false;
+        }
+        idle.notify_all();
+    }
+};
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : impl_(std::make_unique<Impl>(threads ? threads
+                                           : std::max(2u, std::thread::hardware_concurrency())))
+{
+}
+
+ThreadPool::~ThreadPool() {
+    impl_->stop();
+}
+
+void ThreadPool::submit(Task task, TaskPriority priority, CancelToken token) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->sleep_mutex);
+        if (impl_->stopping) {
+            impl_->cancelled.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        impl_->start_locked();
+        impl_->push_locked({std::move(task), std::move(token), Clock::now()},
+                           static_cast<std::size_t>(priority));
+    }
+    impl_->wake.notify_one();
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(impl_->sleep_mutex);
+    impl_->idle.wait(lock, [this]() { return impl_->stopping || impl_->is_idle(); });
+}
+
+void ThreadPool::shutdown() {
+    impl_->stop();
+}
+
+std::size_t ThreadPool::thread_count() const noexcept {
+    return impl_->thread_count;
+}
+
+ThreadPoolStats ThreadPool::stats() const {
+    ThreadPoolStats stats;
+    stats.threads = impl_->thread_count;
+    stats.background_limit = impl_->background_limit;
+    stats.cancelled = impl_->cancelled.load(std::memory_order_relaxed);
+    stats.stolen = impl_->stolen.load(std::memory_order_relaxed);
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->wait_mutex);
+        for (std::size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+            auto& out = stats.priorities[p];
+            out.queued = static_cast<std::size_t>(
+                std::max<std::int64_t>(0, impl_->queued[p].load(std::memory_order_relaxed)));
+            out.active = impl_->active[p].load(std::memory_order_relaxed);
+            out.completed = impl_->completed[p].load(std::memory_order_relaxed);
+            out.wait_p50_ms = impl_->wait_ms[p].percentile(0.50);
+            out.wait_p99_ms = impl_->wait_ms[p].percentile(0.99);
+        }
+    }
+    
+    if (auto started = impl_->started_ns.load(std::memory_order_relaxed)) {
+        Clock::time_point started_at{Clock::duration(started)};
+        double wall_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - started_at).count());
+        double busy_ns = static_cast<double>(impl_->busy_ns.load(std::memory_order_relaxed));
+        if (wall_ns > 0) {
+            stats.utilization = std::min(1.0, busy_ns / (wall_ns * static_cast<double>(stats.threads)));
+        }
+    }
+    return stats;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,209 @@
+/**
+ * @file tracer.cpp
+ * @brief Tracing span collector implementation.
+ */
+
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/types.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace ida_chat {
+
+/**
+ * @brief Ring of events written by one thread.
+ */
+struct Tracer::ThreadBuffer {
+    std::mutex mutex;
+    std::uint32_t tid = 0;
+    std::string name;
+    std::vector<TraceEvent> ring;   ///< Grows to RING_CAPACITY, then wraps
+    std::size_t next = 0;           ///< Write position once wrapped
+    std::size_t dropped = 0;
+    bool exited = false;            ///< Owner thread has finished
+    bool exported = false;          ///< Nothing recorded since the last export
+};
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer& Tracer::local() {
+    // Marks the buffer when its thread exits and drops it at once if
+    // nothing in it is waiting for an export
+    struct Owner {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~Owner() {
+            if (!buffer) return;
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                buffer->exited = true;
+            }
+            Tracer& tracer = Tracer::instance();
+            std::lock_guard<std::mutex> lock(tracer.mutex_);
+            tracer.prune_locked();
+        }
+    };
+    thread_local Owner owner;
+    
+    if (!owner.buffer) {
+        owner.buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        prune_locked();
+        owner.buffer->tid = next_tid_++;
+        owner.buffer->name = "thread " + std::to_string(owner.buffer->tid);
+        buffers_.push_back(owner.buffer);
+    }
+    return *owner.buffer;
+}
+
+void Tracer::prune_locked() const {
+    // Rings of finished threads only matter until someone has seen them
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+        [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            return buffer->exited && (buffer->exported || buffer->ring.empty());
+        }), buffers_.end());
+}
+
+void Tracer::set_thread_name(std::string name) {
+    auto& buffer = local();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = std::move(name);
+}
+
+std::int64_t Tracer::since_epoch(Clock::time_point t) const noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t - epoch_).count();
+}
+
+void Tracer::record(TraceEvent event) {
+    auto& buffer = local();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.exported = false;
+    
+    if (buffer.ring.size() < RING_CAPACITY) {
+        buffer.ring.push_back(std::move(event));
+        return;
+    }
+    buffer.ring[buffer.next] = std::move(event);
+    buffer.next = (buffer.next + 1) % RING_CAPACITY;
+    ++buffer.dropped;
+}
+
+void Tracer::complete(const char* category, const char* name,
+                      Clock::time_point start, Clock::time_point end,
+                      std::string detail) {
+    if (!enabled()) return;
+    
+    TraceEvent event;
+    event.category = category;
+    event.name = name;
+    event.start_ns = since_epoch(start);
+    event.duration_ns = std::max<std::int64_t>(since_epoch(end) - event.start_ns, 0);
+    event.detail = std::move(detail);
+    record(std::move(event));
+}
+
+void Tracer::instant(const char* category, const char* name, std::string detail) {
+    if (!enabled()) return;
+    
+    TraceEvent event;
+    event.category = category;
+    event.name = name;
+    event.start_ns = since_epoch(Clock::now());
+    event.detail = std::move(detail);
+    record(std::move(event));
+}
+
+std::size_t Tracer::event_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::size_t count = 0;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        count += buffer->ring.size();
+    }
+    return count;
+}
+
+nlohmann::json Tracer::to_chrome_json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto events = nlohmann::json::array();
+    std::size_t dropped = 0;
+    
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        if (buffer->ring.empty()) continue;
+        buffer->exported = true;
+        
+        events.push_back({
+            {"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", buffer->tid},
+            {"args", {{"name", buffer->name}}}
+        });
+        
+        for (const auto& event : buffer->ring) {
+            // Chrome trace timestamps are microseconds
+            nlohmann::json entry = {
+                {"cat", event.category},
+                {"name", event.name},
+                {"pid", 1},
+                {"tid", buffer->tid},
+                {"ts", static_cast<double>(event.start_ns) / 1000.0}
+            };
+            if (event.duration_ns >= 0) {
+                entry["ph"] = "X";
+                entry["dur"] = static_cast<double>(event.duration_ns) / 1000.0;
+            } else {
+                entry["ph"] = "i";
+                entry["s"] = "t";
+            }
+            if (!event.detail.empty()) {
+                entry["args"] = {{"detail", event.detail}};
+            }
+            events.push_back(std::move(entry));
+        }
+        dropped += buffer->dropped;
+    }
+    
+    prune_locked();
+    
+    return {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+        {"otherData", {{"version", IDA_CHAT_VERSION}, {"dropped_events", dropped}}}
+    };
+}
+
+bool Tracer::export_chrome_json(const std::string& path) const {
+    auto parent = std::filesystem::path(path).parent_path().string();
+    if (!parent.empty() && !ensure_directory_exists(parent)) {
+        return false;
+    }
+    
+    std::ofstream file(path);
+    if (!file) return false;
+    file << to_chrome_json().dump();
+    return static_cast<bool>(file);
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->ring.clear();
+        buffer->next = 0;
+        buffer->dropped = 0;
+    }
+    prune_locked();
+}
+
+} // namespace ida_chat
@@ -0,0 +1,125 @@
+/**
+ * @file turn_metrics.cpp
+ * @brief Live per-request metrics implementation.
+ */
+
+#include <ida_chat/core/turn_metrics.hpp>
+
+#include <algorithm>
+
+namespace ida_chat {
+
+namespace {
+
+double ms_between(std::chrono::steady_clock::time_point from,
+                  std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // anonymous namespace
+
+double TurnMetrics::cache_hit_ratio() const noexcept {
+    auto prompt = usage.input_tokens + usage.cache_read_tokens + usage.cache_creation_tokens;
+    if (prompt <= 0) return 0.0;
+    return static_cast<double>(usage.cache_read_tokens) / static_cast<double>(prompt);
+}
+
+void TurnMetricsRecorder::begin_request() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    int request = metrics_.request + 1;
+    metrics_ = TurnMetrics{};
+    metrics_.request = request;
+    metrics_.active = true;
+    call_open_ = false;
+    request_start_ = Clock::now();
+}
+
+void TurnMetricsRecorder::end_request() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // A cancelled call never reports usage; keep what was streamed
+    if (call_open_) {
+        call_usage_.output_tokens = std::max<std::int64_t>(
+            call_usage_.output_tokens, static_cast<std::int64_t>(call_output_estimate_));
+        metrics_.usage += call_usage_;
+        call_open_ = false;
+    }
+    metrics_.active = false;
+    metrics_.elapsed_ms = ms_between(request_start_, Clock::now());
+}
+
+void TurnMetricsRecorder::begin_call(int turn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    metrics_.turn = turn;
+    metrics_.ttft_ms = -1.0;
+    metrics_.tokens_per_sec = 0.0;
+    call_open_ = true;
+    call_usage_ = TokenUsage{};
+    call_output_estimate_ = 0;
+    first_token_seen_ = false;
+    call_start_ = Clock::now();
+}
+
+void TurnMetricsRecorder::on_call_usage(const TokenUsage& usage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    call_usage_ = usage;
+}
+
+void TurnMetricsRecorder::on_output(std::size_t tokens) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!call_open_) return;
+    
+    if (!first_token_seen_) {
+        first_token_seen_ = true;
+        first_token_ = now;
+        metrics_.ttft_ms = ms_between(call_start_, now);
+    }
+    last_token_ = now;
+    call_output_estimate_ += tokens;
+}
+
+void TurnMetricsRecorder::end_call(const TokenUsage& usage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!call_open_) return;
+    
+    metrics_.tokens_per_sec = call_rate(usage.output_tokens);
+    metrics_.usage += usage;
+    call_open_ = false;
+}
+
+void TurnMetricsRecorder::on_script(const ScriptResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++metrics_.scripts;
+    metrics_.script_ms += result.execution_time_ms;
+    metrics_.queue_wait_ms += result.queue_wait_ms;
+}
+
+double TurnMetricsRecorder::call_rate(std::int64_t output_tokens) const {
+    // Caller holds mutex_. Needs a little streaming time to mean anything.
+    if (!first_token_seen_) return 0.0;
+    double seconds = ms_between(first_token_, last_token_) / 1000.0;
+    if (seconds < 0.1) return 0.0;
+    return static_cast<double>(output_tokens) / seconds;
+}
+
+TurnMetrics TurnMetricsRecorder::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    TurnMetrics snap = metrics_;
+    if (snap.active) {
+        snap.elapsed_ms = ms_between(request_start_, Clock::now());
+    }
+    if (call_open_) {
+        TokenUsage open = call_usage_;
+        open.output_tokens = std::max<std::int64_t>(
+            open.output_tokens, static_cast<std::int64_t>(call_output_estimate_));
+        snap.usage += open;
+        snap.tokens_per_sec = call_rate(open.output_tokens);
+    }
+    return snap;
+}
+
+} // namespace ida_chat
@@ -13,6 +13,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <cctype>
 
 #ifdef IDA_CHAT_WINDOWS
 #include <windows.h>
@@ -108,6 +109,9 @@ std::string get_home_directory() {
 }
 
 std::string get_config_directory() {
+    if (const char* env = std::getenv("IDA_CHAT_CONFIG_DIR"); env && *env) {
+        return env;
+    }
     return get_home_directory() + IDA_CHAT_PATH_SEP_STR ".ida-chat";
 }
 
@@ -115,6 +119,18 @@ std::string get_sessions_directory() {
     return get_config_directory() + IDA_CHAT_PATH_SEP_STR "sessions";
 }
 
+std::string get_blobs_directory() {
+    return get_config_directory() + IDA_CHAT_PATH_SEP_STR "blobs";
+}
+
+std::string get_metrics_directory() {
+    return get_config_directory() + IDA_CHAT_PATH_SEP_STR "metrics";
+}
+
+std::string get_logs_directory() {
+    return get_config_directory() + IDA_CHAT_PATH_SEP_STR "logs";
+}
+
 bool ensure_directory_exists(const std::string& path) {
 #ifdef IDA_CHAT_WINDOWS
     DWORD attrs = GetFileAttributesA(path.c_str());
@@ -145,6 +161,41 @@ bool ensure_directory_exists(const std::string& path) {
 #endif
 }
 
+// ============================================================================
+// Hashing
+// ============================================================================
+
+std::uint64_t fnv1a_64(std::string_view data) noexcept {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ============================================================================
+// Token Estimation
+// ============================================================================
+
+std::size_t estimate_tokens(std::string_view text) noexcept {
+    std::size_t tokens = 0;
+    std::size_t run = 0;
+    
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c >= 0x80) {
+            ++run;
+            continue;
+        }
+        tokens += (run + 3) / 4;
+        run = 0;
+        if (!std::isspace(c)) {
+            ++tokens;
+        }
+    }
+    return tokens + (run + 3) / 4;
+}
+
 // ============================================================================
 // Base64 URL Encoding
 // ============================================================================
@@ -0,0 +1,268 @@
+/**
+ * @file blob_store.cpp
+ * @brief Content-addressed blob storage implementation.
+ */
+
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/tracer.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef IDA_CHAT_WINDOWS
+#include <windows.h>
+#include <process.h>
+#else
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace ida_chat {
+
+namespace {
+
+long current_pid() {
+#ifdef IDA_CHAT_WINDOWS
+    return static_cast<long>(_getpid());
+#else
+    return static_cast<long>(getpid());
+#endif
+}
+
+/// Whether a lease owner still runs; errs toward alive, which only delays GC
+bool process_alive(long pid) {
+#ifdef IDA_CHAT_WINDOWS
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+    if (!process) return GetLastError() == ERROR_ACCESS_DENIED;
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// BlobStore Implementation
+// ============================================================================
+
+BlobStore::BlobStore(std::string directory)
+    : directory_(std::move(directory)) {
+    (void)ensure_directory_exists(directory_);
+}
+
+BlobStore::~BlobStore() {
+    if (!manifest_path_.empty()) {
+        std::remove(manifest_path_.c_str());
+    }
+}
+
+BlobStore& BlobStore::shared() {
+    static BlobStore store(get_blobs_directory());
+    return store;
+}
+
+std::string BlobStore::content_id(std::string_view data) {
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16) << fnv1a_64(data)
+        << '-' << data.size();
+    return oss.str();
+}
+
+std::string BlobStore::make_preview(std::string_view data) {
+    if (data.size() <= PREVIEW_BYTES) {
+        return std::string(data);
+    }
+    
+    // Back up to the start of a UTF-8 sequence
+    std::size_t cut = PREVIEW_BYTES;
+    while (cut > 0 && (static_cast<unsigned char>(data[cut]) & 0xC0) == 0x80) {
+        --cut;
+    }
+    
+    std::string preview(data.substr(0, cut));
+    preview += "\n... [" + std::to_string(data.size()) + " bytes total, stored as blob]";
+    return preview;
+}
+
+std::string BlobStore::path_for(const std::string& id) const {
+    return directory_ + IDA_CHAT_PATH_SEP_STR + id + ".blob";
+}
+
+bool BlobStore::contains(const std::string& id) const {
+    return !id.empty() && file_exists(path_for(id));
+}
+
+BlobRef BlobStore::put(std::string_view data) {
+    BlobRef ref;
+    std::string id = content_id(data);
+    std::string path = path_for(id);
+    
+    if (file_exists(path)) {
+        // Still in use: restart the GC grace period
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    } else {
+        StallScope stall(StallCause::HistoryIO, "blob write");
+        TraceSpan span("history", "blob_write");
+        
+        // Write-then-rename so readers never observe a partial blob
+        static std::atomic<std::uint64_t> tmp_counter{0};
+#ifdef IDA_CHAT_WINDOWS
+        std::string tmp = path + ".tmp" + std::to_string(tmp_counter++);
+#else
+        std::string tmp = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(tmp_counter++);
+#endif
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) return ref;
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.good()) {
+                file.close();
+                std::remove(tmp.c_str());
+                return ref;
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            // Lost a race with an identical writer, or the rename failed
+            std::remove(tmp.c_str());
+            if (!file_exists(path)) return ref;
+        }
+    }
+    
+    lease(id);
+    ref.id = std::move(id);
+    ref.size = data.size();
+    return ref;
+}
+
+std::string BlobStore::lease_directory() const {
+    return directory_ + IDA_CHAT_PATH_SEP_STR + "leases";
+}
+
+void BlobStore::lease(const std::string& id) {
+    if (id.empty()) return;
+    
+    std::lock_guard<std::mutex> lock(lease_mutex_);
+    if (!leased_.insert(id).second) return;
+    
+    // A manifest under our pid can only be a leftover of a dead process
+    auto mode = std::ios::binary | std::ios::app;
+    if (manifest_path_.empty()) {
+        (void)ensure_directory_exists(lease_directory());
+        manifest_path_ = lease_directory() + IDA_CHAT_PATH_SEP_STR + std::to_string(current_pid()) + ".ids";
+        mode = std::ios::binary | std::ios::trunc;
+    }
+    std::ofstream file(manifest_path_, mode);
+    file << id << '\n';
+}
+
+std::optional<std::string> BlobStore::read(const std::string& id,
+                                           std::uint64_t offset,
+                                           std::size_t length) const {
+    StallScope stall(StallCause::HistoryIO, "blob read");
+    std::ifstream file(path_for(id), std::ios::binary);
+    if (!file) return std::nullopt;
+    
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file) return std::string();
+    
+    std::string buffer(length, '\0');
+    file.read(buffer.data(), static_cast<std::streamsize>(length));
+    buffer.resize(static_cast<std::size_t>(file.gcount()));
+    return buffer;
+}
+
+std::optional<std::string> BlobStore::read_all(const std::string& id) const {
+    return read_file(path_for(id));
+}
+
+// ============================================================================
+// Garbage Collection
+// ============================================================================
+
+void BlobStore::find_ids(std::string_view text, std::unordered_set<std::string>& ids) {
+    // Ids are 16 lowercase hex digits, '-', and the size, also in hex
+    // (content_id leaves the stream in hex mode)
+    constexpr std::size_t HASH_DIGITS = 16;
+    auto is_hex = [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); };
+    
+    std::size_t pos = 0;
+    while ((pos = text.find('-', pos)) != std::string_view::npos) {
+        std::size_t dash = pos++;
+        if (dash < HASH_DIGITS || dash + 1 >= text.size() || !is_hex(text[dash + 1])) continue;
+        
+        std::size_t start = dash - HASH_DIGITS;
+        if (start > 0 && is_hex(text[start - 1])) continue;
+        bool hash = true;
+        for (std::size_t i = start; i < dash && hash; ++i) {
+            hash = is_hex(text[i]);
+        }
+        if (!hash) continue;
+        
+        std::size_t end = dash + 1;
+        while (end < text.size() && is_hex(text[end])) ++end;
+        ids.emplace(text.substr(start, end - start));
+        pos = end;
+    }
+}
+
+std::unordered_set<std::string> BlobStore::running_leases() const {
+    namespace fs = std::filesystem;
+    
+    std::unordered_set<std::string> ids;
+    std::error_code ec;
+    for (fs::directory_iterator it(lease_directory(), ec), end; !ec && it != end; it.increment(ec)) {
+        const auto& path = it->path();
+        if (path.extension() != ".ids") continue;
+        
+        long pid = std::strtol(path.stem().string().c_str(), nullptr, 10);
+        if (pid <= 0 || (pid != current_pid() && !process_alive(pid))) {
+            std::error_code remove_ec;
+            fs::remove(path, remove_ec);
+            continue;
+        }
+        if (auto content = read_file(path.string())) {
+            find_ids(*content, ids);
+        }
+    }
+    return ids;
+}
+
+std::size_t BlobStore::collect_garbage(const std::unordered_set<std::string>& live) {
+    namespace fs = std::filesystem;
+    TraceSpan span("history", "blob_gc");
+    
+    std::unordered_set<std::string> leased = running_leases();
+    
+    auto cutoff = fs::file_time_type::clock::now() - GC_GRACE;
+    std::size_t removed = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        // Blobs nobody references, and temp files left by interrupted writes
+        const auto& path = it->path();
+        bool temp = path.filename().string().find(".blob.tmp") != std::string::npos;
+        if (!temp && (path.extension() != ".blob" || live.count(path.stem().string()) ||
+                      leased.count(path.stem().string()))) continue;
+        
+        std::error_code time_ec;
+        auto written = fs::last_write_time(path, time_ec);
+        if (time_ec || written > cutoff) continue;
+        
+        std::error_code remove_ec;
+        if (fs::remove(path, remove_ec)) ++removed;
+    }
+    return removed;
+}
+
+} // namespace ida_chat
@@ -4,6 +4,9 @@
  */
 
 #include <ida_chat/history/message_history.hpp>
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/tracer.hpp>
 
 #include <fstream>
 #include <sstream>
@@ -46,6 +49,8 @@ struct MessageHistory::Impl {
         
         // Append to file
         std::string line = full_msg.dump() + "\n";
+        StallScope stall(StallCause::HistoryIO, "history append");
+        TraceSpan span("history", "history_write");
         (void)append_to_file(current_session_file, line);
         
         last_message_uuid = uuid;
@@ -143,10 +148,21 @@ std::string MessageHistory::append_tool_result(
     nlohmann::json msg = {
         {"type", "tool_result"},
         {"toolUseId", tool_use_id},
-        {"content", result},
         {"isError", is_error}
     };
     
+    // Large outputs live in the blob store; the transcript keeps a preview
+    if (result.size() >= BlobStore::SPILL_THRESHOLD) {
+        BlobRef blob = BlobStore::shared().put(result);
+        if (blob.valid()) {
+            msg["content"] = BlobStore::make_preview(result);
+            msg["contentBlob"] = blob.id;
+            msg["contentSize"] = blob.size;
+            return impl_->write_message(msg);
+        }
+    }
+    
+    msg["content"] = result;
     return impl_->write_message(msg);
 }
 
@@ -192,6 +208,7 @@ std::string MessageHistory::append_script_execution(
 
 std::vector<HistoryMessage> MessageHistory::load_session(const std::string& session_id) const {
     std::vector<HistoryMessage> messages;
+    StallScope stall(StallCause::HistoryIO, "load session");
     
     std::string file_path = impl_->sessions_dir + "/" + session_id + ".jsonl";
     std::ifstream file(file_path);
@@ -240,6 +257,7 @@ std::vector<HistoryMessage> MessageHistory::load_session(const std::string& sess
 
 std::vector<SessionInfo> MessageHistory::list_sessions() const {
     std::vector<SessionInfo> sessions;
+    StallScope stall(StallCause::HistoryIO, "list sessions");
     
     auto files = list_files(impl_->sessions_dir, ".jsonl");
     
@@ -378,6 +396,11 @@ void export_transcript_html(const std::string& session_file, const std::string&
                      << html_escape(code) << "</pre></div>\n";
             } else if (type == "tool_result") {
                 std::string content = json.value("content", "");
+                if (json.contains("contentBlob")) {
+                    if (auto full = BlobStore::shared().read_all(json["contentBlob"].get<std::string>())) {
+                        content = std::move(*full);
+                    }
+                }
                 bool is_error = json.value("isError", false);
                 html << "<div class='message tool'><strong>Output" 
                      << (is_error ? " (Error)" : "") << ":</strong><pre>" 
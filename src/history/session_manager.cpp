@@ -4,10 +4,14 @@
  */
 
 #include <ida_chat/history/session_manager.hpp>
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
 #include <fstream>
 #include <filesystem>
 #include <map>
+#include <unordered_set>
 
 namespace ida_chat {
 
@@ -146,11 +150,44 @@ std::optional<SessionInfo> SessionManager::get_session_info(const std::string& s
 bool SessionManager::delete_session(const std::string& session_id) {
     std::string path = get_session_path(session_id);
     
+    bool removed = false;
     try {
-        return fs::remove(path);
+        removed = fs::remove(path);
     } catch (const std::exception&) {
         return false;
     }
+    if (removed) {
+        // Scans every transcript, so never on the caller's thread
+        ThreadPool::instance().submit([]() {
+            (void)SessionManager().collect_blobs();
+        }, TaskPriority::Background);
+    }
+    return removed;
+}
+
+std::size_t SessionManager::collect_blobs() const {
+    // Transcripts live in per-database subdirectories
+    std::unordered_set<std::string> live;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(impl_->sessions_dir, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != ".jsonl") continue;
+        if (auto content = read_file(it->path().string())) {
+            BlobStore::find_ids(*content, live);
+        }
+    }
+    if (ec) {
+        // A partial scan could miss references; better to keep everything
+        IDA_CHAT_LOG(LogLevel::Warning, "history", "blob GC skipped: cannot scan %s",
+                     impl_->sessions_dir.c_str());
+        return 0;
+    }
+    
+    std::size_t removed = BlobStore::shared().collect_garbage(live);
+    if (removed > 0) {
+        IDA_CHAT_LOG(LogLevel::Info, "history", "removed %zu unreferenced blobs", removed);
+    }
+    return removed;
 }
 
 std::string SessionManager::create_session(const std::string& database_path) {
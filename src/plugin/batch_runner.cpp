@@ -0,0 +1,305 @@
+/**
+ * @file batch_runner.cpp
+ * @brief Headless batch runner implementation.
+ */
+
+#include <ida_chat/plugin/batch_runner.hpp>
+#include <ida_chat/plugin/settings.hpp>
+#include <ida_chat/core/chat_core.hpp>
+#include <ida_chat/core/chat_callback.hpp>
+#include <ida_chat/core/script_executor.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/common/json.hpp>
+
+#include <ida_chat/common/ida_begin.hpp>
+#include <auto.hpp>
+#include <diskio.hpp>
+#include <kernwin.hpp>
+#include <nalt.hpp>
+#include <ida_chat/common/ida_end.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace ida_chat {
+
+namespace {
+
+/// Name after -O on the idat command line (the plugin's file name)
+constexpr const char* PLUGIN_OPTIONS_NAME = "ida_chat";
+
+void apply_option(BatchOptions& options, const std::string& key, const std::string& value) {
+    if (key == "prompt") {
+        options.prompt = value;
+    } else if (key == "task") {
+        options.task_path = value;
+    } else if (key == "out") {
+        options.output_path = value;
+    } else if (key == "project") {
+        options.project_dir = value;
+    } else if (key == "max_turns") {
+        options.max_turns = std::max(1, std::atoi(value.c_str()));
+    } else if (key == "exit") {
+        options.exit_when_done = value != "0" && value != "off";
+    } else {
+        msg("IDA Chat batch: ignoring unknown option '%s'\n", key.c_str());
+    }
+}
+
+std::string find_project_dir(const BatchOptions& options) {
+    std::vector<std::string> candidates;
+    if (!options.project_dir.empty()) {
+        candidates.push_back(options.project_dir);
+    }
+    candidates.push_back(std::string(idadir(PLG_SUBDIR)) + "/ida_chat_project");
+    candidates.push_back(std::string(get_user_idadir()) + "/plugins/ida_chat_project");
+    
+    std::error_code ec;
+    for (const auto& dir : candidates) {
+        if (std::filesystem::exists(std::filesystem::path(dir) / "PROMPT.md", ec)) {
+            return dir;
+        }
+    }
+    return {};
+}
+
+std::string input_sha256() {
+    uchar hash[32];
+    if (!retrieve_input_file_sha256(hash)) {
+        return {};
+    }
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(sizeof(hash) * 2);
+    for (uchar byte : hash) {
+        hex += HEX[byte >> 4];
+        hex += HEX[byte & 0xF];
+    }
+    return hex;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Options and tasks
+// ============================================================================
+
+std::optional<BatchOptions> get_batch_options() {
+    BatchOptions options;
+    
+    auto from_env = [&options](const char* name, const char* key) {
+        if (const char* value = std::getenv(name); value && *value) {
+            apply_option(options, key, value);
+        }
+    };
+    from_env("IDA_CHAT_BATCH_PROMPT", "prompt");
+    from_env("IDA_CHAT_BATCH_TASK", "task");
+    from_env("IDA_CHAT_BATCH_OUT", "out");
+    from_env("IDA_CHAT_PROJECT_DIR", "project");
+    from_env("IDA_CHAT_BATCH_MAX_TURNS", "max_turns");
+    from_env("IDA_CHAT_BATCH_EXIT", "exit");
+    
+    // -Oida_chat:task=/path/tasks.jsonl;out=/path/results.jsonl wins over the environment
+    if (const char* spec = get_plugin_options(PLUGIN_OPTIONS_NAME)) {
+        std::istringstream entries(spec);
+        std::string entry;
+        while (std::getline(entries, entry, ';')) {
+            if (entry.empty()) continue;
+            auto equals = entry.find('=');
+            if (equals == std::string::npos) {
+                msg("IDA Chat batch: expected key=value, got '%s'\n", entry.c_str());
+                continue;
+            }
+            apply_option(options, entry.substr(0, equals), entry.substr(equals + 1));
+        }
+    }
+    
+    if (options.prompt.empty() && options.task_path.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+std::optional<std::vector<BatchTask>> load_batch_tasks(const std::string& path, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        if (error) *error = "cannot read " + path;
+        return std::nullopt;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    // The first non-empty line decides the format; after that, a line that
+    // is not a task is an error rather than a reason to reread the file as
+    // one prompt
+    std::vector<BatchTask> tasks;
+    bool task_list = true;
+    std::size_t line_number = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (task_list && std::getline(lines, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty()) continue;
+        
+        auto task = nlohmann::json::parse(line, nullptr, false);
+        if (task.is_discarded() || !task.is_object() || !task.contains("prompt") ||
+            !task["prompt"].is_string()) {
+            if (!tasks.empty()) {
+                if (error) {
+                    *error = path + ":" + std::to_string(line_number) +
+                             ": expected a JSON object with a string \"prompt\"";
+                }
+                return std::nullopt;
+            }
+            task_list = false;
+            break;
+        }
+        
+        std::string id = "task-" + std::to_string(tasks.size() + 1);
+        if (auto it = task.find("id"); it != task.end()) {
+            id = it->is_string() ? it->get<std::string>() : it->dump();
+        }
+        tasks.push_back({std::move(id), task["prompt"].get<std::string>()});
+    }
+    
+    if (!task_list || tasks.empty()) {
+        if (trim(text).empty()) {
+            if (error) *error = path + " is empty";
+            return std::nullopt;
+        }
+        tasks.assign(1, {"task-1", std::move(text)});
+    }
+    return tasks;
+}
+
+// ============================================================================
+// Batch run
+// ============================================================================
+
+int run_batch(const BatchOptions& options) {
+    std::vector<BatchTask> tasks;
+    if (!options.task_path.empty()) {
+        std::string error;
+        auto loaded = load_batch_tasks(options.task_path, &error);
+        if (!loaded) {
+            msg("IDA Chat batch: %s\n", error.c_str());
+            return 2;
+        }
+        tasks = std::move(*loaded);
+    }
+    if (!options.prompt.empty()) {
+        tasks.push_back({"prompt", options.prompt});
+    }
+    
+    std::string output_path = options.output_path.empty()
+        ? std::string(get_path(PATH_TYPE_IDB)) + ".ida-chat.jsonl"
+        : options.output_path;
+    std::ofstream out(output_path, std::ios::binary | std::ios::app);
+    if (!out) {
+        msg("IDA Chat batch: cannot write %s\n", output_path.c_str());
+        return 2;
+    }
+    
+    // Scripts run right here: batch mode owns the main thread
+    CollectorCallback callback;
+    ChatCoreOptions core_options;
+    core_options.max_turns = options.max_turns;
+    ChatCore core(callback, create_main_thread_executor("batch"), nullptr, core_options);
+    
+    apply_auth_to_environment();
+    if (!core.connect(get_auth_credentials())) {
+        msg("IDA Chat batch: not connected (check the saved authentication settings)\n");
+        return 2;
+    }
+    
+    std::string project_dir = find_project_dir(options);
+    if (!project_dir.empty()) {
+        core.load_system_prompt(project_dir);
+    } else {
+        msg("IDA Chat batch: no ida_chat_project directory found, running without a system prompt\n");
+    }
+    
+    char input_path[QMAXPATH] = {};
+    (void)get_input_file_path(input_path, sizeof(input_path));
+    std::string sha256 = input_sha256();
+    
+    int failed = 0;
+    for (const auto& task : tasks) {
+        core.start_new_session();
+        callback.clear();
+        
+        auto start = std::chrono::steady_clock::now();
+        auto result = core.process_message(task.prompt);
+        double duration_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        nlohmann::json record = {
+            {"binary", input_path},
+            {"sha256", sha256},
+            {"idb", get_path(PATH_TYPE_IDB)},
+            {"task", task.id},
+            {"success", result.success},
+            {"turns", result.turns_used},
+            {"duration_ms", duration_ms},
+            {"response", result.response},
+            {"metrics", core.get_metrics().to_json()},
+        };
+        record["cost"] = result.cost ? nlohmann::json(*result.cost) : nlohmann::json(nullptr);
+        if (!result.error.empty()) {
+            record["error"] = result.error;
+        }
+        out << record.dump() << '\n';
+        out.flush();
+        
+        if (!result.success) ++failed;
+        msg("IDA Chat batch: %s %s in %d turn(s), %.1f s\n", task.id.c_str(),
+            result.success ? "done" : "FAILED", result.turns_used, duration_ms / 1000.0);
+    }
+    
+    msg("IDA Chat batch: %zu task(s), %d failed, results in %s\n",
+        tasks.size(), failed, output_path.c_str());
+    return failed ? 1 : 0;
+}
+
+// ============================================================================
+// BatchRunner
+// ============================================================================
+
+BatchRunner::BatchRunner(BatchOptions options)
+    : options_(std::move(options))
+{
+    hook_event_listener(HT_UI, this, this);
+}
+
+BatchRunner::~BatchRunner() {
+    unhook_event_listener(HT_UI, this);
+    shutdown_log();
+    set_log_sink(nullptr);
+}
+
+bool idaapi BatchRunner::run(size_t) {
+    // Nothing to toggle without a GUI
+    return false;
+}
+
+ssize_t idaapi BatchRunner::on_event(ssize_t code, va_list) {
+    if (code != ui_ready_to_run || started_) {
+        return 0;
+    }
+    started_ = true;
+    
+    // The agent should see the finished analysis, not a half-built database
+    auto_wait();
+    int exit_code = run_batch(options_);
+    if (options_.exit_when_done) {
+        qexit(exit_code);
+    }
+    return 0;
+}
+
+} // namespace ida_chat
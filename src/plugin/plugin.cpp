@@ -6,6 +6,9 @@
 #include <ida_chat/plugin/plugin.hpp>
 #include <ida_chat/plugin/action_handlers.hpp>
 #include <ida_chat/plugin/settings.hpp>
+#include <ida_chat/plugin/batch_runner.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
 namespace ida_chat {
 
@@ -19,6 +22,14 @@ IDAChatPlugin::~IDAChatPlugin() {
     // Cleanup
     unregister_actions();
     detach_from_menus();
+    
+    // Pool tasks and the log sink run code from this module; stop both
+    // before it may go away. This runs on every database close (the module
+    // stays loaded), so both restart on their next use and init()
+    // installs the sink again.
+    ThreadPool::instance().shutdown();
+    shutdown_log();
+    set_log_sink(nullptr);
 }
 
 bool idaapi IDAChatPlugin::run(size_t arg) {
@@ -56,16 +67,48 @@ void IDAChatPlugin::hide_widget() {
 // Plugin Initialization
 // ============================================================================
 
+namespace {
+
+void configure_logging() {
+    // Engine log messages go to the output window. By default only warnings
+    // and up are produced at all (info too when a log file is enabled); an
+    // explicit filter decides what reaches the window.
+    auto filter = get_log_filter();
+    auto log_file = get_log_file();
+    bool filtered = !filter.empty() && set_log_filter(filter);
+    if (!filter.empty() && !filtered) {
+        msg("IDA Chat: Ignoring malformed log filter '%s'\n", filter.c_str());
+    }
+    if (!filtered) {
+        set_log_level(log_file.empty() ? LogLevel::Warning : LogLevel::Info);
+    }
+    set_log_sink([](const LogRecord& record) {
+        msg("[IDA Chat] %s: %s\n", record.module, record.message.c_str());
+    }, filtered ? LogLevel::Debug : LogLevel::Warning);
+    if (!log_file.empty() && !set_log_file(log_file)) {
+        msg("IDA Chat: Cannot open log file %s\n", log_file.c_str());
+    }
+}
+
+} // anonymous namespace
+
 plugmod_t* idaapi init() {
-    // Check if we're running in IDA (not idat batch mode)
+    // Without the GUI (idat) the plugin only runs when given a batch task
     if (!is_idaq()) {
-        msg("IDA Chat: Skipping initialization in batch mode\n");
-        return nullptr;
+        auto batch = get_batch_options();
+        if (!batch) {
+            msg("IDA Chat: Skipping initialization in batch mode\n");
+            return nullptr;
+        }
+        msg("IDA Chat v%s batch mode\n", PLUGIN_VERSION);
+        configure_logging();
+        return new BatchRunner(std::move(*batch));
     }
     
     msg("IDA Chat v%s initializing...\n", PLUGIN_VERSION);
     
     auto* plugin = new IDAChatPlugin();
+    configure_logging();
     
     // Register actions
     if (!register_actions(plugin)) {
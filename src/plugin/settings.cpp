@@ -90,6 +90,69 @@ void clear_settings() {
 // Common Functions
 // ============================================================================
 
+std::string get_stall_monitor_mode() {
+    if (const char* env = std::getenv("IDA_CHAT_STALL_MONITOR"); env && *env) {
+        return env;
+    }
+    auto settings = load_settings();
+    return settings.value(settings_keys::STALL_MONITOR, "off");
+}
+
+bool get_trace_enabled() {
+    if (const char* env = std::getenv("IDA_CHAT_TRACE"); env && *env) {
+        std::string value = env;
+        return value != "0" && value != "off";
+    }
+    auto settings = load_settings();
+    return settings.value(settings_keys::TRACE, false);
+}
+
+MemoryBudgets get_memory_budgets() {
+    MemoryBudgets budgets;
+    
+    auto settings = load_settings();
+    auto stored = settings.value(settings_keys::MEMORY_BUDGETS, nlohmann::json::object());
+    if (stored.is_object()) {
+        for (const auto& [name, mb] : stored.items()) {
+            auto subsystem = memory_subsystem_from_name(name);
+            if (subsystem && mb.is_number_unsigned()) {
+                budgets.emplace_back(*subsystem, mb.get<std::size_t>() * 1024 * 1024);
+            }
+        }
+    }
+    
+    // Applied in order, so environment entries win
+    if (const char* env = std::getenv("IDA_CHAT_MEMORY_BUDGETS"); env && *env) {
+        if (auto overrides = parse_memory_budgets(env)) {
+            budgets.insert(budgets.end(), overrides->begin(), overrides->end());
+        }
+    }
+    return budgets;
+}
+
+std::string get_log_filter() {
+    if (const char* env = std::getenv("IDA_CHAT_LOG"); env && *env) {
+        return env;
+    }
+    auto settings = load_settings();
+    return settings.value(settings_keys::LOG_FILTER, "");
+}
+
+std::string get_log_file() {
+    if (const char* env = std::getenv("IDA_CHAT_LOG_FILE"); env && *env) {
+        return env;
+    }
+    auto settings = load_settings();
+    if (!settings.value(settings_keys::LOG_FILE, false)) {
+        return {};
+    }
+    auto dir = get_logs_directory();
+    if (!ensure_directory_exists(dir)) {
+        return {};
+    }
+    return dir + IDA_CHAT_PATH_SEP_STR "ida-chat.log";
+}
+
 AuthCredentials get_auth_credentials() {
     AuthCredentials creds;
     creds.type = get_auth_type();
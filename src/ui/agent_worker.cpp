@@ -5,18 +5,14 @@
 
 #include <ida_chat/ui/agent_worker.hpp>
 #include <ida_chat/core/script_executor.hpp>
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/log.hpp>
 
 #include <QFile>
 #include <QDir>
 #include <QTextStream>
 #include <QDebug>
 
-// IDA headers for msg() debug output
-#include <ida_chat/common/ida_begin.hpp>
-#include <ida.hpp>
-#include <kernwin.hpp>
-#include <ida_chat/common/ida_end.hpp>
-
 namespace ida_chat {
 
 // ============================================================================
@@ -35,6 +31,10 @@ void AgentWorker::WorkerCallback::on_thinking_done() {
     emit agent_sigs_.thinking_done();
 }
 
+void AgentWorker::WorkerCallback::on_thinking_text(const std::string& text) {
+    emit agent_sigs_.thinking_text(QString::fromStdString(text));
+}
+
 void AgentWorker::WorkerCallback::on_tool_use(const std::string& tool_name, const std::string& details) {
     emit agent_sigs_.tool_use(QString::fromStdString(tool_name), QString::fromStdString(details));
 }
@@ -59,6 +59,10 @@ void AgentWorker::WorkerCallback::on_result(int num_turns, std::optional<double>
     emit agent_sigs_.result(num_turns, cost.value_or(0.0));
 }
 
+void AgentWorker::WorkerCallback::on_metrics(const MetricsSnapshot& snapshot) {
+    emit agent_sigs_.metrics(QString::fromStdString(snapshot.to_json().dump()));
+}
+
 // ============================================================================
 // AgentWorker Implementation
 // ============================================================================
@@ -107,9 +111,10 @@ void AgentWorker::request_new_session() {
     condition_.notify_one();
 }
 
-void AgentWorker::send_message(const QString& message) {
+void AgentWorker::send_message(const QString& message, std::vector<Attachment> attachments) {
     std::lock_guard<std::mutex> locker(mutex_);
     command_queue_.push({WorkerCommand::SendMessage, message});
+    attachment_queue_.push(std::move(attachments));
     condition_.notify_one();
 }
 
@@ -125,6 +130,10 @@ ChatState AgentWorker::get_state() const noexcept {
     return state_;
 }
 
+TurnMetrics AgentWorker::turn_metrics() const {
+    return turn_metrics_->snapshot();
+}
+
 void AgentWorker::stop() {
     {
         std::lock_guard<std::mutex> locker(mutex_);
@@ -154,10 +163,10 @@ void AgentWorker::set_system_prompt(const QString& prompt) {
 }
 
 void AgentWorker::load_system_prompt(const QString& project_dir) {
-    std::lock_guard<std::mutex> locker(mutex_);
-    project_dir_ = project_dir;
+    IDA_CHAT_LOG(LogLevel::Debug, "prompt", "load_system_prompt: project_dir='%s'",
+                 project_dir.toUtf8().constData());
     
-    msg("[IDA Chat] load_system_prompt: project_dir='%s'\n", project_dir.toUtf8().constData());
+    // Read without holding the lock so UI-thread requests never wait on disk I/O
     
     // Load the prompt synchronously
     QString prompt;
@@ -173,19 +182,31 @@ void AgentWorker::load_system_prompt(const QString& project_dir) {
             }
             prompt += in.readAll();
             f.close();
-            msg("[IDA Chat] load_system_prompt: loaded '%s' (%d chars)\n", 
-                file.toUtf8().constData(), (int)prompt.size());
+            IDA_CHAT_LOG(LogLevel::Debug, "prompt", "load_system_prompt: loaded '%s' (%d chars)",
+                         file.toUtf8().constData(), (int)prompt.size());
         } else {
-            msg("[IDA Chat] load_system_prompt: FAILED to open '%s'\n", path.toUtf8().constData());
+            IDA_CHAT_LOG(LogLevel::Debug, "prompt", "load_system_prompt: FAILED to open '%s'",
+                         path.toUtf8().constData());
         }
     }
     
+    IDA_CHAT_LOG(LogLevel::Info, "prompt", "load_system_prompt: total prompt size = %d chars",
+                 (int)prompt.size());
+    
+    std::lock_guard<std::mutex> locker(mutex_);
+    project_dir_ = project_dir;
     system_prompt_ = prompt;
-    msg("[IDA Chat] load_system_prompt: total prompt size = %d chars\n", (int)system_prompt_.size());
+}
+
+void AgentWorker::request_load_prompt(const QStringList& search_paths) {
+    std::lock_guard<std::mutex> locker(mutex_);
+    command_queue_.push({WorkerCommand::LoadPrompt, search_paths.join('\n')});
+    condition_.notify_one();
 }
 
 void AgentWorker::run() {
     running_ = true;
+    Tracer::instance().set_thread_name("agent worker");
     
     while (running_) {
         WorkerCommand cmd = WorkerCommand::None;
@@ -206,6 +227,10 @@ void AgentWorker::run() {
                 command_queue_.pop();
                 cmd = c;
                 data = d;
+                if (cmd == WorkerCommand::SendMessage && !attachment_queue_.empty()) {
+                    current_attachments_ = std::move(attachment_queue_.front());
+                    attachment_queue_.pop();
+                }
             }
         }
         
@@ -222,11 +247,18 @@ void AgentWorker::process_command(WorkerCommand cmd, const QString& data) {
             
             // Create ChatCore
             ChatCoreOptions options;
+            options.metrics_path = get_metrics_directory() + IDA_CHAT_PATH_SEP_STR "lifetime.json";
             core_ = std::make_unique<ChatCore>(callback_, script_executor_, history_, options);
+            core_->set_turn_metrics(turn_metrics_);
             
             // Set system prompt if available
-            if (!system_prompt_.isEmpty()) {
-                core_->set_system_prompt(system_prompt_.toStdString());
+            QString prompt;
+            {
+                std::lock_guard<std::mutex> locker(mutex_);
+                prompt = system_prompt_;
+            }
+            if (!prompt.isEmpty()) {
+                core_->set_system_prompt(prompt.toStdString());
             }
             
             // Connect
@@ -257,7 +289,9 @@ void AgentWorker::process_command(WorkerCommand cmd, const QString& data) {
             
             state_ = ChatState::Processing;
             
-            auto result = core_->process_message(data.toStdString());
+            auto attachments = std::move(current_attachments_);
+            current_attachments_.clear();
+            auto result = core_->process_message(data.toStdString(), attachments);
             
             if (result.cancelled) {
                 state_ = ChatState::Cancelled;
@@ -277,6 +311,26 @@ void AgentWorker::process_command(WorkerCommand cmd, const QString& data) {
             break;
         }
         
+        case WorkerCommand::LoadPrompt: {
+            // Probing paths and reading the prompt files stays off the GUI thread
+            QString project_dir;
+            for (const QString& path : data.split('\n', Qt::SkipEmptyParts)) {
+                IDA_CHAT_LOG(LogLevel::Debug, "prompt", "load_prompt: checking path '%s'",
+                             path.toUtf8().constData());
+                if (QFile::exists(path + "/PROMPT.md")) {
+                    project_dir = path;
+                    break;
+                }
+            }
+            
+            if (!project_dir.isEmpty()) {
+                load_system_prompt(project_dir);
+            } else {
+                IDA_CHAT_LOG(LogLevel::Warning, "prompt", "load_prompt: no project directory found");
+            }
+            break;
+        }
+        
         case WorkerCommand::Cancel: {
             if (core_) {
                 core_->request_cancel();
@@ -0,0 +1,142 @@
+/**
+ * @file animation_ticker.cpp
+ * @brief Shared animation clock implementation.
+ */
+
+#include <ida_chat/ui/animation_ticker.hpp>
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QEvent>
+#include <algorithm>
+
+namespace ida_chat {
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+AnimationTicker& AnimationTicker::instance() {
+    // Parented to the application so the timer dies with the event loop
+    // instead of during static destruction.
+    static QPointer<AnimationTicker> ticker;
+    if (!ticker) {
+        ticker = new AnimationTicker(QCoreApplication::instance());
+    }
+    return *ticker;
+}
+
+AnimationTicker::AnimationTicker(QObject* parent)
+    : QObject(parent)
+{
+    timer_.setInterval(TICK_INTERVAL_MS);
+    timer_.setTimerType(Qt::CoarseTimer);
+    connect(&timer_, &QTimer::timeout, this, &AnimationTicker::on_tick);
+
+    if (auto* app = qobject_cast<QGuiApplication*>(QCoreApplication::instance())) {
+        app_active_ = app->applicationState() == Qt::ApplicationActive;
+        connect(app, &QGuiApplication::applicationStateChanged, this,
+                [this](Qt::ApplicationState state) {
+            app_active_ = state == Qt::ApplicationActive;
+            update_running_state();
+        });
+    }
+}
+
+// ============================================================================
+// Subscriptions
+// ============================================================================
+
+void AnimationTicker::subscribe(QWidget* widget, TickFn on_tick) {
+    if (!widget) return;
+
+    for (auto& sub : subscribers_) {
+        if (sub.widget == widget) {
+            sub.on_tick = std::move(on_tick);
+            update_running_state();
+            return;
+        }
+    }
+
+    subscribers_.push_back({widget, std::move(on_tick)});
+    widget->installEventFilter(this);
+    connect(widget, &QObject::destroyed, this, [this](QObject* obj) {
+        // The QPointer is already null here; prune every dead entry.
+        Q_UNUSED(obj);
+        subscribers_.erase(
+            std::remove_if(subscribers_.begin(), subscribers_.end(),
+                           [](const Subscriber& s) { return s.widget.isNull(); }),
+            subscribers_.end());
+        update_running_state();
+    }, Qt::UniqueConnection);
+
+    update_running_state();
+}
+
+void AnimationTicker::unsubscribe(QWidget* widget) {
+    if (!widget) return;
+
+    auto it = std::find_if(subscribers_.begin(), subscribers_.end(),
+                           [widget](const Subscriber& s) { return s.widget == widget; });
+    if (it == subscribers_.end()) return;
+
+    subscribers_.erase(it);
+    widget->removeEventFilter(this);
+    disconnect(widget, &QObject::destroyed, this, nullptr);
+    update_running_state();
+}
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+bool AnimationTicker::eventFilter(QObject* watched, QEvent* event) {
+    // Showing or hiding a subscriber (including via its dock) decides
+    // whether the clock needs to run at all.
+    if (event->type() == QEvent::Show || event->type() == QEvent::Hide) {
+        update_running_state();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void AnimationTicker::on_tick() {
+    ++frame_;
+
+    bool any_visible = false;
+
+    // Callbacks may subscribe/unsubscribe; iterate over a snapshot.
+    auto snapshot = subscribers_;
+    for (const auto& sub : snapshot) {
+        QWidget* w = sub.widget.data();
+        if (!w || !w->isVisible()) continue;
+        any_visible = true;
+
+        // Scrolled out of view or fully covered: nothing to repaint.
+        if (w->visibleRegion().isEmpty()) continue;
+
+        if (sub.on_tick) {
+            sub.on_tick(frame_);
+        }
+    }
+
+    if (!any_visible) {
+        timer_.stop();
+    }
+}
+
+bool AnimationTicker::any_subscriber_visible() const {
+    return std::any_of(subscribers_.begin(), subscribers_.end(),
+                       [](const Subscriber& s) { return s.widget && s.widget->isVisible(); });
+}
+
+void AnimationTicker::update_running_state() {
+    bool should_run = app_active_ && any_subscriber_visible();
+
+    if (should_run && !timer_.isActive()) {
+        timer_.start();
+    } else if (!should_run && timer_.isActive()) {
+        timer_.stop();
+    }
+}
+
+} // namespace ida_chat
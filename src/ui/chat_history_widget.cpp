@@ -7,10 +7,9 @@
 #include <ida_chat/ui/chat_message.hpp>
 #include <ida_chat/ui/collapsible_section.hpp>
 #include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/ui/scroll_controller.hpp>
 
 #include <QVBoxLayout>
-#include <QScrollBar>
-#include <QTimer>
 
 namespace ida_chat {
 
@@ -35,8 +34,8 @@ ChatMessage* ChatHistoryWidget::add_message(const QString& text,
         current_processing_ = message;
     }
     
-    // Auto-scroll to bottom
-    QTimer::singleShot(10, this, &ChatHistoryWidget::scroll_to_bottom);
+    // Follow the new message if the user is at the bottom
+    scroll_->request_follow();
     
     return message;
 }
@@ -51,8 +50,8 @@ CollapsibleSection* ChatHistoryWidget::add_collapsible(const QString& title,
     // Connect to resize signal for auto-scroll
     connect(section, &QFrame::customContextMenuRequested, this, &ChatHistoryWidget::on_content_changed);
     
-    // Auto-scroll to bottom
-    QTimer::singleShot(10, this, &ChatHistoryWidget::scroll_to_bottom);
+    // Follow the new message if the user is at the bottom
+    scroll_->request_follow();
     
     return section;
 }
@@ -65,10 +64,7 @@ void ChatHistoryWidget::mark_current_complete() {
 }
 
 void ChatHistoryWidget::scroll_to_bottom() {
-    QScrollBar* vbar = verticalScrollBar();
-    if (vbar) {
-        vbar->setValue(vbar->maximum());
-    }
+    scroll_->scroll_to_bottom();
 }
 
 void ChatHistoryWidget::clear_history() {
@@ -101,7 +97,7 @@ ChatMessage* ChatHistoryWidget::last_message() const {
 
 void ChatHistoryWidget::on_content_changed() {
     // Re-scroll when content changes
-    QTimer::singleShot(10, this, &ChatHistoryWidget::scroll_to_bottom);
+    scroll_->request_follow();
 }
 
 void ChatHistoryWidget::setup_ui() {
@@ -124,6 +120,8 @@ void ChatHistoryWidget::setup_ui() {
     layout_->addStretch();  // Push messages to bottom initially
     
     setWidget(container_);
+    
+    scroll_ = new ScrollController(this);
 }
 
 } // namespace ida_chat
@@ -5,11 +5,11 @@
 
 #include <ida_chat/ui/chat_message.hpp>
 #include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/ui/animation_ticker.hpp>
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QTimer>
 
 namespace ida_chat {
 
@@ -207,25 +207,28 @@ void ChatMessage::update_indicator_style() {
 }
 
 void ChatMessage::start_blinking() {
-    if (blink_timer_) return;
+    if (blinking_) return;
     
-    blink_timer_ = new QTimer(this);
-    connect(blink_timer_, &QTimer::timeout, this, &ChatMessage::toggle_blink);
-    blink_timer_->start(500);  // 500ms interval
+    blinking_ = true;
+    AnimationTicker::instance().subscribe(this, [this](int frame) { on_tick(frame); });
 }
 
 void ChatMessage::stop_blinking() {
-    if (blink_timer_) {
-        blink_timer_->stop();
-        delete blink_timer_;
-        blink_timer_ = nullptr;
+    if (blinking_) {
+        AnimationTicker::instance().unsubscribe(this);
+        blinking_ = false;
     }
     blink_state_ = false;
 }
 
-void ChatMessage::toggle_blink() {
-    blink_state_ = !blink_state_;
-    update_indicator_style();
+void ChatMessage::on_tick(int frame) {
+    // Blink at 500ms on top of the shared 100ms clock; restyle only on change
+    constexpr int ticks_per_phase = 500 / AnimationTicker::TICK_INTERVAL_MS;
+    bool state = (frame / ticks_per_phase) % 2 == 1;
+    if (state != blink_state_) {
+        blink_state_ = state;
+        update_indicator_style();
+    }
 }
 
 } // namespace ida_chat
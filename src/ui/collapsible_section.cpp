@@ -5,7 +5,11 @@
 
 #include <ida_chat/ui/collapsible_section.hpp>
 #include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
+#include <QCoreApplication>
+#include <QPointer>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
@@ -17,9 +21,33 @@ CollapsibleSection::CollapsibleSection(const QString& title,
                                        const QString& content,
                                        bool collapsed,
                                        QWidget* parent)
+    : CollapsibleSection(title,
+                         [content]() { return content; },
+                         make_preview(content),
+                         static_cast<int>(content.trimmed().count('\n')) + 1,
+                         collapsed,
+                         parent)
+{
+    held_ = static_cast<std::size_t>(content.size()) * sizeof(QChar);
+    update_tracked();
+    
+    // Large content moves to the blob store, written on the pool rather than here
+    if (static_cast<std::size_t>(content.size()) >= BlobStore::SPILL_THRESHOLD) {
+        spill(content);
+    }
+}
+
+CollapsibleSection::CollapsibleSection(const QString& title,
+                                       ContentProvider provider,
+                                       const QString& preview,
+                                       int line_count,
+                                       bool collapsed,
+                                       QWidget* parent)
     : QFrame(parent)
     , title_(title)
-    , content_(content)
+    , provider_(std::move(provider))
+    , preview_(preview)
+    , line_count_(line_count)
     , collapsed_(collapsed)
 {
     setup_ui();
@@ -31,6 +59,21 @@ bool CollapsibleSection::should_collapse(const QString& content) {
     return content.trimmed().count('\n') + 1 > COLLAPSE_THRESHOLD;
 }
 
+QString CollapsibleSection::make_preview(const QString& content) {
+    // Show first few lines with ellipsis
+    QStringList lines = content.trimmed().split('\n');
+    QString preview;
+    int preview_lines = qMin(PREVIEW_LINES, static_cast<int>(lines.size()));
+    for (int i = 0; i < preview_lines; ++i) {
+        if (!preview.isEmpty()) preview += '\n';
+        preview += lines[i];
+    }
+    if (lines.size() > PREVIEW_LINES) {
+        preview += QString("\n... (%1 more lines)").arg(lines.size() - PREVIEW_LINES);
+    }
+    return preview;
+}
+
 void CollapsibleSection::expand() {
     if (!collapsed_) return;
     collapsed_ = false;
@@ -43,6 +86,10 @@ void CollapsibleSection::collapse() {
     collapsed_ = true;
     update_header_text();
     update_content();
+    
+    if (tracked_.over_budget()) {
+        release();
+    }
 }
 
 void CollapsibleSection::toggle() {
@@ -80,50 +127,105 @@ void CollapsibleSection::setup_ui() {
     connect(header_, &QPushButton::clicked, this, &CollapsibleSection::toggle);
     layout_->addWidget(header_);
     
-    // Content widget
-    content_widget_ = new QTextEdit(this);
-    content_widget_->setReadOnly(true);
-    content_widget_->setStyleSheet(QString(
-        "QTextEdit {"
+    // Preview label (the full editor is built on first expand)
+    preview_label_ = new QLabel(preview_, this);
+    preview_label_->setTextFormat(Qt::PlainText);
+    preview_label_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    preview_label_->setStyleSheet(QString(
+        "QLabel {"
         "  background-color: %1;"
         "  color: %2;"
         "  padding: 8px;"
         "  border-radius: 4px;"
         "  font-family: monospace;"
         "  font-size: 11px;"
-        "  border: none;"
         "}"
     ).arg(colors.alternate_base.name()).arg(colors.text.name()));
+    layout_->addWidget(preview_label_);
     
     update_content();
-    layout_->addWidget(content_widget_);
 }
 
 void CollapsibleSection::update_header_text() {
     QString arrow = collapsed_ ? QString::fromUtf8("\u25B6") : QString::fromUtf8("\u25BC");  // ▶ or ▼
-    int line_count = content_.trimmed().count('\n') + 1;
-    header_->setText(QString("%1 %2 (%3 lines)").arg(arrow).arg(title_).arg(line_count));
+    header_->setText(QString("%1 %2 (%3 lines)").arg(arrow).arg(title_).arg(line_count_));
 }
 
 void CollapsibleSection::update_content() {
-    if (collapsed_) {
-        // Show first few lines with ellipsis
-        QStringList lines = content_.trimmed().split('\n');
-        QString preview;
-        int preview_lines = qMin(3, lines.size());
-        for (int i = 0; i < preview_lines; ++i) {
-            if (!preview.isEmpty()) preview += '\n';
-            preview += lines[i];
-        }
-        if (lines.size() > 3) {
-            preview += QString("\n... (%1 more lines)").arg(lines.size() - 3);
-        }
-        content_widget_->setPlainText(preview);
-        content_widget_->setMaximumHeight(100);
-    } else {
-        content_widget_->setPlainText(content_);
-        content_widget_->setMaximumHeight(16777215);  // QWIDGETSIZE_MAX
+    if (!collapsed_) {
+        materialize();
+    }
+    
+    preview_label_->setVisible(collapsed_);
+    if (content_widget_) {
+        content_widget_->setVisible(!collapsed_);
     }
 }
 
+void CollapsibleSection::materialize() {
+    if (content_widget_ || !provider_) return;
+    
+    ColorScheme colors = ColorScheme::from_ida_palette();
+    
+    QString content = provider_();
+    
+    content_widget_ = new QTextEdit(this);
+    content_widget_->setReadOnly(true);
+    content_widget_->setStyleSheet(QString(
+        "QTextEdit {"
+        "  background-color: %1;"
+        "  color: %2;"
+        "  padding: 8px;"
+        "  border-radius: 4px;"
+        "  font-family: monospace;"
+        "  font-size: 11px;"
+        "  border: none;"
+        "}"
+    ).arg(colors.alternate_base.name()).arg(colors.text.name()));
+    content_widget_->setPlainText(content);
+    layout_->addWidget(content_widget_);
+    
+    resident_ = static_cast<std::size_t>(content.size()) * sizeof(QChar);
+    update_tracked();
+}
+
+void CollapsibleSection::release() {
+    if (!content_widget_) return;
+    
+    layout_->removeWidget(content_widget_);
+    content_widget_->deleteLater();
+    content_widget_ = nullptr;
+    
+    resident_ = 0;
+    update_tracked();
+}
+
+void CollapsibleSection::spill(const QString& content) {
+    // The widgets keep the text until the write lands; finish_spill() swaps the provider
+    QPointer<CollapsibleSection> self(this);
+    ThreadPool::instance().submit([self, content]() {
+        QByteArray utf8 = content.toUtf8();
+        BlobRef ref = BlobStore::shared().put(
+            std::string_view(utf8.constData(), static_cast<std::size_t>(utf8.size())));
+        QMetaObject::invokeMethod(qApp, [self, id = std::move(ref.id)]() {
+            if (self) self->finish_spill(id);
+        }, Qt::QueuedConnection);
+    }, TaskPriority::Background);
+}
+
+void CollapsibleSection::finish_spill(const std::string& blob_id) {
+    if (blob_id.empty()) return;    // Blob store unavailable; keep holding the text
+    
+    provider_ = [blob_id]() {
+        auto data = BlobStore::shared().read_all(blob_id);
+        return data ? QString::fromStdString(*data) : QString("(content unavailable)");
+    };
+    held_ = 0;
+    update_tracked();
+}
+
+void CollapsibleSection::update_tracked() {
+    tracked_.set(held_ + resident_);
+}
+
 } // namespace ida_chat
@@ -5,12 +5,31 @@
 
 #include <ida_chat/ui/cursor_chat_view.hpp>
 #include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
 #include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/ui/animation_ticker.hpp>
+#include <ida_chat/ui/syntax_highlighter.hpp>
+#include <ida_chat/ui/large_output_viewer.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/types.hpp>
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/common/json.hpp>
 
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QScrollBar>
 #include <QApplication>
 #include <QFrame>
+#include <QPushButton>
+#include <QPlainTextEdit>
+#include <QTextDocument>
+#include <QTextDocumentFragment>
+#include <QTextEdit>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
 
 namespace ida_chat {
 
@@ -29,18 +48,12 @@ UserMessageWidget::UserMessageWidget(const QString& text, QWidget* parent)
     
     auto* bubble = new QWidget(this);
     bubble->setObjectName("UserBubble");
-    bubble->setStyleSheet(QString(
-        "#UserBubble { background: %1; border-radius: %2; }"
-    ).arg(BG_USER_MESSAGE).arg(RADIUS_LG));
     
     auto* bubble_layout = new QVBoxLayout(bubble);
     bubble_layout->setContentsMargins(14, 12, 14, 12);
     
     auto* label = new QLabel(text, bubble);
     label->setWordWrap(true);
-    label->setStyleSheet(QString(
-        "color: %1; font-size: %2; line-height: 1.5; background: transparent;"
-    ).arg(TEXT_PRIMARY).arg(FONT_BASE));
     label->setMaximumWidth(450);
     bubble_layout->addWidget(label);
     
@@ -53,49 +66,150 @@ UserMessageWidget::UserMessageWidget(const QString& text, QWidget* parent)
 
 ThinkingIndicator::ThinkingIndicator(QWidget* parent)
     : QWidget(parent)
-    , timer_(new QTimer(this))
 {
     auto* layout = new QHBoxLayout(this);
     layout->setContentsMargins(0, 4, 0, 4);
     layout->setSpacing(8);
     
     icon_label_ = new QLabel("●", this);
-    icon_label_->setStyleSheet(QString("color: %1; font-size: 8px;").arg(TEXT_MUTED));
+    icon_label_->setObjectName("ThinkingIcon");
     layout->addWidget(icon_label_);
     
     text_label_ = new QLabel("Thinking...", this);
-    text_label_->setStyleSheet(QString("color: %1; font-size: %2;").arg(TEXT_MUTED).arg(FONT_SM));
+    text_label_->setObjectName("ThinkingText");
     layout->addWidget(text_label_);
     
     layout->addStretch();
-    
-    connect(timer_, &QTimer::timeout, this, [this]() {
-        frame_ = (frame_ + 1) % SPINNER_FRAMES.size();
-        icon_label_->setText(SPINNER_FRAMES[frame_]);
-        
-        // Update elapsed time
-        if (active_) {
-            auto elapsed = start_time_.secsTo(QDateTime::currentDateTime());
-            text_label_->setText(QString("Thought %1s").arg(elapsed));
-        }
-    });
 }
 
 void ThinkingIndicator::start() {
     active_ = true;
     start_time_ = QDateTime::currentDateTime();
+    shown_seconds_ = -1;
     text_label_->setText("Thinking...");
-    timer_->start(100);
+    AnimationTicker::instance().subscribe(this, [this](int frame) { on_tick(frame); });
     show();
 }
 
 void ThinkingIndicator::stop(int duration_seconds) {
     active_ = false;
-    timer_->stop();
+    AnimationTicker::instance().unsubscribe(this);
     icon_label_->setText("●");
     text_label_->setText(QString("Thought %1s").arg(duration_seconds));
 }
 
+void ThinkingIndicator::on_tick(int frame) {
+    if (!active_) return;
+    
+    icon_label_->setText(SPINNER_FRAMES[frame % SPINNER_FRAMES.size()]);
+    
+    // The elapsed label only changes once per second
+    auto elapsed = start_time_.secsTo(QDateTime::currentDateTime());
+    if (elapsed != shown_seconds_) {
+        shown_seconds_ = elapsed;
+        text_label_->setText(QString("Thought %1s").arg(elapsed));
+    }
+}
+
+// ============================================================================
+// ThinkingStreamPanel
+// ============================================================================
+
+ThinkingStreamPanel::ThinkingStreamPanel(QWidget* parent)
+    : QWidget(parent)
+    , buffer_([this](const QString& chunk) { deliver(chunk); })
+{
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(4);
+    
+    header_ = new QPushButton(this);
+    header_->setObjectName("ThinkingStreamHeader");
+    header_->setCursor(Qt::PointingHandCursor);
+    header_->setToolTip("Show the thinking stream");
+    connect(header_, &QPushButton::clicked, this, &ThinkingStreamPanel::toggle);
+    layout->addWidget(header_, 0, Qt::AlignLeft);
+    
+    update_header();
+}
+
+void ThinkingStreamPanel::append(const QString& text) {
+    // Collapsed, this is all the work per delta: the view is updated (or the
+    // header recounted) once per frame by the buffer
+    text_ += text;
+    QByteArray utf8 = text.toUtf8();
+    tokens_ += estimate_tokens(std::string_view(utf8.constData(), static_cast<std::size_t>(utf8.size())));
+    buffer_.append(text);
+}
+
+void ThinkingStreamPanel::set_text(const QString& text) {
+    buffer_.discard();
+    text_ = text;
+    QByteArray utf8 = text.toUtf8();
+    tokens_ = estimate_tokens(std::string_view(utf8.constData(), static_cast<std::size_t>(utf8.size())));
+    if (view_) {
+        view_->setPlainText(text_);
+    }
+    update_header();
+}
+
+void ThinkingStreamPanel::finish() {
+    buffer_.flush();
+    update_header();
+}
+
+void ThinkingStreamPanel::toggle() {
+    if (view_) {
+        view_->deleteLater();
+        view_ = nullptr;
+        header_->setToolTip("Show the thinking stream");
+    } else {
+        // Everything received so far is already in text_
+        buffer_.discard();
+        view_ = new QPlainTextEdit(this);
+        view_->setObjectName("ThinkingStream");
+        view_->setReadOnly(true);
+        view_->setFixedHeight(VIEW_HEIGHT);
+        view_->setPlainText(text_);
+        view_->moveCursor(QTextCursor::End);
+        layout()->addWidget(view_);
+        header_->setToolTip("Hide the thinking stream");
+    }
+    update_header();
+}
+
+void ThinkingStreamPanel::deliver(const QString& chunk) {
+    update_header();
+    if (!view_) return;
+    
+    // Stay pinned to the end unless the user scrolled up to read
+    QScrollBar* vbar = view_->verticalScrollBar();
+    bool at_end = vbar->value() == vbar->maximum();
+    
+    QTextCursor cursor(view_->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(chunk);
+    
+    if (at_end) {
+        vbar->setValue(vbar->maximum());
+    }
+}
+
+void ThinkingStreamPanel::update_header() {
+    // Count in steps so the header is not re-laid out for every delta
+    std::size_t shown = tokens_ < 1000 ? tokens_ / 10 * 10 : tokens_ / 100 * 100;
+    QString count = shown < 1000
+        ? QString::number(shown)
+        : QString("%1k").arg(static_cast<double>(shown) / 1000.0, 0, 'f', 1);
+    QString arrow = view_ ? QString::fromUtf8("▾") : QString::fromUtf8("▸");
+    
+    QString text = QString("%1 Thinking stream · ~%2 tokens").arg(arrow, count);
+    if (text != header_->text()) {
+        header_->setText(text);
+    }
+    set_style_state(header_, "expanded", view_ != nullptr);
+}
+
 // ============================================================================
 // ToolActionWidget
 // ============================================================================
@@ -109,19 +223,19 @@ ToolActionWidget::ToolActionWidget(ToolActionType type, const QString& detail, Q
     
     // Bullet point
     auto* bullet = new QLabel("●", this);
-    bullet->setStyleSheet(QString("color: %1; font-size: 6px;").arg(TEXT_MUTED));
+    bullet->setObjectName("ToolBullet");
     bullet->setFixedWidth(12);
     layout->addWidget(bullet);
     
     // Action name (bold)
     auto* action = new QLabel(action_text(type), this);
-    action->setStyleSheet(QString("color: %1; font-size: %2; font-weight: 600;").arg(TEXT_SECONDARY).arg(FONT_SM));
+    action->setObjectName("ToolAction");
     layout->addWidget(action);
     
     // Detail text (lighter, same line)
     if (!detail.isEmpty()) {
         auto* detail_label = new QLabel(detail, this);
-        detail_label->setStyleSheet(QString("color: %1; font-size: %2;").arg(TEXT_MUTED).arg(FONT_SM));
+        detail_label->setObjectName("ToolDetail");
         layout->addWidget(detail_label);
     }
     
@@ -149,10 +263,9 @@ FileBlockWidget::FileBlockWidget(const FileBlockData& data, QWidget* parent)
     , data_(data)
 {
     setCursor(Qt::PointingHandCursor);
-    
-    setStyleSheet(QString(
-        "FileBlockWidget { background: %1; border-radius: %2; }"
-    ).arg(BG_FILE_BLOCK).arg(RADIUS_MD));
+    setObjectName("FileBlock");
+    setAttribute(Qt::WA_StyledBackground);
+    setAttribute(Qt::WA_Hover);
     
     auto* layout = new QHBoxLayout(this);
     layout->setContentsMargins(12, 10, 12, 10);
@@ -160,12 +273,12 @@ FileBlockWidget::FileBlockWidget(const FileBlockData& data, QWidget* parent)
     
     // File icon
     auto* icon = new QLabel("📄", this);
-    icon->setStyleSheet("font-size: 16px;");
+    icon->setObjectName("FileIcon");
     layout->addWidget(icon);
     
     // Filename
     auto* name = new QLabel(data_.filename, this);
-    name->setStyleSheet(QString("color: %1; font-size: %2;").arg(TEXT_PRIMARY).arg(FONT_BASE));
+    name->setObjectName("FileName");
     layout->addWidget(name);
     
     layout->addStretch();
@@ -184,7 +297,7 @@ FileBlockWidget::FileBlockWidget(const FileBlockData& data, QWidget* parent)
         auto* diff = new QLabel(this);
         diff->setTextFormat(Qt::RichText);
         diff->setText(diff_html);
-        diff->setStyleSheet(QString("font-size: %1;").arg(FONT_SM));
+        diff->setObjectName("FileDiff");
         layout->addWidget(diff);
     }
 }
@@ -196,22 +309,6 @@ void FileBlockWidget::mousePressEvent(QMouseEvent* event) {
     QWidget::mousePressEvent(event);
 }
 
-void FileBlockWidget::enterEvent(QEnterEvent* event) {
-    hovered_ = true;
-    setStyleSheet(QString(
-        "FileBlockWidget { background: %1; border-radius: %2; }"
-    ).arg(BG_CARD_HOVER).arg(RADIUS_MD));
-    QWidget::enterEvent(event);
-}
-
-void FileBlockWidget::leaveEvent(QEvent* event) {
-    hovered_ = false;
-    setStyleSheet(QString(
-        "FileBlockWidget { background: %1; border-radius: %2; }"
-    ).arg(BG_FILE_BLOCK).arg(RADIUS_MD));
-    QWidget::leaveEvent(event);
-}
-
 // ============================================================================
 // CodeBlockWidget
 // ============================================================================
@@ -219,8 +316,6 @@ void FileBlockWidget::leaveEvent(QEvent* event) {
 CodeBlockWidget::CodeBlockWidget(const QString& code, const QString& language, QWidget* parent)
     : QWidget(parent)
 {
-    Q_UNUSED(language);
-    
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 8, 0, 8);
     layout->setSpacing(0);
@@ -228,22 +323,57 @@ CodeBlockWidget::CodeBlockWidget(const QString& code, const QString& language, Q
     // Code block container
     auto* code_container = new QWidget(this);
     code_container->setObjectName("CodeContainer");
-    code_container->setStyleSheet(QString(
-        "#CodeContainer { background: %1; border: 1px solid %2; border-radius: %3; }"
-    ).arg(BG_CODE).arg(BORDER_DEFAULT).arg(RADIUS_MD));
     
     auto* code_layout = new QVBoxLayout(code_container);
     code_layout->setContentsMargins(14, 12, 14, 12);
     code_layout->setSpacing(0);
     
-    code_label_ = new QLabel(code, code_container);
-    code_label_->setWordWrap(true);
-    code_label_->setTextInteractionFlags(Qt::TextSelectableByMouse);
-    code_label_->setStyleSheet(QString(
-        "color: %1; font-family: 'SF Mono', 'Menlo', 'Monaco', 'Consolas', monospace; "
-        "font-size: %2; line-height: 1.4; background: transparent; border: none;"
-    ).arg(TEXT_CODE).arg(FONT_SM));
-    code_layout->addWidget(code_label_);
+    // Large code goes into a scrolling plain-text view: a QLabel would lay out
+    // (and, once highlighted, hold as HTML) every line at once
+    CodeLanguage lang = language_from_hint(language);
+    int lines = static_cast<int>(code.count(QLatin1Char('\n'))) + 1;
+    if (lines > PLAIN_VIEW_LINES || code.size() > PLAIN_VIEW_CHARS) {
+        // Span offsets must match the document, which drops '\r'
+        QString text = code;
+        text.remove(QLatin1Char('\r'));
+        
+        auto* view = new QPlainTextEdit(code_container);
+        view->setObjectName("CodeText");
+        view->setReadOnly(true);
+        view->setFrameShape(QFrame::NoFrame);
+        view->setLineWrapMode(QPlainTextEdit::NoWrap);
+        view->setPlainText(text);
+        int visible = qMin(lines, PLAIN_VIEW_VISIBLE_LINES);
+        view->setFixedHeight(visible * view->fontMetrics().lineSpacing()
+                             + 2 * static_cast<int>(view->document()->documentMargin()));
+        code_layout->addWidget(view);
+        
+        // Tokens are computed on a worker; the highlighter only applies them
+        if (lang != CodeLanguage::Plain) {
+            SyntaxHighlighter::instance().request_spans(text, lang, view,
+                [view](const std::vector<HighlightSpan>& spans) {
+                    new CodeSpanHighlighter(spans, view->document());
+                });
+        }
+    } else {
+        code_label_ = new QLabel(code_container);
+        code_label_->setObjectName("CodeText");
+        code_label_->setTextFormat(Qt::PlainText);
+        code_label_->setText(code);
+        code_label_->setWordWrap(true);
+        code_label_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        code_layout->addWidget(code_label_);
+        
+        // Plain text shows immediately; colored spans are computed on a worker
+        // and swapped in when ready (instantly on a cache hit).
+        if (lang != CodeLanguage::Plain) {
+            SyntaxHighlighter::instance().request(code, lang, code_label_, [this](const QString& html) {
+                code_label_->setTextFormat(Qt::RichText);
+                code_label_->setText(
+                    "<pre style='margin: 0; white-space: pre-wrap;'>" + html + "</pre>");
+            });
+        }
+    }
     
     layout->addWidget(code_container);
     
@@ -257,6 +387,7 @@ CodeBlockWidget::CodeBlockWidget(const QString& code, const QString& language, Q
     output_layout->setSpacing(0);
     
     output_label_ = new QLabel(output_widget_);
+    output_label_->setObjectName("OutputText");
     output_label_->setWordWrap(true);
     output_label_->setTextInteractionFlags(Qt::TextSelectableByMouse);
     output_layout->addWidget(output_label_);
@@ -264,18 +395,30 @@ CodeBlockWidget::CodeBlockWidget(const QString& code, const QString& language, Q
     layout->addWidget(output_widget_);
 }
 
-void CodeBlockWidget::set_output(const QString& output, bool is_error) {
-    output_label_->setText(output);
-    output_label_->setStyleSheet(QString(
-        "color: %1; font-family: 'SF Mono', 'Menlo', 'Monaco', 'Consolas', monospace; "
-        "font-size: %2; line-height: 1.4; background: transparent; border: none;"
-    ).arg(is_error ? ACCENT_RED : TEXT_SECONDARY).arg(FONT_SM));
+std::string CodeBlockWidget::set_output(const QString& output, bool is_error) {
+    // Multi-MB outputs would stall layout in a QLabel; collapse them instead
+    if (CollapsedOutputWidget::should_collapse(output)) {
+        if (collapsed_output_) {
+            collapsed_output_->deleteLater();
+        }
+        output_widget_->setVisible(false);
+        output_label_->clear();
+        auto* collapsed = new CollapsedOutputWidget(output, is_error, this);
+        collapsed_output_ = collapsed;
+        layout()->addWidget(collapsed);
+        return collapsed->blob().id;
+    }
     
-    output_widget_->setStyleSheet(QString(
-        "#OutputContainer { background: %1; border: 1px solid %2; border-radius: %3; margin-top: 6px; }"
-    ).arg(is_error ? "#1c0f0f" : BG_ELEVATED).arg(is_error ? "#3d1f1f" : BORDER_SUBTLE).arg(RADIUS_MD));
+    if (collapsed_output_) {
+        collapsed_output_->deleteLater();
+        collapsed_output_ = nullptr;
+    }
     
+    output_label_->setText(output);
+    set_style_state(output_label_, "error", is_error);
+    set_style_state(output_widget_, "error", is_error);
     output_widget_->setVisible(true);
+    return {};
 }
 
 // ============================================================================
@@ -308,22 +451,57 @@ void AssistantResponseWidget::add_tool_action(ToolActionType type, const QString
     layout_->addWidget(action);
 }
 
-void AssistantResponseWidget::add_text(const QString& text) {
+QLabel* AssistantResponseWidget::add_text(const QString& text) {
     auto* label = new QLabel(this);
+    label->setObjectName("ResponseText");
     label->setWordWrap(true);
     label->setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::TextBrowserInteraction);
     label->setOpenExternalLinks(true);
-    
-    // Render markdown to HTML
-    QString html = markdown_to_html(text);
     label->setTextFormat(Qt::RichText);
-    label->setText(html);
     
-    label->setStyleSheet(QString(
-        "QLabel { color: %1; font-size: %2; line-height: 1.5; background: transparent; }"
-        "QLabel a { color: %3; }"
-    ).arg(TEXT_PRIMARY).arg(FONT_BASE).arg(ACCENT_BLUE));
+    if (!text.isEmpty()) {
+        render_text(label, text);
+    }
     layout_->addWidget(label);
+    return label;
+}
+
+void AssistantResponseWidget::render_text(QLabel* label, const QString& text, bool highlight) {
+    StallScope stall(StallCause::Render,
+                     "markdown " + std::to_string(text.size() / 1024) + " KB");
+    TraceSpan span("ui", "render_markdown");
+    if (span.active()) {
+        span.set_detail(std::to_string(text.size() / 1024) + " KB");
+    }
+    auto& renderer = get_markdown_renderer();
+    label->setText(renderer.render(text, highlight));
+    
+    int generation = label->property("render_generation").toInt() + 1;
+    label->setProperty("render_generation", generation);
+    
+    // Uncached code blocks came out plain; render once more when the last of
+    // them is highlighted, unless the label has been given newer text by then
+    const auto& pending = renderer.pending_code_blocks();
+    if (pending.empty()) return;
+    auto remaining = std::make_shared<int>(static_cast<int>(pending.size()));
+    for (const auto& block : pending) {
+        SyntaxHighlighter::instance().request(block.code, language_from_hint(block.language), label,
+            [label, text, generation, remaining](const QString&) {
+                if (--*remaining > 0) return;
+                if (label->property("render_generation").toInt() != generation) return;
+                StallScope stall(StallCause::Render, "markdown rehighlight");
+                label->setText(get_markdown_renderer().render(text));
+            });
+    }
+}
+
+ThinkingStreamPanel* AssistantResponseWidget::thinking_stream() {
+    if (!thinking_stream_) {
+        thinking_stream_ = new ThinkingStreamPanel(this);
+        int at = thinking_ ? layout_->indexOf(thinking_) + 1 : layout_->count();
+        layout_->insertWidget(at, thinking_stream_);
+    }
+    return thinking_stream_;
 }
 
 void AssistantResponseWidget::add_file_block(const FileBlockData& data) {
@@ -336,25 +514,30 @@ void AssistantResponseWidget::add_code_block(const QString& code, const QString&
     layout_->addWidget(last_code_block_);
 }
 
-void AssistantResponseWidget::add_output(const QString& output, bool is_error) {
+std::string AssistantResponseWidget::add_output(const QString& output, bool is_error) {
     if (last_code_block_) {
-        last_code_block_->set_output(output, is_error);
-    } else {
-        // Standalone output
-        auto* label = new QLabel(output, this);
-        label->setWordWrap(true);
-        label->setStyleSheet(QString(
-            "color: %1; font-family: monospace; font-size: %2; background: %3; padding: 8px; border-radius: %4;"
-        ).arg(is_error ? ACCENT_RED : TEXT_SECONDARY).arg(FONT_SM).arg(BG_ELEVATED).arg(RADIUS_MD));
-        layout_->addWidget(label);
+        return last_code_block_->set_output(output, is_error);
+    }
+    if (CollapsedOutputWidget::should_collapse(output)) {
+        auto* collapsed = new CollapsedOutputWidget(output, is_error, this);
+        layout_->addWidget(collapsed);
+        return collapsed->blob().id;
     }
+    
+    // Standalone output
+    auto* label = new QLabel(output, this);
+    label->setObjectName("StandaloneOutput");
+    label->setProperty("error", is_error);
+    label->setWordWrap(true);
+    layout_->addWidget(label);
+    return {};
 }
 
 void AssistantResponseWidget::add_summary(const QStringList& points) {
     for (const QString& point : points) {
         auto* item = new QLabel("• " + point, this);
+        item->setObjectName("SummaryItem");
         item->setWordWrap(true);
-        item->setStyleSheet(QString("color: %1; font-size: %2; margin-left: 8px;").arg(TEXT_PRIMARY).arg(FONT_BASE));
         layout_->addWidget(item);
     }
 }
@@ -370,7 +553,7 @@ CursorChatView::CursorChatView(QWidget* parent)
 }
 
 void CursorChatView::setup_ui() {
-    setStyleSheet(QString("background: %1;").arg(BG_BASE));
+    setObjectName("ChatView");
     
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -381,17 +564,10 @@ void CursorChatView::setup_ui() {
     scroll_area_->setWidgetResizable(true);
     scroll_area_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     scroll_area_->setFrameShape(QFrame::NoFrame);
-    scroll_area_->setStyleSheet(QString(
-        "QScrollArea { border: none; background: %1; }"
-        "QScrollBar:vertical { background: %1; width: 10px; margin: 2px; }"
-        "QScrollBar::handle:vertical { background: %2; border-radius: 4px; min-height: 30px; }"
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { height: 0; }"
-        "QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical { background: none; }"
-    ).arg(BG_BASE).arg(BORDER_DEFAULT));
+    scroll_area_->setObjectName("ChatScroll");
     
     // Content widget
     content_widget_ = new QWidget(scroll_area_);
-    content_widget_->setStyleSheet(QString("background: %1;").arg(BG_BASE));
     
     content_layout_ = new QVBoxLayout(content_widget_);
     content_layout_->setContentsMargins(0, 20, 0, 20);
@@ -400,88 +576,656 @@ void CursorChatView::setup_ui() {
     
     scroll_area_->setWidget(content_widget_);
     layout->addWidget(scroll_area_);
+    
+    scroll_ = new ScrollController(scroll_area_);
+    
+    // Re-evaluate which tasks stay live whenever the viewport moves
+    reclaim_timer_.setSingleShot(true);
+    reclaim_timer_.setInterval(RECLAIM_DELAY_MS);
+    connect(&reclaim_timer_, &QTimer::timeout, this, &CursorChatView::reclaim);
+    connect(scroll_area_->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &CursorChatView::schedule_reclaim);
+    
+    // Highlights only cover what is on screen, so they follow the viewport
+    highlight_timer_.setSingleShot(true);
+    highlight_timer_.setInterval(HIGHLIGHT_DELAY_MS);
+    connect(&highlight_timer_, &QTimer::timeout, this, &CursorChatView::apply_highlights);
+    connect(scroll_area_->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &CursorChatView::schedule_highlights);
+}
+
+// ============================================================================
+// Task blocks
+// ============================================================================
+
+namespace {
+
+/// Search key: task position in the high half, op position in the low half
+std::uint64_t search_key(std::size_t task, std::size_t op) {
+    return (static_cast<std::uint64_t>(task) << 32) | static_cast<std::uint32_t>(op);
 }
 
-void CursorChatView::add_user_message(const QString& text) {
-    auto* msg = new UserMessageWidget(text, content_widget_);
-    content_layout_->insertWidget(content_layout_->count() - 1, msg);
+nlohmann::json op_to_json(const CursorMessageData& op) {
+    nlohmann::json j = {
+        {"type", static_cast<int>(op.type)},
+        {"content", op.content.toStdString()}
+    };
+    switch (op.type) {
+        case CursorMessageType::Thinking:
+            j["duration"] = op.duration_seconds;
+            break;
+        case CursorMessageType::ToolAction:
+            j["tool"] = static_cast<int>(op.tool_type);
+            j["detail"] = op.tool_detail.toStdString();
+            break;
+        case CursorMessageType::FileBlock:
+            j["file"] = {
+                {"name", op.file_data.filename.toStdString()},
+                {"added", op.file_data.lines_added},
+                {"removed", op.file_data.lines_removed},
+                {"new", op.file_data.is_new},
+                {"language", op.file_data.language.toStdString()}
+            };
+            break;
+        case CursorMessageType::CodeBlock:
+            j["code"] = op.code.toStdString();
+            break;
+        case CursorMessageType::Output:
+            j["output"] = op.code_output.toStdString();
+            j["error"] = op.code_error;
+            break;
+        default:
+            break;
+    }
+    return j;
+}
+
+CursorMessageData op_from_json(const nlohmann::json& j) {
+    auto str = [&j](const char* key) {
+        return QString::fromStdString(j.value(key, std::string()));
+    };
+    
+    CursorMessageData op;
+    op.type = static_cast<CursorMessageType>(j.value("type", 0));
+    op.content = str("content");
+    op.duration_seconds = j.value("duration", 0);
+    op.tool_type = static_cast<ToolActionType>(j.value("tool", static_cast<int>(ToolActionType::Custom)));
+    op.tool_detail = str("detail");
+    op.code = str("code");
+    op.code_output = str("output");
+    op.code_error = j.value("error", false);
+    if (j.contains("file")) {
+        const auto& f = j["file"];
+        op.file_data.filename = QString::fromStdString(f.value("name", std::string()));
+        op.file_data.lines_added = f.value("added", 0);
+        op.file_data.lines_removed = f.value("removed", 0);
+        op.file_data.is_new = f.value("new", false);
+        op.file_data.language = QString::fromStdString(f.value("language", std::string()));
+    }
+    return op;
+}
+
+/// Rough live cost of one op: text held by the log plus its rendered form
+std::size_t op_bytes(const CursorMessageData& op) {
+    constexpr std::size_t WIDGET_OVERHEAD = 2 * 1024;
+    constexpr std::size_t RENDER_FACTOR = 3;  // Log copy + label text + HTML
+    
+    std::size_t chars = static_cast<std::size_t>(op.content.size() + op.tool_detail.size()
+                                               + op.code.size() + op.code_output.size());
+    return WIDGET_OVERHEAD + chars * sizeof(QChar) * RENDER_FACTOR;
+}
+
+} // anonymous namespace
+
+ChatTaskEntry& CursorChatView::new_task(const QString& task_id, const QString& title) {
+    auto* block = new QWidget(content_widget_);
+    block->setObjectName("ChatTaskBlock");
+    auto* layout = new QVBoxLayout(block);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(content_layout_->spacing());
+    content_layout_->insertWidget(content_layout_->count() - 1, block);
+    
+    ChatTaskEntry entry;
+    entry.task_id = task_id;
+    entry.title = title;
+    entry.block = block;
+    entry.last_used = ++use_clock_;
+    
+    if (!task_id.isEmpty()) {
+        task_index_.insert(task_id, tasks_.size());
+    }
+    tasks_.push_back(std::move(entry));
+    return tasks_.back();
+}
+
+ChatTaskEntry& CursorChatView::current_task() {
+    // Messages before the first task (e.g. connection status) get their own block
+    if (tasks_.empty()) {
+        return new_task(QString(), QString());
+    }
+    return tasks_.back();
+}
+
+void CursorChatView::record(CursorMessageData op) {
+    ChatTaskEntry& task = current_task();
+    task.estimated_bytes += op_bytes(op);
+    index_op(search_key(tasks_.size() - 1, task.ops.size()), op);
+    task.ops.push_back(std::move(op));
+}
+
+std::size_t CursorChatView::live_task_count() const {
+    return static_cast<std::size_t>(std::count_if(tasks_.begin(), tasks_.end(),
+        [](const ChatTaskEntry& entry) { return !entry.is_spilled() && !entry.spilling; }));
+}
+
+std::size_t CursorChatView::live_bytes() const {
+    std::size_t total = 0;
+    for (const auto& entry : tasks_) {
+        total += entry.estimated_bytes;
+    }
+    return total;
+}
+
+void CursorChatView::enforce_live_limit(std::size_t keep) {
+    std::size_t live = live_task_count();
+    
+    while (live > MAX_LIVE_TASKS) {
+        // Least recently used, never the task being written, the one just
+        // opened, or one close enough to the viewport to be rehydrated again
+        int near_px = REHYDRATE_DISTANCE_SCREENS * scroll_area_->viewport()->height();
+        std::size_t victim = tasks_.size();
+        for (std::size_t i = 0; i + 1 < tasks_.size(); ++i) {
+            const ChatTaskEntry& entry = tasks_[i];
+            if (i == keep || entry.is_spilled() || entry.spilling || entry.loading) continue;
+            if (distance_to_viewport(entry) <= near_px) continue;
+            if (victim == tasks_.size() || tasks_[i].last_used < tasks_[victim].last_used) {
+                victim = i;
+            }
+        }
+        if (victim == tasks_.size()) break;
+        
+        spill_task(victim);
+        if (!tasks_[victim].spilling) break;
+        --live;
+    }
+}
+
+void CursorChatView::clear_block(QWidget* block) {
+    auto* layout = block->layout();
+    while (layout->count() > 0) {
+        auto* item = layout->takeAt(0);
+        if (item->widget()) {
+            item->widget()->hide();
+            item->widget()->deleteLater();
+        }
+        delete item;
+    }
+}
+
+void CursorChatView::spill_task(std::size_t index) {
+    ChatTaskEntry& entry = tasks_[index];
+    if (entry.is_spilled() || entry.spilling || entry.loading) return;
+    
+    // The widgets stay up until the write lands; finish_spill() swaps them
+    entry.spilling = true;
+    quint64 generation = ++entry.io_generation;
+    
+    QPointer<CursorChatView> self(this);
+    ThreadPool::instance().submit(
+        [self, token = task_io_, index, generation, ops = entry.ops]() {
+            nlohmann::json array = nlohmann::json::array();
+            for (const auto& op : ops) {
+                array.push_back(op_to_json(op));
+            }
+            BlobRef ref = BlobStore::shared().put(array.dump());
+            QMetaObject::invokeMethod(qApp, [self, token, index, generation, id = std::move(ref.id)]() {
+                if (self && !token.cancelled()) {
+                    self->finish_spill(index, generation, id);
+                }
+            }, Qt::QueuedConnection);
+        }, TaskPriority::Background, task_io_);
+}
+
+void CursorChatView::finish_spill(std::size_t index, quint64 generation, std::string blob_id) {
+    if (index >= tasks_.size()) return;
+    ChatTaskEntry& entry = tasks_[index];
+    if (!entry.spilling || entry.io_generation != generation) return;  // Abandoned
+    entry.spilling = false;
+    
+    // Blob store unavailable, or the user scrolled back while it was written
+    if (blob_id.empty()) return;
+    int near_px = REHYDRATE_DISTANCE_SCREENS * scroll_area_->viewport()->height();
+    if (distance_to_viewport(entry) <= near_px) return;
+    
+    // Keep the block's height so content below does not move
+    entry.spilled_height = entry.block->height();
+    entry.spilled_width = scroll_area_->viewport()->width();
+    
+    entry.blob_id = std::move(blob_id);
+    entry.estimated_bytes = 0;
+    std::vector<CursorMessageData>().swap(entry.ops);
+    clear_block(entry.block);
+    
+    QString label = entry.title.isEmpty() ? QString("Earlier messages") : entry.title;
+    auto* placeholder = new QPushButton(QString::fromUtf8("▸ ") + label, entry.block);
+    placeholder->setObjectName("TaskPlaceholder");
+    placeholder->setCursor(Qt::PointingHandCursor);
+    placeholder->setToolTip("Click to load this task");
+    if (entry.spilled_height > 0) {
+        placeholder->setFixedHeight(entry.spilled_height);
+    }
+    connect(placeholder, &QPushButton::clicked, this, [this, index]() {
+        if (index >= tasks_.size() || !tasks_[index].is_spilled()) return;
+        rehydrate_task(index, [this, index]() {
+            enforce_live_limit(index);
+            scroll_->scroll_to_widget(tasks_[index].block);
+        });
+    });
+    entry.block->layout()->addWidget(placeholder);
+    entry.placeholder = placeholder;
+    
+    live_bytes_.set(live_bytes());
+}
+
+void CursorChatView::rehydrate_task(std::size_t index, std::function<void()> then) {
+    ChatTaskEntry& entry = tasks_[index];
+    if (!entry.is_spilled()) {
+        if (then) then();
+        return;
+    }
+    
+    if (then) {
+        entry.after_load.push_back(std::move(then));
+    }
+    if (entry.loading) return;
+    entry.loading = true;
+    
+    // Read and parse on the pool, including collapsed outputs the task
+    // refers to by id; only widget construction happens on the GUI thread
+    QPointer<CursorChatView> self(this);
+    ThreadPool::instance().submit(
+        [self, token = task_io_, index, blob_id = entry.blob_id]() {
+            std::optional<std::vector<CursorMessageData>> ops;
+            std::vector<QString> outputs;
+            if (auto data = BlobStore::shared().read_all(blob_id)) {
+                try {
+                    std::vector<CursorMessageData> parsed;
+                    for (const auto& j : nlohmann::json::parse(*data)) {
+                        parsed.push_back(op_from_json(j));
+                    }
+                    ops = std::move(parsed);
+                } catch (...) {
+                }
+            }
+            if (ops) {
+                outputs.resize(ops->size());
+                for (std::size_t i = 0; i < ops->size(); ++i) {
+                    const auto& op = (*ops)[i];
+                    if (op.type != CursorMessageType::Output || !op.code_output.isEmpty()
+                        || op.content.isEmpty()) {
+                        continue;
+                    }
+                    auto blob = BlobStore::shared().read_all(op.content.toStdString());
+                    outputs[i] = blob ? QString::fromStdString(*blob) : QString("(output unavailable)");
+                }
+            }
+            QMetaObject::invokeMethod(qApp,
+                [self, token, index, ops = std::move(ops), outputs = std::move(outputs)]() {
+                    if (self && !token.cancelled()) {
+                        self->finish_rehydrate(index, ops, outputs);
+                    }
+                }, Qt::QueuedConnection);
+        }, TaskPriority::Interactive, task_io_);
+}
+
+void CursorChatView::finish_rehydrate(std::size_t index,
+                                      std::optional<std::vector<CursorMessageData>> ops,
+                                      std::vector<QString> outputs) {
+    if (index >= tasks_.size()) return;
+    ChatTaskEntry& entry = tasks_[index];
+    entry.loading = false;
+    auto callbacks = std::move(entry.after_load);
+    entry.after_load.clear();
+    
+    // Keep the placeholder if the blob was removed; callers do not retry
+    if (!ops) return;
+    
+    StallScope stall(StallCause::Render, "rehydrate task");
+    clear_block(entry.block);
+    auto* layout = entry.block->layout();
+    
+    // Rebuild straight into the block; this must not touch current_response_
+    AssistantResponseWidget* response = nullptr;
+    auto ensure_response = [&]() {
+        if (!response) {
+            response = new AssistantResponseWidget(entry.block);
+            layout->addWidget(response);
+        }
+        return response;
+    };
+    
+    for (std::size_t i = 0; i < ops->size(); ++i) {
+        const auto& op = (*ops)[i];
+        switch (op.type) {
+            case CursorMessageType::User:
+                layout->addWidget(new UserMessageWidget(op.content, entry.block));
+                response = nullptr;
+                break;
+            case CursorMessageType::Thinking:
+                ensure_response()->add_thinking(op.duration_seconds);
+                if (!op.content.isEmpty()) {
+                    response->thinking_stream()->set_text(op.content);
+                }
+                break;
+            case CursorMessageType::ToolAction:
+                ensure_response()->add_tool_action(op.tool_type, op.tool_detail);
+                break;
+            case CursorMessageType::Text:
+                ensure_response()->add_text(op.content);
+                break;
+            case CursorMessageType::FileBlock:
+                ensure_response()->add_file_block(op.file_data);
+                break;
+            case CursorMessageType::CodeBlock:
+                ensure_response()->add_code_block(op.code, op.content);
+                break;
+            case CursorMessageType::Output:
+                ensure_response()->add_output(op.code_output.isEmpty() ? outputs[i] : op.code_output,
+                                              op.code_error);
+                break;
+            case CursorMessageType::Summary:
+                ensure_response()->add_summary(op.content.split(QLatin1Char('\n')));
+                break;
+            default:
+                break;
+        }
+    }
+    
+    entry.estimated_bytes = 0;
+    for (const auto& op : *ops) {
+        entry.estimated_bytes += op_bytes(op);
+    }
+    entry.ops = std::move(*ops);
+    entry.blob_id.clear();
+    entry.placeholder.clear();
+    entry.spilled_height = 0;
+    entry.spilled_width = 0;
+    entry.last_used = ++use_clock_;
+    live_bytes_.set(live_bytes());
+    
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+void CursorChatView::resize_placeholders() {
+    // Text reflows with the width, so scale the recorded height to keep the
+    // scrollbar roughly where the real content would put it
+    int width = qMax(scroll_area_->viewport()->width(), 1);
+    for (auto& entry : tasks_) {
+        if (!entry.placeholder || entry.spilled_height <= 0 || entry.spilled_width <= 0) continue;
+        qint64 scaled = static_cast<qint64>(entry.spilled_height) * entry.spilled_width / width;
+        int height = static_cast<int>(qMax<qint64>(scaled, entry.placeholder->sizeHint().height()));
+        entry.placeholder->setFixedHeight(height);
+    }
+}
+
+void CursorChatView::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    resize_placeholders();
+}
+
+bool CursorChatView::scroll_to_task(const QString& task_id) {
+    auto it = task_index_.constFind(task_id);
+    if (it == task_index_.constEnd()) return false;
+    
+    // Scroll to the placeholder now; the block grows in place once loaded
+    std::size_t index = it.value();
+    if (tasks_[index].is_spilled()) {
+        rehydrate_task(index, [this, index]() { enforce_live_limit(index); });
+    }
+    tasks_[index].last_used = ++use_clock_;
+    
+    scroll_->scroll_to_widget(tasks_[index].block);
+    return true;
+}
+
+// ============================================================================
+// Adding content
+// ============================================================================
+
+void CursorChatView::add_user_message(const QString& text, const QString& task_id) {
+    end_text_stream();
+    
+    ChatTaskEntry& task = (task_id.isEmpty() && !tasks_.empty())
+        ? tasks_.back()
+        : new_task(task_id, text.left(80).simplified());
+    
+    auto* msg = new UserMessageWidget(text, task.block);
+    task.block->layout()->addWidget(msg);
+    record({CursorMessageType::User, text});
+    current_response_ = nullptr;
+    StallMonitor::instance().hint(StallCause::Layout, "chat view");
+    
+    enforce_live_limit(tasks_.size() - 1);
+    
+    // Sending a message always jumps back to the live end of the conversation
     scroll_to_bottom();
 }
 
 AssistantResponseWidget* CursorChatView::start_assistant_response() {
-    current_response_ = new AssistantResponseWidget(content_widget_);
-    content_layout_->insertWidget(content_layout_->count() - 1, current_response_);
+    end_text_stream();
+    
+    QWidget* block = current_task().block;
+    current_response_ = new AssistantResponseWidget(block);
+    block->layout()->addWidget(current_response_);
     return current_response_;
 }
 
 void CursorChatView::finish_assistant_response() {
+    end_text_stream();
+    
     current_response_ = nullptr;
-    scroll_to_bottom();
+    content_changed();
 }
 
 void CursorChatView::show_thinking() {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_thinking();
-    scroll_to_bottom();
+    record({CursorMessageType::Thinking});
+    content_changed();
 }
 
 void CursorChatView::hide_thinking(int duration_seconds) {
+    end_text_stream();
+    
+    QString thinking_text;
     if (current_response_ && current_response_->thinking_indicator()) {
         current_response_->thinking_indicator()->stop(duration_seconds);
     }
+    if (current_response_ && current_response_->has_thinking_stream()) {
+        current_response_->thinking_stream()->finish();
+        thinking_text = current_response_->thinking_stream()->text();
+    }
+    
+    ChatTaskEntry& task = current_task();
+    for (auto it = task.ops.rbegin(); it != task.ops.rend(); ++it) {
+        if (it->type == CursorMessageType::Thinking) {
+            it->duration_seconds = duration_seconds;
+            if (!thinking_text.isEmpty()) {
+                // Kept so a rehydrated task can show the stream again
+                task.estimated_bytes -= op_bytes(*it);
+                it->content = thinking_text;
+                task.estimated_bytes += op_bytes(*it);
+            }
+            break;
+        }
+    }
+}
+
+void CursorChatView::append_thinking_text(const QString& text) {
+    if (!current_response_) {
+        start_assistant_response();
+    }
+    current_response_->thinking_stream()->append(text);
 }
 
 void CursorChatView::add_tool_action(ToolActionType type, const QString& detail) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_tool_action(type, detail);
-    scroll_to_bottom();
+    
+    CursorMessageData op{CursorMessageType::ToolAction};
+    op.tool_type = type;
+    op.tool_detail = detail;
+    record(std::move(op));
+    content_changed();
 }
 
 void CursorChatView::add_assistant_text(const QString& text) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_text(text);
-    scroll_to_bottom();
+    record({CursorMessageType::Text, text});
+    content_changed();
+}
+
+void CursorChatView::append_assistant_text(const QString& text) {
+    if (text.isEmpty()) return;
+    if (!current_response_) {
+        start_assistant_response();
+    }
+    
+    if (!streaming_) {
+        streaming_ = true;
+        stream_text_.clear();
+        stream_label_ = current_response_->add_text(QString());
+        stream_op_ = current_task().ops.size();
+        record({CursorMessageType::Text});
+    }
+    text_buffer_.append(text);
+}
+
+void CursorChatView::on_stream_chunk(const QString& chunk) {
+    if (!streaming_) return;
+    
+    stream_text_ += chunk;
+    if (stream_label_) {
+        // Code is colored once, when the stream ends, not on every frame
+        AssistantResponseWidget::render_text(stream_label_, stream_text_, false);
+    }
+    content_changed();
+}
+
+void CursorChatView::end_text_stream() {
+    if (!streaming_) return;
+    
+    text_buffer_.flush();
+    streaming_ = false;
+    if (stream_label_) {
+        AssistantResponseWidget::render_text(stream_label_, stream_text_);
+    }
+    stream_label_.clear();
+    
+    // The op was recorded empty when the stream started; fill it in and index it
+    ChatTaskEntry& task = tasks_.back();
+    if (stream_op_ < task.ops.size()) {
+        CursorMessageData& op = task.ops[stream_op_];
+        task.estimated_bytes -= op_bytes(op);
+        op.content = std::move(stream_text_);
+        task.estimated_bytes += op_bytes(op);
+        index_op(search_key(tasks_.size() - 1, stream_op_), op);
+    }
+    stream_text_.clear();
 }
 
 void CursorChatView::add_file_block(const FileBlockData& data) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_file_block(data);
-    scroll_to_bottom();
+    
+    CursorMessageData op{CursorMessageType::FileBlock};
+    op.file_data = data;
+    record(std::move(op));
+    content_changed();
 }
 
 void CursorChatView::add_code_block(const QString& code, const QString& language) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_code_block(code, language);
-    scroll_to_bottom();
+    
+    CursorMessageData op{CursorMessageType::CodeBlock, language};
+    op.code = code;
+    record(std::move(op));
+    content_changed();
 }
 
 void CursorChatView::add_code_output(const QString& output, bool is_error) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
-    current_response_->add_output(output, is_error);
-    scroll_to_bottom();
+    std::string blob_id = current_response_->add_output(output, is_error);
+    
+    // The collapsed widget already stores the output; keep only its id
+    CursorMessageData op{CursorMessageType::Output};
+    op.code_error = is_error;
+    QByteArray utf8;
+    if (!blob_id.empty()) {
+        utf8 = output.toUtf8();
+        op.content = QString::fromStdString(blob_id);
+    } else {
+        op.code_output = output;
+    }
+    record(std::move(op));
+    
+    // record() skips id-only outputs; index the text on a worker instead
+    if (!blob_id.empty()) {
+        std::uint64_t key = search_key(tasks_.size() - 1, tasks_.back().ops.size() - 1);
+        ThreadPool::instance().submit(
+            [index = search_index_, key, utf8, blob_id = std::move(blob_id)]() {
+                index->add(key, std::string_view(utf8.constData(),
+                                                 static_cast<std::size_t>(utf8.size())), blob_id);
+            }, TaskPriority::Background, index_jobs_);
+    }
+    content_changed();
 }
 
 void CursorChatView::add_summary(const QStringList& points) {
+    end_text_stream();
+    
     if (!current_response_) {
         start_assistant_response();
     }
     current_response_->add_summary(points);
-    scroll_to_bottom();
+    record({CursorMessageType::Summary, points.join(QLatin1Char('\n'))});
+    content_changed();
 }
 
 void CursorChatView::clear() {
+    text_buffer_.discard();
+    streaming_ = false;
+    stream_label_.clear();
+    stream_text_.clear();
+    
     // Remove all widgets except the stretch
     while (content_layout_->count() > 1) {
         auto* item = content_layout_->takeAt(0);
@@ -491,14 +1235,451 @@ void CursorChatView::clear() {
         delete item;
     }
     current_response_ = nullptr;
+    task_io_.cancel();
+    task_io_ = CancelToken::create();
+    tasks_.clear();
+    task_index_.clear();
+    reclaim_timer_.stop();
+    live_bytes_.set(0);
+    
+    index_jobs_.cancel();
+    index_jobs_ = CancelToken::create();
+    search_job_.cancel();
+    search_index_ = std::make_shared<SearchIndex>();
+    highlighted_.clear();
+    search_hits_.clear();
+    search_current_ = -1;
+    search_stale_ = false;
+    hit_widget_.clear();
+    if (!search_query_.isEmpty()) {
+        emit search_result_changed(-1, 0);
+    }
 }
 
 void CursorChatView::scroll_to_bottom() {
-    QTimer::singleShot(10, this, [this]() {
-        scroll_area_->verticalScrollBar()->setValue(
-            scroll_area_->verticalScrollBar()->maximum()
-        );
+    scroll_->scroll_to_bottom();
+}
+
+void CursorChatView::content_changed() {
+    // The insert itself is cheap; Qt lays it out on the next event-loop pass
+    StallMonitor::instance().hint(StallCause::Layout, "chat view");
+    trace_layout();
+    scroll_->request_follow();
+    schedule_reclaim();
+}
+
+void CursorChatView::trace_layout() {
+    if (!Tracer::enabled() || layout_trace_pending_) return;
+    
+    // A zero timer runs after the LayoutRequest Qt posts for the insert, so
+    // the span covers the wait for the next pass plus the relayout itself
+    layout_trace_pending_ = true;
+    auto queued = Tracer::Clock::now();
+    QTimer::singleShot(0, this, [this, queued]() {
+        layout_trace_pending_ = false;
+        Tracer::instance().complete("ui", "layout", queued, Tracer::Clock::now());
+    });
+}
+
+// ============================================================================
+// Viewport-driven reclamation
+// ============================================================================
+
+void CursorChatView::schedule_reclaim() {
+    if (!reclaim_timer_.isActive()) {
+        reclaim_timer_.start();
+    }
+}
+
+int CursorChatView::distance_to_viewport(const ChatTaskEntry& entry) const {
+    // Blocks are direct children of the content widget, so geometry() is in
+    // content coordinates, as is the scrollbar value
+    int top = scroll_area_->verticalScrollBar()->value();
+    int bottom = top + scroll_area_->viewport()->height();
+    QRect rect = entry.block->geometry();
+    
+    if (rect.bottom() < top) return top - rect.bottom();
+    if (rect.top() > bottom) return rect.top() - bottom;
+    return 0;
+}
+
+void CursorChatView::reclaim() {
+    if (tasks_.size() < 2) {
+        live_bytes_.set(live_bytes());
+        return;
+    }
+    
+    int screen = qMax(scroll_area_->viewport()->height(), 1);
+    int near_px = REHYDRATE_DISTANCE_SCREENS * screen;
+    int far_px = EVICT_DISTANCE_SCREENS * screen;
+    
+    // The last task is being written to and always stays live
+    std::vector<std::pair<int, std::size_t>> offscreen;
+    for (std::size_t i = 0; i + 1 < tasks_.size(); ++i) {
+        int distance = distance_to_viewport(tasks_[i]);
+        if (tasks_[i].is_spilled()) {
+            if (distance <= near_px && !tasks_[i].loading) {
+                rehydrate_task(i);
+            }
+        } else if (tasks_[i].spilling) {
+            if (distance <= near_px) {
+                // Scrolled back before the write landed; keep the widgets
+                ++tasks_[i].io_generation;
+                tasks_[i].spilling = false;
+            }
+        } else if (distance > far_px) {
+            spill_task(i);
+        } else if (distance > near_px) {
+            offscreen.emplace_back(distance, i);
+        }
+    }
+    
+    // Over budget: also spill off-screen tasks inside the far band, farthest first
+    live_bytes_.set(live_bytes());
+    if (live_bytes_.over_budget()) {
+        std::size_t budget = live_bytes_.budget();
+        std::size_t bytes = live_bytes_.get();
+        std::sort(offscreen.begin(), offscreen.end(), std::greater<>());
+        for (const auto& [distance, index] : offscreen) {
+            if (bytes <= budget) break;
+            std::size_t freed = tasks_[index].estimated_bytes;
+            spill_task(index);
+            if (tasks_[index].spilling) {
+                bytes -= freed;
+            }
+        }
+    }
+    
+    enforce_live_limit(tasks_.size());
+    live_bytes_.set(live_bytes());
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+namespace {
+
+/// Text as the user sees it (labels holding markdown/HTML are flattened)
+QString widget_text(const QWidget* widget) {
+    if (auto* label = qobject_cast<const QLabel*>(widget)) {
+        const QString& text = label->text();
+        bool rich = label->textFormat() == Qt::RichText
+            || (label->textFormat() == Qt::AutoText && Qt::mightBeRichText(text));
+        return rich ? QTextDocumentFragment::fromHtml(text).toPlainText() : text;
+    }
+    if (auto* edit = qobject_cast<const QTextEdit*>(widget)) {
+        return edit->document()->toPlainText();
+    }
+    if (auto* edit = qobject_cast<const QPlainTextEdit*>(widget)) {
+        return edit->document()->toPlainText();
+    }
+    return {};
+}
+
+/// Text-bearing descendants of a task block, in display order
+std::vector<QWidget*> text_widgets(QWidget* root) {
+    std::vector<QWidget*> result;
+    for (QWidget* child : root->findChildren<QWidget*>()) {
+        bool text = qobject_cast<QLabel*>(child) || qobject_cast<QTextEdit*>(child)
+            || qobject_cast<QPlainTextEdit*>(child);
+        if (text && child->isVisibleTo(root)) {
+            result.push_back(child);
+        }
+    }
+    return result;
+}
+
+int count_matches(const QString& text, const QString& query) {
+    return static_cast<int>(text.count(query, Qt::CaseInsensitive));
+}
+
+/// Position of the n-th (zero-based) occurrence, or -1
+int nth_match(const QString& text, const QString& query, int n) {
+    int pos = -1;
+    for (int i = 0; i <= n; ++i) {
+        pos = static_cast<int>(text.indexOf(query, pos + 1, Qt::CaseInsensitive));
+        if (pos < 0) return -1;
+    }
+    return pos;
+}
+
+/// Highlight every occurrence in a text edit; the current one is stronger
+template <typename Edit>
+void highlight_edit(Edit* edit, const QString& query, int current, int max_count) {
+    QColor match(theme::ACCENT_YELLOW);
+    match.setAlpha(80);
+    QColor active(theme::ACCENT_YELLOW);
+    active.setAlpha(200);
+    
+    QList<QTextEdit::ExtraSelection> selections;
+    QTextCursor cursor = edit->document()->find(query);
+    while (!cursor.isNull() && selections.size() < max_count) {
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = cursor;
+        selection.format.setBackground(selections.size() == current ? active : match);
+        selections.push_back(selection);
+        cursor = edit->document()->find(query, cursor);
+    }
+    edit->setExtraSelections(selections);
+    
+    // Long outputs scroll internally; bring the current hit into view
+    if (current >= 0 && current < selections.size()) {
+        QTextCursor at = selections[current].cursor;
+        at.clearSelection();
+        edit->setTextCursor(at);
+        edit->ensureCursorVisible();
+    }
+}
+
+} // anonymous namespace
+
+void CursorChatView::index_op(std::uint64_t key, const CursorMessageData& op) {
+    // Collapsed outputs only carry a blob id here; add_code_output indexes them
+    if (op.type == CursorMessageType::Output && op.code_output.isEmpty()) return;
+    
+    std::string text;
+    auto append = [&text](const QString& part) {
+        if (part.isEmpty()) return;
+        if (!text.empty()) text += '\n';
+        text += part.toStdString();
+    };
+    if (op.type != CursorMessageType::CodeBlock) {
+        append(op.content);     // Language hint for code blocks
+    }
+    append(op.tool_detail);
+    append(op.code);
+    append(op.code_output);
+    append(op.file_data.filename);
+    if (text.empty()) return;
+    
+    // Adding may spill older documents to the blob store, so it runs on the pool
+    ThreadPool::instance().submit([index = search_index_, key, text = std::move(text)]() {
+        index->add(key, text);
+    }, TaskPriority::Background, index_jobs_);
+    search_stale_ = !search_query_.isEmpty();
+}
+
+void CursorChatView::run_find(std::function<void(std::vector<SearchIndex::Hit>)> done) {
+    // Blob-backed documents are read from disk during verification, so the
+    // lookup runs on the pool; a newer query or clear() supersedes it
+    search_job_.cancel();
+    search_job_ = CancelToken::create();
+    
+    QPointer<CursorChatView> self(this);
+    QByteArray utf8 = search_query_.toUtf8();
+    ThreadPool::instance().submit(
+        [self, token = search_job_, index = search_index_, utf8, done = std::move(done)]() {
+            auto hits = index->find(std::string_view(utf8.constData(),
+                                                     static_cast<std::size_t>(utf8.size())));
+            QMetaObject::invokeMethod(qApp, [self, token, done, hits = std::move(hits)]() {
+                if (self && !token.cancelled()) {
+                    done(hits);
+                }
+            }, Qt::QueuedConnection);
+        }, TaskPriority::Interactive, search_job_);
+}
+
+void CursorChatView::search(const QString& query) {
+    clear_highlights();
+    search_query_ = query;
+    search_hits_.clear();
+    search_current_ = -1;
+    search_stale_ = false;
+    hit_widget_.clear();
+    
+    if (query.isEmpty()) {
+        search_job_.cancel();
+        emit search_result_changed(-1, 0);
+        return;
+    }
+    
+    run_find([this](std::vector<SearchIndex::Hit> hits) {
+        search_hits_ = std::move(hits);
+        if (search_hits_.empty()) {
+            emit search_result_changed(-1, 0);
+            return;
+        }
+        
+        // Start from what the user is looking at rather than the top of the chat
+        int top = scroll_area_->verticalScrollBar()->value();
+        std::size_t first_task = 0;
+        while (first_task < tasks_.size() && tasks_[first_task].block->geometry().bottom() < top) {
+            ++first_task;
+        }
+        auto it = std::lower_bound(search_hits_.begin(), search_hits_.end(), search_key(first_task, 0),
+            [](const SearchIndex::Hit& hit, std::uint64_t key) { return hit.key < key; });
+        show_search_hit(it == search_hits_.end() ? 0 : static_cast<int>(it - search_hits_.begin()));
     });
 }
 
+void CursorChatView::refresh_search(std::vector<SearchIndex::Hit> hits) {
+    // Keep the position: new content is only ever appended after the current hit
+    std::uint64_t key = 0;
+    std::size_t offset = 0;
+    if (search_current_ >= 0) {
+        key = search_hits_[search_current_].key;
+        offset = search_hits_[search_current_].offset;
+    }
+    
+    search_hits_ = std::move(hits);
+    
+    auto it = std::lower_bound(search_hits_.begin(), search_hits_.end(), std::make_pair(key, offset),
+        [](const SearchIndex::Hit& hit, const std::pair<std::uint64_t, std::size_t>& at) {
+            return std::make_pair(hit.key, hit.offset) < at;
+        });
+    search_current_ = search_hits_.empty() ? -1
+        : static_cast<int>(std::min<std::ptrdiff_t>(it - search_hits_.begin(),
+                                                   static_cast<std::ptrdiff_t>(search_hits_.size()) - 1));
+}
+
+void CursorChatView::step_search(int delta) {
+    if (search_query_.isEmpty()) return;
+    
+    auto step = [this, delta]() {
+        int total = search_hit_count();
+        if (total == 0) {
+            emit search_result_changed(-1, 0);
+            return;
+        }
+        
+        int index = search_current_ < 0 ? 0 : ((search_current_ + delta) % total + total) % total;
+        show_search_hit(index);
+    };
+    
+    if (!search_stale_) {
+        step();
+        return;
+    }
+    search_stale_ = false;
+    run_find([this, step](std::vector<SearchIndex::Hit> hits) {
+        refresh_search(std::move(hits));
+        step();
+    });
+}
+
+void CursorChatView::show_search_hit(int index) {
+    search_current_ = index;
+    emit search_result_changed(index, search_hit_count());
+    
+    // Hits are ordered by key, so earlier hits in the same task are adjacent
+    std::size_t task = static_cast<std::size_t>(search_hits_[index].key >> 32);
+    int ordinal = 0;
+    for (int j = index - 1; j >= 0 && (search_hits_[j].key >> 32) == task; --j) {
+        ++ordinal;
+    }
+    if (task >= tasks_.size()) return;
+    
+    if (tasks_[task].is_spilled()) {
+        // Show the placeholder now and come back for the exact hit once
+        // loaded, unless the user has moved on by then
+        QString query = search_query_;
+        rehydrate_task(task, [this, task, index, query]() {
+            enforce_live_limit(task);
+            if (search_query_ == query && search_current_ == index && index < search_hit_count()) {
+                show_search_hit(index);
+            }
+        });
+        tasks_[task].last_used = ++use_clock_;
+        hit_widget_.clear();
+        scroll_->scroll_to_widget(tasks_[task].block);
+        return;
+    }
+    ChatTaskEntry& entry = tasks_[task];
+    entry.last_used = ++use_clock_;
+    
+    // Map the hit to the widget showing that occurrence. Rendered text can
+    // differ from the indexed source (markdown), so fall back to the last
+    // match in the block, then to the block itself.
+    hit_widget_.clear();
+    hit_occurrence_ = 0;
+    QWidget* last = nullptr;
+    int last_count = 0;
+    for (QWidget* widget : text_widgets(entry.block)) {
+        int count = count_matches(widget_text(widget), search_query_);
+        if (count == 0) continue;
+        if (ordinal < count) {
+            hit_widget_ = widget;
+            hit_occurrence_ = ordinal;
+            break;
+        }
+        ordinal -= count;
+        last = widget;
+        last_count = count;
+    }
+    if (!hit_widget_ && last) {
+        hit_widget_ = last;
+        hit_occurrence_ = last_count - 1;
+    }
+    
+    scroll_->scroll_to_widget(hit_widget_ ? hit_widget_.data() : entry.block);
+    schedule_highlights();
+}
+
+void CursorChatView::clear_search() {
+    search_job_.cancel();
+    clear_highlights();
+    search_query_.clear();
+    search_hits_.clear();
+    search_current_ = -1;
+    search_stale_ = false;
+    hit_widget_.clear();
+    highlight_timer_.stop();
+    emit search_result_changed(-1, 0);
+}
+
+void CursorChatView::schedule_highlights() {
+    if (!search_query_.isEmpty()) {
+        highlight_timer_.start();
+    }
+}
+
+void CursorChatView::clear_highlights() {
+    for (const auto& widget : highlighted_) {
+        if (!widget) continue;
+        if (auto* label = qobject_cast<QLabel*>(widget.data())) {
+            label->setSelection(0, 0);
+        } else if (auto* edit = qobject_cast<QTextEdit*>(widget.data())) {
+            edit->setExtraSelections({});
+        } else if (auto* plain = qobject_cast<QPlainTextEdit*>(widget.data())) {
+            plain->setExtraSelections({});
+        }
+    }
+    highlighted_.clear();
+}
+
+void CursorChatView::apply_highlights() {
+    clear_highlights();
+    if (search_query_.isEmpty() || search_hits_.empty()) return;
+    
+    // Only widgets inside the viewport; everything else is done on scroll
+    QRect view(0, scroll_area_->verticalScrollBar()->value(),
+               scroll_area_->viewport()->width(), scroll_area_->viewport()->height());
+    
+    for (const auto& entry : tasks_) {
+        if (entry.is_spilled() || distance_to_viewport(entry) > 0) continue;
+        
+        for (QWidget* widget : text_widgets(entry.block)) {
+            QRect rect(widget->mapTo(content_widget_, QPoint(0, 0)), widget->size());
+            if (!rect.intersects(view)) continue;
+            
+            int current = widget == hit_widget_ ? hit_occurrence_ : -1;
+            if (auto* label = qobject_cast<QLabel*>(widget)) {
+                // A label has a single selection: the current hit, else the first
+                int pos = nth_match(widget_text(label), search_query_, qMax(current, 0));
+                if (pos < 0) continue;
+                if (!(label->textInteractionFlags() & Qt::TextSelectableByMouse)) {
+                    label->setTextInteractionFlags(label->textInteractionFlags() | Qt::TextSelectableByMouse);
+                }
+                label->setSelection(pos, static_cast<int>(search_query_.size()));
+            } else if (auto* edit = qobject_cast<QTextEdit*>(widget)) {
+                highlight_edit(edit, search_query_, current, MAX_HIGHLIGHTS_PER_WIDGET);
+            } else if (auto* plain = qobject_cast<QPlainTextEdit*>(widget)) {
+                highlight_edit(plain, search_query_, current, MAX_HIGHLIGHTS_PER_WIDGET);
+            }
+            highlighted_.emplace_back(widget);
+        }
+    }
+}
+
 } // namespace ida_chat
@@ -4,15 +4,91 @@
  */
 
 #include <ida_chat/ui/cursor_input.hpp>
-#include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/ui/large_output_viewer.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+#include <ida_chat/history/blob_store.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
+#include <QApplication>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QKeyEvent>
+#include <QMimeData>
+#include <QPointer>
+
+#include <algorithm>
 
 namespace ida_chat {
 
-using namespace theme;
+// ============================================================================
+// PromptEdit
+// ============================================================================
+
+void PromptEdit::insertFromMimeData(const QMimeData* source) {
+    if (source && source->hasText()) {
+        QString text = source->text();
+        if (text.size() >= ATTACH_CHARS || text.count(QLatin1Char('\n')) >= ATTACH_LINES) {
+            emit large_paste(text);
+            return;
+        }
+    }
+    QTextEdit::insertFromMimeData(source);
+}
+
+// ============================================================================
+// AttachmentChip
+// ============================================================================
+
+AttachmentChip::AttachmentChip(const QString& label, QWidget* parent)
+    : QFrame(parent)
+{
+    setObjectName("AttachmentChip");
+    
+    auto* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(8, 3, 4, 3);
+    layout->setSpacing(4);
+    
+    label_ = new QLabel(QString::fromUtf8("📎 %1 · saving…").arg(label), this);
+    label_->setObjectName("AttachmentLabel");
+    layout->addWidget(label_);
+    
+    remove_button_ = new QPushButton(QString::fromUtf8("×"), this);
+    remove_button_->setObjectName("AttachmentRemove");
+    remove_button_->setFixedSize(18, 18);
+    remove_button_->setCursor(Qt::PointingHandCursor);
+    remove_button_->setToolTip("Remove attachment");
+    connect(remove_button_, &QPushButton::clicked, this, [this]() {
+        emit remove_requested(this);
+    });
+    layout->addWidget(remove_button_);
+}
+
+QString AttachmentChip::describe(const Attachment& attachment) {
+    QString tokens = attachment.tokens >= 1000
+        ? QString("%1k").arg(attachment.tokens / 1000.0, 0, 'f', 1)
+        : QString::number(attachment.tokens);
+    return QString("%1 · %2 · ~%3 tokens")
+        .arg(QString::fromStdString(attachment.label))
+        .arg(format_byte_size(attachment.size))
+        .arg(tokens);
+}
+
+void AttachmentChip::set_ready(const Attachment& attachment, const QString& preview) {
+    attachment_ = attachment;
+    pending_ = false;
+    label_->setText(QString::fromUtf8("📎 ") + describe(attachment));
+    setToolTip(preview);
+}
+
+void AttachmentChip::set_failed() {
+    pending_ = false;
+    label_->setText(QString::fromUtf8("📎 could not save paste"));
+    set_style_state(this, "error", true);
+}
+
+// ============================================================================
+// CursorInputWidget
+// ============================================================================
 
 CursorInputWidget::CursorInputWidget(QWidget* parent)
     : QWidget(parent)
@@ -21,33 +97,30 @@ CursorInputWidget::CursorInputWidget(QWidget* parent)
 }
 
 void CursorInputWidget::setup_ui() {
-    setStyleSheet(QString("background: %1;").arg(BG_BASE));
+    setObjectName("CursorInput");
     
     auto* main_layout = new QVBoxLayout(this);
     main_layout->setContentsMargins(16, 12, 16, 16);
     main_layout->setSpacing(10);
     
+    // Attachment chips (hidden until something large is pasted)
+    chips_row_ = new QWidget(this);
+    chips_layout_ = new QHBoxLayout(chips_row_);
+    chips_layout_->setContentsMargins(0, 0, 0, 0);
+    chips_layout_->setSpacing(6);
+    chips_layout_->addStretch();
+    chips_row_->setVisible(false);
+    main_layout->addWidget(chips_row_);
+    
     // Text input - simple, minimal border
-    text_edit_ = new QTextEdit(this);
+    text_edit_ = new PromptEdit(this);
     text_edit_->setPlaceholderText("Plan, search, build anything...");
-    text_edit_->setStyleSheet(QString(
-        "QTextEdit {"
-        "  background: %1;"
-        "  color: %2;"
-        "  border: 1px solid %3;"
-        "  border-radius: 8px;"
-        "  padding: 12px;"
-        "  font-size: %4;"
-        "  selection-background-color: %5;"
-        "}"
-        "QTextEdit:focus {"
-        "  border-color: %6;"
-        "}"
-    ).arg(BG_INPUT).arg(TEXT_PRIMARY).arg(BORDER_SUBTLE).arg(FONT_BASE).arg(ACCENT_BLUE).arg(BORDER_DEFAULT));
+    text_edit_->setObjectName("PromptEdit");
     text_edit_->setMinimumHeight(60);
     text_edit_->setMaximumHeight(120);
     text_edit_->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     text_edit_->installEventFilter(this);
+    connect(text_edit_, &PromptEdit::large_paste, this, &CursorInputWidget::add_paste_attachment);
     main_layout->addWidget(text_edit_);
     
     // Bottom row with controls
@@ -61,40 +134,13 @@ void CursorInputWidget::setup_ui() {
     agent_button_->setCheckable(true);
     agent_button_->setChecked(true);
     agent_button_->setCursor(Qt::PointingHandCursor);
-    agent_button_->setStyleSheet(QString(
-        "QPushButton {"
-        "  background: %1;"
-        "  color: %2;"
-        "  border: none;"
-        "  border-radius: 12px;"
-        "  padding: 5px 14px;"
-        "  font-size: %3;"
-        "}"
-        "QPushButton:checked {"
-        "  background: %4;"
-        "  color: %5;"
-        "}"
-        "QPushButton:hover {"
-        "  background: %6;"
-        "}"
-    ).arg(BG_CARD).arg(TEXT_SECONDARY).arg(FONT_SM)
-     .arg(BG_ELEVATED).arg(TEXT_PRIMARY).arg(BG_CARD_HOVER));
+    agent_button_->setObjectName("AgentButton");
     controls_layout->addWidget(agent_button_);
     
     // Model label (just text, hidden for CLI mode)
     model_combo_ = new QComboBox(controls);
     model_combo_->addItems({"claude-sonnet-4-20250514"});
-    model_combo_->setStyleSheet(QString(
-        "QComboBox {"
-        "  background: transparent;"
-        "  color: %1;"
-        "  border: none;"
-        "  padding: 4px 0;"
-        "  font-size: %2;"
-        "}"
-        "QComboBox::drop-down { width: 0; border: none; }"
-        "QComboBox::down-arrow { image: none; }"
-    ).arg(TEXT_MUTED).arg(FONT_SM));
+    model_combo_->setObjectName("ModelCombo");
     model_combo_->setVisible(false);  // Hidden by default for CLI mode
     controls_layout->addWidget(model_combo_);
     
@@ -102,30 +148,14 @@ void CursorInputWidget::setup_ui() {
     
     // Hint label
     hint_label_ = new QLabel("/ for commands · @ for files", controls);
-    hint_label_->setStyleSheet(QString("color: %1; font-size: %2;").arg(TEXT_PLACEHOLDER).arg(FONT_XS));
+    hint_label_->setObjectName("InputHint");
     controls_layout->addWidget(hint_label_);
     
     // Submit button (circle)
     submit_button_ = new QPushButton("↑", controls);
     submit_button_->setFixedSize(32, 32);
     submit_button_->setCursor(Qt::PointingHandCursor);
-    submit_button_->setStyleSheet(QString(
-        "QPushButton {"
-        "  background: %1;"
-        "  color: %2;"
-        "  border: none;"
-        "  border-radius: 16px;"
-        "  font-size: 16px;"
-        "  font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "  background: %3;"
-        "}"
-        "QPushButton:disabled {"
-        "  background: %4;"
-        "  color: %5;"
-        "}"
-    ).arg(BG_ELEVATED).arg(TEXT_PRIMARY).arg(BG_CARD_HOVER).arg(BG_CARD).arg(TEXT_MUTED));
+    submit_button_->setObjectName("SubmitButton");
     
     connect(submit_button_, &QPushButton::clicked, this, &CursorInputWidget::submit);
     controls_layout->addWidget(submit_button_);
@@ -143,12 +173,83 @@ QString CursorInputWidget::text() const {
 
 void CursorInputWidget::clear() {
     text_edit_->clear();
+    for (auto* chip : chips_) {
+        chip->deleteLater();
+    }
+    chips_.clear();
+    chips_row_->setVisible(false);
+    update_submit_button();
+}
+
+bool CursorInputWidget::has_attachments() const {
+    return std::any_of(chips_.begin(), chips_.end(),
+                       [](const AttachmentChip* chip) { return chip->is_ready(); });
+}
+
+std::vector<Attachment> CursorInputWidget::take_attachments() {
+    std::vector<Attachment> attachments;
+    for (auto* chip : chips_) {
+        if (chip->is_ready()) {
+            attachments.push_back(chip->attachment());
+        }
+        chip->deleteLater();
+    }
+    chips_.clear();
+    chips_row_->setVisible(false);
+    update_submit_button();
+    return attachments;
+}
+
+void CursorInputWidget::add_paste_attachment(const QString& text) {
+    QString label = QString("Pasted text #%1").arg(++paste_counter_);
+    
+    auto* chip = new AttachmentChip(label, chips_row_);
+    connect(chip, &AttachmentChip::remove_requested, this, &CursorInputWidget::remove_chip);
+    chips_layout_->insertWidget(chips_layout_->count() - 1, chip);
+    chips_.append(chip);
+    chips_row_->setVisible(true);
+    update_submit_button();
+    
+    // Encoding, hashing, token counting and the blob write all scale with the
+    // paste, so they run off the GUI thread
+    QPointer<CursorInputWidget> self(this);
+    QPointer<AttachmentChip> target(chip);
+    std::string name = label.toStdString();
+    ThreadPool::instance().submit([self, target, text, name]() {
+        QByteArray utf8 = text.toUtf8();
+        std::string_view data(utf8.constData(), static_cast<std::size_t>(utf8.size()));
+        
+        BlobRef ref = BlobStore::shared().put(data);
+        Attachment attachment;
+        attachment.blob_id = ref.id;
+        attachment.label = name;
+        attachment.size = ref.size;
+        attachment.tokens = estimate_tokens(data);
+        QString preview = text.left(PREVIEW_CHARS);
+        
+        QMetaObject::invokeMethod(qApp, [self, target, attachment, preview]() {
+            if (!self || !target) return;  // Removed while saving
+            if (attachment.blob_id.empty()) {
+                target->set_failed();
+            } else {
+                target->set_ready(attachment, preview);
+            }
+            self->update_submit_button();
+        }, Qt::QueuedConnection);
+    }, TaskPriority::Interactive);
+}
+
+void CursorInputWidget::remove_chip(AttachmentChip* chip) {
+    chips_.removeOne(chip);
+    chip->deleteLater();
+    chips_row_->setVisible(!chips_.isEmpty());
+    update_submit_button();
 }
 
 void CursorInputWidget::set_enabled(bool enabled) {
     enabled_ = enabled;
     text_edit_->setEnabled(enabled);
-    submit_button_->setEnabled(enabled && !text().isEmpty());
+    update_submit_button();
     
     if (!enabled) {
         text_edit_->setPlaceholderText("Processing...");
@@ -210,15 +311,18 @@ bool CursorInputWidget::eventFilter(QObject* obj, QEvent* event) {
 }
 
 void CursorInputWidget::submit() {
-    QString msg = text();
-    if (!msg.isEmpty() && enabled_) {
-        emit message_submitted(msg);
-        clear();
-    }
+    if (!submit_button_->isEnabled()) return;
+    
+    // Receivers take the attachments with take_attachments() before clear()
+    emit message_submitted(text());
+    clear();
 }
 
 void CursorInputWidget::update_submit_button() {
-    submit_button_->setEnabled(enabled_ && !text().isEmpty());
+    bool pending = std::any_of(chips_.begin(), chips_.end(),
+                               [](const AttachmentChip* chip) { return chip->is_pending(); });
+    bool has_content = !text().isEmpty() || has_attachments();
+    submit_button_->setEnabled(enabled_ && has_content && !pending);
 }
 
 } // namespace ida_chat
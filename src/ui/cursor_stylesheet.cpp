@@ -0,0 +1,253 @@
+/**
+ * @file cursor_stylesheet.cpp
+ * @brief Theme stylesheet compilation.
+ */
+
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+#include <ida_chat/ui/cursor_theme.hpp>
+
+#include <QStyle>
+
+namespace ida_chat {
+
+using namespace theme;
+
+namespace {
+
+QString build_stylesheet() {
+    QString css;
+    
+    // ========================================================================
+    // Base
+    // ========================================================================
+    
+    css += QString(
+        "QWidget { background-color: %1; color: %2; }"
+        "QLabel { background: transparent; }"
+        "QScrollBar:vertical { background: %1; width: 8px; border: none; }"
+        "QScrollBar::handle:vertical { background: %3; border-radius: 4px; min-height: 20px; }"
+        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { height: 0; }"
+        "QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical { background: none; }"
+        "QScrollBar:horizontal { background: %1; height: 8px; border: none; }"
+        "QScrollBar::handle:horizontal { background: %3; border-radius: 4px; min-width: 20px; }"
+        "QScrollBar::add-line:horizontal, QScrollBar::sub-line:horizontal { width: 0; }"
+        "QSplitter::handle { background: %4; }"
+    ).arg(BG_BASE, TEXT_PRIMARY, BORDER_DEFAULT, BORDER_SUBTLE);
+    
+    // ========================================================================
+    // Chat view
+    // ========================================================================
+    
+    css += QString(
+        "#ChatScroll { border: none; background: %1; }"
+        "#ChatScroll QScrollBar:vertical { width: 10px; margin: 2px; }"
+        "#UserBubble { background: %2; border-radius: %3; }"
+        "#UserBubble QLabel { color: %4; font-size: %5; }"
+        "#ThinkingIcon { color: %6; font-size: 8px; }"
+        "#ThinkingText { color: %6; font-size: %7; }"
+        "#ToolBullet { color: %6; font-size: 6px; }"
+        "#ToolAction { color: %8; font-size: %7; font-weight: 600; }"
+        "#ToolDetail { color: %6; font-size: %7; }"
+    ).arg(BG_BASE, BG_USER_MESSAGE, RADIUS_LG, TEXT_PRIMARY, FONT_BASE,
+          TEXT_MUTED, FONT_SM, TEXT_SECONDARY);
+    
+    css += QString(
+        "#ThinkingStreamHeader { background: transparent; color: %1; border: none; "
+        "  padding: 0; font-size: %2; text-align: left; }"
+        "#ThinkingStreamHeader:hover, #ThinkingStreamHeader[expanded=\"true\"] { color: %3; }"
+        "#ThinkingStream { background: %4; color: %1; border: 1px solid %5; border-radius: %6; "
+        "  font-size: %2; font-style: italic; }"
+    ).arg(TEXT_MUTED, FONT_SM, TEXT_SECONDARY, BG_ELEVATED, BORDER_SUBTLE, RADIUS_MD);
+    
+    css += QString(
+        "#FileBlock { background: %1; border-radius: %2; }"
+        "#FileBlock:hover { background: %3; }"
+        "#FileIcon { font-size: 16px; }"
+        "#FileName { color: %4; font-size: %5; }"
+        "#FileDiff { font-size: %6; }"
+    ).arg(BG_FILE_BLOCK, RADIUS_MD, BG_CARD_HOVER, TEXT_PRIMARY, FONT_BASE, FONT_SM);
+    
+    css += QString(
+        "#CodeContainer { background: %1; border: 1px solid %2; border-radius: %3; }"
+        "#CodeText { color: %4; font-family: %5; font-size: %6; border: none; }"
+        "QPlainTextEdit#CodeText { background: transparent; }"
+        "#OutputContainer { background: %7; border: 1px solid %8; border-radius: %3; margin-top: 6px; }"
+        "#OutputContainer[error=\"true\"] { background: %9; border-color: %10; }"
+        "#OutputText { color: %11; font-family: %5; font-size: %6; border: none; }"
+        "#OutputText[error=\"true\"] { color: %12; }"
+    ).arg(BG_CODE, BORDER_DEFAULT, RADIUS_MD, TEXT_CODE, FONT_MONO, FONT_SM,
+          BG_ELEVATED, BORDER_SUBTLE, BG_ERROR)
+     .arg(BORDER_ERROR, TEXT_SECONDARY, ACCENT_RED);
+    
+    css += QString(
+        "#ResponseText { color: %1; font-size: %2; }"
+        "#StandaloneOutput { color: %3; font-family: monospace; font-size: %4; "
+        "  background: %5; padding: 8px; border-radius: %6; }"
+        "#StandaloneOutput[error=\"true\"] { color: %7; }"
+        "#SummaryItem { color: %1; font-size: %2; margin-left: 8px; }"
+    ).arg(TEXT_PRIMARY, FONT_BASE, TEXT_SECONDARY, FONT_SM, BG_ELEVATED, RADIUS_MD, ACCENT_RED);
+    
+    css += QString(
+        "#TaskPlaceholder { background: transparent; color: %1; border: 1px dashed %2; "
+        "  border-radius: %3; padding: 6px 12px; margin: 0 20px; text-align: left; font-size: %4; }"
+        "#TaskPlaceholder:hover { background: %5; color: %6; }"
+    ).arg(TEXT_MUTED, BORDER_SUBTLE, RADIUS_MD, FONT_SM, BG_CARD_HOVER, TEXT_SECONDARY);
+    
+    // ========================================================================
+    // Large outputs
+    // ========================================================================
+    
+    css += QString(
+        "#OutputTitle { color: %1; font-size: %2; font-weight: 600; border: none; }"
+        "#OutputTitle[error=\"true\"] { color: %3; }"
+        "#OutputBadge { color: %1; background: %4; border-radius: %5; padding: 1px 6px; "
+        "  font-size: %6; border: none; }"
+        "#OutputOpenButton { color: %7; background: transparent; border: 1px solid %8; "
+        "  border-radius: %5; padding: 2px 10px; font-size: %6; }"
+        "#OutputOpenButton:hover { background: %4; }"
+    ).arg(TEXT_SECONDARY, FONT_SM, ACCENT_RED, BG_CARD_HOVER, RADIUS_SM, FONT_XS,
+          TEXT_PRIMARY, BORDER_DEFAULT);
+    
+    css += QString(
+        "#ViewerSearch { background: %1; border: 1px solid %2; border-radius: %3; padding: 4px 8px; }"
+        "#ViewerSearch:focus { border-color: %4; }"
+        "#ViewerButton { background: %5; border: 1px solid %2; border-radius: %3; padding: 4px 10px; }"
+        "#ViewerButton:hover { background: %6; }"
+        "#ViewerStatus { color: %7; font-size: %8; }"
+        "#ViewerText { background: %9; color: %10; border: 1px solid %11; border-radius: %3; }"
+    ).arg(BG_INPUT, BORDER_DEFAULT, RADIUS_SM, BORDER_FOCUS, BG_ELEVATED, BG_CARD_HOVER,
+          TEXT_MUTED, FONT_XS, BG_CODE)
+     .arg(TEXT_CODE, BORDER_SUBTLE);
+    
+    // ========================================================================
+    // Task sidebar
+    // ========================================================================
+    
+    css += QString(
+        "#TaskSidebar, #TaskSidebarContent { background: %1; }"
+        "#TaskSidebarScroll { border: none; background: transparent; }"
+        "#TaskSidebarScroll QScrollBar:vertical { background: transparent; width: 6px; }"
+        "#TaskSidebarScroll QScrollBar::handle:vertical { border-radius: 3px; }"
+        "#TaskSectionHeader { color: %2; font-size: 11px; font-weight: 600; "
+        "  text-transform: uppercase; letter-spacing: 0.5px; padding: 8px 0; }"
+    ).arg(BG_SIDEBAR, TEXT_MUTED);
+    
+    css += QString(
+        "#TaskCard, #TaskCard QWidget { background: transparent; }"
+        "#TaskCard:hover { background: %1; border-radius: 6px; }"
+        "#TaskTitle { color: %2; font-size: 13px; font-weight: 500; }"
+        "#TaskTime, #TaskSummary { color: %3; font-size: 11px; }"
+        "#TaskSummary[status=\"error\"] { color: %4; }"
+        "#TaskDiff { font-size: 11px; }"
+        "#TaskStatusIcon { color: %3; font-size: 14px; }"
+        "#TaskStatusIcon[status=\"complete\"] { color: %5; }"
+        "#TaskStatusIcon[status=\"error\"] { color: %4; }"
+    ).arg(BG_CARD_HOVER, TEXT_PRIMARY, TEXT_MUTED, ACCENT_RED, ACCENT_GREEN);
+    
+    // ========================================================================
+    // Input
+    // ========================================================================
+    
+    css += QString(
+        "#PromptEdit { background: %1; color: %2; border: 1px solid %3; border-radius: 8px; "
+        "  padding: 12px; font-size: %4; selection-background-color: %5; }"
+        "#PromptEdit:focus { border-color: %6; }"
+        "#AgentButton { background: %7; color: %8; border: none; border-radius: 12px; "
+        "  padding: 5px 14px; font-size: %9; }"
+        "#AgentButton:checked { background: %10; color: %2; }"
+        "#AgentButton:hover { background: %11; }"
+    ).arg(BG_INPUT, TEXT_PRIMARY, BORDER_SUBTLE, FONT_BASE, ACCENT_BLUE, BORDER_DEFAULT,
+          BG_CARD, TEXT_SECONDARY, FONT_SM)
+     .arg(BG_ELEVATED, BG_CARD_HOVER);
+    
+    css += QString(
+        "#ModelCombo { background: transparent; color: %1; border: none; padding: 4px 0; font-size: %2; }"
+        "#ModelCombo::drop-down { width: 0; border: none; }"
+        "#ModelCombo::down-arrow { image: none; }"
+        "#InputHint { color: %3; font-size: %4; }"
+        "#SubmitButton { background: %5; color: %6; border: none; border-radius: 16px; "
+        "  font-size: 16px; font-weight: bold; }"
+        "#SubmitButton:hover { background: %7; }"
+        "#SubmitButton:disabled { background: %8; color: %1; }"
+    ).arg(TEXT_MUTED, FONT_SM, TEXT_PLACEHOLDER, FONT_XS, BG_ELEVATED, TEXT_PRIMARY,
+          BG_CARD_HOVER, BG_CARD);
+    
+    css += QString(
+        "#AttachmentChip { background: %1; border: 1px solid %2; border-radius: %3; }"
+        "#AttachmentChip[error=\"true\"] { background: %4; border-color: %5; }"
+        "#AttachmentLabel { color: %6; font-size: %7; border: none; }"
+        "#AttachmentRemove { background: transparent; color: %8; border: none; font-size: 13px; }"
+        "#AttachmentRemove:hover { color: %9; }"
+    ).arg(BG_ELEVATED, BORDER_DEFAULT, RADIUS_MD, BG_ERROR, BORDER_ERROR, TEXT_SECONDARY,
+          FONT_XS, TEXT_MUTED, TEXT_PRIMARY);
+    
+    // ========================================================================
+    // Search
+    // ========================================================================
+    
+    css += QString(
+        "#SearchBar { background: %1; border-bottom: 1px solid %2; }"
+        "#SearchInput { background: %3; color: %4; border: 1px solid %2; border-radius: %5; "
+        "  padding: 4px 8px; font-size: %6; selection-background-color: %7; }"
+        "#SearchInput:focus { border-color: %8; }"
+        "#SearchStatus { color: %9; font-size: %10; }"
+    ).arg(BG_ELEVATED, BORDER_DEFAULT, BG_INPUT, TEXT_PRIMARY, RADIUS_SM, FONT_SM, ACCENT_BLUE,
+          BORDER_FOCUS, TEXT_MUTED)
+     .arg(FONT_XS);
+    
+    css += QString(
+        "#SearchStatus[empty=\"true\"] { color: %1; }"
+        "#SearchButton { background: transparent; color: %2; border: none; border-radius: %3; }"
+        "#SearchButton:hover { background: %4; color: %5; }"
+        "#SearchButton:disabled { color: %6; }"
+    ).arg(ACCENT_RED, TEXT_SECONDARY, RADIUS_SM, BG_CARD_HOVER, TEXT_PRIMARY, BORDER_DEFAULT);
+    
+    // ========================================================================
+    // Diagnostics
+    // ========================================================================
+    
+    css += QString(
+        "#StallOverlay { background: %1; color: %2; border: 1px solid %3; border-radius: %4; "
+        "  padding: 2px 6px; font-family: %5; font-size: %6; }"
+    ).arg(BG_ELEVATED, TEXT_SECONDARY, BORDER_DEFAULT, RADIUS_SM, FONT_MONO, FONT_XS);
+    
+    css += QString(
+        "#MemoryPanel { background: %1; color: %2; border: 1px solid %3; border-radius: %4; "
+        "  padding: 4px 8px; font-family: %5; font-size: %6; }"
+        "#MemoryPanel[over=\"true\"] { border-color: %7; }"
+    ).arg(BG_ELEVATED, TEXT_SECONDARY, BORDER_DEFAULT, RADIUS_SM, FONT_MONO, FONT_XS, COLOR_WARNING);
+    
+    css += QString(
+        "#TurnStatus { color: %1; font-family: %2; font-size: %3; padding: 2px 12px; "
+        "  border-top: 1px solid %4; }"
+        "#TurnStatus[active=\"true\"] { color: %5; }"
+    ).arg(TEXT_MUTED, FONT_MONO, FONT_XS, BORDER_SUBTLE, TEXT_SECONDARY);
+    
+    return css;
+}
+
+} // anonymous namespace
+
+const QString& cursor_stylesheet() {
+    static const QString css = build_stylesheet();
+    return css;
+}
+
+void apply_cursor_stylesheet(QWidget* root) {
+    if (root) {
+        root->setStyleSheet(cursor_stylesheet());
+    }
+}
+
+void set_style_state(QWidget* widget, const char* name, const QVariant& value) {
+    if (!widget || widget->property(name) == value) return;
+    
+    widget->setProperty(name, value);
+    
+    // Property selectors are only re-evaluated on polish
+    QStyle* style = widget->style();
+    style->unpolish(widget);
+    style->polish(widget);
+}
+
+} // namespace ida_chat
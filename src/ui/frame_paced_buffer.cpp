@@ -0,0 +1,59 @@
+/**
+ * @file frame_paced_buffer.cpp
+ * @brief Frame-paced text buffer implementation.
+ */
+
+#include <ida_chat/ui/frame_paced_buffer.hpp>
+
+#include <algorithm>
+
+namespace ida_chat {
+
+FramePacedBuffer::FramePacedBuffer(Sink sink)
+    : sink_(std::move(sink))
+{
+    timer_.setSingleShot(true);
+    timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&timer_, &QTimer::timeout, &timer_, [this]() { deliver(); });
+}
+
+void FramePacedBuffer::append(const QString& text) {
+    if (text.isEmpty()) return;
+    
+    pending_ += text;
+    if (!timer_.isActive()) {
+        timer_.start(interval_ms_);
+    }
+}
+
+void FramePacedBuffer::flush() {
+    timer_.stop();
+    if (has_pending()) {
+        deliver();
+    }
+}
+
+void FramePacedBuffer::discard() {
+    timer_.stop();
+    pending_.clear();
+    interval_ms_ = FRAME_MS;
+}
+
+void FramePacedBuffer::deliver() {
+    // Swap out first: the sink may append more (re-entrancy is harmless)
+    QString chunk;
+    chunk.swap(pending_);
+    
+    QElapsedTimer cost;
+    cost.start();
+    if (sink_) {
+        sink_(chunk);
+    }
+    
+    interval_ms_ = std::clamp(static_cast<int>(cost.elapsed()) * 2, FRAME_MS, MAX_INTERVAL_MS);
+    if (has_pending() && !timer_.isActive()) {
+        timer_.start(interval_ms_);
+    }
+}
+
+} // namespace ida_chat
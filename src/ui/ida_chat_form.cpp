@@ -18,7 +18,10 @@
 #include <QClipboard>
 #include <QDir>
 #include <QFile>
-#include <QElapsedTimer>
+#include <QTimer>
+#include <QDateTime>
+#include <QShortcut>
+#include <QKeySequence>
 
 // Then IDA headers with our compatibility wrapper
 #include <ida_chat/common/ida_begin.hpp>
@@ -28,10 +31,19 @@
 
 // Then our headers
 #include <ida_chat/ui/ida_chat_form.hpp>
-#include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
 #include <ida_chat/core/script_executor.hpp>
+#include <ida_chat/core/script_scheduler.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+#include <ida_chat/core/tracer.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
+#include <ida_chat/core/log.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+#include <ida_chat/history/session_manager.hpp>
 #include <ida_chat/plugin/settings.hpp>
 
+#include <atomic>
+
 namespace ida_chat {
 
 // ============================================================================
@@ -50,15 +62,22 @@ const char* IDAChatForm::widget_title() {
 
 IDAChatForm::IDAChatForm() 
     : QObject(nullptr)
-{}
+{
+    // One fairness group per form, so chats in two databases share the main thread
+    static std::atomic<unsigned> next_session{1};
+    script_session_ = "chat-" + std::to_string(next_session.fetch_add(1));
+}
 
 IDAChatForm::~IDAChatForm() {
     if (worker_) {
         worker_->stop();
     }
+    ScriptScheduler::instance().close_session(script_session_);
 }
 
 void IDAChatForm::create_and_show() {
+    startup_trace_.start();
+    
     // Create an empty IDA widget
     TWidget* tw = create_empty_widget(WIDGET_TITLE, -1);
     if (!tw) {
@@ -82,13 +101,36 @@ void IDAChatForm::on_widget_visible(IDAWidget* ida_widget) {
     
     ida_widget_ = ida_widget;
     
+    if (!startup_trace_.is_running()) {
+        startup_trace_.start();
+    }
+    startup_trace_.mark("widget");
+    
+    // Only what the first frame needs is built here; the agent, onboarding
+    // panel and sidebar are created after the dock has painted or on first use.
     create_ui(widget_);
+    startup_trace_.mark("create_ui");
+    
+    QTimer::singleShot(0, this, &IDAChatForm::on_first_show);
+}
+
+void IDAChatForm::on_first_show() {
+    if (!widget_) return;  // Closed before the first event-loop turn
+    
+    startup_trace_.mark_first_show();
+    
     init_agent();
+    startup_trace_.mark("init_agent");
+    
+    start_stall_monitor();
+    start_tracer();
+    MemoryAccountant::instance().set_budgets(get_memory_budgets());
     
     // Check if we need to show onboarding
     Settings settings;
     if (settings.show_wizard()) {
         show_onboarding();
+        startup_trace_.mark("onboarding");
     } else {
         // Auto-connect with saved settings
         AuthCredentials creds;
@@ -98,16 +140,75 @@ void IDAChatForm::on_widget_visible(IDAWidget* ida_widget) {
         }
         worker_->request_connect(creds);
     }
+    
+    bool slow_start = startup_trace_.over_budget();
+    IDA_CHAT_LOG(slow_start ? LogLevel::Warning : LogLevel::Info, "ui", "startup: %s%s",
+                 slow_start ? "OVER BUDGET - " : "",
+                 startup_trace_.summary().toUtf8().constData());
 }
 
 void IDAChatForm::on_widget_closing() {
     if (worker_) {
         worker_->stop();
     }
+    export_stall_report();
+    export_trace();
+    stall_overlay_ = nullptr;
+    memory_panel_ = nullptr;
     widget_ = nullptr;
     ida_widget_ = nullptr;
 }
 
+void IDAChatForm::start_stall_monitor() {
+    std::string mode = get_stall_monitor_mode();
+    if (mode != "on" && mode != "overlay") return;
+    
+    StallMonitor::instance().start([](std::function<void()> fn) {
+        QMetaObject::invokeMethod(qApp, std::move(fn), Qt::QueuedConnection);
+    });
+    
+    if (mode == "overlay" && !stall_overlay_) {
+        stall_overlay_ = new StallOverlay(chat_container_);
+        stall_overlay_->show();
+    }
+}
+
+void IDAChatForm::export_stall_report() {
+    auto& monitor = StallMonitor::instance();
+    if (!monitor.is_running()) return;
+    
+    monitor.stop();
+    if (monitor.stall_count() == 0) return;
+    
+    std::string path = get_metrics_directory() + IDA_CHAT_PATH_SEP_STR "stalls-"
+        + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss").toStdString() + ".json";
+    if (monitor.export_json(path)) {
+        msg("[IDA Chat] %zu GUI stalls recorded, report: %s\n",
+            monitor.stall_count(), path.c_str());
+    }
+    monitor.clear();
+}
+
+void IDAChatForm::start_tracer() {
+    if (!get_trace_enabled()) return;
+    
+    auto& tracer = Tracer::instance();
+    tracer.set_thread_name("ui");
+    tracer.set_enabled(true);
+}
+
+void IDAChatForm::export_trace() {
+    auto& tracer = Tracer::instance();
+    if (!Tracer::enabled() || tracer.event_count() == 0) return;
+    
+    std::string path = get_metrics_directory() + IDA_CHAT_PATH_SEP_STR "trace-"
+        + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss").toStdString() + ".json";
+    if (tracer.export_chrome_json(path)) {
+        msg("[IDA Chat] %zu trace events, Chrome trace: %s\n", tracer.event_count(), path.c_str());
+    }
+    tracer.clear();
+}
+
 bool IDAChatForm::is_visible() const {
     return widget_ && widget_->isVisible();
 }
@@ -127,37 +228,22 @@ void IDAChatForm::hide() {
 }
 
 void IDAChatForm::create_ui(QWidget* parent) {
-    using namespace theme;
-    
     // Main layout
     main_layout_ = new QVBoxLayout(parent);
     main_layout_->setContentsMargins(0, 0, 0, 0);
     main_layout_->setSpacing(0);
     
-    // Apply dark theme to parent
-    parent->setStyleSheet(QString(
-        "QWidget { background-color: %1; color: %2; }"
-        "QScrollBar:vertical { background: %1; width: 8px; border: none; }"
-        "QScrollBar::handle:vertical { background: %3; border-radius: 4px; min-height: 20px; }"
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { height: 0; }"
-        "QScrollBar:horizontal { background: %1; height: 8px; border: none; }"
-        "QScrollBar::handle:horizontal { background: %3; border-radius: 4px; min-width: 20px; }"
-        "QScrollBar::add-line:horizontal, QScrollBar::sub-line:horizontal { width: 0; }"
-    ).arg(BG_BASE, TEXT_PRIMARY, BORDER_DEFAULT));
+    // Apply the compiled dark theme once at the root; children only set
+    // object names and state properties.
+    apply_cursor_stylesheet(parent);
     
     // Create stacked widget for switching between onboarding and main view
     stack_ = new QStackedWidget(parent);
     
-    // Create main view (sidebar + chat)
+    // Create main view (chat; the sidebar is added with the first task)
     create_main_view();
     stack_->addWidget(main_view_);
     
-    // Create onboarding panel
-    onboarding_ = new OnboardingPanel(stack_);
-    connect(onboarding_, &OnboardingPanel::onboarding_complete,
-            this, &IDAChatForm::on_onboarding_complete);
-    stack_->addWidget(onboarding_);
-    
     main_layout_->addWidget(stack_, 1);
     
     // Default to main view
@@ -165,8 +251,6 @@ void IDAChatForm::create_ui(QWidget* parent) {
 }
 
 void IDAChatForm::create_main_view() {
-    using namespace theme;
-    
     main_view_ = new QWidget(stack_);
     QHBoxLayout* layout = new QHBoxLayout(main_view_);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -176,19 +260,11 @@ void IDAChatForm::create_main_view() {
     splitter_ = new QSplitter(Qt::Horizontal, main_view_);
     splitter_->setHandleWidth(1);
     splitter_->setChildrenCollapsible(false);
-    splitter_->setStyleSheet(QString(
-        "QSplitter::handle { background: %1; }"
-    ).arg(BORDER_SUBTLE));
     
-    // === LEFT: Task Sidebar ===
-    sidebar_ = new TaskSidebar(splitter_);
-    connect(sidebar_, &TaskSidebar::task_selected,
-            this, &IDAChatForm::update_for_task);
-    splitter_->addWidget(sidebar_);
+    // === LEFT: Task Sidebar (created by ensure_sidebar) ===
     
     // === RIGHT: Chat Container ===
     chat_container_ = new QWidget(splitter_);
-    chat_container_->setStyleSheet(QString("background-color: %1;").arg(BG_BASE));
     
     QVBoxLayout* chat_layout = new QVBoxLayout(chat_container_);
     chat_layout->setContentsMargins(0, 0, 0, 0);
@@ -198,6 +274,15 @@ void IDAChatForm::create_main_view() {
     chat_view_ = new CursorChatView(chat_container_);
     chat_layout->addWidget(chat_view_, 1);
     
+    // Ctrl+F anywhere in the chat column (including the input) opens search
+    auto* find_shortcut = new QShortcut(QKeySequence::Find, chat_container_);
+    find_shortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(find_shortcut, &QShortcut::activated, this, &IDAChatForm::open_search);
+    
+    auto* memory_shortcut = new QShortcut(QKeySequence("Ctrl+Shift+M"), chat_container_);
+    memory_shortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(memory_shortcut, &QShortcut::activated, this, &IDAChatForm::toggle_memory_panel);
+    
     // Input widget
     input_ = new CursorInputWidget(chat_container_);
     input_->set_placeholder("Plan, search, build anything...");
@@ -207,19 +292,48 @@ void IDAChatForm::create_main_view() {
             this, &IDAChatForm::on_cancel);
     chat_layout->addWidget(input_);
     
+    create_status_bar();
+    
     splitter_->addWidget(chat_container_);
+    splitter_->setStretchFactor(0, 1);
     
-    // Set initial splitter sizes (sidebar: 240px, chat: rest)
-    splitter_->setSizes({240, 560});
+    layout->addWidget(splitter_);
+}
+
+TaskSidebar* IDAChatForm::ensure_sidebar() {
+    if (sidebar_) return sidebar_;
+    
+    sidebar_ = new TaskSidebar(splitter_);
+    connect(sidebar_, &TaskSidebar::task_selected,
+            this, &IDAChatForm::update_for_task);
+    splitter_->insertWidget(0, sidebar_);
+    
+    // Sidebar: 240px, chat: rest
+    splitter_->setSizes({240, qMax(splitter_->width() - 240, 320)});
     splitter_->setStretchFactor(0, 0);  // Sidebar doesn't stretch
     splitter_->setStretchFactor(1, 1);  // Chat stretches
     
-    layout->addWidget(splitter_);
+    return sidebar_;
+}
+
+OnboardingPanel* IDAChatForm::ensure_onboarding() {
+    if (onboarding_) return onboarding_;
+    
+    onboarding_ = new OnboardingPanel(stack_);
+    connect(onboarding_, &OnboardingPanel::onboarding_complete,
+            this, &IDAChatForm::on_onboarding_complete);
+    stack_->addWidget(onboarding_);
+    
+    return onboarding_;
 }
 
 void IDAChatForm::create_status_bar() {
-    // Status bar removed in Cursor-style UI
-    // Status info is shown in sidebar task cards
+    // Per-request totals stay on the sidebar task cards; this strip shows the
+    // live numbers of the running request, polled from the worker's recorder
+    status_strip_ = new TurnStatusStrip([this]() {
+        return worker_ ? worker_->turn_metrics() : TurnMetrics{};
+    }, chat_container_);
+    chat_container_->layout()->addWidget(status_strip_);
 }
 
 void IDAChatForm::init_agent() {
@@ -231,6 +345,11 @@ void IDAChatForm::init_agent() {
     std::string binary_path = "unknown_binary";
     message_history_ = std::make_unique<MessageHistory>(binary_path);
     
+    // Reclaim blobs of deleted sessions; scans every transcript, so not here
+    ThreadPool::instance().submit([]() {
+        (void)SessionManager().collect_blobs();
+    }, TaskPriority::Background);
+    
     // Create worker
     worker_ = std::make_unique<AgentWorker>(executor, message_history_.get());
     
@@ -247,6 +366,8 @@ void IDAChatForm::init_agent() {
             this, &IDAChatForm::on_thinking);
     connect(sigs, &AgentSignals::thinking_done,
             this, &IDAChatForm::on_thinking_done);
+    connect(sigs, &AgentSignals::thinking_text,
+            this, &IDAChatForm::on_thinking_text);
     connect(sigs, &AgentSignals::tool_use,
             this, &IDAChatForm::on_tool_use);
     connect(sigs, &AgentSignals::text,
@@ -259,11 +380,14 @@ void IDAChatForm::init_agent() {
             this, &IDAChatForm::on_error);
     connect(sigs, &AgentSignals::result,
             this, &IDAChatForm::on_result);
+    connect(sigs, &AgentSignals::metrics,
+            this, &IDAChatForm::on_metrics);
     connect(sigs, &AgentSignals::finished,
             this, &IDAChatForm::on_finished);
     
     // Load system prompt from project directory
-    // Try multiple locations for the project files
+    // Try multiple locations for the project files; the worker probes them
+    // and reads the prompt so no disk I/O happens on the GUI thread.
     QStringList search_paths = {
         // Installed location (via CMake install)
         QApplication::applicationDirPath() + "/plugins/ida_chat_project",
@@ -275,28 +399,14 @@ void IDAChatForm::init_agent() {
         "/Users/int/dev/ida-conv/ida-chat-plugin/project",
     };
     
-    QString project_dir;
-    for (const QString& path : search_paths) {
-        msg("[IDA Chat] init_agent: checking path '%s'\n", path.toUtf8().constData());
-        if (QDir(path).exists() && QFile::exists(path + "/PROMPT.md")) {
-            project_dir = path;
-            msg("[IDA Chat] init_agent: found project dir at '%s'\n", project_dir.toUtf8().constData());
-            break;
-        }
-    }
-    
-    if (!project_dir.isEmpty()) {
-        worker_->load_system_prompt(project_dir);
-    } else {
-        msg("[IDA Chat] init_agent: WARNING - no project directory found!\n");
-    }
+    worker_->request_load_prompt(search_paths);
     
     // Start the worker thread
     worker_->start();
 }
 
 ScriptExecutorFn IDAChatForm::create_script_executor() {
-    return create_main_thread_executor();
+    return create_main_thread_executor(script_session_);
 }
 
 // ============================================================================
@@ -354,6 +464,10 @@ void IDAChatForm::on_thinking_done() {
     chat_view_->hide_thinking(duration_seconds);
 }
 
+void IDAChatForm::on_thinking_text(const QString& text) {
+    chat_view_->append_thinking_text(text);
+}
+
 void IDAChatForm::on_tool_use(const QString& tool_name, const QString& details) {
     // Map tool names to ToolActionType
     ToolActionType type = ToolActionType::Custom;
@@ -377,7 +491,8 @@ void IDAChatForm::on_tool_use(const QString& tool_name, const QString& details)
 }
 
 void IDAChatForm::on_text(const QString& text) {
-    chat_view_->add_assistant_text(text);
+    // API mode streams deltas; they are coalesced into one element per frame
+    chat_view_->append_assistant_text(text);
 }
 
 void IDAChatForm::on_script_code(const QString& code) {
@@ -392,25 +507,33 @@ void IDAChatForm::on_error(const QString& error) {
     chat_view_->add_code_output(error, true);
     
     // Mark current task as error
-    if (!current_task_id_.isEmpty()) {
+    if (sidebar_ && !current_task_id_.isEmpty()) {
         sidebar_->error_task(current_task_id_, error);
     }
 }
 
 void IDAChatForm::on_result(int num_turns, double cost) {
     // Update task in sidebar with result info
-    if (!current_task_id_.isEmpty()) {
+    if (sidebar_ && !current_task_id_.isEmpty()) {
         sidebar_->update_task_cost(current_task_id_, cost, num_turns);
     }
 }
 
+void IDAChatForm::on_metrics(const QString& snapshot_json) {
+    auto snapshot = nlohmann::json::parse(snapshot_json.toStdString(), nullptr, false);
+    if (!snapshot.is_discarded()) {
+        status_strip_->set_percentiles(snapshot);
+    }
+}
+
 void IDAChatForm::on_finished() {
     processing_ = false;
     input_->set_enabled(true);
     chat_view_->finish_assistant_response();
+    status_strip_->stop();
     
     // Complete the task in sidebar
-    if (!current_task_id_.isEmpty()) {
+    if (sidebar_ && !current_task_id_.isEmpty()) {
         sidebar_->complete_task(current_task_id_);
     }
 }
@@ -420,20 +543,28 @@ void IDAChatForm::on_finished() {
 // ============================================================================
 
 void IDAChatForm::on_message_submitted(const QString& text) {
-    if (text.isEmpty() || processing_) return;
+    if (processing_ || !worker_) return;
+    if (text.isEmpty() && !input_->has_attachments()) return;
     
     processing_ = true;
     thinking_start_time_ = 0;
     
+    // Large pastes travel as blob references, not through the prompt text
+    std::vector<Attachment> attachments = input_->take_attachments();
+    QString display = text;
+    for (const auto& attachment : attachments) {
+        display += QString::fromUtf8("\n📎 ") + AttachmentChip::describe(attachment);
+    }
+    
     // Create a new task in sidebar
-    QString task_title = text;
+    QString task_title = text.isEmpty() ? QString::fromStdString(attachments.front().label) : text;
     if (task_title.length() > 40) {
         task_title = task_title.left(37) + "...";
     }
-    current_task_id_ = sidebar_->add_task(task_title);
+    current_task_id_ = ensure_sidebar()->add_task(task_title);
     
     // Add user message to chat view
-    chat_view_->add_user_message(text);
+    chat_view_->add_user_message(display.trimmed(), current_task_id_);
     
     // Start assistant response container
     chat_view_->start_assistant_response();
@@ -441,9 +572,10 @@ void IDAChatForm::on_message_submitted(const QString& text) {
     // Disable input while processing
     input_->set_enabled(false);
     input_->clear();
+    status_strip_->start();
     
     // Send to worker
-    worker_->send_message(text);
+    worker_->send_message(text, std::move(attachments));
 }
 
 void IDAChatForm::on_cancel() {
@@ -454,12 +586,13 @@ void IDAChatForm::on_cancel() {
         chat_view_->add_assistant_text("(Cancelled)");
         chat_view_->finish_assistant_response();
         
-        if (!current_task_id_.isEmpty()) {
+        if (sidebar_ && !current_task_id_.isEmpty()) {
             sidebar_->error_task(current_task_id_, "Cancelled by user");
         }
         
         processing_ = false;
         input_->set_enabled(true);
+        status_strip_->stop();
     }
 }
 
@@ -483,6 +616,8 @@ void IDAChatForm::on_clear() {
     );
     
     if (reply == QMessageBox::Yes) {
+        // One trace file per session
+        export_trace();
         chat_view_->clear();
         worker_->request_new_session();
         session_usage_ = TokenUsage{};
@@ -510,15 +645,51 @@ void IDAChatForm::on_onboarding_complete() {
 // ============================================================================
 
 void IDAChatForm::show_onboarding() {
-    onboarding_->load_current_settings();
+    ensure_onboarding()->load_current_settings();
     stack_->setCurrentWidget(onboarding_);
 }
 
 void IDAChatForm::update_for_task(const QString& task_id) {
-    // Called when user clicks a task in sidebar
-    // Could scroll to that task's messages in chat view
-    // For now, just update the current task
-    current_task_id_ = task_id;
+    // Called when user clicks a task in sidebar. Navigation only:
+    // current_task_id_ stays on the running task so its card keeps updating.
+    if (chat_view_) {
+        chat_view_->scroll_to_task(task_id);
+    }
+}
+
+void IDAChatForm::toggle_memory_panel() {
+    if (!chat_container_) return;
+    
+    if (!memory_panel_) {
+        memory_panel_ = new MemoryPanel(chat_container_);
+        memory_panel_->show();
+        return;
+    }
+    memory_panel_->setVisible(!memory_panel_->isVisible());
+}
+
+void IDAChatForm::open_search() {
+    if (!chat_view_) return;
+    
+    if (!search_bar_) {
+        search_bar_ = new SearchBar(chat_container_);
+        static_cast<QVBoxLayout*>(chat_container_->layout())->insertWidget(0, search_bar_);
+        
+        connect(search_bar_, &SearchBar::query_changed, chat_view_, &CursorChatView::search);
+        connect(search_bar_, &SearchBar::next_requested, chat_view_, [this]() {
+            chat_view_->step_search(1);
+        });
+        connect(search_bar_, &SearchBar::prev_requested, chat_view_, [this]() {
+            chat_view_->step_search(-1);
+        });
+        connect(search_bar_, &SearchBar::closed, this, [this]() {
+            chat_view_->clear_search();
+            input_->focus();
+        });
+        connect(chat_view_, &CursorChatView::search_result_changed,
+                search_bar_, &SearchBar::set_result);
+    }
+    search_bar_->open();
 }
 
 } // namespace ida_chat
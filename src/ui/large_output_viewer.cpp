@@ -0,0 +1,288 @@
+/**
+ * @file large_output_viewer.cpp
+ * @brief Collapsed placeholder and chunked viewer for large script outputs.
+ */
+
+#include <ida_chat/ui/large_output_viewer.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFontDatabase>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QLocale>
+#include <QPointer>
+#include <QApplication>
+
+namespace ida_chat {
+
+QString format_byte_size(quint64 bytes) {
+    if (bytes < 1024) return QString("%1 B").arg(bytes);
+    if (bytes < 1024 * 1024) return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    if (bytes < 1024ull * 1024 * 1024) return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    return QString("%1 GB").arg(bytes / (1024.0 * 1024.0 * 1024.0), 0, 'f', 2);
+}
+
+// ============================================================================
+// CollapsedOutputWidget
+// ============================================================================
+
+bool CollapsedOutputWidget::should_collapse(const QString& output) {
+    // Same threshold as the history spill (UTF-16 units never exceed UTF-8
+    // bytes, so a collapsed output is always spilled too)
+    if (static_cast<std::size_t>(output.size()) >= BlobStore::SPILL_THRESHOLD) return true;
+    return output.count(QLatin1Char('\n')) > COLLAPSE_LINES;
+}
+
+CollapsedOutputWidget::CollapsedOutputWidget(const QString& output, bool is_error, QWidget* parent)
+    : QWidget(parent)
+    , is_error_(is_error)
+{
+    // The id is known up front; the write (normally a dedup hit, since the
+    // history stores the same bytes) happens on the pool
+    QByteArray utf8 = output.toUtf8();
+    std::string_view data(utf8.constData(), static_cast<std::size_t>(utf8.size()));
+    blob_.id = BlobStore::content_id(data);
+    blob_.size = data.size();
+    
+    QPointer<CollapsedOutputWidget> self(this);
+    ThreadPool::instance().submit([self, utf8]() {
+        BlobRef ref = BlobStore::shared().put(
+            std::string_view(utf8.constData(), static_cast<std::size_t>(utf8.size())));
+        QMetaObject::invokeMethod(qApp, [self, ok = ref.valid()]() {
+            if (self) self->on_stored(ok);
+        }, Qt::QueuedConnection);
+    }, TaskPriority::Interactive);
+    
+    line_count_ = static_cast<int>(output.count(QLatin1Char('\n'))) + 1;
+    
+    // Preview: first few lines, capped so a single huge line stays cheap
+    qsizetype cut = -1;
+    qsizetype from = 0;
+    for (int i = 0; i < PREVIEW_LINES; ++i) {
+        cut = output.indexOf(QLatin1Char('\n'), from);
+        if (cut < 0) break;
+        from = cut + 1;
+    }
+    qsizetype preview_len = cut < 0 ? output.size() : cut;
+    QString preview = output.left(qMin<qsizetype>(preview_len, 2000));
+    
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    
+    auto* container = new QWidget(this);
+    container->setObjectName("OutputContainer");
+    container->setProperty("error", is_error);
+    
+    auto* container_layout = new QVBoxLayout(container);
+    container_layout->setContentsMargins(14, 10, 14, 10);
+    container_layout->setSpacing(6);
+    
+    // Header: title, size badge, open button
+    auto* header = new QHBoxLayout();
+    header->setSpacing(8);
+    
+    auto* title = new QLabel(is_error ? "Error output" : "Output", container);
+    title->setObjectName("OutputTitle");
+    title->setProperty("error", is_error);
+    header->addWidget(title);
+    
+    auto* badge = new QLabel(QString("%1 · %2 lines")
+        .arg(format_byte_size(static_cast<quint64>(utf8.size())))
+        .arg(QLocale().toString(line_count_)), container);
+    badge->setObjectName("OutputBadge");
+    header->addWidget(badge);
+    header->addStretch();
+    
+    open_button_ = new QPushButton("Open", container);
+    open_button_->setCursor(Qt::PointingHandCursor);
+    open_button_->setEnabled(false);
+    open_button_->setToolTip("Saving output...");
+    open_button_->setObjectName("OutputOpenButton");
+    connect(open_button_, &QPushButton::clicked, this, &CollapsedOutputWidget::open_viewer);
+    header->addWidget(open_button_);
+    
+    container_layout->addLayout(header);
+    
+    auto* preview_label = new QLabel(container);
+    preview_label->setTextFormat(Qt::PlainText);
+    preview_label->setText(preview + "\n…");
+    preview_label->setWordWrap(true);
+    preview_label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    preview_label->setObjectName("OutputText");
+    preview_label->setProperty("error", is_error);
+    container_layout->addWidget(preview_label);
+    
+    layout->addWidget(container);
+}
+
+void CollapsedOutputWidget::on_stored(bool ok) {
+    open_button_->setEnabled(ok);
+    open_button_->setToolTip(ok ? QString() : QString("Could not save the output"));
+}
+
+void CollapsedOutputWidget::open_viewer() {
+    if (!blob_.valid()) return;
+    
+    QString title = QString("%1 (%2)")
+        .arg(is_error_ ? "Error output" : "Script output")
+        .arg(format_byte_size(blob_.size));
+    
+    auto* viewer = new LargeOutputViewer(blob_, title, window());
+    viewer->show();
+    viewer->raise();
+    viewer->activateWindow();
+}
+
+// ============================================================================
+// LargeOutputViewer
+// ============================================================================
+
+LargeOutputViewer::LargeOutputViewer(const BlobRef& blob, const QString& title, QWidget* parent)
+    : QWidget(parent, Qt::Window | Qt::Tool)
+    , blob_(blob)
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle(title);
+    resize(900, 600);
+    
+    // Parented to IDA's main window, so the dock's sheet does not cascade here
+    apply_cursor_stylesheet(this);
+    
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(8, 8, 8, 8);
+    layout->setSpacing(6);
+    
+    // Search row
+    auto* search_row = new QHBoxLayout();
+    search_row->setSpacing(6);
+    
+    search_edit_ = new QLineEdit(this);
+    search_edit_->setPlaceholderText("Find...");
+    search_edit_->setClearButtonEnabled(true);
+    search_edit_->setObjectName("ViewerSearch");
+    connect(search_edit_, &QLineEdit::returnPressed, this, [this]() { find(false); });
+    search_row->addWidget(search_edit_, 1);
+    
+    auto make_button = [this](const QString& text) {
+        auto* button = new QPushButton(text, this);
+        button->setObjectName("ViewerButton");
+        return button;
+    };
+    
+    auto* prev_button = make_button("Previous");
+    connect(prev_button, &QPushButton::clicked, this, [this]() { find(true); });
+    search_row->addWidget(prev_button);
+    
+    auto* next_button = make_button("Next");
+    connect(next_button, &QPushButton::clicked, this, [this]() { find(false); });
+    search_row->addWidget(next_button);
+    
+    status_label_ = new QLabel(this);
+    status_label_->setObjectName("ViewerStatus");
+    search_row->addWidget(status_label_);
+    
+    layout->addLayout(search_row);
+    
+    // Text view: no wrapping and no undo keep appends and layout cheap
+    text_ = new QPlainTextEdit(this);
+    text_->setReadOnly(true);
+    text_->setUndoRedoEnabled(false);
+    text_->setLineWrapMode(QPlainTextEdit::NoWrap);
+    text_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    text_->setObjectName("ViewerText");
+    layout->addWidget(text_, 1);
+    
+    // One chunk per event-loop pass
+    load_timer_.setInterval(0);
+    connect(&load_timer_, &QTimer::timeout, this, &LargeOutputViewer::load_next_chunk);
+    load_timer_.start();
+    
+    update_status();
+}
+
+void LargeOutputViewer::load_next_chunk() {
+    auto data = BlobStore::shared().read(blob_.id, offset_, CHUNK_BYTES);
+    bool at_end = !data || data->empty() || offset_ + data->size() >= blob_.size;
+    
+    if (data) {
+        offset_ += data->size();
+        carry_.append(data->data(), static_cast<qsizetype>(data->size()));
+    }
+    
+    // Only insert whole lines (keeps UTF-8 sequences intact); a pathological
+    // line longer than a few chunks is flushed anyway.
+    QByteArray ready;
+    if (at_end) {
+        ready = std::move(carry_);
+        carry_.clear();
+    } else {
+        qsizetype nl = carry_.lastIndexOf('\n');
+        if (nl >= 0) {
+            ready = carry_.left(nl + 1);
+            carry_.remove(0, nl + 1);
+        } else if (carry_.size() > 4 * CHUNK_BYTES) {
+            ready = std::move(carry_);
+            carry_.clear();
+        }
+    }
+    
+    if (!ready.isEmpty()) {
+        QTextCursor cursor(text_->document());
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(QString::fromUtf8(ready));
+    }
+    
+    if (text_->blockCount() >= MAX_BLOCKS && !at_end) {
+        truncated_ = true;
+        at_end = true;
+    }
+    
+    if (at_end) {
+        load_timer_.stop();
+        carry_.clear();
+    }
+    
+    update_status();
+}
+
+void LargeOutputViewer::find(bool backward) {
+    QString query = search_edit_->text();
+    if (query.isEmpty()) return;
+    
+    QTextDocument::FindFlags flags;
+    if (backward) flags |= QTextDocument::FindBackward;
+    
+    if (!text_->find(query, flags)) {
+        // Wrap around
+        QTextCursor cursor = text_->textCursor();
+        cursor.movePosition(backward ? QTextCursor::End : QTextCursor::Start);
+        text_->setTextCursor(cursor);
+        if (!text_->find(query, flags)) {
+            status_label_->setText(load_timer_.isActive()
+                ? "No match in loaded text yet"
+                : "No match");
+            return;
+        }
+    }
+    update_status();
+}
+
+void LargeOutputViewer::update_status() {
+    QString lines = QLocale().toString(text_->blockCount());
+    
+    if (load_timer_.isActive()) {
+        int percent = blob_.size ? static_cast<int>(offset_ * 100 / blob_.size) : 100;
+        status_label_->setText(QString("Loading %1% · %2 lines").arg(percent).arg(lines));
+    } else if (truncated_) {
+        status_label_->setText(QString("Showing first %1 lines of %2")
+            .arg(lines).arg(format_byte_size(blob_.size)));
+    } else {
+        status_label_->setText(QString("%1 lines · %2").arg(lines).arg(format_byte_size(blob_.size)));
+    }
+}
+
+} // namespace ida_chat
@@ -4,6 +4,7 @@
  */
 
 #include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/ui/syntax_highlighter.hpp>
 
 #include <QApplication>
 #include <QPalette>
@@ -107,12 +108,27 @@ QString MarkdownRenderer::render_inline_code(const QString& code) const {
         .arg(escaped);
 }
 
-QString MarkdownRenderer::render_code_block(const QString& code, const QString& /*language*/) const {
-    QString escaped = escape_html(code);
+QString MarkdownRenderer::render_code_block(const QString& code, const QString& language) const {
+    return code_block_html(code, language, true);
+}
+
+QString MarkdownRenderer::code_block_html(const QString& code, const QString& language, bool highlight) const {
+    // Rendering is synchronous, so only cached blocks get colors here; the
+    // rest fall back to plain text and are listed in pending_code_blocks().
+    std::optional<QString> highlighted;
+    if (highlight) {
+        CodeLanguage lang = language_from_hint(language);
+        if (lang != CodeLanguage::Plain) {
+            highlighted = SyntaxHighlighter::instance().cached_html(code, lang);
+            if (!highlighted) pending_code_blocks_.push_back({code, language});
+        }
+    }
+    QString body = highlighted ? *highlighted : escape_html(code);
+    
     return QString("<pre style=\"background-color: %1; color: %2; padding: 8px; border-radius: 4px; overflow-x: auto;\"><code>%3</code></pre>")
         .arg(colors_.dark.name())
         .arg(colors_.text.name())
-        .arg(escaped);
+        .arg(body);
 }
 
 QString MarkdownRenderer::render_inline(const QString& text) const {
@@ -183,7 +199,8 @@ QString MarkdownRenderer::render_line(const QString& line) const {
     return render_inline(escape_html(line));
 }
 
-QString MarkdownRenderer::render(const QString& markdown) const {
+QString MarkdownRenderer::render(const QString& markdown, bool highlight) const {
+    pending_code_blocks_.clear();
     QString result;
     QStringList lines = markdown.split('\n');
     
@@ -199,7 +216,7 @@ QString MarkdownRenderer::render(const QString& markdown) const {
         if (line.startsWith("```")) {
             if (in_code_block) {
                 // End code block
-                result += render_code_block(code_block_content, code_block_language);
+                result += code_block_html(code_block_content, code_block_language, highlight);
                 code_block_content.clear();
                 code_block_language.clear();
                 in_code_block = false;
@@ -241,9 +258,9 @@ QString MarkdownRenderer::render(const QString& markdown) const {
         }
     }
     
-    // Close any unclosed code block
+    // Close any unclosed code block; it is still being written, so never color it
     if (in_code_block) {
-        result += render_code_block(code_block_content, code_block_language);
+        result += code_block_html(code_block_content, code_block_language, false);
     }
     
     // Close any unclosed list
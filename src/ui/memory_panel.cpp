@@ -0,0 +1,91 @@
+/**
+ * @file memory_panel.cpp
+ * @brief Memory debug panel implementation.
+ */
+
+#include <ida_chat/ui/memory_panel.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+#include <ida_chat/core/memory_accounting.hpp>
+
+#include <QStringList>
+
+namespace ida_chat {
+
+namespace {
+
+QString format_bytes(std::size_t bytes) {
+    if (bytes < 1024) return QString("%1 B").arg(bytes);
+    if (bytes < 1024 * 1024) return QString("%1 KB").arg(static_cast<double>(bytes) / 1024.0, 0, 'f', 1);
+    return QString("%1 MB").arg(static_cast<double>(bytes) / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+QString row(const QString& name, const QString& live, const QString& peak, const QString& budget) {
+    return QString("%1 %2 %3 %4")
+        .arg(name, -16)
+        .arg(live, 9)
+        .arg(peak, 9)
+        .arg(budget, 9);
+}
+
+} // anonymous namespace
+
+MemoryPanel::MemoryPanel(QWidget* parent)
+    : QLabel(parent)
+{
+    setObjectName("MemoryPanel");
+    setTextFormat(Qt::PlainText);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_StyledBackground);
+    
+    timer_.setInterval(REFRESH_INTERVAL_MS);
+    connect(&timer_, &QTimer::timeout, this, &MemoryPanel::refresh);
+    
+    move(8, 8);
+    refresh();
+    raise();
+}
+
+QString MemoryPanel::format_usage(bool* any_over_budget) {
+    auto& accountant = MemoryAccountant::instance();
+    bool over = false;
+    
+    QStringList lines;
+    lines << row("memory", "live", "peak", "budget");
+    for (const auto& usage : accountant.usage()) {
+        over = over || usage.over_budget();
+        lines << row(QString::fromUtf8(memory_subsystem_name(usage.subsystem)),
+                     format_bytes(usage.bytes),
+                     format_bytes(usage.peak),
+                     usage.budget ? format_bytes(usage.budget) : QString("-"))
+               + (usage.over_budget() ? " !" : "");
+    }
+    lines << row("total", format_bytes(accountant.total()), QString(), QString());
+    
+    if (any_over_budget) *any_over_budget = over;
+    return lines.join('\n');
+}
+
+void MemoryPanel::showEvent(QShowEvent* event) {
+    QLabel::showEvent(event);
+    raise();
+    refresh();
+    timer_.start();
+}
+
+void MemoryPanel::hideEvent(QHideEvent* event) {
+    timer_.stop();
+    QLabel::hideEvent(event);
+}
+
+void MemoryPanel::refresh() {
+    bool over = false;
+    QString text = format_usage(&over);
+    set_style_state(this, "over", over);
+    
+    if (text != this->text()) {
+        setText(text);
+        adjustSize();
+    }
+}
+
+} // namespace ida_chat
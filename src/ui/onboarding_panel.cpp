@@ -6,7 +6,10 @@
 #include <ida_chat/ui/onboarding_panel.hpp>
 #include <ida_chat/ui/markdown_renderer.hpp>
 #include <ida_chat/plugin/settings.hpp>
-#include <ida_chat/core/chat_core.hpp>  // for test_claude_connection
+#include <ida_chat/core/chat_core.hpp>  // for test_claude_connection_cached
+#include <ida_chat/ui/animation_ticker.hpp>
+#include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/core/thread_pool.hpp>
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -17,6 +20,9 @@
 #include <QButtonGroup>
 #include <QStackedWidget>
 #include <QTimer>
+#include <QPointer>
+#include <QDateTime>
+#include <QApplication>
 
 namespace ida_chat {
 
@@ -27,7 +33,10 @@ OnboardingPanel::OnboardingPanel(QWidget* parent)
     load_current_settings();
 }
 
-OnboardingPanel::~OnboardingPanel() = default;
+OnboardingPanel::~OnboardingPanel() {
+    // A queued test is skipped; a running one finishes and drops its result
+    test_token_.cancel();
+}
 
 void OnboardingPanel::load_current_settings() {
     Settings settings;
@@ -82,36 +91,81 @@ void OnboardingPanel::on_auth_type_changed() {
 }
 
 void OnboardingPanel::on_test_clicked() {
-    if (testing_) return;
+    // While a test is running the button doubles as Cancel
+    if (testing_) {
+        cancel_test();
+        return;
+    }
     testing_ = true;
     
-    test_button_->setEnabled(false);
-    test_button_->setText("Testing...");
+    test_button_->setText("Cancel");
     status_label_->setText("Testing connection...");
     status_label_->setStyleSheet("color: #f59e0b;");  // Orange
     
     // Get credentials
     AuthCredentials creds = get_credentials();
     
-    // Test in background (would normally use QThread)
-    // For simplicity, we'll test synchronously
-    QTimer::singleShot(100, this, [this, creds]() {
-        auto [success, message] = test_claude_connection(creds);
-        on_test_finished(success, QString::fromStdString(message));
+    // The CLI test spawns a process and waits for a full model reply, so it
+    // runs on the shared pool, which the plugin joins before it unloads.
+    // Cancelling kills the CLI child, freeing the worker, and bumps the
+    // generation so a late result is dropped.
+    const quint64 generation = ++test_generation_;
+    test_started_ms_ = QDateTime::currentMSecsSinceEpoch();
+    test_token_.cancel();
+    test_token_ = CancelToken::create();
+    
+    QPointer<OnboardingPanel> self(this);
+    CancelToken token = test_token_;
+    ThreadPool::instance().submit([self, creds, generation, token]() {
+        ConnectionTestResult result = test_claude_connection_cached(creds, false, token);
+        if (token.cancelled()) return;
+        QMetaObject::invokeMethod(qApp, [self, result, generation]() {
+            if (self && self->test_generation_ == generation) {
+                self->on_test_finished(result);
+            }
+        }, Qt::QueuedConnection);
+    }, TaskPriority::Interactive, test_token_);
+    
+    AnimationTicker::instance().subscribe(status_label_, [this](int frame) {
+        update_test_progress(frame);
     });
 }
 
-void OnboardingPanel::on_test_finished(bool success, const QString& message) {
+void OnboardingPanel::update_test_progress(int frame) {
+    qint64 elapsed = (QDateTime::currentMSecsSinceEpoch() - test_started_ms_) / 1000;
+    status_label_->setText(QString("%1 Testing connection... %2s")
+        .arg(theme::SPINNER_FRAMES[frame % theme::SPINNER_FRAMES.size()])
+        .arg(elapsed));
+}
+
+void OnboardingPanel::cancel_test() {
+    ++test_generation_;
+    test_token_.cancel();
+    end_test();
+    status_label_->setText("Test cancelled");
+    status_label_->setStyleSheet(QString("color: %1;").arg(ColorScheme::from_ida_palette().mid.name()));
+}
+
+void OnboardingPanel::end_test() {
     testing_ = false;
-    test_button_->setEnabled(true);
+    AnimationTicker::instance().unsubscribe(status_label_);
     test_button_->setText("Test Connection");
+}
+
+void OnboardingPanel::on_test_finished(const ConnectionTestResult& result) {
+    end_test();
+    
+    QString message = QString::fromStdString(result.message);
+    QString detail = QString(" (%1, %2)")
+        .arg(QString::fromStdString(result.auth_path))
+        .arg(result.cached ? QString("cached") : QString("%1 ms").arg(qRound(result.latency_ms)));
     
-    if (success) {
-        status_label_->setText(QString::fromUtf8("\u2713 ") + message);  // ✓
+    if (result.success) {
+        status_label_->setText(QString::fromUtf8("\u2713 ") + message + detail);  // ✓
         status_label_->setStyleSheet("color: #22c55e;");  // Green
         save_button_->setEnabled(true);
     } else {
-        status_label_->setText(QString::fromUtf8("\u2717 ") + message);  // ✗
+        status_label_->setText(QString::fromUtf8("\u2717 ") + message + detail);  // ✗
         status_label_->setStyleSheet("color: #ef4444;");  // Red
     }
 }
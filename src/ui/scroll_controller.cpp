@@ -0,0 +1,82 @@
+/**
+ * @file scroll_controller.cpp
+ * @brief Coalesced stick-to-bottom autoscroll implementation.
+ */
+
+#include <ida_chat/ui/scroll_controller.hpp>
+
+#include <QScrollBar>
+
+namespace ida_chat {
+
+ScrollController::ScrollController(QScrollArea* area)
+    : QObject(area)
+    , area_(area)
+{
+    frame_timer_.setSingleShot(true);
+    frame_timer_.setInterval(FRAME_INTERVAL_MS);
+    connect(&frame_timer_, &QTimer::timeout, this, &ScrollController::apply);
+    
+    QScrollBar* vbar = area->verticalScrollBar();
+    connect(vbar, &QScrollBar::rangeChanged, this, &ScrollController::on_range_changed);
+    connect(vbar, &QScrollBar::valueChanged, this, &ScrollController::on_value_changed);
+}
+
+void ScrollController::request_follow() {
+    if (following_ && !frame_timer_.isActive()) {
+        frame_timer_.start();
+    }
+}
+
+void ScrollController::scroll_to_bottom() {
+    target_.clear();
+    following_ = true;
+    request_follow();
+}
+
+void ScrollController::scroll_to_widget(QWidget* target) {
+    target_ = target;
+    following_ = false;
+    if (!frame_timer_.isActive()) {
+        frame_timer_.start();
+    }
+}
+
+void ScrollController::on_range_changed(int min, int max) {
+    Q_UNUSED(min);
+    Q_UNUSED(max);
+    
+    // Content grew (or shrank) after a layout pass; stay pinned if following
+    // or anchored to a navigation target.
+    if (following_ || target_) {
+        apply();
+    }
+}
+
+void ScrollController::on_value_changed(int value) {
+    if (applying_ || !area_) return;
+    
+    // User scrolled: drop any anchor, follow only while at (or near) the bottom.
+    target_.clear();
+    QScrollBar* vbar = area_->verticalScrollBar();
+    following_ = vbar->maximum() - value <= STICK_THRESHOLD_PX;
+}
+
+void ScrollController::apply() {
+    if (!area_) return;
+    
+    QScrollBar* vbar = area_->verticalScrollBar();
+    if (target_ && area_->widget()) {
+        applying_ = true;
+        vbar->setValue(target_->mapTo(area_->widget(), QPoint(0, 0)).y());
+        applying_ = false;
+        return;
+    }
+    if (!following_ || vbar->value() == vbar->maximum()) return;
+    
+    applying_ = true;
+    vbar->setValue(vbar->maximum());
+    applying_ = false;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,128 @@
+/**
+ * @file search_bar.cpp
+ * @brief Find-in-conversation bar implementation.
+ */
+
+#include <ida_chat/ui/search_bar.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+
+#include <QHBoxLayout>
+#include <QKeyEvent>
+
+namespace ida_chat {
+
+SearchBar::SearchBar(QWidget* parent)
+    : QWidget(parent)
+{
+    setObjectName("SearchBar");
+    setAttribute(Qt::WA_StyledBackground);
+    
+    auto* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(12, 6, 8, 6);
+    layout->setSpacing(6);
+    
+    input_ = new QLineEdit(this);
+    input_->setObjectName("SearchInput");
+    input_->setPlaceholderText("Find in conversation");
+    input_->setClearButtonEnabled(true);
+    input_->installEventFilter(this);
+    layout->addWidget(input_, 1);
+    
+    status_ = new QLabel(this);
+    status_->setObjectName("SearchStatus");
+    status_->setMinimumWidth(64);
+    status_->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    layout->addWidget(status_);
+    
+    prev_button_ = new QPushButton(QString::fromUtf8("▲"), this);
+    prev_button_->setObjectName("SearchButton");
+    prev_button_->setToolTip("Previous match (Shift+Enter)");
+    prev_button_->setFixedSize(24, 24);
+    layout->addWidget(prev_button_);
+    
+    next_button_ = new QPushButton(QString::fromUtf8("▼"), this);
+    next_button_->setObjectName("SearchButton");
+    next_button_->setToolTip("Next match (Enter)");
+    next_button_->setFixedSize(24, 24);
+    layout->addWidget(next_button_);
+    
+    auto* close_button = new QPushButton(QString::fromUtf8("✕"), this);
+    close_button->setObjectName("SearchButton");
+    close_button->setToolTip("Close (Esc)");
+    close_button->setFixedSize(24, 24);
+    layout->addWidget(close_button);
+    
+    debounce_.setSingleShot(true);
+    debounce_.setInterval(DEBOUNCE_MS);
+    connect(&debounce_, &QTimer::timeout, this, &SearchBar::flush_query);
+    connect(input_, &QLineEdit::textChanged, this, [this]() { debounce_.start(); });
+    
+    connect(prev_button_, &QPushButton::clicked, this, &SearchBar::prev_requested);
+    connect(next_button_, &QPushButton::clicked, this, &SearchBar::next_requested);
+    connect(close_button, &QPushButton::clicked, this, &SearchBar::close_bar);
+    
+    set_result(-1, 0);
+    hide();
+}
+
+void SearchBar::open() {
+    show();
+    input_->setFocus(Qt::ShortcutFocusReason);
+    input_->selectAll();
+    
+    // Reopening with the old query restores its highlights
+    if (!input_->text().isEmpty()) {
+        flush_query();
+    }
+}
+
+void SearchBar::set_result(int current, int total) {
+    if (input_->text().isEmpty()) {
+        status_->clear();
+    } else if (total == 0) {
+        status_->setText("No results");
+    } else {
+        status_->setText(QString("%1 / %2").arg(current + 1).arg(total));
+    }
+    set_style_state(status_, "empty", !input_->text().isEmpty() && total == 0);
+    prev_button_->setEnabled(total > 0);
+    next_button_->setEnabled(total > 0);
+}
+
+void SearchBar::flush_query() {
+    debounce_.stop();
+    emit query_changed(input_->text());
+}
+
+void SearchBar::close_bar() {
+    debounce_.stop();
+    hide();
+    emit closed();
+}
+
+bool SearchBar::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == input_ && event->type() == QEvent::KeyPress) {
+        auto* key = static_cast<QKeyEvent*>(event);
+        switch (key->key()) {
+            case Qt::Key_Return:
+            case Qt::Key_Enter:
+                // A pending query is run first; its first hit is the "next" one
+                if (debounce_.isActive()) {
+                    flush_query();
+                } else if (key->modifiers() & Qt::ShiftModifier) {
+                    emit prev_requested();
+                } else {
+                    emit next_requested();
+                }
+                return true;
+            case Qt::Key_Escape:
+                close_bar();
+                return true;
+            default:
+                break;
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+} // namespace ida_chat
@@ -0,0 +1,96 @@
+/**
+ * @file stall_overlay.cpp
+ * @brief Frame-time / stall counter overlay implementation.
+ */
+
+#include <ida_chat/ui/stall_overlay.hpp>
+#include <ida_chat/core/stall_monitor.hpp>
+
+#include <QEvent>
+
+namespace ida_chat {
+
+StallOverlay::StallOverlay(QWidget* parent)
+    : QLabel(parent)
+{
+    setObjectName("StallOverlay");
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_StyledBackground);
+    
+    frame_timer_.setTimerType(Qt::PreciseTimer);
+    frame_timer_.setInterval(FRAME_INTERVAL_MS);
+    connect(&frame_timer_, &QTimer::timeout, this, &StallOverlay::on_frame);
+    
+    if (parent) {
+        parent->installEventFilter(this);
+    }
+    refresh();
+    raise();
+}
+
+bool StallOverlay::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == parentWidget() && event->type() == QEvent::Resize) {
+        reposition();
+    }
+    return QLabel::eventFilter(watched, event);
+}
+
+void StallOverlay::showEvent(QShowEvent* event) {
+    QLabel::showEvent(event);
+    frame_clock_.start();
+    refresh_clock_.start();
+    frame_timer_.start();
+    reposition();
+}
+
+void StallOverlay::hideEvent(QHideEvent* event) {
+    frame_timer_.stop();
+    QLabel::hideEvent(event);
+}
+
+void StallOverlay::on_frame() {
+    // A late tick means the event loop could not keep up for that interval
+    double frame_ms = frame_clock_.nsecsElapsed() / 1.0e6;
+    frame_clock_.restart();
+    StallMonitor::instance().record_frame(frame_ms);
+    
+    if (refresh_clock_.elapsed() >= REFRESH_INTERVAL_MS) {
+        refresh_clock_.restart();
+        refresh();
+    }
+}
+
+void StallOverlay::refresh() {
+    auto& monitor = StallMonitor::instance();
+    FrameStats frames = monitor.frame_stats();
+    
+    QString text = QString("frame p95 %1 ms | stalls %2")
+        .arg(frames.p95_ms, 0, 'f', 1)
+        .arg(monitor.stall_count());
+    
+    auto stalls = monitor.records();
+    if (!stalls.empty()) {
+        const auto& last = stalls.back();
+        text += QString(" | last %1 ms %2")
+            .arg(last.duration_ms, 0, 'f', 0)
+            .arg(QString::fromUtf8(stall_cause_str(last.cause)));
+        if (!last.detail.empty()) {
+            text += QString(" (%1)").arg(QString::fromStdString(last.detail));
+        }
+    }
+    
+    if (text != this->text()) {
+        setText(text);
+        adjustSize();
+        reposition();
+    }
+}
+
+void StallOverlay::reposition() {
+    if (auto* parent = parentWidget()) {
+        move(parent->width() - width() - 8, 8);
+        raise();
+    }
+}
+
+} // namespace ida_chat
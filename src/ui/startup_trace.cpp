@@ -0,0 +1,48 @@
+/**
+ * @file startup_trace.cpp
+ * @brief Phase timings for opening the chat dock.
+ */
+
+#include <ida_chat/ui/startup_trace.hpp>
+
+#include <QStringList>
+
+namespace ida_chat {
+
+void StartupTrace::start() {
+    phases_.clear();
+    last_us_ = 0;
+    first_show_ms_ = -1;
+    clock_.start();
+}
+
+void StartupTrace::mark(const QString& name) {
+    if (!clock_.isValid()) return;
+    
+    qint64 now_us = clock_.nsecsElapsed() / 1000;
+    phases_.push_back({name, now_us - last_us_});
+    last_us_ = now_us;
+}
+
+void StartupTrace::mark_first_show() {
+    if (!clock_.isValid()) return;
+    
+    mark("first_show");
+    first_show_ms_ = last_us_ / 1000;
+}
+
+QString StartupTrace::summary() const {
+    QStringList parts;
+    for (const auto& phase : phases_) {
+        parts << QString("%1 %2 ms").arg(phase.name).arg(phase.elapsed_us / 1000.0, 0, 'f', 1);
+    }
+    
+    QString text = parts.join(", ");
+    if (first_show_ms_ >= 0) {
+        text += QString(" | first show %1 ms (budget %2 ms)")
+            .arg(first_show_ms_).arg(FIRST_SHOW_BUDGET_MS);
+    }
+    return text;
+}
+
+} // namespace ida_chat
@@ -0,0 +1,594 @@
+/**
+ * @file syntax_highlighter.cpp
+ * @brief Background syntax highlighting implementation.
+ */
+
+#include <ida_chat/ui/syntax_highlighter.hpp>
+#include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/ui/markdown_renderer.hpp>
+#include <ida_chat/core/thread_pool.hpp>
+
+#include <QColor>
+#include <QCoreApplication>
+#include <QSet>
+#include <QStringView>
+#include <QTextBlock>
+#include <QTextCharFormat>
+#include <QTextDocument>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+
+namespace ida_chat {
+
+using namespace theme;
+
+// ============================================================================
+// Keyword Tables
+// ============================================================================
+
+namespace {
+
+const QSet<QString>& python_keywords() {
+    static const QSet<QString> words = {
+        "False", "None", "True", "and", "as", "assert", "async", "await",
+        "break", "class", "continue", "def", "del", "elif", "else", "except",
+        "finally", "for", "from", "global", "if", "import", "in", "is",
+        "lambda", "nonlocal", "not", "or", "pass", "raise", "return", "try",
+        "while", "with", "yield", "match", "case"
+    };
+    return words;
+}
+
+const QSet<QString>& python_builtins() {
+    static const QSet<QString> words = {
+        "int", "str", "bytes", "bytearray", "bool", "float", "list", "dict",
+        "set", "tuple", "object", "type", "len", "range", "print", "hex",
+        "isinstance", "enumerate", "zip", "map", "filter", "sorted", "open",
+        "self", "cls", "Exception"
+    };
+    return words;
+}
+
+const QSet<QString>& c_keywords() {
+    static const QSet<QString> words = {
+        "if", "else", "for", "while", "do", "switch", "case", "default",
+        "break", "continue", "return", "goto", "sizeof", "typedef", "struct",
+        "union", "enum", "static", "extern", "const", "volatile", "register",
+        "inline", "__fastcall", "__cdecl", "__stdcall", "__thiscall",
+        "__usercall", "__userpurge", "__noreturn", "LABEL"
+    };
+    return words;
+}
+
+const QSet<QString>& c_types() {
+    static const QSet<QString> words = {
+        "void", "char", "short", "int", "long", "float", "double", "signed",
+        "unsigned", "bool", "_BOOL1", "_BOOL2", "_BOOL4", "_BOOL8", "_BYTE",
+        "_WORD", "_DWORD", "_QWORD", "_OWORD", "__int8", "__int16", "__int32",
+        "__int64", "__int128", "size_t", "BYTE", "WORD", "DWORD", "QWORD",
+        "HANDLE", "LPVOID", "PVOID"
+    };
+    return words;
+}
+
+const QSet<QString>& asm_registers() {
+    static const QSet<QString> words = {
+        // x86 / x64
+        "al", "ah", "ax", "eax", "rax", "bl", "bh", "bx", "ebx", "rbx",
+        "cl", "ch", "cx", "ecx", "rcx", "dl", "dh", "dx", "edx", "rdx",
+        "si", "esi", "rsi", "sil", "di", "edi", "rdi", "dil",
+        "bp", "ebp", "rbp", "bpl", "sp", "esp", "rsp", "spl", "ip", "eip", "rip",
+        "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+        "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d",
+        "cs", "ds", "es", "fs", "gs", "ss",
+        // ARM / AArch64
+        "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9", "x10",
+        "x16", "x17", "x29", "x30", "w0", "w1", "w2", "w3", "w4", "w5", "w8",
+        "lr", "pc", "xzr", "wzr", "r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7"
+    };
+    return words;
+}
+
+const QSet<QString>& asm_directives() {
+    static const QSet<QString> words = {
+        "db", "dw", "dd", "dq", "byte", "word", "dword", "qword", "ptr",
+        "offset", "near", "far", "proc", "endp", "public", "extrn", "align"
+    };
+    return words;
+}
+
+// ============================================================================
+// Lexer helpers
+// ============================================================================
+
+bool is_ident_start(QChar c) {
+    return c.isLetter() || c == QLatin1Char('_');
+}
+
+bool is_ident_char(QChar c) {
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+class Lexer {
+public:
+    Lexer(const QString& code, std::vector<HighlightSpan>& out)
+        : code_(code), n_(code.size()), out_(out) {}
+
+    void emit(int start, int end, TokenKind kind) {
+        if (end > start) out_.push_back({start, end - start, kind});
+    }
+
+    int skip_to_eol(int i) const {
+        while (i < n_ && code_[i] != QLatin1Char('\n')) ++i;
+        return i;
+    }
+
+    int scan_ident(int i) const {
+        while (i < n_ && is_ident_char(code_[i])) ++i;
+        return i;
+    }
+
+    int scan_string(int i, QChar quote) const {
+        ++i;
+        while (i < n_) {
+            QChar c = code_[i];
+            if (c == QLatin1Char('\\')) { i += 2; continue; }
+            if (c == quote) return i + 1;
+            if (c == QLatin1Char('\n')) return i;
+            ++i;
+        }
+        return n_;
+    }
+
+    int scan_number(int i) const {
+        // Covers 123, 0x1F, 1.5e3, 10u, 0FFh
+        while (i < n_ && (code_[i].isLetterOrNumber() || code_[i] == QLatin1Char('.'))) ++i;
+        return i;
+    }
+
+    int next_non_space(int i) const {
+        while (i < n_ && (code_[i] == QLatin1Char(' ') || code_[i] == QLatin1Char('\t'))) ++i;
+        return i;
+    }
+
+    const QString& code_;
+    const int n_;
+    std::vector<HighlightSpan>& out_;
+};
+
+void tokenize_python(const QString& code, std::vector<HighlightSpan>& out) {
+    Lexer lx(code, out);
+    const auto& keywords = python_keywords();
+    const auto& builtins = python_builtins();
+    bool line_start = true;
+
+    int i = 0;
+    while (i < lx.n_) {
+        QChar c = code[i];
+
+        if (c == QLatin1Char('\n')) { line_start = true; ++i; continue; }
+        if (c.isSpace()) { ++i; continue; }
+
+        if (c == QLatin1Char('#')) {
+            int end = lx.skip_to_eol(i);
+            lx.emit(i, end, TokenKind::Comment);
+            i = end;
+        } else if (c == QLatin1Char('@') && line_start) {
+            int end = lx.scan_ident(i + 1);
+            lx.emit(i, end, TokenKind::Preprocessor);
+            i = end;
+        } else if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            // Triple-quoted strings may span lines
+            QString triple(3, c);
+            if (QStringView(code).mid(i, 3) == triple) {
+                int close = code.indexOf(triple, i + 3);
+                int end = close < 0 ? lx.n_ : close + 3;
+                lx.emit(i, end, TokenKind::String);
+                i = end;
+            } else {
+                int end = lx.scan_string(i, c);
+                lx.emit(i, end, TokenKind::String);
+                i = end;
+            }
+        } else if (c.isDigit()) {
+            int end = lx.scan_number(i);
+            lx.emit(i, end, TokenKind::Number);
+            i = end;
+        } else if (is_ident_start(c)) {
+            int end = lx.scan_ident(i);
+            QString word = code.mid(i, end - i);
+            if (keywords.contains(word)) {
+                lx.emit(i, end, TokenKind::Keyword);
+            } else if (builtins.contains(word)) {
+                lx.emit(i, end, TokenKind::Type);
+            } else {
+                int next = lx.next_non_space(end);
+                if (next < lx.n_ && code[next] == QLatin1Char('(')) {
+                    lx.emit(i, end, TokenKind::Function);
+                }
+            }
+            i = end;
+        } else {
+            ++i;
+        }
+        line_start = false;
+    }
+}
+
+void tokenize_c(const QString& code, std::vector<HighlightSpan>& out) {
+    Lexer lx(code, out);
+    const auto& keywords = c_keywords();
+    const auto& types = c_types();
+    bool line_start = true;
+
+    int i = 0;
+    while (i < lx.n_) {
+        QChar c = code[i];
+
+        if (c == QLatin1Char('\n')) { line_start = true; ++i; continue; }
+        if (c.isSpace()) { ++i; continue; }
+
+        if (c == QLatin1Char('/') && i + 1 < lx.n_ && code[i + 1] == QLatin1Char('/')) {
+            int end = lx.skip_to_eol(i);
+            lx.emit(i, end, TokenKind::Comment);
+            i = end;
+        } else if (c == QLatin1Char('/') && i + 1 < lx.n_ && code[i + 1] == QLatin1Char('*')) {
+            int close = code.indexOf(QLatin1String("*/"), i + 2);
+            int end = close < 0 ? lx.n_ : close + 2;
+            lx.emit(i, end, TokenKind::Comment);
+            i = end;
+        } else if (c == QLatin1Char('#') && line_start) {
+            int end = lx.skip_to_eol(i);
+            lx.emit(i, end, TokenKind::Preprocessor);
+            i = end;
+        } else if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            int end = lx.scan_string(i, c);
+            lx.emit(i, end, TokenKind::String);
+            i = end;
+        } else if (c.isDigit()) {
+            int end = lx.scan_number(i);
+            lx.emit(i, end, TokenKind::Number);
+            i = end;
+        } else if (is_ident_start(c)) {
+            int end = lx.scan_ident(i);
+            QString word = code.mid(i, end - i);
+            if (keywords.contains(word)) {
+                lx.emit(i, end, TokenKind::Keyword);
+            } else if (types.contains(word) || word.endsWith(QLatin1String("_t"))) {
+                lx.emit(i, end, TokenKind::Type);
+            } else {
+                int next = lx.next_non_space(end);
+                if (next < lx.n_ && code[next] == QLatin1Char('(')) {
+                    lx.emit(i, end, TokenKind::Function);
+                }
+            }
+            i = end;
+        } else {
+            ++i;
+        }
+        line_start = false;
+    }
+}
+
+void tokenize_asm(const QString& code, std::vector<HighlightSpan>& out) {
+    Lexer lx(code, out);
+    const auto& registers = asm_registers();
+    const auto& directives = asm_directives();
+
+    int i = 0;
+    while (i < lx.n_) {
+        // One line at a time: [segment:address] [label:] mnemonic operands ; comment
+        int eol = lx.skip_to_eol(i);
+        bool seen_mnemonic = false;
+
+        int j = lx.next_non_space(i);
+
+        // IDA listing prefix, e.g. ".text:0000000140001000"
+        if (j < eol && (code[j] == QLatin1Char('.') || is_ident_start(code[j]))) {
+            int k = j + 1;
+            while (k < eol && (is_ident_char(code[k]) || code[k] == QLatin1Char('.'))) ++k;
+            if (k < eol && code[k] == QLatin1Char(':')) {
+                int addr_end = k + 1;
+                while (addr_end < eol && code[addr_end].isLetterOrNumber()) ++addr_end;
+                bool is_prefix = addr_end > k + 1;
+                lx.emit(j, is_prefix ? addr_end : k + 1, TokenKind::Label);
+                j = is_prefix ? addr_end : k + 1;
+            }
+        }
+
+        while (j < eol) {
+            QChar c = code[j];
+
+            if (c == QLatin1Char(' ') || c == QLatin1Char('\t')) { ++j; continue; }
+
+            if (c == QLatin1Char(';')) {
+                lx.emit(j, eol, TokenKind::Comment);
+                break;
+            }
+            if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+                int end = qMin(lx.scan_string(j, c), eol);
+                lx.emit(j, end, TokenKind::String);
+                j = end;
+                continue;
+            }
+            if (c.isDigit()) {
+                int end = lx.scan_number(j);
+                lx.emit(j, end, TokenKind::Number);
+                j = end;
+                continue;
+            }
+            if (is_ident_start(c) || c == QLatin1Char('.') || c == QLatin1Char('$')) {
+                int end = lx.scan_ident(j + 1);
+                QString word = code.mid(j, end - j);
+                QString lower = word.toLower();
+                if (end < eol && code[end] == QLatin1Char(':') && !seen_mnemonic) {
+                    lx.emit(j, end + 1, TokenKind::Label);
+                    end += 1;
+                } else if (registers.contains(lower)) {
+                    lx.emit(j, end, TokenKind::Register);
+                } else if (directives.contains(lower)) {
+                    lx.emit(j, end, TokenKind::Type);
+                    seen_mnemonic = true;
+                } else if (!seen_mnemonic) {
+                    lx.emit(j, end, TokenKind::Keyword);
+                    seen_mnemonic = true;
+                }
+                j = end;
+                continue;
+            }
+            ++j;
+        }
+
+        i = eol + 1;
+    }
+}
+
+QString color_for(TokenKind kind) {
+    switch (kind) {
+        case TokenKind::Keyword: return SYNTAX_KEYWORD;
+        case TokenKind::Type: return SYNTAX_TYPE;
+        case TokenKind::String: return SYNTAX_STRING;
+        case TokenKind::Number: return SYNTAX_NUMBER;
+        case TokenKind::Comment: return SYNTAX_COMMENT;
+        case TokenKind::Preprocessor: return SYNTAX_PREPROC;
+        case TokenKind::Function: return SYNTAX_FUNCTION;
+        case TokenKind::Register: return SYNTAX_REGISTER;
+        case TokenKind::Label: return SYNTAX_LABEL;
+    }
+    return TEXT_CODE;
+}
+
+} // namespace
+
+// ============================================================================
+// Pure API
+// ============================================================================
+
+CodeLanguage language_from_hint(const QString& hint) {
+    QString h = hint.trimmed().toLower();
+    if (h == "python" || h == "py" || h == "python3" || h == "idapython") {
+        return CodeLanguage::Python;
+    }
+    if (h == "c" || h == "cpp" || h == "c++" || h == "h" || h == "hpp" ||
+        h == "pseudocode" || h == "hexrays") {
+        return CodeLanguage::C;
+    }
+    if (h == "asm" || h == "assembly" || h == "nasm" || h == "masm" || h == "x86" ||
+        h == "x64" || h == "arm" || h == "arm64" || h == "disasm") {
+        return CodeLanguage::Asm;
+    }
+    return CodeLanguage::Plain;
+}
+
+std::vector<HighlightSpan> tokenize_code(const QString& code, CodeLanguage language) {
+    std::vector<HighlightSpan> spans;
+    switch (language) {
+        case CodeLanguage::Python: tokenize_python(code, spans); break;
+        case CodeLanguage::C: tokenize_c(code, spans); break;
+        case CodeLanguage::Asm: tokenize_asm(code, spans); break;
+        case CodeLanguage::Plain: break;
+    }
+    return spans;
+}
+
+QString spans_to_html(const QString& code, const std::vector<HighlightSpan>& spans) {
+    QString html;
+    html.reserve(code.size() + static_cast<int>(spans.size()) * 32);
+
+    int pos = 0;
+    for (const auto& span : spans) {
+        if (span.start < pos) continue;
+        html += MarkdownRenderer::escape_html(code.mid(pos, span.start - pos));
+        html += QStringLiteral("<span style=\"color: %1;\">").arg(color_for(span.kind));
+        html += MarkdownRenderer::escape_html(code.mid(span.start, span.length));
+        html += QStringLiteral("</span>");
+        pos = span.start + span.length;
+    }
+    html += MarkdownRenderer::escape_html(code.mid(pos));
+    return html;
+}
+
+// ============================================================================
+// SyntaxHighlighter
+// ============================================================================
+
+SyntaxHighlighter& SyntaxHighlighter::instance() {
+    static QPointer<SyntaxHighlighter> highlighter;
+    if (!highlighter) {
+        highlighter = new SyntaxHighlighter(QCoreApplication::instance());
+    }
+    return *highlighter;
+}
+
+SyntaxHighlighter::SyntaxHighlighter(QObject* parent)
+    : QObject(parent) {}
+
+quint64 SyntaxHighlighter::cache_key(const QString& code, CodeLanguage language) {
+    return static_cast<quint64>(qHashMulti(0, static_cast<int>(language), code.size(), code));
+}
+
+std::optional<QString> SyntaxHighlighter::cached_html(const QString& code, CodeLanguage language) const {
+    if (auto* html = cache_.object(cache_key(code, language))) {
+        return *html;
+    }
+    return std::nullopt;
+}
+
+void SyntaxHighlighter::apply_budget() {
+    // Half the budget each; lowering maxCost to a new budget evicts
+    std::size_t budget = cache_bytes_.budget();
+    qsizetype max_cost = budget ? qMax<qsizetype>(1, static_cast<qsizetype>(budget / 2))
+                                : std::numeric_limits<qsizetype>::max();
+    if (cache_.maxCost() != max_cost) {
+        cache_.setMaxCost(max_cost);
+    }
+    if (span_cache_.maxCost() != max_cost) {
+        span_cache_.setMaxCost(max_cost);
+    }
+}
+
+void SyntaxHighlighter::request(const QString& code, CodeLanguage language,
+                                QObject* context, ReadyFn on_ready) {
+    quint64 key = cache_key(code, language);
+    if (auto* html = cache_.object(key)) {
+        on_ready(*html);
+        return;
+    }
+
+    auto it = pending_.find(key);
+    bool already_running = it != pending_.end();
+    pending_[key].push_back({context, std::move(on_ready)});
+
+    if (!already_running) {
+        start_job(key, code, language, true);
+    }
+}
+
+void SyntaxHighlighter::request_spans(const QString& code, CodeLanguage language,
+                                      QObject* context, SpansReadyFn on_ready) {
+    quint64 key = cache_key(code, language);
+    if (auto* spans = span_cache_.object(key)) {
+        on_ready(*spans);
+        return;
+    }
+
+    auto it = pending_spans_.find(key);
+    bool already_running = it != pending_spans_.end();
+    pending_spans_[key].push_back({context, std::move(on_ready)});
+
+    if (!already_running) {
+        start_job(key, code, language, false);
+    }
+}
+
+/// One queued tokenize. Completion is posted from the destructor, so a job
+/// the pool drops without running (shutdown) still clears its pending entry.
+struct SyntaxHighlighter::Job {
+    QPointer<SyntaxHighlighter> owner;
+    quint64 key = 0;
+    bool as_html = false;
+    QString code;
+    CodeLanguage language = CodeLanguage::Plain;
+
+    bool done = false;
+    QString html;
+    std::vector<HighlightSpan> spans;
+
+    void run() {
+        spans = tokenize_code(code, language);
+        if (as_html) {
+            html = spans_to_html(code, spans);
+            spans.clear();
+        }
+        code.clear();
+        done = true;
+    }
+
+    ~Job() {
+        // Never dereference owner here: this may run on a worker thread
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app) return;
+        QMetaObject::invokeMethod(app, [owner = std::move(owner), key = key, as_html = as_html, done = done,
+                                        html = std::move(html), spans = std::move(spans)]() {
+            if (owner) owner->finish_job(key, as_html, done, html, spans);
+        }, Qt::QueuedConnection);
+    }
+};
+
+void SyntaxHighlighter::start_job(quint64 key, const QString& code, CodeLanguage language, bool as_html) {
+    auto job = std::make_shared<Job>();
+    job->owner = this;
+    job->key = key;
+    job->as_html = as_html;
+    job->code = code;
+    job->language = language;
+    ThreadPool::instance().submit([job]() { job->run(); }, TaskPriority::Interactive);
+}
+
+void SyntaxHighlighter::finish_job(quint64 key, bool as_html, bool done,
+                                   const QString& html, const std::vector<HighlightSpan>& spans) {
+    apply_budget();
+
+    if (as_html) {
+        auto waiters = pending_.take(key);
+        if (!done) return;   // Dropped by the pool; the next request retries
+
+        cache_.insert(key, new QString(html),
+                      qMax<qsizetype>(1, html.size() * static_cast<qsizetype>(sizeof(QChar))));
+        for (auto& waiter : waiters) {
+            if (waiter.context && waiter.on_ready) {
+                waiter.on_ready(html);
+            }
+        }
+    } else {
+        auto waiters = pending_spans_.take(key);
+        if (!done) return;
+
+        span_cache_.insert(key, new std::vector<HighlightSpan>(spans),
+                           qMax<qsizetype>(1, static_cast<qsizetype>(spans.size() * sizeof(HighlightSpan))));
+        for (auto& waiter : waiters) {
+            if (waiter.context && waiter.on_ready) {
+                waiter.on_ready(spans);
+            }
+        }
+    }
+
+    cache_bytes_.set(static_cast<std::size_t>(cache_.totalCost() + span_cache_.totalCost()));
+}
+
+// ============================================================================
+// CodeSpanHighlighter
+// ============================================================================
+
+CodeSpanHighlighter::CodeSpanHighlighter(std::vector<HighlightSpan> spans, QTextDocument* document)
+    : QSyntaxHighlighter(document)
+    , spans_(std::move(spans)) {}
+
+void CodeSpanHighlighter::highlightBlock(const QString& text) {
+    static const auto formats = [] {
+        std::array<QTextCharFormat, static_cast<std::size_t>(TokenKind::Label) + 1> f;
+        for (std::size_t i = 0; i < f.size(); ++i) {
+            f[i].setForeground(QColor(color_for(static_cast<TokenKind>(i))));
+        }
+        return f;
+    }();
+
+    int begin = currentBlock().position();
+    int end = begin + static_cast<int>(text.size());
+
+    // Spans are sorted and disjoint, so their ends ascend too
+    auto it = std::partition_point(spans_.begin(), spans_.end(), [begin](const HighlightSpan& span) {
+        return span.start + span.length <= begin;
+    });
+    for (; it != spans_.end() && it->start < end; ++it) {
+        // Multi-line tokens (block comments, docstrings) are clipped per block
+        int from = qMax(it->start, begin);
+        int to = qMin(it->start + it->length, end);
+        setFormat(from - begin, to - from, formats[static_cast<std::size_t>(it->kind)]);
+    }
+}
+
+} // namespace ida_chat
@@ -5,10 +5,11 @@
 
 #include <ida_chat/ui/task_sidebar.hpp>
 #include <ida_chat/ui/cursor_theme.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+#include <ida_chat/ui/animation_ticker.hpp>
 
 #include <QMouseEvent>
 #include <QUuid>
-#include <QStyle>
 #include <QFrame>
 
 namespace ida_chat {
@@ -22,23 +23,15 @@ using namespace theme;
 TaskCard::TaskCard(const TaskItem& task, QWidget* parent)
     : QWidget(parent)
     , task_(task)
-    , animation_timer_(new QTimer(this))
 {
     setup_ui();
-    
-    connect(animation_timer_, &QTimer::timeout, this, [this]() {
-        animation_frame_ = (animation_frame_ + 1) % SPINNER_FRAMES.size();
-        update_status_icon();
-    });
-    
-    if (task_.status == TaskStatus::Generating) {
-        animation_timer_->start(100);
-    }
 }
 
 void TaskCard::setup_ui() {
     setCursor(Qt::PointingHandCursor);
-    setStyleSheet(QString("background: transparent;"));
+    setObjectName("TaskCard");
+    setAttribute(Qt::WA_StyledBackground);
+    setAttribute(Qt::WA_Hover);
     
     auto* layout = new QHBoxLayout(this);
     layout->setContentsMargins(8, 10, 12, 10);
@@ -46,6 +39,7 @@ void TaskCard::setup_ui() {
     
     // Status icon
     status_icon_ = new QLabel(this);
+    status_icon_->setObjectName("TaskStatusIcon");
     status_icon_->setFixedWidth(20);
     status_icon_->setAlignment(Qt::AlignCenter);
     layout->addWidget(status_icon_);
@@ -61,25 +55,25 @@ void TaskCard::setup_ui() {
     title_row->setSpacing(8);
     
     title_label_ = new QLabel(task_.title, content);
-    title_label_->setStyleSheet(QString("color: %1; font-size: 13px; font-weight: 500;").arg(TEXT_PRIMARY));
+    title_label_->setObjectName("TaskTitle");
     title_label_->setMaximumWidth(180);
     title_row->addWidget(title_label_, 1);
     
     time_label_ = new QLabel(format_time_ago(), content);
-    time_label_->setStyleSheet(QString("color: %1; font-size: 11px;").arg(TEXT_MUTED));
+    time_label_->setObjectName("TaskTime");
     title_row->addWidget(time_label_);
     
     content_layout->addLayout(title_row);
     
     // Subtitle / summary row
     summary_label_ = new QLabel(content);
-    summary_label_->setStyleSheet(QString("color: %1; font-size: 11px;").arg(TEXT_MUTED));
+    summary_label_->setObjectName("TaskSummary");
     summary_label_->setMaximumWidth(200);
     content_layout->addWidget(summary_label_);
     
     // Diff stats (hidden initially)
     diff_label_ = new QLabel(content);
-    diff_label_->setStyleSheet(QString("font-size: 11px;"));
+    diff_label_->setObjectName("TaskDiff");
     diff_label_->setVisible(false);
     content_layout->addWidget(diff_label_);
     
@@ -98,16 +92,13 @@ void TaskCard::update_task(const TaskItem& task) {
     // Update subtitle based on status
     if (task_.status == TaskStatus::Generating) {
         summary_label_->setText("Generating");
-        summary_label_->setStyleSheet(QString("color: %1; font-size: 11px;").arg(TEXT_MUTED));
         diff_label_->setVisible(false);
     } else if (task_.status == TaskStatus::Error) {
         summary_label_->setText(task_.summary.isEmpty() ? "Error" : task_.summary);
-        summary_label_->setStyleSheet(QString("color: %1; font-size: 11px;").arg(ACCENT_RED));
         diff_label_->setVisible(false);
     } else {
         // Complete - show diff stats and summary
         summary_label_->setText(task_.summary.isEmpty() ? "Complete" : task_.summary);
-        summary_label_->setStyleSheet(QString("color: %1; font-size: 11px;").arg(TEXT_MUTED));
         
         // Show diff if we have it
         if (task_.lines_added > 0 || task_.lines_removed > 0) {
@@ -125,33 +116,42 @@ void TaskCard::update_task(const TaskItem& task) {
         }
     }
     
-    // Update animation
+    update_animation();
+    update_status_icon();
+}
+
+void TaskCard::update_animation() {
+    // Spinner frames come from the shared ticker; only the glyph changes per
+    // tick, the icon style is set once by update_status_icon().
     if (task_.status == TaskStatus::Generating) {
-        if (!animation_timer_->isActive()) {
-            animation_timer_->start(100);
-        }
+        AnimationTicker::instance().subscribe(this, [this](int frame) {
+            animation_frame_ = frame % SPINNER_FRAMES.size();
+            status_icon_->setText(SPINNER_FRAMES[animation_frame_]);
+        });
     } else {
-        animation_timer_->stop();
+        AnimationTicker::instance().unsubscribe(this);
     }
-    
-    update_status_icon();
 }
 
 void TaskCard::update_status_icon() {
+    // Colors come from the theme sheet; only a status change repolishes
+    QString state;
     switch (task_.status) {
         case TaskStatus::Generating:
             status_icon_->setText(SPINNER_FRAMES[animation_frame_]);
-            status_icon_->setStyleSheet(QString("color: %1; font-size: 14px;").arg(TEXT_MUTED));
+            state = "generating";
             break;
         case TaskStatus::Complete:
             status_icon_->setText("⊙");
-            status_icon_->setStyleSheet(QString("color: %1; font-size: 14px;").arg(ACCENT_GREEN));
+            state = "complete";
             break;
         case TaskStatus::Error:
             status_icon_->setText("⊗");
-            status_icon_->setStyleSheet(QString("color: %1; font-size: 14px;").arg(ACCENT_RED));
+            state = "error";
             break;
     }
+    set_style_state(status_icon_, "status", state);
+    set_style_state(summary_label_, "status", state);
 }
 
 QString TaskCard::format_time_ago() const {
@@ -171,18 +171,6 @@ void TaskCard::mousePressEvent(QMouseEvent* event) {
     QWidget::mousePressEvent(event);
 }
 
-void TaskCard::enterEvent(QEnterEvent* event) {
-    hovered_ = true;
-    setStyleSheet(QString("background: %1; border-radius: 6px;").arg(BG_CARD_HOVER));
-    QWidget::enterEvent(event);
-}
-
-void TaskCard::leaveEvent(QEvent* event) {
-    hovered_ = false;
-    setStyleSheet(QString("background: transparent;"));
-    QWidget::leaveEvent(event);
-}
-
 // ============================================================================
 // TaskSection Implementation
 // ============================================================================
@@ -197,9 +185,7 @@ TaskSection::TaskSection(const QString& title, QWidget* parent)
     
     // Header
     header_label_ = new QLabel(this);
-    header_label_->setStyleSheet(QString(
-        "color: %1; font-size: 11px; font-weight: 600; text-transform: uppercase; letter-spacing: 0.5px; padding: 8px 0;"
-    ).arg(TEXT_MUTED));
+    header_label_->setObjectName("TaskSectionHeader");
     layout->addWidget(header_label_);
     
     // Cards container
@@ -272,7 +258,8 @@ TaskSidebar::TaskSidebar(QWidget* parent)
 void TaskSidebar::setup_ui() {
     setMinimumWidth(220);
     setMaximumWidth(320);
-    setStyleSheet(QString("background: %1;").arg(BG_SIDEBAR));
+    setObjectName("TaskSidebar");
+    setAttribute(Qt::WA_StyledBackground);
     
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -283,16 +270,10 @@ void TaskSidebar::setup_ui() {
     scroll_area_->setWidgetResizable(true);
     scroll_area_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     scroll_area_->setFrameShape(QFrame::NoFrame);
-    scroll_area_->setStyleSheet(QString(
-        "QScrollArea { border: none; background: transparent; }"
-        "QScrollBar:vertical { background: transparent; width: 6px; }"
-        "QScrollBar::handle:vertical { background: %1; border-radius: 3px; min-height: 20px; }"
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { height: 0; }"
-        "QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical { background: none; }"
-    ).arg(BORDER_DEFAULT));
+    scroll_area_->setObjectName("TaskSidebarScroll");
     
     auto* content = new QWidget(scroll_area_);
-    content->setStyleSheet(QString("background: %1;").arg(BG_SIDEBAR));
+    content->setObjectName("TaskSidebarContent");
     
     auto* content_layout = new QVBoxLayout(content);
     content_layout->setContentsMargins(0, 16, 0, 16);
@@ -0,0 +1,127 @@
+/**
+ * @file turn_status_strip.cpp
+ * @brief Live request metrics strip implementation.
+ */
+
+#include <ida_chat/ui/turn_status_strip.hpp>
+#include <ida_chat/ui/cursor_stylesheet.hpp>
+
+#include <QStringList>
+#include <utility>
+
+namespace ida_chat {
+
+namespace {
+
+QString format_tokens(std::int64_t tokens) {
+    if (tokens < 1000) return QString::number(tokens);
+    return QString("%1k").arg(static_cast<double>(tokens) / 1000.0, 0, 'f', 1);
+}
+
+QString format_ms(double ms) {
+    if (ms < 1000.0) return QString("%1 ms").arg(static_cast<int>(ms));
+    return QString("%1 s").arg(ms / 1000.0, 0, 'f', 1);
+}
+
+const char* const BASE_TOOLTIP =
+    "Time to first token, output rate, prompt cache hits, tokens in/out, "
+    "script run time and main-thread queue wait for the current request";
+
+/// "TTFT  p50 820 ms  p95 1.4 s  p99 2.1 s  (n=42)" for one histogram
+QString percentile_line(const nlohmann::json& histograms, const char* name, const char* label) {
+    auto it = histograms.find(name);
+    if (it == histograms.end()) return {};
+    
+    return QString("%1  p50 %2  p95 %3  p99 %4  (n=%5)")
+        .arg(label)
+        .arg(format_ms(it->value("p50", 0.0)))
+        .arg(format_ms(it->value("p95", 0.0)))
+        .arg(format_ms(it->value("p99", 0.0)))
+        .arg(it->value("count", 0));
+}
+
+} // anonymous namespace
+
+TurnStatusStrip::TurnStatusStrip(Source source, QWidget* parent)
+    : QLabel(parent)
+    , source_(std::move(source))
+{
+    setObjectName("TurnStatus");
+    setTextFormat(Qt::PlainText);
+    setToolTip(BASE_TOOLTIP);
+    
+    timer_.setInterval(REFRESH_INTERVAL_MS);
+    connect(&timer_, &QTimer::timeout, this, &TurnStatusStrip::refresh);
+    hide();
+}
+
+void TurnStatusStrip::start() {
+    show();
+    refresh();
+    timer_.start();
+}
+
+void TurnStatusStrip::stop() {
+    timer_.stop();
+    refresh();
+}
+
+void TurnStatusStrip::refresh() {
+    if (!source_) return;
+    
+    TurnMetrics metrics = source_();
+    QString text = format(metrics);
+    if (text != this->text()) {
+        setText(text);
+    }
+    set_style_state(this, "active", metrics.active);
+}
+
+void TurnStatusStrip::set_percentiles(const nlohmann::json& snapshot) {
+    static constexpr std::pair<const char*, const char*> scopes[] = {
+        {"session", "This session:"},
+        {"lifetime", "All sessions:"},
+    };
+    static constexpr std::pair<const char*, const char*> rows[] = {
+        {metric_names::TTFT_MS, "TTFT"},
+        {metric_names::TURN_LATENCY_MS, "Turn"},
+        {metric_names::SCRIPT_MS, "Script"},
+    };
+    
+    QStringList lines{BASE_TOOLTIP};
+    for (const auto& [scope, title] : scopes) {
+        auto histograms = snapshot.value(scope, nlohmann::json::object())
+                                  .value("histograms", nlohmann::json::object());
+        QStringList scope_lines;
+        for (const auto& [name, label] : rows) {
+            QString line = percentile_line(histograms, name, label);
+            if (!line.isEmpty()) scope_lines << line;
+        }
+        if (!scope_lines.isEmpty()) {
+            lines << QString() << title << scope_lines;
+        }
+    }
+    setToolTip(lines.join("\n"));
+}
+
+QString TurnStatusStrip::format(const TurnMetrics& metrics) {
+    QStringList parts;
+    parts << QString("turn %1").arg(metrics.turn);
+    parts << "TTFT " + (metrics.ttft_ms < 0 ? QString("…") : format_ms(metrics.ttft_ms));
+    if (metrics.tokens_per_sec > 0.0) {
+        parts << QString("%1 tok/s").arg(metrics.tokens_per_sec, 0, 'f', 0);
+    }
+    parts << QString("cache %1%").arg(static_cast<int>(metrics.cache_hit_ratio() * 100.0 + 0.5));
+    parts << QString("in %1").arg(format_tokens(metrics.usage.input_tokens
+                                                + metrics.usage.cache_read_tokens
+                                                + metrics.usage.cache_creation_tokens));
+    parts << QString("out %1").arg(format_tokens(metrics.usage.output_tokens));
+    if (metrics.scripts > 0) {
+        parts << QString("scripts %1 (queue %2)")
+            .arg(format_ms(metrics.script_ms), format_ms(metrics.queue_wait_ms));
+    }
+    parts << format_ms(metrics.elapsed_ms);
+    return parts.join(QString::fromUtf8(" · "));
+}
+
+} // namespace ida_chat